@@ -23,6 +23,18 @@ void main()
 		return;
 	}
 
+	// Distance field glyphs: alpha holds the distance to the outline, 0.5 on the edge.
+	// Smoothing over one screen pixel keeps the edge sharp at any scale.
+	if (fs_in.textureID > 32.5)
+	{
+		int fieldID = int(fs_in.textureID - 32.5);
+		float distance = texture(textureArray[fieldID], fs_in.uv).a;
+		float width = max(fwidth(distance) * 0.5, 0.001);
+		float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+		color = vec4(fs_in.color.rgb, fs_in.color.a * alpha);
+		return;
+	}
+
 	int textureID = int(fs_in.textureID - 0.5);
 	vec4 textureColor = fs_in.color * texture(textureArray[textureID], fs_in.uv); 
 
@@ -0,0 +1,44 @@
+struct Material 
+{
+    sampler2D diffuse;
+	sampler2D specular;
+    float shininess;
+}; 
+
+struct DirLight
+{
+	vec3 direction;
+	
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+};
+
+struct PointLight 
+{
+    vec3 position;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+	float constant;
+	float linear;
+	float quadratic;
+};
+
+struct SpotLight 
+{
+    vec3 position;
+	vec3 direction;
+	float inCutOff;
+	float outCutOff;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+	float constant;
+	float linear;
+	float quadratic;
+};
\ No newline at end of file
@@ -2,50 +2,7 @@
 
 layout (location = 0) out vec4 resultColor;
 
-struct Material 
-{
-    sampler2D diffuse;
-	sampler2D specular;
-    float shininess;
-}; 
-
-struct DirLight
-{
-	vec3 direction;
-	
-	vec3 ambient;
-	vec3 diffuse;
-	vec3 specular;
-};
-
-struct PointLight 
-{
-    vec3 position;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-
-	float constant;
-	float linear;
-	float quadratic;
-};
-
-struct SpotLight 
-{
-    vec3 position;
-	vec3 direction;
-	float inCutOff;
-	float outCutOff;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-
-	float constant;
-	float linear;
-	float quadratic;
-};
+#include "include/lights.glsl"
 
 uniform vec3 viewPos;
 uniform DirLight dirLight;
@@ -70,11 +27,13 @@ void main()
 	vec3 norm = normalize(fragment.normal);
 	vec3 viewDir = normalize(viewPos - fragment.position);
 
-	vec3 dirLight = GetDirLight(dirLight, norm, viewDir);
-	//vec3 pointLight = GetPointLight(pointLight, norm, viewDir);
-	//vec3 spotLight = GetSpotLight(spotLight, norm, viewDir);
-	
-	vec3 result = dirLight;// + pointLight + spotLight;
+	vec3 result = GetDirLight(dirLight, norm, viewDir);
+#ifdef POINT_LIGHT
+	result += GetPointLight(pointLight, norm, viewDir);
+#endif
+#ifdef SPOT_LIGHT
+	result += GetSpotLight(spotLight, norm, viewDir);
+#endif
 	
 	resultColor = vec4(result, 1);
 }
@@ -2,16 +2,28 @@
 
 out vec4 outColor;
 
-uniform sampler2D tex;
+uniform sampler2D layers[4];
+uniform vec3 lightDirection = vec3(-1.0f, -0.5f, 1.0f);
 
 in DATA
 {
 	vec3 position;
 	vec2 uv;
+	vec4 splat;
+	vec3 normal;
 } fs_in;
 
 
 void main()
 {
-	outColor = texture(tex, fs_in.uv);
+	vec4 weights = fs_in.splat / max(dot(fs_in.splat, vec4(1.0f)), 0.001f);
+
+	vec4 albedo = texture(layers[0], fs_in.uv) * weights.x
+		+ texture(layers[1], fs_in.uv) * weights.y
+		+ texture(layers[2], fs_in.uv) * weights.z
+		+ texture(layers[3], fs_in.uv) * weights.w;
+
+	float diffuse = max(dot(normalize(fs_in.normal), normalize(-lightDirection)), 0.0f);
+
+	outColor = vec4(albedo.rgb * (0.4f + 0.6f * diffuse), albedo.a);
 }
\ No newline at end of file
@@ -2,19 +2,40 @@
 
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 uv;
+layout (location = 2) in vec2 morph;
+layout (location = 3) in vec4 splat;
+layout (location = 4) in vec3 normal;
 
 uniform mat4 pr_matrix = mat4(1.0f);
 uniform mat4 vw_matrix = mat4(1.0f);
 
+uniform vec3 cameraPosition;
+uniform float lodLevel;
+uniform vec2 morphRange;
+
 out DATA
 {
 	vec3 position;
 	vec2 uv;
+	vec4 splat;
+	vec3 normal;
 } vs_out;
 
 void main()
 {
-	gl_Position =  pr_matrix * vw_matrix * vec4(position, 1.0f);
-	vs_out.position = vec3(vec4(position, 1.0f));
+	// Vertices that disappear at the next LOD slide towards the coarser surface before the switch.
+	float morphFactor = 0.0f;
+	if (abs(morph.y - lodLevel) < 0.5f)
+	{
+		float distanceToCamera = distance(position, cameraPosition);
+		morphFactor = clamp((distanceToCamera - morphRange.x) / (morphRange.y - morphRange.x), 0.0f, 1.0f);
+	}
+
+	vec3 morphedPosition = vec3(position.x, mix(position.y, morph.x, morphFactor), position.z);
+
+	gl_Position =  pr_matrix * vw_matrix * vec4(morphedPosition, 1.0f);
+	vs_out.position = morphedPosition;
 	vs_out.uv = uv;
+	vs_out.splat = splat;
+	vs_out.normal = normal;
 }
\ No newline at end of file
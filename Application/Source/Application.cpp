@@ -8,10 +8,10 @@ static void SetLightingParameters(ShaderProgram*const shaderScene);
 
 void Application::LoadAssets()
 {
-	//_fontManager->AddFont("font1", "Resources/Fonts/Assistant-Regular.ttf", 14);
-	_textureManager->AddTex2D("lm-test", "Resources/Textures/lm-test.png");
-	 _textureManager->AddTex2D("lm-test-sp", "Resources/Textures/lm-test-sp.png");
-	_textureManager->AddTex2D("terrain", "Resources/Textures/forrest-terrain.jpg");
+	_fontManager->AddFont("font1", "Resources/Fonts/Assistant-Regular.ttf", 32, FontRenderingDistanceField);
+	_textureManager->AddTex2DAsync("lm-test", "Resources/Textures/lm-test.png");
+	_textureManager->AddTex2DAsync("lm-test-sp", "Resources/Textures/lm-test-sp.png");
+	_textureManager->AddTex2DAsync("terrain", "Resources/Textures/forrest-terrain.jpg");
 
 	vector<string> sb_paths;
 	sb_paths.push_back("Resources/Textures/sb/sb_rt.png");
@@ -20,21 +20,36 @@ void Application::LoadAssets()
 	sb_paths.push_back("Resources/Textures/sb/sb_bt.png");
 	sb_paths.push_back("Resources/Textures/sb/sb_bk.png");
 	sb_paths.push_back("Resources/Textures/sb/sb_ft.png");
-	_textureManager->AddCubemap("skybox", sb_paths);
+	_textureManager->AddCubemapAsync("skybox", sb_paths);
+
+	_shaderManager->Add("terrain", "Resources/Shaders/terrain.vert", "Resources/Shaders/terrain.frag");
+	_shaderManager->Add("skybox", "Resources/Shaders/skybox.vert", "Resources/Shaders/skybox.frag");
+	_shaderManager->Add("scene", "Resources/Shaders/scene.vert", "Resources/Shaders/scene.frag");
+	_shaderManager->Add("hud", "Resources/Shaders/hud.vert", "Resources/Shaders/hud.frag");
+
+#ifdef _DEBUG
+	// Edited shaders and textures are picked up without restarting.
+	_shaderManager->EnableHotReload();
+	_textureManager->EnableHotReload();
+#endif
 }
 
 Application::Application()
 {
-	_shaderFactory = new ShaderFactory();
+	_shaderManager = new ShaderManager();
 	_textureManager = new TextureManager();
+	_textureManager->SetTex2DBudget(256 * 1024 * 1024);
+	_textureManager->SetCubemapBudget(64 * 1024 * 1024);
 	_renderable2DManager = new Renderable2DManager();
+	_fontManager = new FontManager();
 }
 
 Application::~Application()
 {
-	SafeDelete(_shaderFactory);
+	SafeDelete(_shaderManager);
 	SafeDelete(_textureManager);
 	SafeDelete(_renderable2DManager);
+	SafeDelete(_fontManager);
 }
 
 void Application::Initialize(const InitializationToolset& initToolset)
@@ -42,28 +57,46 @@ void Application::Initialize(const InitializationToolset& initToolset)
 	_graphicsObjFactorySet = initToolset.GraphicsObjFactorySet;
 
 	CreateGameWindow("sedge Application", 1280, 720, false, false);
+	SetThreadedSimulation(true);
+	// Without vsync frames are capped rather than rendered as fast as possible.
+	SetFrameRateLimit(240);
 
 	_inputManager = MainWindow->GetInputManager();
 
 	LoadAssets();
 
-	auto terrain = new Terrain(_textureManager->GetTex2D("terrain"));
-	auto terrainShader = _shaderFactory->CreateShaderProgram("terrain", "Resources/Shaders/terrain.vert", "Resources/Shaders/terrain.frag");
+	const char*const terrainPath = "Resources/terrain.tiles";
+	// Tiles are cooked on the first run or when the file format changed.
+	TerrainTileFile tileFile;
+	if (!FileUtils::CheckFileExists(terrainPath) || !tileFile.Open(terrainPath))
+	{
+		auto heightmap = Heightmap::CreateProcedural(1025, 1025, 20.0f, 1);
+		TerrainTileFile::Write(terrainPath, *heightmap, TerrainParameters());
+		SafeDelete(heightmap);
+	}
+
+	// The scene holds plain pointers, the references keep the textures from being evicted.
+	_terrainTexture = _textureManager->GetTex2DRef("terrain");
+	_skyboxTexture = _textureManager->GetCubemapRef("skybox");
 
-	auto skybox = new Skybox(_textureManager->GetCubemap("skybox"));
-	auto shaderSkybox = _shaderFactory->CreateShaderProgram("skybox", "Resources/Shaders/skybox.vert", "Resources/Shaders/skybox.frag");
+	auto terrain = new Terrain(_terrainTexture.Get(), terrainPath);
+	auto terrainShader = _shaderManager->GetShader(S3_NAME("terrain"));
+
+	auto skybox = new Skybox(_skyboxTexture.Get());
+	auto shaderSkybox = _shaderManager->GetShader(S3_NAME("skybox"));
 
 	auto camera = new FPSCamera();
-	camera->SetPosition(Vector3(0, 1, 0));
+	camera->SetPosition(Vector3(0, 25.0f, 0));
+	camera->SetFar(1000.0f);
 
-	//auto sponzaModel = _graphicsObjFactorySet.ModelFactory.CreateModel("Resources/Models/sponza/sponza.obj");
+	//auto sponzaModel = _graphicsObjFactorySet.ModelFactory.CreateModel("Resources/Models/sponza/sponza.obj", _textureManager);
 	//auto sponza = new Actor(sponzaModel);
 	//sponza->SetScale(Vector3(0.008f, 0.008f, 0.008f));
 
 	auto cubeMesh = new Cube(0xff00ff);
 	auto cube = new Actor(cubeMesh);
 
-	auto shaderScene = _shaderFactory->CreateShaderProgram("scene", "Resources/Shaders/scene.vert", "Resources/Shaders/scene.frag");
+	auto shaderScene = _shaderManager->GetShader(S3_NAME("scene"));
 	_mainScene = new Scene(camera, shaderScene);
 	_mainScene->SetTerrain(terrain, terrainShader);
 	_mainScene->SetSkybox(skybox, shaderSkybox);
@@ -71,17 +104,17 @@ void Application::Initialize(const InitializationToolset& initToolset)
 	_mainScene->AddEntity(cube);
 	SetLightingParameters(shaderScene);
 
-	//auto label = _graphicsObjFactorySet.LabelFactory.CreateLabel("startup...", _fontManager->GetFont("font1"), Vector2(0.1f, 8.7f), 0, Size2D(2, 2));
-	//auto label2 = _graphicsObjFactorySet.LabelFactory.CreateLabel("p:", _fontManager->GetFont("font1"), Vector2(0.1f, 8.4f), 0, Size2D(2, 2));
+	auto label = SpriteFactory::CreateLabel("startup...", _fontManager->GetFont("font1"), Vector2(0.1f, 8.9f), 0, 0.3f);
+	auto label2 = SpriteFactory::CreateLabel("p:", _fontManager->GetFont("font1"), Vector2(0.1f, 8.6f), 0, 0.3f);
 
-	//_renderable2DManager->AddLabel("fps", label);
-	//_renderable2DManager->AddLabel("position", label2);
+	_fpsLabel = _renderable2DManager->AddLabel("fps", label);
+	_positionLabel = _renderable2DManager->AddLabel("position", label2);
 
-	auto shaderHud = _shaderFactory->CreateShaderProgram("hud", "Resources/Shaders/hud.vert", "Resources/Shaders/hud.frag");
+	auto shaderHud = _shaderManager->GetShader(S3_NAME("hud"));
 	shaderHud->SetProjection(Matrix4::GetOrthographic(0.0f, 16.0f, 0.0f, 9.0f, -1.0f, 1.0f));
 	_hudLayer = new Layer2D(shaderHud);
-	//_hudLayer->Add(label);
-	//_hudLayer->Add(label2);
+	_hudLayer->Add(label);
+	_hudLayer->Add(label2);
 }
 
 void Application::UpdateLogic()
@@ -90,18 +123,28 @@ void Application::UpdateLogic()
 	UpdateCamera(*camera, *_inputManager);
 
 	_mainScene->Update();
+}
 
-	const Vector3& cameraPosition = camera->GetPosition();
-	//_renderable2DManager->GetLabel("fps")->SetText(std::to_string(GetFPS()) + " fps");
-	//auto posX = std::to_string(cameraPosition.x);
-	//auto posY = std::to_string(cameraPosition.y);
-	//auto posZ = std::to_string(cameraPosition.z);
-	//_renderable2DManager->GetLabel("position")->SetText(posX + " " + posY + " " + posZ);
+void Application::CaptureFrame(FrameSnapshot& frame)
+{
+	_mainScene->Capture(frame);
 }
 
-void Application::Render()
+void Application::Render(const float alpha)
 {
-	_mainScene->Draw();
+	const FrameSnapshot& frame = GetRenderFrame();
+
+	// Laying out text may rasterize glyphs, so the labels are updated here rather than with the logic.
+	const Vector3& cameraPosition = frame.View.GetPosition();
+	_renderable2DManager->GetLabel(_fpsLabel)->SetText(std::to_string(GetFPS()) + " fps");
+	auto posX = std::to_string(cameraPosition.x);
+	auto posY = std::to_string(cameraPosition.y);
+	auto posZ = std::to_string(cameraPosition.z);
+	_renderable2DManager->GetLabel(_positionLabel)->SetText(posX + " " + posY + " " + posZ);
+
+	_shaderManager->Update();
+	_textureManager->Update();
+	_mainScene->Draw(frame, alpha);
 
 	GraphicsAPI::DisableDepthTesting();
 	_hudLayer->Draw();
@@ -112,6 +155,10 @@ void Application::Dispose()
 {
 	SafeDelete(_mainScene);
 	SafeDelete(_hudLayer);
+
+	_terrainTexture.Reset();
+	_skyboxTexture.Reset();
+	AssetRegistryBase::LogResidency();
 }
 
 float horizontalAngle = 0;
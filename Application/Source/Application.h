@@ -7,10 +7,15 @@ class Application : public sedge::Engine
 private:
 	sedge::Scene* _mainScene;
 	sedge::Layer2D* _hudLayer;
-	sedge::ShaderFactory* _shaderFactory;
+	sedge::ShaderManager* _shaderManager;
 	sedge::TextureManager* _textureManager;
+	sedge::Texture2DRef _terrainTexture;
+	sedge::CubemapRef _skyboxTexture;
 	sedge::Renderable2DManager* _renderable2DManager;
+	sedge::FontManager* _fontManager;
 	sedge::Renderable3DManager* _renderable3DManager;
+	sedge::LabelHandle _fpsLabel;
+	sedge::LabelHandle _positionLabel;
 	sedge::GraphicsObjectFactorySet _graphicsObjFactorySet;
 	sedge::InputManager* _inputManager;
 
@@ -21,7 +26,8 @@ public:
 public:
 	void Initialize(const sedge::InitializationToolset& initToolset) override;
 	void UpdateLogic() override;
-	void Render() override;
+	void CaptureFrame(sedge::FrameSnapshot& frame) override;
+	void Render(const float alpha) override;
 	void Dispose() override;
 
 private:
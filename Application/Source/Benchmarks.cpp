@@ -0,0 +1,239 @@
+#include "Benchmarks.h"
+#include <Engine.h>
+#include <thread>
+#include <fstream>
+
+using namespace std;
+using namespace sedge;
+
+static float MeasureTerrainGeneration(const Heightmap& heightmap, const TerrainParameters& parameters, ThreadPool& pool);
+static bool WriteBenchmarkModel(const char*const path);
+static bool RunMeshFileBenchmark(const char*const modelPath);
+
+int RunTerrainBenchmark()
+{
+	TerrainParameters parameters;
+	parameters.ChunkCount = 32;
+
+	const uint mapSize = parameters.ChunkCount * parameters.ChunkSize + 1;
+	auto heightmap = Heightmap::CreateProcedural(mapSize, mapSize, 20.0f, 1);
+
+	const uint maxThreads = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+	float singleThreadTime = 0.0f;
+
+	LOG_INFO("Terrain generation benchmark: ", mapSize, "x", mapSize, " samples, ", parameters.ChunkCount * parameters.ChunkCount, " chunks");
+
+	for (uint threads = 1; threads <= maxThreads; threads = (threads * 2 > maxThreads && threads < maxThreads) ? maxThreads : threads * 2)
+	{
+		// The calling thread works as well, so the pool needs one worker less.
+		ThreadPool pool(threads - 1);
+		const float time = MeasureTerrainGeneration(*heightmap, parameters, pool);
+
+		if (threads == 1)
+			singleThreadTime = time;
+
+		LOG_INFO(threads, " threads: ", time, " ms, speedup ", singleThreadTime / time);
+	}
+
+	SafeDelete(heightmap);
+
+	return 0;
+}
+
+int RunModelImportBenchmark(const char*const path)
+{
+	const char*const generatedPath = "Resources/benchmark.obj";
+	const char*const modelPath = path != nullptr ? path : generatedPath;
+
+	if (path == nullptr && !FileUtils::CheckFileExists(generatedPath) && !WriteBenchmarkModel(generatedPath))
+	{
+		LOG_ERROR("Failed to write \"", generatedPath, "\"");
+		return 1;
+	}
+
+	const uint maxThreads = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+	const int repetitions = 3;
+	float singleThreadTime = 0.0f;
+
+	LOG_INFO("Model import benchmark: ", modelPath);
+
+	for (uint threads = 1; threads <= maxThreads; threads = (threads * 2 > maxThreads && threads < maxThreads) ? maxThreads : threads * 2)
+	{
+		ThreadPool pool(threads - 1);
+		ModelData model;
+		float bestTime = 0.0f;
+		Stopwatch stopwatch;
+
+		for (int i = 0; i < repetitions; i++)
+		{
+			stopwatch.Start();
+			const bool loaded = ObjLoader::Load(modelPath, model, pool);
+			stopwatch.Stop();
+
+			if (!loaded)
+				return 1;
+
+			const float time = stopwatch.ElapsedMS();
+			bestTime = (i == 0 || time < bestTime) ? time : bestTime;
+		}
+
+		if (threads == 1)
+		{
+			uint vertices = 0;
+			uint indices = 0;
+			for (const MeshData& mesh : model.Meshes)
+			{
+				vertices += mesh.Vertices.size();
+				indices += mesh.Indices.size();
+			}
+
+			LOG_INFO((uint)model.Meshes.size(), " meshes, ", vertices, " vertices, ", indices / 3, " triangles");
+			singleThreadTime = bestTime;
+		}
+
+		LOG_INFO(threads, " threads: ", bestTime, " ms, speedup ", singleThreadTime / bestTime);
+	}
+
+	return RunMeshFileBenchmark(modelPath) ? 0 : 1;
+}
+
+// Cooks the model like the ModelFactory does. Loading the result only maps the file,
+// reading the blobs stands in for the upload.
+bool RunMeshFileBenchmark(const char*const modelPath)
+{
+	const string meshPath = MeshFile::GetCachePath(modelPath);
+	ModelData model;
+	Stopwatch stopwatch;
+
+	if (!ObjLoader::Load(modelPath, model))
+		return false;
+
+	stopwatch.Start();
+	MeshSimplifier::GenerateLods(model);
+	stopwatch.Stop();
+
+	LOG_INFO("Level of detail generation: ", stopwatch.ElapsedMS(), " ms");
+
+	stopwatch.Start();
+	MeshOptimizer::Optimize(model);
+	stopwatch.Stop();
+
+	LOG_INFO("Mesh optimization: ", stopwatch.ElapsedMS(), " ms");
+
+	if (!MeshFile::Write(meshPath.c_str(), TextureCache::HashFile(modelPath), model))
+	{
+		LOG_ERROR("Failed to cook \"", meshPath, "\"");
+		return false;
+	}
+
+	const int repetitions = 3;
+	float bestTime = 0.0f;
+	unsigned long long bytes = 0;
+
+	for (int i = 0; i < repetitions; i++)
+	{
+		stopwatch.Start();
+
+		MeshFile file;
+		if (!file.Open(meshPath.c_str()))
+			return false;
+
+		uint checksum = 0;
+		bytes = 0;
+		for (uint j = 0; j < file.GetSubmeshCount(); j++)
+		{
+			const Submesh submesh = file.GetSubmesh(j);
+			const uint* words = (const uint*)submesh.Vertices;
+			for (uint k = 0; k < submesh.VertexCount * sizeof(VertexData) / sizeof(uint); k++)
+				checksum += words[k];
+			const uint indexSize = submesh.IndexType == UnsginedShort ? sizeof(ushort) : sizeof(uint);
+			const byte* indexBytes = (const byte*)submesh.Indices;
+			for (uint k = 0; k < submesh.IndexCount * indexSize; k++)
+				checksum += indexBytes[k];
+
+			bytes += submesh.VertexCount * sizeof(VertexData) + submesh.IndexCount * indexSize;
+		}
+
+		stopwatch.Stop();
+
+		const float time = stopwatch.ElapsedMS();
+		bestTime = (i == 0 || time < bestTime) ? time : bestTime;
+
+		if (checksum == 0)
+			LOG_WARNING("Mesh file \"", meshPath, "\" holds no data");
+	}
+
+	LOG_INFO("Mesh file: ", bestTime, " ms for ", (uint)(bytes / 1024), " KB");
+
+	return true;
+}
+
+// A displaced grid split into material bands, written the way common exporters do:
+// quads with position, UV and normal indices, about as many triangles as Sponza.
+bool WriteBenchmarkModel(const char*const path)
+{
+	const int size = 360;
+	const int materialCount = 24;
+
+	ofstream stream(path);
+	if (!stream)
+		return false;
+
+	for (int y = 0; y <= size; y++)
+	{
+		for (int x = 0; x <= size; x++)
+		{
+			const float height = sinf(x * 0.1f) * cosf(y * 0.07f) * 4.0f;
+			stream << "v " << x * 0.5f << " " << height << " " << y * 0.5f << "\n";
+			stream << "vt " << (float)x / size << " " << (float)y / size << "\n";
+			stream << "vn " << 0.0f << " " << 1.0f << " " << 0.0f << "\n";
+		}
+	}
+
+	const int rowsPerMaterial = size / materialCount;
+	for (int y = 0; y < size; y++)
+	{
+		if (y % rowsPerMaterial == 0)
+			stream << "usemtl material" << y / rowsPerMaterial << "\n";
+
+		for (int x = 0; x < size; x++)
+		{
+			const int corners[4] = { y * (size + 1) + x + 1, y * (size + 1) + x + 2, (y + 1) * (size + 1) + x + 2, (y + 1) * (size + 1) + x + 1 };
+
+			stream << "f";
+			for (int corner : corners)
+				stream << " " << corner << "/" << corner << "/" << corner;
+			stream << "\n";
+		}
+	}
+
+	return !stream.fail();
+}
+
+// Returns the best of several runs in milliseconds.
+float MeasureTerrainGeneration(const Heightmap& heightmap, const TerrainParameters& parameters, ThreadPool& pool)
+{
+	const int repetitions = 5;
+
+	vector<VertexDataTerrain> vertices;
+	vector<BoundingBox> chunkBounds;
+	vector<float> levelErrors;
+
+	// Warm-up run, also allocates the output buffers.
+	Terrain::GenerateVertices(heightmap, parameters, pool, vertices, chunkBounds, levelErrors);
+
+	float bestTime = 0.0f;
+	Stopwatch stopwatch;
+
+	for (int i = 0; i < repetitions; i++)
+	{
+		stopwatch.Start();
+		Terrain::GenerateVertices(heightmap, parameters, pool, vertices, chunkBounds, levelErrors);
+		stopwatch.Stop();
+
+		const float time = stopwatch.ElapsedMS();
+		bestTime = (i == 0 || time < bestTime) ? time : bestTime;
+	}
+
+	return bestTime;
+}
\ No newline at end of file
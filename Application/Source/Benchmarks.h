@@ -0,0 +1,7 @@
+#pragma once
+
+// Benchmarks run without a window or a graphics context and return the process exit code.
+int RunTerrainBenchmark();
+// Imports the given OBJ file, or a generated one of about the size of Sponza if there is none,
+// then cooks it and measures loading the mesh file.
+int RunModelImportBenchmark(const char*const path);
\ No newline at end of file
@@ -1,7 +1,26 @@
 #include "Application.h"
+#include "Benchmarks.h"
+#include <cstring>
 
-int main()
+int main(int argc, char* argv[])
 {
+	if (argc > 1 && strcmp(argv[1], "--bench-terrain") == 0)
+		return RunTerrainBenchmark();
+
+	if (argc > 1 && strcmp(argv[1], "--bench-obj") == 0)
+		return RunModelImportBenchmark(argc > 2 ? argv[2] : nullptr);
+
+	// --pack <directory> <archive> builds a pack file, e.g. --pack Resources Resources.spak
+	if (argc > 3 && strcmp(argv[1], "--pack") == 0)
+		return sedge::PackFile::Write(argv[3], argv[2], sedge::PackCompressionLZ4) ? 0 : 1;
+
+#ifndef _DEBUG
+	// Shipped builds read their assets from the archive, files it does not contain are still read from disk.
+	// Debug builds leave it alone, an archive packed earlier would hide every file edited since.
+	if (sedge::FileUtils::CheckFileExists("Resources.spak"))
+		sedge::FileSystem::Mount("Resources", "Resources.spak");
+#endif
+
 	Application app;
 	app.Run();
 
@@ -25,16 +25,31 @@ This file is included by the main header sedge.h
 
 #include "Graphics/Shaders/ShaderProgram.h"
 #include "Graphics/Shaders/ShaderFactory.h"
+#include "Graphics/Shaders/ShaderPreprocessor.h"
+#include "Graphics/Shaders/ShaderCache.h"
 #include "Graphics/Renderables/Sprite.h"
+#include "Graphics/Renderables/Label.h"
 #include "Graphics/Renderables/Mesh.h"
 #include "Graphics/Renderables/Model.h"
 #include "Graphics/Renderables/Skybox.h"
 #include "Graphics/Renderables/SpriteFactory.h"
 #include "Graphics/Renderables/MeshFactory.h"
+#include "Graphics/Renderables/ModelFactory.h"
+#include "Graphics/Renderables/ModelData.h"
+#include "Graphics/Renderables/ObjLoader.h"
+#include "Graphics/Renderables/MeshFile.h"
+#include "Graphics/Renderables/MeshOptimizer.h"
+#include "Graphics/Renderables/MeshSimplifier.h"
 #include "Graphics/Terrain/Terrain.h"
+#include "Graphics/Terrain/Heightmap.h"
+#include "Graphics/Terrain/TerrainTileFile.h"
 #include "Graphics/Renderables/Primitives/Cube.h"
 
 #include "Graphics/AssetManagers/TextureManager.h"
+#include "Graphics/Textures/TextureAtlas.h"
+#include "Graphics/Textures/TextureCache.h"
+#include "Graphics/Text/Font.h"
+#include "Graphics/AssetManagers/FontManager.h"
 #include "Graphics/AssetManagers/Renderable2DManager.h"
 #include "Graphics/AssetManagers/Renderable3DManager.h"
 #include "Graphics/AssetManagers/ShaderManager.h"
@@ -45,6 +60,7 @@ This file is included by the main header sedge.h
 
 #include "Logic/Objects/Actor.h"
 #include "Logic/Objects/Scene.h"
+#include "Logic/Objects/FrameSnapshot.h"
 #include "Logic/Objects/Entity.h"
 #include "Logic/Cameras/FPSCamera.h"
 #include "Logic/Cameras/TPSCamera.h"
@@ -52,8 +68,16 @@ This file is included by the main header sedge.h
 #include "System/InputManager.h"
 #include "System/MemoryManagement.h"
 #include "System/Stopwatch.h"
+#include "System/FrameLimiter.h"
+#include "System/FrameStatistics.h"
 #include "System/RNG.h"
 #include "System/Logger.h"
 #include "System/DateTime.h"
+#include "System/FileUtils.h"
+#include "System/ThreadPool.h"
+#include "System/FileWatcher.h"
+#include "System/FileSystem.h"
+#include "System/PackFile.h"
+#include "System/AsyncFileReader.h"
 
 #include "Graphics/Renderables/GraphicsObjectFactorySet.h"
\ No newline at end of file
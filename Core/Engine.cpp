@@ -11,8 +11,12 @@ Implementation of the top level engine functions.
 
 using namespace sedge;
 
+static float GetMilliseconds(const long long nanoseconds);
+
 Engine::Engine()
+	: _fps(0), _simulatedTime(0), _maxUpdatesPerFrame(5), _renderFrame(0), _threadedSimulation(false), _frameReady(false), _simulating(false)
 {
+	SetUpdateRate(60);
 	_runTimer = new Stopwatch();
 	Window::InitializeLibrary();
 }
@@ -50,41 +54,169 @@ void Engine::Run()
 	LOG_INFO("Application exited...");
 }
 
+void Engine::SetUpdateRate(const uint updatesPerSecond)
+{
+	_updateInterval = 1000000000LL / (updatesPerSecond > 0 ? updatesPerSecond : 1);
+}
+
 void Engine::RunMainLoop()
 {
-	uint updates = 0;
-	float updateTime = 0.0f;
 	uint frames = 0;
-	float renderTime = 0.0f;
+	long long frameCountStart = 0;
+	long long frameStart = 0;
+	// One update is due right away, so the first frame has something to draw.
+	_simulatedTime = -_updateInterval;
+	_renderFrame = 0;
 	_runTimer->Start();
 
+	if (_threadedSimulation)
+	{
+		LOG_INFO("Running the simulation on a thread of its own...");
+		_simulating = true;
+		_simulationThread = std::thread(&Engine::RunSimulationThread, this);
+	}
+
 	// The actual game loop.
 	while (MainWindow != nullptr && !MainWindow->IsClosed())
 	{
-		MainWindow->Clear();
+		FrameTiming timing;
+		float alpha = 0.0f;
 
-		// Update input and managers.
-		if (_runTimer->ElapsedS() - updateTime > (1.0f / 60.0f))
+		if (_threadedSimulation)
+			alpha = TakeSimulatedFrame(timing);
+		else
 		{
-			UpdateLogic();
-			MainWindow->UpdateContextState();
-
-			++updates;
-			updateTime += 1.0f / 60.0f;
+			const long long updateStart = _runTimer->ElapsedNanoseconds();
+			timing.Updates = UpdateSimulation(alpha);
+			timing.Times[FrameStageUpdate] = GetMilliseconds(_runTimer->ElapsedNanoseconds() - updateStart);
 		}
 
-		Render();
-		MainWindow->UpdateWindowState();
+		const long long renderStart = _runTimer->ElapsedNanoseconds();
+
+		MainWindow->Clear();
+
+		// Run what jobs handed over for the graphics context.
+		ThreadPool::GetShared().RunMainThreadJobs();
+
+		Render(alpha);
+
+		const long long presentStart = _runTimer->ElapsedNanoseconds();
+
+		if (_threadedSimulation)
+			MainWindow->Present();
+		else
+			MainWindow->UpdateWindowState();
+
+		const long long presentEnd = _runTimer->ElapsedNanoseconds();
+
+		_frameLimiter.Wait();
+
+		const long long frameEnd = _runTimer->ElapsedNanoseconds();
+		timing.Times[FrameStageRender] = GetMilliseconds(presentStart - renderStart);
+		timing.Times[FrameStagePresent] = GetMilliseconds(presentEnd - presentStart);
+		timing.Times[FrameStageFrame] = GetMilliseconds(frameEnd - frameStart);
+		frameStart = frameEnd;
+
+		_frameStatistics.Record(timing);
 
 		frames++;
 
 		// Update service information.
-		if (_runTimer->ElapsedS() - renderTime > 1.0f)
+		if (_runTimer->ElapsedNanoseconds() - frameCountStart >= 1000000000LL)
 		{
-			renderTime += 1.0f;
+			frameCountStart += 1000000000LL;
 			_fps = frames;
 			frames = 0;
-			updates = 0;
 		}
 	}
+
+	if (_threadedSimulation)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_frameMutex);
+			_simulating = false;
+		}
+
+		_frameCondition.notify_all();
+		_simulationThread.join();
+	}
+
+	_frameStatistics.LogSummary();
+}
+
+uint Engine::UpdateSimulation(float& alpha)
+{
+	const long long now = _runTimer->ElapsedNanoseconds();
+	uint updates = 0;
+
+	while (now - _simulatedTime >= _updateInterval)
+	{
+		if (updates == _maxUpdatesPerFrame)
+		{
+			// Drop the whole updates that are left and keep the fraction, so alpha stays meaningful.
+			_simulatedTime += (now - _simulatedTime) / _updateInterval * _updateInterval;
+			break;
+		}
+
+		UpdateLogic();
+		// Clicks and the like are reported to the first update after they happened.
+		MainWindow->UpdateContextState();
+		CaptureFrame(_simulatedFrame);
+
+		_simulatedTime += _updateInterval;
+		updates++;
+	}
+
+	alpha = (float)(now - _simulatedTime) / _updateInterval;
+
+	return updates;
+}
+
+void Engine::RunSimulationThread()
+{
+	while (true)
+	{
+		const long long updateStart = _runTimer->ElapsedNanoseconds();
+
+		float alpha;
+		const uint updates = UpdateSimulation(alpha);
+
+		// The render thread only swaps the snapshots while this thread waits below, so the index is stable here.
+		_frames[1 - _renderFrame] = _simulatedFrame;
+		_frameAlphas[1 - _renderFrame] = alpha;
+		_frameTimings[1 - _renderFrame].Updates = updates;
+		_frameTimings[1 - _renderFrame].Times[FrameStageUpdate] = GetMilliseconds(_runTimer->ElapsedNanoseconds() - updateStart);
+
+		std::unique_lock<std::mutex> lock(_frameMutex);
+		_frameReady = true;
+		_frameCondition.notify_all();
+
+		// Getting at most one frame ahead of rendering bounds the latency.
+		_frameCondition.wait(lock, [this] { return !_frameReady || !_simulating; });
+		if (!_simulating)
+			return;
+	}
+}
+
+float Engine::TakeSimulatedFrame(FrameTiming& timing)
+{
+	std::unique_lock<std::mutex> lock(_frameMutex);
+	_frameCondition.wait(lock, [this] { return _frameReady; });
+
+	// The simulation thread is parked until the frame is taken, so events cannot change the input while an update reads it.
+	MainWindow->PollEvents();
+
+	_renderFrame = 1 - _renderFrame;
+	_frameReady = false;
+	_frameCondition.notify_all();
+
+	timing.Updates = _frameTimings[_renderFrame].Updates;
+	timing.Times[FrameStageUpdate] = _frameTimings[_renderFrame].Times[FrameStageUpdate];
+
+	return _frameAlphas[_renderFrame];
+}
+
+float GetMilliseconds(const long long nanoseconds)
+{
+	return nanoseconds / 1.0e6f;
 }
\ No newline at end of file
@@ -9,6 +9,10 @@ The sedgengine class must be inherited in order to build applications using the
 
 #pragma once
 
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "Common.h"
 
 namespace sedge
@@ -24,14 +28,36 @@ namespace sedge
 		Window* MainWindow;
 
 	private:
-		uint _fps;
+		std::atomic<uint> _fps;
 		Stopwatch* _runTimer;
+		// In nanoseconds of run time.
+		long long _simulatedTime; // how far the updates have advanced the simulation
+		long long _updateInterval;
+		uint _maxUpdatesPerFrame;
+		FrameLimiter _frameLimiter;
+		FrameStatistics _frameStatistics;
 
 		InitializationToolset _initToolset;
 
+		// Captured after every update, by the thread that runs them.
+		FrameSnapshot _simulatedFrame;
+		// With a simulation thread, Render reads a copy of one frame while the next is captured.
+		FrameSnapshot _frames[2];
+		float _frameAlphas[2];
+		FrameTiming _frameTimings[2]; // the update times, measured on the simulation thread
+		uint _renderFrame;
+		bool _threadedSimulation;
+		std::thread _simulationThread;
+		std::mutex _frameMutex;
+		std::condition_variable _frameCondition;
+		bool _frameReady; // captured and not yet taken by the render thread
+		bool _simulating;
+
 	public:
 		void Run();
 		inline uint GetFPS() const { return _fps; }
+		// Times of every frame, split into update, render and present. Logged when the main loop ends.
+		inline FrameStatistics& GetFrameStatistics() { return _frameStatistics; }
 
 	protected:
 		Engine();
@@ -39,10 +65,39 @@ namespace sedge
 
 		void CreateGameWindow(const char* name, uint width, uint height, bool fullscreen = false, bool vsync = true);
 
+		// Runs UpdateLogic and CaptureFrame on a thread of their own, overlapping with Render of the previous frame.
+		// Logic then must not touch the graphics API and Render must take everything it shows from the snapshot.
+		// Set it in Initialize.
+		inline void SetThreadedSimulation(const bool threaded) { _threadedSimulation = threaded; }
+		inline bool IsThreadedSimulation() const { return _threadedSimulation; }
+
+		// The snapshot captured for the frame being rendered, only valid during Render.
+		inline const FrameSnapshot& GetRenderFrame() const { return _threadedSimulation ? _frames[_renderFrame] : _simulatedFrame; }
+
+		// UpdateLogic runs at this fixed rate, 60 by default, however fast frames are rendered.
+		void SetUpdateRate(const uint updatesPerSecond);
+		inline float GetUpdateInterval() const { return _updateInterval / 1.0e9f; }
+		// A frame runs at most this many updates to catch up, 5 by default. Beyond that the simulation
+		// falls behind real time rather than every frame taking longer than the last.
+		inline void SetMaxUpdatesPerFrame(const uint updates) { _maxUpdatesPerFrame = updates > 0 ? updates : 1; }
+		// Caps the frame rate, e.g. without vsync. 0, the default, renders as fast as possible.
+		inline void SetFrameRateLimit(const uint framesPerSecond) { _frameLimiter.SetFrameRate(framesPerSecond); }
+
 		virtual void Initialize(const InitializationToolset& initToolset) = 0; // Runs upon startup.
 		virtual void RunMainLoop(); // Contains main game logic.
 		virtual void Dispose() = 0; // Runs upon closing the main window.
 		virtual void UpdateLogic() {}
-		virtual void Render() {}
+		// Runs after every update, on the same thread.
+		virtual void CaptureFrame(FrameSnapshot& frame) {}
+		// Alpha is how far the frame lies from the last update towards the next one, in [0, 1), for
+		// interpolating between the last two updates of the snapshot.
+		virtual void Render(const float alpha) {}
+
+	private:
+		// Runs the updates that are due and returns how many.
+		uint UpdateSimulation(float& alpha);
+		void RunSimulationThread();
+		// Waits for the next captured frame, swaps it in for rendering and returns its alpha and update times.
+		float TakeSimulatedFrame(FrameTiming& timing);
 	};
 }
\ No newline at end of file
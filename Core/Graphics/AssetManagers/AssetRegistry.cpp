@@ -0,0 +1,54 @@
+/*
+===========================================================================
+AssetRegistry.cpp
+
+Implements the AssetRegistryBase class.
+===========================================================================
+*/
+
+#include "AssetRegistry.h"
+#include <algorithm>
+
+using namespace sedge;
+
+AssetRegistryBase::AssetRegistryBase(const char*const typeName)
+	: TypeName(typeName)
+{
+	GetRegistries().push_back(this);
+}
+
+AssetRegistryBase::~AssetRegistryBase()
+{
+	std::vector<AssetRegistryBase*>& registries = GetRegistries();
+	registries.erase(std::remove(registries.begin(), registries.end(), this), registries.end());
+}
+
+void AssetRegistryBase::GetAllResidency(std::vector<AssetResidency>& residency)
+{
+	residency.clear();
+	for (const AssetRegistryBase* registry : GetRegistries())
+		residency.push_back(registry->GetResidency());
+}
+
+void AssetRegistryBase::LogResidency()
+{
+	std::vector<AssetResidency> residency;
+	GetAllResidency(residency);
+
+	for (const AssetResidency& entry : residency)
+	{
+		const uint residentKB = (uint)(entry.ResidentBytes / 1024);
+		const uint budgetKB = (uint)(entry.Budget / 1024);
+
+		LOG_INFO(entry.TypeName, ": ", entry.Count, " assets, ", entry.Referenced, " referenced, ",
+			residentKB, " KB resident of ", budgetKB, " KB budget, ", entry.Evictions, " evicted");
+	}
+}
+
+// Registries are created and destroyed on the main thread only.
+std::vector<AssetRegistryBase*>& AssetRegistryBase::GetRegistries()
+{
+	static std::vector<AssetRegistryBase*> registries;
+
+	return registries;
+}
\ No newline at end of file
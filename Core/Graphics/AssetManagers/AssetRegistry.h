@@ -0,0 +1,380 @@
+/*
+===========================================================================
+AssetRegistry.h
+
+The storage shared by all asset managers. Assets live in a dense slot
+table and are referred to by handles, an index plus the generation of
+the slot, so resolving a handle is a single array access and handles to
+removed assets are detected instead of dangling. Names are interned into
+NameIDs and mapped to slots once, when an asset is added or looked up.
+
+The registry owns its assets and deletes them when they are replaced,
+removed or when it is destroyed. Users that need an asset to stay alive
+hold an AssetRef, a reference-counted handle, and referenced assets are
+never replaced. Registries that know the
+memory size of their assets can be given a budget: while it is exceeded,
+the unreferenced assets that were released the longest time ago are
+evicted, and plain handles to them resolve to nullptr afterwards.
+===========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <CustomTypes.h>
+#include "System/NameID.h"
+#include "System/Logger.h"
+#include "System/MemoryManagement.h"
+
+namespace sedge
+{
+	template<typename T>
+	struct AssetHandle
+	{
+		uint Index;
+		uint Generation; // 0 never belongs to a live asset
+
+		AssetHandle() : Index(0), Generation(0) { }
+		AssetHandle(const uint index, const uint generation) : Index(index), Generation(generation) { }
+
+		inline bool IsValid() const { return Generation != 0; }
+		inline bool operator == (const AssetHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+		inline bool operator != (const AssetHandle& other) const { return !(*this == other); }
+	};
+
+	struct AssetResidency
+	{
+		const char* TypeName;
+		uint Count;
+		uint Referenced;
+		unsigned long long ResidentBytes;
+		unsigned long long Budget; // 0 if unlimited
+		uint Evictions;
+	};
+
+	// Lets the residency of every registry be reported without knowing the asset types.
+	class AssetRegistryBase
+	{
+	protected:
+		const char* TypeName;
+
+	public:
+		// Collects the residency of all registries that currently exist.
+		static void GetAllResidency(std::vector<AssetResidency>& residency);
+		static void LogResidency();
+
+		virtual AssetResidency GetResidency() const = 0;
+
+	protected:
+		AssetRegistryBase(const char*const typeName);
+		virtual ~AssetRegistryBase();
+
+	private:
+		static std::vector<AssetRegistryBase*>& GetRegistries();
+
+		AssetRegistryBase(const AssetRegistryBase& tRef) = delete;
+		AssetRegistryBase& operator = (const AssetRegistryBase& tRef) = delete;
+	};
+
+	template<typename T>
+	class AssetRegistry;
+
+	// Keeps an asset from being evicted for as long as any copy of it exists.
+	// References must be released before the registry they point into is destroyed.
+	template<typename T>
+	class AssetRef
+	{
+	private:
+		AssetRegistry<T>* _registry;
+		AssetHandle<T> _handle;
+
+	public:
+		AssetRef() : _registry(nullptr) { }
+		AssetRef(AssetRegistry<T>*const registry, const AssetHandle<T> handle)
+			: _registry(registry), _handle(handle)
+		{
+			if (_registry != nullptr)
+				_registry->Acquire(_handle);
+		}
+
+		AssetRef(const AssetRef& other) : AssetRef(other._registry, other._handle) { }
+		~AssetRef() { Reset(); }
+
+		AssetRef& operator = (const AssetRef& other)
+		{
+			if (this != &other)
+			{
+				if (other._registry != nullptr)
+					other._registry->Acquire(other._handle);
+
+				Reset();
+				_registry = other._registry;
+				_handle = other._handle;
+			}
+
+			return *this;
+		}
+
+		void Reset()
+		{
+			if (_registry != nullptr)
+				_registry->Release(_handle);
+
+			_registry = nullptr;
+			_handle = AssetHandle<T>();
+		}
+
+		inline T*const Get() const { return _registry != nullptr ? _registry->Get(_handle) : nullptr; }
+		inline T*const operator -> () const { return Get(); }
+		inline AssetHandle<T> GetHandle() const { return _handle; }
+		inline bool IsValid() const { return Get() != nullptr; }
+	};
+
+	template<typename T>
+	class AssetRegistry : public AssetRegistryBase
+	{
+	public:
+		typedef std::function<unsigned long long(const T*const)> SizeFunction;
+
+	private:
+		struct Slot
+		{
+			T* Asset;
+			uint Generation;
+			NameID Name;
+			uint References;
+			unsigned long long LastUse;
+		};
+
+		std::vector<Slot> _slots;
+		std::vector<uint> _freeSlots;
+		std::unordered_map<NameID, uint> _slotsByName;
+		std::unordered_map<NameID, std::string> _names; // only used to report hash collisions
+		SizeFunction _sizeOf;
+		unsigned long long _budget;
+		unsigned long long _useCounter;
+		uint _evictions;
+
+	public:
+		// The type name is used in log messages and residency reports. Without a size function
+		// the assets count as taking no memory and are never evicted.
+		AssetRegistry(const char*const typeName, const SizeFunction& sizeOf = nullptr)
+			: AssetRegistryBase(typeName), _sizeOf(sizeOf), _budget(0), _useCounter(0), _evictions(0) { }
+		~AssetRegistry() { Clear(); }
+
+		// Takes ownership of the asset. If the name is taken and overwrite is not set, or the asset it
+		// would replace is still referenced, the asset is deleted right away and an invalid handle is returned.
+		AssetHandle<T> Add(const char*const name, T* asset, const bool overwrite = false)
+		{
+			const NameID id = HashName(name);
+
+			auto it = _names.find(id);
+			if (it != _names.end() && it->second != name)
+			{
+				LOG_ERROR(TypeName, " name \"", name, "\" collides with \"", it->second, "\"");
+				SafeDelete(asset);
+				return AssetHandle<T>();
+			}
+
+			const AssetHandle<T> existing = Find(id);
+			if (existing.IsValid())
+			{
+				if (!overwrite)
+				{
+					LOG_WARNING(TypeName, " \"", name, "\" already exists and will not be overwritten");
+					SafeDelete(asset);
+					return AssetHandle<T>();
+				}
+
+				// Referenced assets may be in use through a pointer, e.g. by a pending load, deleting them is not safe.
+				if (_slots[existing.Index].References > 0)
+				{
+					LOG_ERROR(TypeName, " \"", name, "\" is still referenced and cannot be replaced");
+					SafeDelete(asset);
+					return AssetHandle<T>();
+				}
+
+				Remove(existing);
+			}
+
+			uint index = 0;
+			if (_freeSlots.empty())
+			{
+				index = _slots.size();
+				Slot slot = { nullptr, 0, 0, 0, 0 };
+				_slots.push_back(slot);
+			}
+			else
+			{
+				index = _freeSlots.back();
+				_freeSlots.pop_back();
+			}
+
+			Slot& slot = _slots[index];
+			slot.Asset = asset;
+			slot.Generation++;
+			slot.Name = id;
+			slot.References = 0;
+			slot.LastUse = ++_useCounter;
+
+			_slotsByName[id] = index;
+			_names[id] = name;
+
+			return AssetHandle<T>(index, slot.Generation);
+		}
+
+		// References to the asset resolve to nullptr afterwards.
+		void Remove(const AssetHandle<T> handle)
+		{
+			if (Get(handle) == nullptr)
+				return;
+
+			Slot& slot = _slots[handle.Index];
+			_slotsByName.erase(slot.Name);
+			_names.erase(slot.Name);
+			SafeDelete(slot.Asset);
+			// Live slots have odd generations and free ones even, so old handles never match again.
+			slot.Generation++;
+			slot.References = 0;
+			_freeSlots.push_back(handle.Index);
+		}
+
+		void Clear()
+		{
+			for (Slot& slot : _slots)
+				SafeDelete(slot.Asset);
+
+			_slots.clear();
+			_freeSlots.clear();
+			_slotsByName.clear();
+			_names.clear();
+		}
+
+		AssetHandle<T> Find(const NameID name) const
+		{
+			auto it = _slotsByName.find(name);
+			if (it == _slotsByName.end())
+				return AssetHandle<T>();
+
+			return AssetHandle<T>(it->second, _slots[it->second].Generation);
+		}
+
+		inline AssetHandle<T> Find(const char*const name) const { return Find(HashName(name)); }
+
+		inline T*const Get(const AssetHandle<T> handle) const
+		{
+			if (handle.Index >= _slots.size() || _slots[handle.Index].Generation != handle.Generation)
+				return nullptr;
+
+			return _slots[handle.Index].Asset;
+		}
+
+		inline T*const Get(const NameID name) const { return Get(Find(name)); }
+		inline T*const Get(const char*const name) const { return Get(Find(name)); }
+
+		inline AssetRef<T> GetRef(const AssetHandle<T> handle) { return AssetRef<T>(this, handle); }
+		inline AssetRef<T> GetRef(const char*const name) { return AssetRef<T>(this, Find(name)); }
+
+		void Acquire(const AssetHandle<T> handle)
+		{
+			if (Get(handle) != nullptr)
+				_slots[handle.Index].References++;
+		}
+
+		// Unreferenced assets stay resident until Trim needs their memory.
+		void Release(const AssetHandle<T> handle)
+		{
+			if (Get(handle) == nullptr)
+				return;
+
+			Slot& slot = _slots[handle.Index];
+			if (slot.References > 0 && --slot.References == 0)
+				slot.LastUse = ++_useCounter;
+		}
+
+		// 0 removes the limit, the budget is only enforced by Trim.
+		inline void SetBudget(const unsigned long long bytes) { _budget = bytes; }
+		inline unsigned long long GetBudget() const { return _budget; }
+
+		// Evicts unreferenced assets, the ones released the longest time ago first, until the registry fits its budget.
+		void Trim()
+		{
+			if (_budget == 0 || !_sizeOf)
+				return;
+
+			unsigned long long residentBytes = GetResidentBytes();
+			while (residentBytes > _budget)
+			{
+				uint victim = _slots.size();
+				for (uint i = 0; i < _slots.size(); i++)
+				{
+					const Slot& slot = _slots[i];
+					if (slot.Asset != nullptr && slot.References == 0 && _sizeOf(slot.Asset) > 0 &&
+						(victim == _slots.size() || slot.LastUse < _slots[victim].LastUse))
+						victim = i;
+				}
+
+				if (victim == _slots.size())
+					break;
+
+				residentBytes -= _sizeOf(_slots[victim].Asset);
+				Remove(AssetHandle<T>(victim, _slots[victim].Generation));
+				_evictions++;
+			}
+		}
+
+		unsigned long long GetResidentBytes() const
+		{
+			unsigned long long bytes = 0;
+			if (!_sizeOf)
+				return bytes;
+
+			for (const Slot& slot : _slots)
+			{
+				if (slot.Asset != nullptr)
+					bytes += _sizeOf(slot.Asset);
+			}
+
+			return bytes;
+		}
+
+		virtual AssetResidency GetResidency() const override
+		{
+			AssetResidency residency;
+			residency.TypeName = TypeName;
+			residency.Count = GetCount();
+			residency.Referenced = 0;
+			residency.ResidentBytes = GetResidentBytes();
+			residency.Budget = _budget;
+			residency.Evictions = _evictions;
+
+			for (const Slot& slot : _slots)
+			{
+				if (slot.Asset != nullptr && slot.References > 0)
+					residency.Referenced++;
+			}
+
+			return residency;
+		}
+
+		inline uint GetCount() const { return _slots.size() - _freeSlots.size(); }
+
+		// Visits every live asset, in slot order.
+		template<typename Function>
+		void ForEach(const Function& function) const
+		{
+			for (const Slot& slot : _slots)
+			{
+				if (slot.Asset != nullptr)
+					function(slot.Asset);
+			}
+		}
+
+	private:
+		AssetRegistry(const AssetRegistry& tRef) = delete;
+		AssetRegistry& operator = (const AssetRegistry& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+/*
+===========================================================================
+FontManager.cpp
+
+Implements the FontManager class.
+===========================================================================
+*/
+
+#include "FontManager.h"
+#include "System/Logger.h"
+#include "System/MemoryManagement.h"
+
+using namespace sedge;
+
+FontManager::FontManager()
+	: _fonts("Font")
+{
+}
+
+FontManager::~FontManager()
+{
+	_fonts.Clear();
+}
+
+FontHandle FontManager::AddFont(const char*const name, const char*const path, const float size, const FontRendering rendering, const bool overrideExisting)
+{
+	if (GetFont(name) != nullptr && !overrideExisting)
+	{
+		LOG_WARNING("Font \"", name, "\" already exists and will not be overwritten");
+		return FontHandle();
+	}
+
+	Font* font = new Font(name, path, size, rendering);
+	if (!font->Load())
+	{
+		LOG_ERROR("Failed to load font: ", name);
+		SafeDelete(font);
+		return FontHandle();
+	}
+
+	return _fonts.Add(name, font, overrideExisting);
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+/*
+===========================================================================
+FontManager.h
+
+Defines a class responsible for managing Font objects.
+===========================================================================
+*/
+
+#pragma once
+
+#include <CustomTypes.h>
+#include "AssetRegistry.h"
+#include "Graphics/Text/Font.h"
+
+namespace sedge
+{
+	typedef AssetHandle<Font> FontHandle;
+
+	class FontManager
+	{
+	private:
+		AssetRegistry<Font> _fonts;
+
+	public:
+		FontManager();
+		~FontManager();
+
+		// The size is the pixel height from the highest ascender to the lowest descender.
+		FontHandle AddFont(const char*const name, const char*const path, const float size, const FontRendering rendering = FontRenderingBitmap, const bool overrideExisting = false);
+
+		inline FontHandle FindFont(const char*const name) const { return _fonts.Find(name); }
+		inline Font*const GetFont(const FontHandle handle) const { return _fonts.Get(handle); }
+		inline Font*const GetFont(const char*const name) const { return _fonts.Get(name); }
+
+		inline uint GetCount() { return _fonts.GetCount(); }
+
+	private:
+		FontManager(const FontManager& tRef) = delete;
+		FontManager& operator = (const FontManager& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -11,80 +11,35 @@ Implements the Renderable2DManager class.
 #include "System/MemoryManagement.h"
 
 #include "Graphics/Renderables/Sprite.h"
+#include "Graphics/Renderables/Label.h"
 #include "Graphics/Renderables/Group.h"
 
 using namespace sedge;
 using namespace std;
 
-Renderable2DManager::~Renderable2DManager()
-{
-	for (auto item : _groups)
-		SafeDelete(item.second);
-	for (auto item : _sprites)
-		SafeDelete(item.second);
-	for (auto item : _labels)
-		SafeDelete(item.second);
-}
-
-void Renderable2DManager::AddSprite(const char* name, Sprite*const sprite, const bool overwrite)
-{
-	if (GetSprite(name) == nullptr)
-		_sprites[name] = sprite;
-	else
-	{
-		if (overwrite)
-			_sprites[name] = sprite;
-		else
-			LOG_WARNING("Sprite \"", name, "\" already exists and will not be overwritten");
-	}
-}
-
-void Renderable2DManager::AddLabel(const char* name, Label* label, bool overwrite)
+Renderable2DManager::Renderable2DManager()
+	: _sprites("Sprite"), _labels("Label"), _groups("Group")
 {
-	if (GetSprite(name) == nullptr)
-		_labels[name] = label;
-	else
-	{
-		if (overwrite)
-			_labels[name] = label;
-		else
-			LOG_WARNING("Label \"", name, "\" already exists and will not be overwritten");
-	}
 }
 
-void Renderable2DManager::AddGroup(const char* name, bool overwrite)
+Renderable2DManager::~Renderable2DManager()
 {
-	if (GetGroup(name) == nullptr)
-		_groups[name] = new Group();
-	else
-	{
-		if (overwrite)
-			_groups[name] = new Group();
-		else
-			LOG_WARNING("Group \"", name, "\" already exists and will not be overwritten");
-	}
+	_groups.Clear();
+	_sprites.Clear();
+	_labels.Clear();
 }
 
-Sprite*const Renderable2DManager::GetSprite(const char* name)
+SpriteHandle Renderable2DManager::AddSprite(const char*const name, Sprite*const sprite, const bool overwrite)
 {
-	if (_sprites.find(name) != _sprites.end())
-		return _sprites[name];
-
-	return nullptr;
+	return _sprites.Add(name, sprite, overwrite);
 }
 
-Label*const Renderable2DManager::GetLabel(const char* name)
+LabelHandle Renderable2DManager::AddLabel(const char*const name, Label*const label, const bool overwrite)
 {
-	if (_labels.find(name) != _labels.end())
-			return _labels[name];
-
-	return nullptr;
+	return _labels.Add(name, label, overwrite);
 }
 
-Group*const Renderable2DManager::GetGroup(const char* name)
+GroupHandle Renderable2DManager::AddGroup(const char*const name, const bool overwrite)
 {
-	if (_groups.find(name) != _groups.end())
-			return _groups[name];
-	
-	return nullptr;
+	return _groups.Add(name, new Group(), overwrite);
 }
\ No newline at end of file
@@ -3,16 +3,13 @@
 Renderable2DManager.h
 
 Defines a class responsible for managing Renderable2D objects.
-
-TODO: standartize all of the manager classes
 ===========================================================================
 */
 
 #pragma once
 
-#include <map>
-#include <string>
 #include <CustomTypes.h>
+#include "AssetRegistry.h"
 
 namespace sedge
 {
@@ -20,27 +17,39 @@ namespace sedge
 	class Label;
 	class Sprite;
 
+	typedef AssetHandle<Sprite> SpriteHandle;
+	typedef AssetHandle<Label> LabelHandle;
+	typedef AssetHandle<Group> GroupHandle;
+
 	class Renderable2DManager
 	{
 	private:
-		std::map<std::string, Sprite*> _sprites;
-		std::map<std::string, Label*> _labels;
-		std::map<std::string, Group*> _groups;
+		AssetRegistry<Sprite> _sprites;
+		AssetRegistry<Label> _labels;
+		AssetRegistry<Group> _groups;
 
 	public:
-		Renderable2DManager() {}
+		Renderable2DManager();
 		~Renderable2DManager();
 
-		void AddSprite(const char* name, Sprite*const sprite, const bool overwrite = false);
-		void AddLabel(const char* name, Label*const label, const bool overwrite = false);
-		void AddGroup(const char* name, const bool overwrite = false);
-		Sprite*const GetSprite(const char* name);
-		Label*const GetLabel(const char* name);
-		Group*const GetGroup(const char* name);
-
-		inline const uint GetSpriteCount() { return _sprites.size(); }
-		inline const uint GetLabelCount() { return _labels.size(); }
-		inline const uint GetGroupCount() { return _groups.size(); }
+		// The manager owns the added renderables, ones that are not added because of a name clash are deleted.
+		SpriteHandle AddSprite(const char*const name, Sprite*const sprite, const bool overwrite = false);
+		LabelHandle AddLabel(const char*const name, Label*const label, const bool overwrite = false);
+		GroupHandle AddGroup(const char*const name, const bool overwrite = false);
+
+		inline SpriteHandle FindSprite(const char*const name) const { return _sprites.Find(name); }
+		inline LabelHandle FindLabel(const char*const name) const { return _labels.Find(name); }
+		inline GroupHandle FindGroup(const char*const name) const { return _groups.Find(name); }
+		inline Sprite*const GetSprite(const SpriteHandle handle) const { return _sprites.Get(handle); }
+		inline Sprite*const GetSprite(const char*const name) const { return _sprites.Get(name); }
+		inline Label*const GetLabel(const LabelHandle handle) const { return _labels.Get(handle); }
+		inline Label*const GetLabel(const char*const name) const { return _labels.Get(name); }
+		inline Group*const GetGroup(const GroupHandle handle) const { return _groups.Get(handle); }
+		inline Group*const GetGroup(const char*const name) const { return _groups.Get(name); }
+
+		inline const uint GetSpriteCount() { return _sprites.GetCount(); }
+		inline const uint GetLabelCount() { return _labels.GetCount(); }
+		inline const uint GetGroupCount() { return _groups.GetCount(); }
 
 	private:
 		Renderable2DManager(const Renderable2DManager& tRef) = delete;
@@ -17,78 +17,29 @@ Implements the Renderable3DManager class.
 using namespace sedge;
 using namespace std;
 
-void Renderable3DManager::AddMesh(const char*const name, Mesh*const mesh, const bool overwrite)
+Renderable3DManager::Renderable3DManager()
+	: _meshes("Mesh"), _models("Model"), _skyboxes("Skybox")
 {
-	if (GetMesh(name) == nullptr)
-		_meshes[name] = mesh;
-	else
-	{
-		if (overwrite)
-			_meshes[name] = mesh;
-		else
-			LOG_WARNING("Mesh \"", name, "\" already exists and will not be overwritten");
-	}
 }
 
-void Renderable3DManager::AddModel(const char*const name, Model*const model, const bool overwrite)
+MeshHandle Renderable3DManager::AddMesh(const char*const name, Mesh*const mesh, const bool overwrite)
 {
-	if (GetModel(name) == nullptr)
-		_models[name] = model;
-	else
-	{
-		if (overwrite)
-			_models[name] = model;
-		else
-			LOG_WARNING("Model \"", name, "\" already exists and will not be overwritten");
-	}
+	return _meshes.Add(name, mesh, overwrite);
 }
 
-void Renderable3DManager::AddSkybox(const char*const name, Skybox*const skybox, const bool overwrite)
+ModelHandle Renderable3DManager::AddModel(const char*const name, Model*const model, const bool overwrite)
 {
-	if (GetSkybox(name) == nullptr)
-		_skyboxes[name] = skybox;
-	else
-	{
-		if (overwrite)
-			_skyboxes[name] = skybox;
-		else
-			LOG_WARNING("Skybox \"", name, "\" already exists and will not be overwritten");
-	}
+	return _models.Add(name, model, overwrite);
 }
 
-Mesh*const Renderable3DManager::GetMesh(const char*const name)
+SkyboxHandle Renderable3DManager::AddSkybox(const char*const name, Skybox*const skybox, const bool overwrite)
 {
-	if (_meshes.find(name) != _meshes.end())
-		return _meshes[name];
-
-	LOG_ERROR("Mesh \"", name, "\" already exists and will not be overwritten");
-	return nullptr;
-}
-
-Model*const Renderable3DManager::GetModel(const char*const name)
-{
-	if (_models.find(name) != _models.end())
-		return _models[name];
-
-	LOG_ERROR("Model \"", name, "\" already exists and will not be overwritten");
-	return nullptr;
-}
-
-Skybox*const Renderable3DManager::GetSkybox(const char*const name)
-{
-	if (_skyboxes.find(name) != _skyboxes.end())
-		return _skyboxes[name];
-
-	LOG_ERROR("Skybox \"", name, "\" already exists and will not be overwritten");
-	return nullptr;
+	return _skyboxes.Add(name, skybox, overwrite);
 }
 
 Renderable3DManager::~Renderable3DManager()
 {
-	for (auto item : _meshes)
-		SafeDelete(item.second);
-	for (auto item : _models)
-		SafeDelete(item.second);
-	for (auto item : _skyboxes)
-		SafeDelete(item.second);
+	_meshes.Clear();
+	_models.Clear();
+	_skyboxes.Clear();
 }
\ No newline at end of file
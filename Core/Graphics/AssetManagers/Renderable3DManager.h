@@ -3,16 +3,13 @@
 Renderable3DManager.h
 
 Defines a class responsible for managing Renderable3D objects.
-
-TODO: standartize all of the manager classes
 ===========================================================================
 */
 
 #pragma once
 
-#include <map>
-#include <string>
 #include <CustomTypes.h>
+#include "AssetRegistry.h"
 
 namespace sedge
 {
@@ -20,27 +17,39 @@ namespace sedge
 	class Model;
 	class Skybox;
 
+	typedef AssetHandle<Mesh> MeshHandle;
+	typedef AssetHandle<Model> ModelHandle;
+	typedef AssetHandle<Skybox> SkyboxHandle;
+
 	class Renderable3DManager
 	{
 	private:
-		std::map<std::string, Mesh*> _meshes;
-		std::map<std::string, Model*> _models;
-		std::map<std::string, Skybox*> _skyboxes;
+		AssetRegistry<Mesh> _meshes;
+		AssetRegistry<Model> _models;
+		AssetRegistry<Skybox> _skyboxes;
 
 	public:
-		Renderable3DManager() {}
+		Renderable3DManager();
 		~Renderable3DManager();
 
-		void AddMesh(const char*const name, Mesh*const mesh, const bool overwrite = false);
-		void AddModel(const char*const name, Model*const model, const bool overwrite = false);
-		void AddSkybox(const char*const name, Skybox*const skybox, const bool overwrite = false);
-		Mesh*const GetMesh(const char*const name);
-		Model*const GetModel(const char*const name);
-		Skybox*const GetSkybox(const char*const name);
-
-		inline const uint GetMeshCount() { return _meshes.size(); }
-		inline const uint GetModelCount() { return _models.size(); }
-		inline const uint GetSkyboxCount() { return _skyboxes.size(); }
+		// The manager owns the added renderables, ones that are not added because of a name clash are deleted.
+		MeshHandle AddMesh(const char*const name, Mesh*const mesh, const bool overwrite = false);
+		ModelHandle AddModel(const char*const name, Model*const model, const bool overwrite = false);
+		SkyboxHandle AddSkybox(const char*const name, Skybox*const skybox, const bool overwrite = false);
+
+		inline MeshHandle FindMesh(const char*const name) const { return _meshes.Find(name); }
+		inline ModelHandle FindModel(const char*const name) const { return _models.Find(name); }
+		inline SkyboxHandle FindSkybox(const char*const name) const { return _skyboxes.Find(name); }
+		inline Mesh*const GetMesh(const MeshHandle handle) const { return _meshes.Get(handle); }
+		inline Mesh*const GetMesh(const char*const name) const { return _meshes.Get(name); }
+		inline Model*const GetModel(const ModelHandle handle) const { return _models.Get(handle); }
+		inline Model*const GetModel(const char*const name) const { return _models.Get(name); }
+		inline Skybox*const GetSkybox(const SkyboxHandle handle) const { return _skyboxes.Get(handle); }
+		inline Skybox*const GetSkybox(const char*const name) const { return _skyboxes.Get(name); }
+
+		inline const uint GetMeshCount() { return _meshes.GetCount(); }
+		inline const uint GetModelCount() { return _models.GetCount(); }
+		inline const uint GetSkyboxCount() { return _skyboxes.GetCount(); }
 
 	private:
 		Renderable3DManager(const Renderable3DManager& tRef) = delete;
@@ -9,45 +9,150 @@ Implements ShaderManager class
 #include "ShaderManager.h"
 #include "Graphics/Shaders/ShaderFactory.h"
 #include "Graphics/Shaders/ShaderProgram.h"
+#include "System/FileUtils.h"
+#include "System/FileWatcher.h"
+#include "System/ThreadPool.h"
 #include "System/Logger.h"
 #include "System/MemoryManagement.h"
+#include <algorithm>
 
 using namespace sedge;
 using namespace std;
 
-void ShaderManager::Add(const char*const name, const char*const vertexPath, const char*const fragmentPath, const bool overrideExisting)
+ShaderManager::ShaderManager()
+	: _programs("Shader program"), _watcher(nullptr), _pendingReloads(0)
 {
-	if (GetShader(name) != nullptr)
+}
+
+ShaderHandle ShaderManager::Add(const char*const name, const char*const vertexPath, const char*const fragmentPath, const char*const defines, const bool overrideExisting)
+{
+	if (GetShader(name) != nullptr && !overrideExisting)
 	{
-		if (overrideExisting)
-		{
-			ShaderProgram* program = ShaderFactory::CreateShaderProgram(name, vertexPath, fragmentPath);
-			if (program != nullptr)
-				_programs[name] = program;
-		}
-		else
+		LOG_WARNING("Shader program \"", name, "\" already exists and will not be overwritten");
+		return ShaderHandle();
+	}
+
+	ShaderProgram* program = ShaderFactory::CreateShaderProgram(name, vertexPath, fragmentPath, defines);
+	if (program == nullptr)
+		return ShaderHandle();
+
+	if (_watcher != nullptr)
+		WatchDependencies(program);
+
+	return _programs.Add(name, program, overrideExisting);
+}
+
+void ShaderManager::FindDependents(const char*const path, vector<ShaderHandle>& dependents) const
+{
+	const string normalized = FileUtils::NormalizePath(path);
+
+	_programs.ForEach([&](const ShaderProgram*const program)
+	{
+		const vector<string>& dependencies = program->GetDependencies();
+		if (find(dependencies.begin(), dependencies.end(), normalized) != dependencies.end())
+			dependents.push_back(_programs.Find(program->GetName()));
+	});
+}
+
+void ShaderManager::EnableHotReload()
+{
+	if (_watcher != nullptr)
+		return;
+
+	_watcher = new FileWatcher();
+	_programs.ForEach([this](const ShaderProgram*const program) { WatchDependencies(program); });
+}
+
+void ShaderManager::Update()
+{
+	if (_watcher == nullptr)
+		return;
+
+	_changedFiles.clear();
+	_watcher->GetChanges(_changedFiles);
+
+	vector<ShaderHandle> dependents;
+	for (const string& path : _changedFiles)
+		FindDependents(path.c_str(), dependents);
+
+	for (const ShaderHandle handle : dependents)
+	{
+		// A program that is already being prepared picks up the latest files on its next change.
+		if (find(_preparing.begin(), _preparing.end(), handle) == _preparing.end())
+			PrepareReload(handle);
+	}
+
+	vector<PreparedReload> prepared;
+	{
+		lock_guard<mutex> lock(_mutex);
+		prepared.swap(_prepared);
+	}
+
+	for (PreparedReload& reload : prepared)
+	{
+		_preparing.erase(find(_preparing.begin(), _preparing.end(), reload.Program));
+
+		ShaderProgram* program = GetShader(reload.Program);
+		if (program != nullptr && reload.Source != nullptr)
 		{
-			LOG_WARNING("Shader program \"", name, "\" already exists and will not be overwritten");
+			if (program->Reload(*reload.Source))
+			{
+				LOG_INFO("Reloaded shader program \"", program->GetName(), "\"");
+				WatchDependencies(program);
+			}
+			else
+				LOG_ERROR("Shader program \"", program->GetName(), "\" failed to build and keeps its previous version");
 		}
+
+		SafeDelete(reload.Source);
 	}
-	else
+}
+
+void ShaderManager::PrepareReload(const ShaderHandle handle)
+{
+	const ShaderProgram* program = GetShader(handle);
+	const string vertexPath = program->GetVertexPath();
+	const string fragmentPath = program->GetFragmentPath();
+	const string defines = program->GetDefines();
+
+	_preparing.push_back(handle);
 	{
-		ShaderProgram* program = ShaderFactory::CreateShaderProgram(name, vertexPath, fragmentPath);
-		if (program != nullptr)
-			_programs[name] = program;
+		lock_guard<mutex> lock(_mutex);
+		_pendingReloads++;
 	}
+
+	// The task only works on copies, the program may be replaced before it finishes.
+	ThreadPool::GetShared().Enqueue([this, handle, vertexPath, fragmentPath, defines]()
+	{
+		ShaderProgramSource* source = new ShaderProgramSource();
+		if (!ShaderProgram::Prepare(vertexPath.c_str(), fragmentPath.c_str(), defines.c_str(), *source))
+			SafeDelete(source);
+
+		lock_guard<mutex> lock(_mutex);
+		PreparedReload reload = { handle, source };
+		_prepared.push_back(reload);
+		_pendingReloads--;
+		_idleCondition.notify_all();
+	});
 }
 
-ShaderProgram*const ShaderManager::GetShader(const char*const name)
+void ShaderManager::WatchDependencies(const ShaderProgram*const program)
 {
-	if (_programs.find(name) != _programs.end())
-		return _programs[name];
-
-	return nullptr;
+	for (const string& path : program->GetDependencies())
+		_watcher->Watch(path.c_str());
 }
 
 ShaderManager::~ShaderManager()
 {
-	for (auto item : _programs)
-		SafeDelete(item.second);
+	SafeDelete(_watcher);
+
+	{
+		unique_lock<mutex> lock(_mutex);
+		_idleCondition.wait(lock, [this] { return _pendingReloads == 0; });
+	}
+
+	for (PreparedReload& reload : _prepared)
+		SafeDelete(reload.Source);
+
+	_programs.Clear();
 }
\ No newline at end of file
@@ -3,35 +3,75 @@
 ShaderManager.h
 
 Defines a class responsible for managing ShaderProgram objects.
-
-TODO: standartize all of the manager classes
 ===========================================================================
 */
 
 #pragma once
 
-#include <map>
-#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include "AssetRegistry.h"
 
 namespace sedge
 {
 	class ShaderProgram;
+	class FileWatcher;
+	struct ShaderProgramSource;
+
+	typedef AssetHandle<ShaderProgram> ShaderHandle;
 
 	class ShaderManager
 	{
 	private:
-		std::map<std::string, ShaderProgram*> _programs;
+		struct PreparedReload
+		{
+			ShaderHandle Program; // stale if the program was replaced in the meantime
+			ShaderProgramSource* Source; // nullptr if the sources could not be read
+		};
+
+		AssetRegistry<ShaderProgram> _programs;
+		FileWatcher* _watcher; // only while hot reloading
+		std::vector<std::string> _changedFiles;
+		std::vector<ShaderHandle> _preparing;
+		std::vector<PreparedReload> _prepared;
+		uint _pendingReloads;
+		std::mutex _mutex;
+		std::condition_variable _idleCondition;
 
 	public:
-		ShaderManager() {}
+		ShaderManager();
 		~ShaderManager();
-		void Add(const char*const name, const char*const vertexPath, const char*const fragmentPath, const bool overrideExisting = false);
-		ShaderProgram*const GetShader(const char* name);
+		// Every permutation is a program of its own, registered under its own name. The program is built right away,
+		// its sources are read and compiled, or its binary loaded, before this returns.
+		ShaderHandle Add(const char*const name, const char*const vertexPath, const char*const fragmentPath, const char*const defines = nullptr, const bool overrideExisting = false);
+
+		// The programs built from the file, directly or through an include.
+		void FindDependents(const char*const path, std::vector<ShaderHandle>& dependents) const;
+
+		inline ShaderHandle FindShader(const char*const name) const { return _programs.Find(name); }
+		inline ShaderProgram*const GetShader(const ShaderHandle handle) const { return _programs.Get(handle); }
+		inline ShaderProgram*const GetShader(const NameID name) const { return _programs.Get(name); }
+		inline ShaderProgram*const GetShader(const char*const name) const { return _programs.Get(name); }
+
+		inline uint GetCount() const { return _programs.GetCount(); }
+
+		// Watches the sources and includes of all programs, including the ones added later. The programs built from
+		// a changed file are preprocessed in the background and rebuilt and swapped in by Update. A program that
+		// fails to build keeps its previous version.
+		void EnableHotReload();
+		inline bool IsHotReloadEnabled() const { return _watcher != nullptr; }
+
+		// Swaps in the programs whose sources changed, must be called on the rendering thread before drawing.
+		void Update();
 
 	private:
 		ShaderManager(const ShaderManager& tRef) = delete;
 		ShaderManager& operator = (const ShaderManager& tRef) = delete;
 
+		void PrepareReload(const ShaderHandle handle);
+		void WatchDependencies(const ShaderProgram*const program);
+
 		friend class GraphicsAssetManagerFactory;
 	};
 }
\ No newline at end of file
@@ -12,86 +12,219 @@ Implements the texture manager class.
 #include "System/MemoryManagement.h"
 #include "Graphics/Textures/Texture2D.h"
 #include "Graphics/Textures/Cubemap.h"
+#include "System/AsyncFileReader.h"
+#include "System/FileWatcher.h"
+#include "System/FileUtils.h"
 
 using namespace sedge;
 using namespace std;
-	
-void TextureManager::AddTex2D(const char*const name, const char*const path, const TextureType type, const TextureWrapMode wrapMode, const TextureFilterMode filterMode, const bool overrideExisting)
+
+static unsigned long long GetTextureSize(const Texture*const texture);
+template<typename T>
+static void ReloadTexture(AssetRegistry<T>& registry, TextureLoader& loader, T*const texture, const vector<string>& paths);
+
+TextureManager::TextureManager()
+	: _texture2Ds("Texture", GetTextureSize), _cubemaps("Cubemap", GetTextureSize), _watcher(nullptr)
 {
-	if (GetTex2D(name) != nullptr)
+	_loader = new TextureLoader(AsyncFileReader::GetShared());
+}
+
+Texture2DHandle TextureManager::AddTex2D(const char*const name, const char*const path, const TextureType type, const TextureWrapMode wrapMode, const TextureFilterMode filterMode, const bool overrideExisting)
+{
+	if (GetTex2D(name) != nullptr && !overrideExisting)
 	{
-		if (overrideExisting)
-		{
-			Texture2D* newTexture = TextureFactory::CreateTexture2DFromFile(name, path, type, wrapMode, filterMode);
-			if (newTexture != nullptr)
-			{
-				_texture2Ds[name] = newTexture;
-				_idsToNames[newTexture->GetID()] = name;
-			}
-		}
-		else
-		{
-			LOG_WARNING("Texture \"", name, "\" already exists and will not be overwritten");
-		}
+		LOG_WARNING("Texture \"", name, "\" already exists and will not be overwritten");
+		return Texture2DHandle();
 	}
-	else
+
+	Texture2D* newTexture = TextureFactory::CreateTexture2DFromFile(name, path, type, wrapMode, filterMode);
+	if (newTexture == nullptr)
+		return Texture2DHandle();
+
+	if (_watcher != nullptr)
+		_watcher->Watch(path);
+
+	return _texture2Ds.Add(name, newTexture, overrideExisting);
+}
+
+CubemapHandle TextureManager::AddCubemap(const char*const name, const std::vector<std::string>& paths, const TextureWrapMode wrapMode, const TextureFilterMode filterMode, const bool overrideExisting)
+{
+	if (GetCubemap(name) != nullptr && !overrideExisting)
 	{
-		Texture2D* newTexture = TextureFactory::CreateTexture2DFromFile(name, path, type, wrapMode, filterMode);
-		if (newTexture != nullptr)
-		{
-			_texture2Ds[name] = newTexture;
-			_idsToNames[newTexture->GetID()] = name;
-		}
+		LOG_WARNING("Texture \"", name, "\" already exists and will not be overwritten");
+		return CubemapHandle();
 	}
+
+	Cubemap* newTexture = TextureFactory::CreateCubemapFromFile(name, paths, wrapMode, filterMode);
+	if (newTexture == nullptr)
+		return CubemapHandle();
+
+	if (_watcher != nullptr)
+	{
+		for (const string& path : paths)
+			_watcher->Watch(path.c_str());
+	}
+
+	return _cubemaps.Add(name, newTexture, overrideExisting);
+}
+
+Texture2DHandle TextureManager::AddTex2DAsync(const char*const name, const char*const path, const TextureLoadedCallback& onLoaded, const TextureType type, const TextureWrapMode wrapMode, const TextureFilterMode filterMode)
+{
+	if (GetTex2D(name) != nullptr)
+	{
+		LOG_WARNING("Texture \"", name, "\" already exists and will not be overwritten");
+		return Texture2DHandle();
+	}
+
+	Texture2D* newTexture = TextureFactory::CreateTexture2DPlaceholder(name, path, type, wrapMode, filterMode);
+	if (newTexture == nullptr)
+		return Texture2DHandle();
+
+	// Registered before the loader sees it, Add deletes the texture if the name is not usable.
+	const Texture2DHandle handle = _texture2Ds.Add(name, newTexture);
+	if (!handle.IsValid())
+		return handle;
+
+	if (_watcher != nullptr)
+		_watcher->Watch(path);
+
+	// The loader keeps a pointer to the texture, so it is held until the load completes.
+	_texture2Ds.Acquire(handle);
+	auto release = [this, handle, onLoaded](Texture*const texture, const bool loaded)
+	{
+		_texture2Ds.Release(handle);
+		if (onLoaded)
+			onLoaded(texture, loaded);
+	};
+
+	_loader->Load(newTexture, vector<string>(1, path), release);
+
+	return handle;
 }
 
-void TextureManager::AddCubemap(const char*const name, const std::vector<std::string>& paths, const TextureWrapMode wrapMode, const TextureFilterMode filterMode, const bool overrideExisting)
+CubemapHandle TextureManager::AddCubemapAsync(const char*const name, const std::vector<std::string>& paths, const TextureLoadedCallback& onLoaded, const TextureWrapMode wrapMode, const TextureFilterMode filterMode)
 {
 	if (GetCubemap(name) != nullptr)
 	{
-		if (overrideExisting)
-		{
-			Cubemap* newTexture = TextureFactory::CreateCubemapFromFile(name, paths, wrapMode, filterMode);
-			if (newTexture != nullptr)
-			{
-				_cubemaps[name] = newTexture;
-				_idsToNames[newTexture->GetID()] = name;
-			}
-		}
-		else
-		{
-			LOG_WARNING("Texture \"", name, "\" already exists and will not be overwritten");
-		}
+		LOG_WARNING("Texture \"", name, "\" already exists and will not be overwritten");
+		return CubemapHandle();
 	}
-	else
+
+	Cubemap* newTexture = TextureFactory::CreateCubemapPlaceholder(name, paths, wrapMode, filterMode);
+	if (newTexture == nullptr)
+		return CubemapHandle();
+
+	const CubemapHandle handle = _cubemaps.Add(name, newTexture);
+	if (!handle.IsValid())
+		return handle;
+
+	if (_watcher != nullptr)
 	{
-		Cubemap* newTexture = TextureFactory::CreateCubemapFromFile(name, paths, wrapMode, filterMode);
-		if (newTexture != nullptr)
-		{
-			_cubemaps[name] = newTexture;
-			_idsToNames[newTexture->GetID()] = name;
-		}
+		for (const string& path : paths)
+			_watcher->Watch(path.c_str());
 	}
+
+	_cubemaps.Acquire(handle);
+	auto release = [this, handle, onLoaded](Texture*const texture, const bool loaded)
+	{
+		_cubemaps.Release(handle);
+		if (onLoaded)
+			onLoaded(texture, loaded);
+	};
+
+	_loader->Load(newTexture, paths, release);
+
+	return handle;
 }
 
-Texture2D*const TextureManager::GetTex2D(const char*const name)
+void TextureManager::EnableHotReload()
 {
-	if (_texture2Ds.find(name) != _texture2Ds.end())
-		return _texture2Ds[name];
+	if (_watcher != nullptr)
+		return;
 
-	return nullptr;
+	_watcher = new FileWatcher();
+
+	_texture2Ds.ForEach([this](const Texture2D*const texture)
+	{
+		if (strcmp(texture->GetPath(), "") != 0)
+			_watcher->Watch(texture->GetPath());
+	});
+
+	_cubemaps.ForEach([this](const Cubemap*const texture)
+	{
+		for (const string& path : texture->GetPaths())
+			_watcher->Watch(path.c_str());
+	});
 }
 
-Cubemap*const TextureManager::GetCubemap(const char*const name)
+void TextureManager::Update()
 {
-	if (_cubemaps.find(name) != _cubemaps.end())
-		return _cubemaps[name];
+	if (_watcher != nullptr)
+		ReloadChangedFiles();
+
+	_loader->Update();
 
-	return nullptr;
+	_texture2Ds.Trim();
+	_cubemaps.Trim();
+}
+
+void TextureManager::ReloadChangedFiles()
+{
+	_changedFiles.clear();
+	_watcher->GetChanges(_changedFiles);
+
+	for (const string& path : _changedFiles)
+	{
+		_texture2Ds.ForEach([&](Texture2D*const texture)
+		{
+			if (FileUtils::NormalizePath(texture->GetPath()) == path)
+				ReloadTexture(_texture2Ds, *_loader, texture, vector<string>(1, texture->GetPath()));
+		});
+
+		_cubemaps.ForEach([&](Cubemap*const texture)
+		{
+			const vector<string>& paths = texture->GetPaths();
+			for (const string& facePath : paths)
+			{
+				if (FileUtils::NormalizePath(facePath) == path)
+				{
+					ReloadTexture(_cubemaps, *_loader, texture, paths);
+					break;
+				}
+			}
+		});
+	}
 }
 
 TextureManager::~TextureManager()
 {
-	for (auto item : _texture2Ds)
-		SafeDelete(item.second);
+	SafeDelete(_watcher);
+	// Pending loads still point at the textures.
+	SafeDelete(_loader);
+
+	_texture2Ds.Clear();
+	_cubemaps.Clear();
+}
+
+unsigned long long GetTextureSize(const Texture*const texture)
+{
+	return texture->GetMemorySize();
+}
+
+// Like an asynchronous load, the texture is held until the new images are swapped in.
+template<typename T>
+void ReloadTexture(AssetRegistry<T>& registry, TextureLoader& loader, T*const texture, const vector<string>& paths)
+{
+	const AssetHandle<T> handle = registry.Find(texture->GetName());
+	registry.Acquire(handle);
+
+	auto release = [&registry, handle](Texture*const reloaded, const bool loaded)
+	{
+		if (loaded)
+			LOG_INFO("Reloaded texture \"", reloaded->GetName(), "\"");
+
+		registry.Release(handle);
+	};
+
+	loader.Load(texture, paths, release, true);
 }
\ No newline at end of file
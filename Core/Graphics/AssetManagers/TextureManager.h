@@ -3,43 +3,81 @@
 TextureManager.h
 
 Defines a class responsible for managing Texture objects.
-
-TODO: standartize all of the manager classes
 ===========================================================================
 */
 
 #pragma once
 
-#include <map>
 #include <vector>
+#include "AssetRegistry.h"
 #include "Graphics/Textures/Texture.h"
+#include "Graphics/Textures/TextureLoader.h"
 
 namespace sedge
 {
 	class Texture2D;
 	class Cubemap;
+	class FileWatcher;
+
+	typedef AssetHandle<Texture2D> Texture2DHandle;
+	typedef AssetHandle<Cubemap> CubemapHandle;
+	typedef AssetRef<Texture2D> Texture2DRef;
+	typedef AssetRef<Cubemap> CubemapRef;
 
 	class TextureManager
 	{
 	private:
-		std::map<std::string, Texture2D*> _texture2Ds;
-		std::map<std::string, Cubemap*> _cubemaps;
-		std::map<ID, std::string> _idsToNames;
+		AssetRegistry<Texture2D> _texture2Ds;
+		AssetRegistry<Cubemap> _cubemaps;
+		TextureLoader* _loader;
+		FileWatcher* _watcher; // only while hot reloading
+		std::vector<std::string> _changedFiles;
 
 	public:
-		TextureManager() {}
+		TextureManager();
 		~TextureManager();
-		void AddTex2D(const char*const name, const char*const path, const TextureType type = Diffuse, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterModebool = Linear, const bool overrideExisting = false);
-		void AddCubemap(const char*const name, const std::vector<std::string>& paths, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear, const bool overrideExisting = false);
-		Texture2D*const GetTex2D(const char*const name);
-		Cubemap*const GetCubemap(const char*const name);
+		Texture2DHandle AddTex2D(const char*const name, const char*const path, const TextureType type = Diffuse, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterModebool = Linear, const bool overrideExisting = false);
+		CubemapHandle AddCubemap(const char*const name, const std::vector<std::string>& paths, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear, const bool overrideExisting = false);
+		// The textures are usable right away and show a placeholder until Update uploads the decoded images.
+		Texture2DHandle AddTex2DAsync(const char*const name, const char*const path, const TextureLoadedCallback& onLoaded = nullptr, const TextureType type = Diffuse, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear);
+		CubemapHandle AddCubemapAsync(const char*const name, const std::vector<std::string>& paths, const TextureLoadedCallback& onLoaded = nullptr, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear);
+
+		inline Texture2DHandle FindTex2D(const char*const name) const { return _texture2Ds.Find(name); }
+		inline CubemapHandle FindCubemap(const char*const name) const { return _cubemaps.Find(name); }
+		inline Texture2D*const GetTex2D(const Texture2DHandle handle) const { return _texture2Ds.Get(handle); }
+		inline Texture2D*const GetTex2D(const NameID name) const { return _texture2Ds.Get(name); }
+		inline Texture2D*const GetTex2D(const char*const name) const { return _texture2Ds.Get(name); }
+		inline Cubemap*const GetCubemap(const CubemapHandle handle) const { return _cubemaps.Get(handle); }
+		inline Cubemap*const GetCubemap(const NameID name) const { return _cubemaps.Get(name); }
+		inline Cubemap*const GetCubemap(const char*const name) const { return _cubemaps.Get(name); }
+		// Referenced textures are never evicted.
+		inline Texture2DRef GetTex2DRef(const char*const name) { return _texture2Ds.GetRef(name); }
+		inline CubemapRef GetCubemapRef(const char*const name) { return _cubemaps.GetRef(name); }
+
+		// Video memory the textures of each kind may take, 0 for no limit. Unreferenced textures are evicted
+		// in Update while a budget is exceeded, the ones released the longest time ago first.
+		inline void SetTex2DBudget(const unsigned long long bytes) { _texture2Ds.SetBudget(bytes); }
+		inline void SetCubemapBudget(const unsigned long long bytes) { _cubemaps.SetBudget(bytes); }
+		inline unsigned long long GetTex2DResidentBytes() const { return _texture2Ds.GetResidentBytes(); }
+		inline unsigned long long GetCubemapResidentBytes() const { return _cubemaps.GetResidentBytes(); }
 
-		inline uint GetCount() { return _texture2Ds.size(); }
+		inline uint GetCount() { return _texture2Ds.GetCount(); }
+		inline bool IsLoading() { return !_loader->IsIdle(); }
+
+		// Watches the image files of all textures, including the ones added later. A changed file is decoded
+		// in the background and swapped in by Update, the texture keeps its old contents until then.
+		void EnableHotReload();
+		inline bool IsHotReloadEnabled() const { return _watcher != nullptr; }
+
+		// Uploads the textures decoded in the background and enforces the budgets, must be called on the rendering thread.
+		void Update();
 
 	private:
 		TextureManager(const TextureManager& tRef) = delete;
 		TextureManager& operator = (const TextureManager& tRef) = delete;
 
+		void ReloadChangedFiles();
+
 		friend class GraphicsAssetManagerFactory;
 	};
 }
\ No newline at end of file
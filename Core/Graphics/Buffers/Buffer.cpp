@@ -11,12 +11,12 @@ Implements Buffer class.
 
 using namespace sedge;
 
-Buffer::Buffer(const BufferTarget target, const uint elementSize, const uint elementCount, void*const dataPtr, const DrawingMode drawingMode)
-	: Target(target), ElementSize(elementSize), ElementCount(elementCount), DataPtr(dataPtr), Mode(drawingMode)
+Buffer::Buffer(const BufferTarget target, const uint elementSize, const uint elementCount, const void*const initialData, const DrawingMode drawingMode)
+	: Target(target), ElementSize(elementSize), ElementCount(elementCount), DataPtr(nullptr), Mode(drawingMode)
 {
 	GraphicsAPI::GenBuffers(1, &BufferID);
 	Bind();
-	GraphicsAPI::SetBufferData(Target, ElementSize * ElementCount, DataPtr, drawingMode);
+	GraphicsAPI::SetBufferData(Target, ElementSize * ElementCount, initialData, drawingMode);
 	Unbind();
 }
 
@@ -24,7 +24,8 @@ namespace sedge
 		DrawingMode Mode;
 
 	protected:
-		Buffer(const BufferTarget target, const uint elementSize, const uint elementCount, void*const dataPtr = nullptr, const DrawingMode drawingMode = Static);
+		// The initial data is only uploaded, the buffer does not keep a pointer to it.
+		Buffer(const BufferTarget target, const uint elementSize, const uint elementCount, const void*const initialData = nullptr, const DrawingMode drawingMode = Static);
 
 	public:
 		virtual ~Buffer();
@@ -10,7 +10,12 @@ Implements the IndexBuffer class
 
 using namespace sedge;
 
-IndexBuffer::IndexBuffer(const uint count, uint*const data, const DrawingMode drawingMode)
-	: Buffer(Element, sizeof(*data), count, data, drawingMode)
+IndexBuffer::IndexBuffer(const uint count, const uint*const initialData, const DrawingMode drawingMode)
+	: Buffer(Element, sizeof(uint), count, initialData, drawingMode), _indexType(UnsignedInt)
+{
+}
+
+IndexBuffer::IndexBuffer(const uint count, const ushort*const initialData, const DrawingMode drawingMode)
+	: Buffer(Element, sizeof(ushort), count, initialData, drawingMode), _indexType(UnsginedShort)
 {
 }
\ No newline at end of file
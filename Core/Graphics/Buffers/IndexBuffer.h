@@ -9,12 +9,20 @@ Represents an entity called index buffer, designed to reduce the number of verti
 #pragma once
 
 #include "Buffer.h"
+#include "Graphics/DrawingEnums.h"
 
 namespace sedge
 {
 	class IndexBuffer : public Buffer
 	{
+	private:
+		ValueType _indexType;
+
 	public:
-		IndexBuffer(const uint count, uint*const dataPtr = nullptr, const DrawingMode drawingMode = Static);
+		IndexBuffer(const uint count, const uint*const initialData = nullptr, const DrawingMode drawingMode = Static);
+		// 16-bit indices halve the buffer for meshes with up to 65536 vertices.
+		IndexBuffer(const uint count, const ushort*const initialData, const DrawingMode drawingMode = Static);
+
+		inline const ValueType GetIndexType() const { return _indexType; }
 	};
 }
\ No newline at end of file
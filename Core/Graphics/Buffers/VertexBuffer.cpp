@@ -13,8 +13,8 @@ Implements the VertexBuffer class
 
 using namespace sedge;
 
-VertexBuffer::VertexBuffer(uint vertexSize, uint vertexCount, const VertexLayout& layout, void*const dataPtr, DrawingMode drawingMode)
-	: Buffer(Array, vertexSize, vertexCount, dataPtr, drawingMode)
+VertexBuffer::VertexBuffer(uint vertexSize, uint vertexCount, const VertexLayout& layout, const void*const initialData, DrawingMode drawingMode)
+	: Buffer(Array, vertexSize, vertexCount, initialData, drawingMode)
 {
 	_layout = new VertexLayout(layout);
 }
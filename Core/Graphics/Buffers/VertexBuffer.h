@@ -20,7 +20,7 @@ namespace sedge
 		VertexLayout* _layout;
 
 	public:
-		VertexBuffer(uint vertexSize, uint vertexCount, const VertexLayout& layout, void*const dataPtr = nullptr, DrawingMode drawingMode = Static);
+		VertexBuffer(uint vertexSize, uint vertexCount, const VertexLayout& layout, const void*const initialData = nullptr, DrawingMode drawingMode = Static);
 		virtual ~VertexBuffer();
 
 		virtual void Bind() const override;
@@ -44,7 +44,10 @@ namespace sedge
 		static void DeleteTextures(const uint n, ID*const textures);
 		static void BindTexture(const TextureTarget target, const ID textureID);
 		static void LoadTex2DImage(const int level, const ColorCode internalFormat, const int width, const int height, const int border, const ColorCode format, const ValueType valueType, const void*const pixels);
+		static void LoadTex2DSubImage(const int level, const int x, const int y, const int width, const int height, const ColorCode format, const ValueType valueType, const void*const pixels);
 		static void LoadCubemapImage(const uint num, const int level, const ColorCode internalFormat, const int width, const int height, const int border, const ColorCode format, const ValueType valueType, const void*const pixels);
+		static void LoadCompressedTex2DImage(const int level, const CompressedFormat format, const int width, const int height, const uint size, const void*const data);
+		static void LoadCompressedCubemapImage(const uint num, const int level, const CompressedFormat format, const int width, const int height, const uint size, const void*const data);
 		static void GenerateMipmap(const TextureTarget target);
 		static void ActivateTexture(const uint num);
 		static void SetTextureWrapMode(const TextureTarget target, const TextureWrap wrap, const TextureWrapMode mode);
@@ -70,6 +73,19 @@ namespace sedge
 		static char* GetShaderInfoLog(const ID shaderID);
 		static void BindShaderProgram(const ID programID);
 		static void LoadShaderSource(const ID shaderID, const char*const source);
+		static const bool GetProgramLinkStatus(const ID programID);
+		static char* GetProgramInfoLog(const ID programID);
+		// Copies the values of the uniforms both programs have, the current program is restored afterwards.
+		static void CopyUniforms(const ID sourceProgramID, const ID targetProgramID);
+
+		// Program binaries, only usable if the driver supports at least one binary format.
+		static const int GetProgramBinaryFormatCount();
+		// Must be called before the program is linked.
+		static void SetProgramBinaryRetrievable(const ID programID);
+		static const uint GetProgramBinaryLength(const ID programID);
+		static void GetProgramBinary(const ID programID, const uint bufferSize, uint*const format, void*const binary);
+		// Returns false if the driver rejects the binary, the program then has to be built from source.
+		static const bool LoadProgramBinary(const ID programID, const uint format, const void*const binary, const uint size);
 		static const int GetUniformLocation(const ID programID, const char*const name);
 		static void SetUniformMatrix4(const int location, const int count, const bool transpose, const float*const values);
 		static void SetUniform1f(const int location, const float value);
@@ -27,6 +27,7 @@ namespace sedge
 		static const int GetTextureFilter(const TextureFilter filter);
 		static const int GetTextureFilterMode(const TextureFilterMode filterMode);
 		static const int GetColorCode(const ColorCode code);
+		static const int GetCompressedFormat(const CompressedFormat format);
 
 		static const int GetShaderTarget(const ShaderTarget target);
 
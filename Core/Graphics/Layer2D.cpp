@@ -31,7 +31,6 @@ Layer2D::Layer2D(ShaderProgram* shaderProgram, Renderer2D* renderer)
 
 Layer2D::~Layer2D()
 {
-	SafeDelete(_shaderProgram);
 	SafeDelete(_renderer);
 }
 
@@ -43,6 +42,12 @@ void Layer2D::Add(Renderable2D*const renderable)
 void Layer2D::Draw()
 {
 	_shaderProgram->Bind();
+
+	int textureUnits[Renderer2D::MaxTextureSlots];
+	for (uint i = 0; i < Renderer2D::MaxTextureSlots; i++)
+		textureUnits[i] = i;
+	_shaderProgram->SetUniform1iv("textureArray", Renderer2D::MaxTextureSlots, textureUnits);
+
 	_renderer->Begin();
 
 	for (const Renderable2D* renderable : _renderables)
@@ -54,8 +59,6 @@ void Layer2D::Draw()
 
 void Layer2D::SetShaderProgram(ShaderProgram*const shaderProgram)
 {
-	SafeDelete(_shaderProgram);
-
 	_shaderProgram = shaderProgram;
 }
 
@@ -22,7 +22,7 @@ namespace sedge
 	{
 	private:
 		std::vector<Renderable2D*> _renderables; // an array of elements in the layer
-		ShaderProgram* _shaderProgram; // a shader instance
+		ShaderProgram* _shaderProgram; // owned by the shader manager
 		Renderer2D* _renderer; // a renderer instance
 		Matrix4 _transformationMatrix; // transformation applied to the layer
 
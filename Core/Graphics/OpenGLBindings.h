@@ -114,11 +114,26 @@ void GraphicsAPI::LoadTex2DImage(const int level, const ColorCode internalFormat
 	glTexImage2D(GL_TEXTURE_2D, level, EnumConverter::GetColorCode(internalFormat), width, height, border, EnumConverter::GetColorCode(format), EnumConverter::GetValueType(valueType), pixels);
 }
 
+void GraphicsAPI::LoadTex2DSubImage(const int level, const int x, const int y, const int width, const int height, const ColorCode format, const ValueType valueType, const void*const pixels)
+{
+	glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, EnumConverter::GetColorCode(format), EnumConverter::GetValueType(valueType), pixels);
+}
+
 void GraphicsAPI::LoadCubemapImage(const uint num, const int level, const ColorCode internalFormat, const int width, const int height, const int border, const ColorCode format, const ValueType valueType, const void * const pixels)
 {
 	glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + num, level, EnumConverter::GetColorCode(internalFormat), width, height, border, EnumConverter::GetColorCode(format), EnumConverter::GetValueType(valueType), pixels);
 }
 
+void GraphicsAPI::LoadCompressedTex2DImage(const int level, const CompressedFormat format, const int width, const int height, const uint size, const void*const data)
+{
+	glCompressedTexImage2D(GL_TEXTURE_2D, level, EnumConverter::GetCompressedFormat(format), width, height, 0, size, data);
+}
+
+void GraphicsAPI::LoadCompressedCubemapImage(const uint num, const int level, const CompressedFormat format, const int width, const int height, const uint size, const void*const data)
+{
+	glCompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + num, level, EnumConverter::GetCompressedFormat(format), width, height, 0, size, data);
+}
+
 void GraphicsAPI::GenerateMipmap(const TextureTarget target)
 {
 	glGenerateMipmap(EnumConverter::GetTextureTarget(target));
@@ -236,6 +251,154 @@ void GraphicsAPI::LoadShaderSource(const ID shaderID, const char*const source)
 	glShaderSource(shaderID, 1, &source, NULL);
 }
 
+const bool GraphicsAPI::GetProgramLinkStatus(const ID programID)
+{
+	int programStatus;
+	glGetProgramiv(programID, GL_LINK_STATUS, &programStatus);
+
+	return programStatus == GL_TRUE;
+}
+
+char* GraphicsAPI::GetProgramInfoLog(const ID programID)
+{
+	GLint infoLogLength;
+	glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+	char* strInfoLog = new char[infoLogLength + 1];
+	glGetProgramInfoLog(programID, infoLogLength, 0, strInfoLog);
+	strInfoLog[infoLogLength] = '\0';
+
+	return strInfoLog;
+}
+
+void GraphicsAPI::CopyUniforms(const ID sourceProgramID, const ID targetProgramID)
+{
+	GLint currentProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+	glUseProgram(targetProgramID);
+
+	GLint uniformCount = 0;
+	glGetProgramiv(sourceProgramID, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+	for (GLint i = 0; i < uniformCount; i++)
+	{
+		GLchar name[256];
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(sourceProgramID, i, sizeof(name), &length, &size, &type, name);
+
+		// Arrays are reported as "name[0]", every element has a location of its own.
+		std::string baseName(name, length);
+		if (size > 1 && baseName.size() > 3 && baseName.compare(baseName.size() - 3, 3, "[0]") == 0)
+			baseName.resize(baseName.size() - 3);
+
+		for (GLint element = 0; element < size; element++)
+		{
+			const std::string elementName = size > 1 ? baseName + '[' + std::to_string(element) + ']' : baseName;
+			const GLint source = glGetUniformLocation(sourceProgramID, elementName.c_str());
+			const GLint target = glGetUniformLocation(targetProgramID, elementName.c_str());
+			// Uniform block members have no location.
+			if (source < 0 || target < 0)
+				continue;
+
+			GLfloat floats[16];
+			GLint ints[4];
+			switch (type)
+			{
+			case GL_FLOAT:
+				glGetUniformfv(sourceProgramID, source, floats);
+				glUniform1fv(target, 1, floats);
+				break;
+			case GL_FLOAT_VEC2:
+				glGetUniformfv(sourceProgramID, source, floats);
+				glUniform2fv(target, 1, floats);
+				break;
+			case GL_FLOAT_VEC3:
+				glGetUniformfv(sourceProgramID, source, floats);
+				glUniform3fv(target, 1, floats);
+				break;
+			case GL_FLOAT_VEC4:
+				glGetUniformfv(sourceProgramID, source, floats);
+				glUniform4fv(target, 1, floats);
+				break;
+			case GL_FLOAT_MAT2:
+				glGetUniformfv(sourceProgramID, source, floats);
+				glUniformMatrix2fv(target, 1, GL_FALSE, floats);
+				break;
+			case GL_FLOAT_MAT3:
+				glGetUniformfv(sourceProgramID, source, floats);
+				glUniformMatrix3fv(target, 1, GL_FALSE, floats);
+				break;
+			case GL_FLOAT_MAT4:
+				glGetUniformfv(sourceProgramID, source, floats);
+				glUniformMatrix4fv(target, 1, GL_FALSE, floats);
+				break;
+			case GL_INT_VEC2:
+			case GL_BOOL_VEC2:
+				glGetUniformiv(sourceProgramID, source, ints);
+				glUniform2iv(target, 1, ints);
+				break;
+			case GL_INT_VEC3:
+			case GL_BOOL_VEC3:
+				glGetUniformiv(sourceProgramID, source, ints);
+				glUniform3iv(target, 1, ints);
+				break;
+			case GL_INT_VEC4:
+			case GL_BOOL_VEC4:
+				glGetUniformiv(sourceProgramID, source, ints);
+				glUniform4iv(target, 1, ints);
+				break;
+			// Scalar ints and bools and all sampler types.
+			default:
+				glGetUniformiv(sourceProgramID, source, ints);
+				glUniform1iv(target, 1, ints);
+				break;
+			}
+		}
+	}
+
+	glUseProgram(currentProgram);
+}
+
+const int GraphicsAPI::GetProgramBinaryFormatCount()
+{
+	if (glGetProgramBinary == nullptr || glProgramBinary == nullptr)
+		return 0;
+
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+	return formatCount;
+}
+
+void GraphicsAPI::SetProgramBinaryRetrievable(const ID programID)
+{
+	glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+const uint GraphicsAPI::GetProgramBinaryLength(const ID programID)
+{
+	GLint length = 0;
+	glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	return length;
+}
+
+void GraphicsAPI::GetProgramBinary(const ID programID, const uint bufferSize, uint*const format, void*const binary)
+{
+	GLenum binaryFormat = 0;
+	glGetProgramBinary(programID, bufferSize, NULL, &binaryFormat, binary);
+	*format = binaryFormat;
+}
+
+const bool GraphicsAPI::LoadProgramBinary(const ID programID, const uint format, const void*const binary, const uint size)
+{
+	glProgramBinary(programID, format, binary, size);
+
+	return GetProgramLinkStatus(programID);
+}
+
 const int GraphicsAPI::GetUniformLocation(const ID programID, const char*const name)
 {
 	return glGetUniformLocation(programID, name);
@@ -557,6 +720,21 @@ const int EnumConverter::GetColorCode(const ColorCode code)
 	}
 }
 
+const int EnumConverter::GetCompressedFormat(const CompressedFormat format)
+{
+	switch (format)
+	{
+	case CompressedBC1:
+		return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case CompressedBC3:
+		return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case CompressedBC7:
+		return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default:
+		return 0;
+	}
+}
+
 const int EnumConverter::GetPrimitiveType(const PrimitiveType type)
 {
 	switch (type)
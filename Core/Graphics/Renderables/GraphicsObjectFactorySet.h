@@ -1,11 +1,13 @@
 #pragma once
 
 #include "Graphics/Renderables/MeshFactory.h"
+#include "Graphics/Renderables/ModelFactory.h"
 
 namespace sedge
 {
 	struct GraphicsObjectFactorySet
 	{
 		MeshFactory MeshFactory;
+		ModelFactory ModelFactory;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+/*
+===========================================================================
+Label.cpp
+
+Implements the Label class.
+===========================================================================
+*/
+
+#include "Label.h"
+#include "Graphics/Text/Font.h"
+#include "Graphics/Renderers/Renderer2D.h"
+
+using namespace sedge;
+
+Label::Label(const std::string& text, Font*const font, const Vector2& position, const float zIndex, const float lineHeight, const Color& color)
+	: Renderable2D(Vector3(position.x, position.y, zIndex), Size2D(0, 0), color), _font(font), _scale(lineHeight / font->GetLineHeight())
+{
+	SetText(text);
+}
+
+void Label::SetText(const std::string& text)
+{
+	_text = text;
+
+	const TextLayout& layout = _font->GetLayout(_text);
+	Size = Size2D(layout.Width * _scale, layout.Height * _scale);
+}
+
+void Label::Submit(Renderer2D*const renderer) const
+{
+	renderer->RenderText(_text, _font, Position, _scale, Col);
+}
\ No newline at end of file
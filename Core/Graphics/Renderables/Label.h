@@ -0,0 +1,40 @@
+/*
+===========================================================================
+Label.h
+
+A 2D renderable showing a line or several lines of text in one font.
+The position is the top left corner of the text, like for sprites.
+===========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include "Renderable2D.h"
+
+namespace sedge
+{
+	class Font;
+
+	class Label : public Renderable2D
+	{
+	private:
+		std::string _text;
+		Font* _font;
+		float _scale; // layer units per font pixel
+
+	private:
+		Label(const std::string& text, Font*const font, const Vector2& position, const float zIndex, const float lineHeight, const Color& color);
+
+	public:
+		inline const std::string& GetText() const { return _text; }
+		inline Font* GetFont() const { return _font; }
+
+		void SetText(const std::string& text);
+
+		virtual void Draw() const override {}
+		virtual void Submit(Renderer2D*const renderer) const override;
+
+		friend class SpriteFactory;
+	};
+}
\ No newline at end of file
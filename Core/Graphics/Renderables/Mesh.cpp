@@ -16,31 +16,40 @@ Implemlents the Mesh class
 #include "Graphics/AssetManagers/TextureManager.h"
 #include "System/Logger.h"
 #include "Graphics/GraphicsAPI.h"
+#include <algorithm>
+#include <cmath>
 
 using namespace std;
 using namespace sedge;
 
 Mesh::Mesh(const char*const name,
-	vector<VertexData> vertices,
-	vector<uint> elements,
-	vector<Texture2D*> diffTextures,
-	vector<Texture2D*> specTextures)
-	: Name(name), DiffTextures(diffTextures), SpecTextures(specTextures)
+	const VertexData*const vertices, const uint vertexCount,
+	const void*const elements, const uint elementCount, const ValueType elementType,
+	const BoundingBox& bounds,
+	const MeshLodRange*const lods, const uint lodCount,
+	const vector<Texture2DRef>& diffTextures,
+	const vector<Texture2DRef>& specTextures)
+	: Name(name), DiffTextures(diffTextures), SpecTextures(specTextures), Bounds(bounds), CurrentLod(0)
 {
-	VBO = new VertexBuffer(sizeof(VertexData), vertices.size(), VertexLayout::GetDefaultMeshVertexLayout(), vertices.data());
-	IBO = new IndexBuffer(elements.size(), elements.data());
+	if (lodCount > 0)
+		Lods.assign(lods, lods + lodCount);
+	else
+	{
+		MeshLodRange lod = { 0, elementCount, 0.0f };
+		Lods.push_back(lod);
+	}
+
+	VBO = new VertexBuffer(sizeof(VertexData), vertexCount, VertexLayout::GetDefaultMeshVertexLayout(), vertices);
+	if (elementType == UnsginedShort)
+		IBO = new IndexBuffer(elementCount, (const ushort*)elements);
+	else
+		IBO = new IndexBuffer(elementCount, (const uint*)elements);
 }
 
 Mesh::~Mesh()
 {
 	SafeDelete(VBO);
 	SafeDelete(IBO);
-
-	for (auto texture : DiffTextures)
-		SafeDelete(texture);
-
-	for (auto texture : SpecTextures)
-		SafeDelete(texture);
 }
 
 void Mesh::Draw() const
@@ -50,7 +59,7 @@ void Mesh::Draw() const
 
 	for (uint i = 0; i < DiffTextures.size(); i++)
 	{
-		const auto texture = DiffTextures[i];
+		const auto texture = DiffTextures[i].Get();
 
 		Texture2D::ActivateTexture(i);
 		texture->Bind();
@@ -62,14 +71,57 @@ void Mesh::Draw() const
 	const int specOffset = 1; // TODO: remove this.
 	for (uint i = 0; i < SpecTextures.size(); i++)
 	{
-		const auto texture = SpecTextures[i];
+		const auto texture = SpecTextures[i].Get();
 
 		Texture2D::ActivateTexture(i + specOffset);
 		texture->Bind();
 	}
 
-	Renderable3D::Draw();
+	const MeshLodRange& lod = Lods[CurrentLod];
+	VBO->Bind();
+	IBO->Bind();
+	GraphicsAPI::DrawElements(Triangles, lod.IndexCount, IBO->GetIndexType(), (const void*)((size_t)lod.FirstIndex * IBO->GetElementSize()));
 
 	for (uint i = 0; i < SpecTextures.size(); i++)
 		SpecTextures[i]->Unbind();
+}
+
+void Mesh::SelectLod(const LodView& view, const Matrix4& modelMatrix)
+{
+	CurrentLod = 0;
+	if (Lods.size() < 2)
+		return;
+
+	const float* m = modelMatrix.data;
+	const Vector3 center = Bounds.GetCenter();
+	const Vector3 extents = Bounds.GetExtents();
+	const Vector3 worldCenter(
+		m[0] * center.x + m[4] * center.y + m[8] * center.z + m[12],
+		m[1] * center.x + m[5] * center.y + m[9] * center.z + m[13],
+		m[2] * center.x + m[6] * center.y + m[10] * center.z + m[14]);
+
+	// Non-uniform scales are covered by the largest axis.
+	const float scale = sqrtf(max(max(
+		m[0] * m[0] + m[1] * m[1] + m[2] * m[2],
+		m[4] * m[4] + m[5] * m[5] + m[6] * m[6]),
+		m[8] * m[8] + m[9] * m[9] + m[10] * m[10]));
+
+	const float radius = sqrtf(extents.x * extents.x + extents.y * extents.y + extents.z * extents.z) * scale;
+	const float dx = worldCenter.x - view.CameraPosition.x;
+	const float dy = worldCenter.y - view.CameraPosition.y;
+	const float dz = worldCenter.z - view.CameraPosition.z;
+	const float distance = sqrtf(dx * dx + dy * dy + dz * dz) - radius;
+
+	if (distance <= 0.0f)
+		return;
+
+	const float pixelsPerUnit = view.PixelScale * scale / distance;
+	for (uint i = Lods.size() - 1; i > 0; i--)
+	{
+		if (Lods[i].Error * pixelsPerUnit <= view.MaxScreenError)
+		{
+			CurrentLod = i;
+			return;
+		}
+	}
 }
\ No newline at end of file
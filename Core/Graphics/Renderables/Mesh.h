@@ -11,32 +11,48 @@ Declares the Mesh class
 #include <string>
 #include <vector>
 #include "Renderable3D.h"
+#include "Math/BoundingBox.h"
+#include "Graphics/DrawingEnums.h"
+#include "ModelData.h"
+#include "Graphics/AssetManagers/TextureManager.h"
 
 namespace sedge
 {
 	struct VertexData;
 	class VertexBuffer;
 	class IndexBuffer;
-	class Texture2D;
 
 	class Mesh : public Renderable3D
 	{
 	protected:
 		std::string Name;
-		std::vector<Texture2D*> DiffTextures;
-		std::vector<Texture2D*> SpecTextures;
+		// The textures belong to the texture manager, the references only keep them resident.
+		std::vector<Texture2DRef> DiffTextures;
+		std::vector<Texture2DRef> SpecTextures;
+		BoundingBox Bounds;
+		std::vector<MeshLodRange> Lods; // the full mesh first
+		uint CurrentLod;
 
 	private:
 		Mesh(const char*const name,
-			std::vector<VertexData> vertices,
-			std::vector<uint> elements,
-			std::vector<Texture2D*> diffTextures = std::vector<Texture2D*>(),
-			std::vector<Texture2D*> specTextures = std::vector<Texture2D*>());
+			const VertexData*const vertices, const uint vertexCount,
+			const void*const elements, const uint elementCount, const ValueType elementType,
+			const BoundingBox& bounds,
+			const MeshLodRange*const lods, const uint lodCount,
+			const std::vector<Texture2DRef>& diffTextures,
+			const std::vector<Texture2DRef>& specTextures);
 
 	public:
 		~Mesh();
 
 		const char*const GetName() const { return Name.c_str(); }
+		inline const BoundingBox& GetBounds() const { return Bounds; }
+		inline uint GetLodCount() const { return Lods.size(); }
+		inline uint GetCurrentLod() const { return CurrentLod; }
+
+		// Picks the coarsest level whose error, projected from the closest point of the
+		// bounding sphere, stays within the allowed screen error.
+		virtual void SelectLod(const LodView& view, const Matrix4& modelMatrix) override;
 
 		virtual void Draw() const override;
 
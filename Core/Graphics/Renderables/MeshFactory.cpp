@@ -4,15 +4,90 @@
 #include "Graphics/Structures/VertexData.h"
 #include "System/MemoryManagement.h"
 #include "Graphics/Textures/Texture2D.h"
+#include "Math/BoundingBox.h"
+#include "ModelData.h"
 
 using namespace std;
 using namespace sedge;
 
 Mesh*const MeshFactory::CreateMesh(const char*const name,
-	vector<VertexData> vertices,
-	vector<uint> elements,
-	vector<Texture2D*> diffTextures,
-	vector<Texture2D*> specTextures)
+	const vector<VertexData>& vertices,
+	const vector<uint>& elements,
+	const vector<Texture2DRef>& diffTextures,
+	const vector<Texture2DRef>& specTextures)
 {
-	return new Mesh(name, vertices, elements, diffTextures, specTextures);
+	const vector<const vector<uint>*> lodElements(1, &elements);
+
+	return CreateMesh(name, vertices, lodElements, vector<float>(1, 0.0f), diffTextures, specTextures);
+}
+
+Mesh*const MeshFactory::CreateMesh(const MeshData& data,
+	const vector<Texture2DRef>& diffTextures,
+	const vector<Texture2DRef>& specTextures)
+{
+	vector<const vector<uint>*> lodElements(1, &data.Indices);
+	vector<float> lodErrors(1, 0.0f);
+	for (const MeshLod& lod : data.Lods)
+	{
+		lodElements.push_back(&lod.Indices);
+		lodErrors.push_back(lod.Error);
+	}
+
+	return CreateMesh(data.Name.c_str(), data.Vertices, lodElements, lodErrors, diffTextures, specTextures);
+}
+
+Mesh*const MeshFactory::CreateMesh(const char*const name,
+	const VertexData*const vertices, const uint vertexCount,
+	const void*const elements, const uint elementCount, const ValueType elementType,
+	const BoundingBox& bounds,
+	const MeshLodRange*const lods, const uint lodCount,
+	const vector<Texture2DRef>& diffTextures,
+	const vector<Texture2DRef>& specTextures)
+{
+	return new Mesh(name, vertices, vertexCount, elements, elementCount, elementType, bounds, lods, lodCount, diffTextures, specTextures);
+}
+
+Mesh*const MeshFactory::CreateMesh(const char*const name,
+	const vector<VertexData>& vertices,
+	const vector<const vector<uint>*>& lodElements,
+	const vector<float>& lodErrors,
+	const vector<Texture2DRef>& diffTextures,
+	const vector<Texture2DRef>& specTextures)
+{
+	BoundingBox bounds;
+	if (!vertices.empty())
+		bounds = BoundingBox(vertices[0].Position, vertices[0].Position);
+
+	for (const VertexData& vertex : vertices)
+		bounds.Merge(BoundingBox(vertex.Position, vertex.Position));
+
+	// All levels share one index buffer.
+	vector<MeshLodRange> lods(lodElements.size());
+	uint elementCount = 0;
+	for (uint i = 0; i < lodElements.size(); i++)
+	{
+		lods[i].FirstIndex = elementCount;
+		lods[i].IndexCount = lodElements[i]->size();
+		lods[i].Error = lodErrors[i];
+		elementCount += lods[i].IndexCount;
+	}
+
+	if (vertices.size() > 65536)
+	{
+		vector<uint> allElements;
+		allElements.reserve(elementCount);
+		for (const vector<uint>* elements : lodElements)
+			allElements.insert(allElements.end(), elements->begin(), elements->end());
+
+		return new Mesh(name, vertices.data(), vertices.size(), allElements.data(), elementCount, UnsignedInt,
+			bounds, lods.data(), lods.size(), diffTextures, specTextures);
+	}
+
+	vector<ushort> shortElements;
+	shortElements.reserve(elementCount);
+	for (const vector<uint>* elements : lodElements)
+		shortElements.insert(shortElements.end(), elements->begin(), elements->end());
+
+	return new Mesh(name, vertices.data(), vertices.size(), shortElements.data(), elementCount, UnsginedShort,
+		bounds, lods.data(), lods.size(), diffTextures, specTextures);
 }
\ No newline at end of file
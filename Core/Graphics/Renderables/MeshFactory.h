@@ -2,20 +2,48 @@
 
 #include <vector>
 #include <CustomTypes.h>
+#include "Graphics/AssetManagers/TextureManager.h"
+#include "Graphics/DrawingEnums.h"
 
 namespace sedge
 {
 	class Mesh;
-	class Texture2D;
 	struct VertexData;
+	struct BoundingBox;
+	struct MeshData;
+	struct MeshLodRange;
 
 	class MeshFactory
 	{
 	public:
+		// Meshes with up to 65536 vertices get 16-bit indices.
 		static Mesh*const CreateMesh(const char*const name,
-			std::vector<VertexData> vertices,
-			std::vector<uint> elements,
-			std::vector<Texture2D*> diffTextures = std::vector<Texture2D*>(),
-			std::vector<Texture2D*> specTextures = std::vector<Texture2D*>());
+			const std::vector<VertexData>& vertices,
+			const std::vector<uint>& elements,
+			const std::vector<Texture2DRef>& diffTextures = std::vector<Texture2DRef>(),
+			const std::vector<Texture2DRef>& specTextures = std::vector<Texture2DRef>());
+
+		// The levels of detail of the mesh data share its buffers.
+		static Mesh*const CreateMesh(const MeshData& data,
+			const std::vector<Texture2DRef>& diffTextures = std::vector<Texture2DRef>(),
+			const std::vector<Texture2DRef>& specTextures = std::vector<Texture2DRef>());
+
+		// Uploads the data straight from where it lies, e.g. a mapped mesh file. Nothing is copied or kept.
+		// Without level of detail ranges all the elements form a single level.
+		static Mesh*const CreateMesh(const char*const name,
+			const VertexData*const vertices, const uint vertexCount,
+			const void*const elements, const uint elementCount, const ValueType elementType,
+			const BoundingBox& bounds,
+			const MeshLodRange*const lods = nullptr, const uint lodCount = 0,
+			const std::vector<Texture2DRef>& diffTextures = std::vector<Texture2DRef>(),
+			const std::vector<Texture2DRef>& specTextures = std::vector<Texture2DRef>());
+
+	private:
+		static Mesh*const CreateMesh(const char*const name,
+			const std::vector<VertexData>& vertices,
+			const std::vector<const std::vector<uint>*>& lodElements,
+			const std::vector<float>& lodErrors,
+			const std::vector<Texture2DRef>& diffTextures,
+			const std::vector<Texture2DRef>& specTextures);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,324 @@
+/*
+===========================================================================
+MeshFile.cpp
+
+Implements the MeshFile class.
+===========================================================================
+*/
+
+#include "MeshFile.h"
+#include "ModelData.h"
+#include "Graphics/Structures/VertexData.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+using namespace sedge;
+
+static const char MeshFileMagic[4] = { 'S', 'M', 'S', 'H' };
+static const uint MeshFileVersion = 3;
+static const uint BlobAlignment = 16;
+
+struct MeshFile::Header
+{
+	char Magic[4];
+	uint Version;
+	unsigned long long SourceHash;
+	uint VertexSize; // sizeof(VertexData) when the file was cooked, the blob is unusable if the layout changed
+	uint SubmeshCount;
+	uint VertexCount;
+	uint LodCount; // of all submeshes together
+	BoundingBox Bounds;
+	unsigned long long VertexOffset;
+	unsigned long long IndexOffset;
+	unsigned long long IndexSize; // in bytes
+	unsigned long long StringOffset;
+	unsigned long long StringSize;
+};
+
+struct MeshFile::SubmeshEntry
+{
+	uint FirstVertex;
+	uint VertexCount;
+	uint IndexOffset; // in bytes, from the start of the index blob
+	uint IndexCount; // of all levels of detail
+	uint IndexSize; // 2 or 4
+	uint FirstLod;
+	uint LodCount; // including the full mesh
+	BoundingBox Bounds;
+	uint NameOffset; // into the string table
+	uint DiffuseOffset;
+	uint SpecularOffset;
+};
+
+static unsigned long long Align(const unsigned long long offset);
+static BoundingBox GetMeshBounds(const MeshData& mesh);
+static uint AddString(const std::string& value, std::string& strings);
+static uint GetIndexSize(const uint vertexCount);
+static void WriteIndices(std::ofstream& stream, const std::vector<uint>& indices, const uint indexSize, std::vector<ushort>& shortIndices);
+
+MeshFile::MeshFile()
+	: _header(nullptr), _submeshes(nullptr), _lods(nullptr)
+{
+}
+
+bool MeshFile::Open(const char*const path, const unsigned long long sourceHash)
+{
+	Close();
+
+	if (!_file.Open(path))
+		return false;
+
+	const byte* bytes = _file.GetData();
+	const unsigned long long size = _file.GetSize();
+	const Header* header = (const Header*)bytes;
+
+	bool valid = size >= sizeof(Header)
+		&& memcmp(header->Magic, MeshFileMagic, sizeof(MeshFileMagic)) == 0
+		&& header->Version == MeshFileVersion
+		&& header->VertexSize == sizeof(VertexData)
+		&& (sourceHash == 0 || header->SourceHash == sourceHash)
+		&& sizeof(Header) + (unsigned long long)header->SubmeshCount * sizeof(SubmeshEntry) + (unsigned long long)header->LodCount * sizeof(MeshLodRange) <= size
+		&& header->VertexOffset + (unsigned long long)header->VertexCount * sizeof(VertexData) <= size
+		&& header->IndexOffset + header->IndexSize <= size
+		&& header->StringOffset + header->StringSize <= size
+		&& header->StringSize > 0 && bytes[header->StringOffset + header->StringSize - 1] == 0;
+
+	if (!valid)
+	{
+		_file.Close();
+		return false;
+	}
+
+	// Only the directory is checked, the blobs are not touched until they are uploaded.
+	const SubmeshEntry* submeshes = (const SubmeshEntry*)(bytes + sizeof(Header));
+	const MeshLodRange* lods = (const MeshLodRange*)(submeshes + header->SubmeshCount);
+	for (uint i = 0; valid && i < header->SubmeshCount; i++)
+	{
+		const SubmeshEntry& entry = submeshes[i];
+		valid = (unsigned long long)entry.FirstVertex + entry.VertexCount <= header->VertexCount
+			&& entry.IndexSize == GetIndexSize(entry.VertexCount)
+			&& entry.IndexOffset % entry.IndexSize == 0
+			&& (unsigned long long)entry.IndexOffset + (unsigned long long)entry.IndexCount * entry.IndexSize <= header->IndexSize
+			&& entry.NameOffset < header->StringSize
+			&& entry.DiffuseOffset < header->StringSize
+			&& entry.SpecularOffset < header->StringSize
+			&& entry.LodCount > 0
+			&& (unsigned long long)entry.FirstLod + entry.LodCount <= header->LodCount;
+
+		for (uint j = 0; valid && j < entry.LodCount; j++)
+			valid = (unsigned long long)lods[entry.FirstLod + j].FirstIndex + lods[entry.FirstLod + j].IndexCount <= entry.IndexCount;
+	}
+
+	if (!valid)
+	{
+		_file.Close();
+		return false;
+	}
+
+	_header = header;
+	_submeshes = submeshes;
+	_lods = lods;
+
+	return true;
+}
+
+void MeshFile::Close()
+{
+	_file.Close();
+	_header = nullptr;
+	_submeshes = nullptr;
+	_lods = nullptr;
+}
+
+uint MeshFile::GetSubmeshCount() const
+{
+	return _header != nullptr ? _header->SubmeshCount : 0;
+}
+
+Submesh MeshFile::GetSubmesh(const uint index) const
+{
+	const byte* bytes = _file.GetData();
+	const SubmeshEntry& entry = _submeshes[index];
+	const char* strings = (const char*)(bytes + _header->StringOffset);
+
+	Submesh submesh;
+	submesh.Name = strings + entry.NameOffset;
+	submesh.DiffuseTexture = strings + entry.DiffuseOffset;
+	submesh.SpecularTexture = strings + entry.SpecularOffset;
+	submesh.Vertices = (const VertexData*)(bytes + _header->VertexOffset) + entry.FirstVertex;
+	submesh.VertexCount = entry.VertexCount;
+	submesh.Indices = bytes + _header->IndexOffset + entry.IndexOffset;
+	submesh.IndexCount = entry.IndexCount;
+	submesh.IndexType = entry.IndexSize == sizeof(ushort) ? UnsginedShort : UnsignedInt;
+	submesh.Lods = _lods + entry.FirstLod;
+	submesh.LodCount = entry.LodCount;
+	submesh.Bounds = entry.Bounds;
+
+	return submesh;
+}
+
+BoundingBox MeshFile::GetBounds() const
+{
+	return _header != nullptr ? _header->Bounds : BoundingBox();
+}
+
+unsigned long long MeshFile::GetSourceHash() const
+{
+	return _header != nullptr ? _header->SourceHash : 0;
+}
+
+std::string MeshFile::GetCachePath(const char*const sourcePath)
+{
+	return std::string(sourcePath) + ".smesh";
+}
+
+bool MeshFile::IsMeshFile(const char*const path)
+{
+	const size_t length = strlen(path);
+
+	return length >= 6 && strcmp(path + length - 6, ".smesh") == 0;
+}
+
+bool MeshFile::Write(const char*const path, const unsigned long long sourceHash, const ModelData& model)
+{
+	std::ofstream stream(FileSystem::GetNativePath(path), std::ios::binary);
+	if (!stream)
+		return false;
+
+	Header header;
+	memcpy(header.Magic, MeshFileMagic, sizeof(MeshFileMagic));
+	header.Version = MeshFileVersion;
+	header.SourceHash = sourceHash;
+	header.VertexSize = sizeof(VertexData);
+	header.SubmeshCount = model.Meshes.size();
+	header.VertexCount = 0;
+	header.LodCount = 0;
+	header.IndexSize = 0;
+
+	// Offset 0 of the string table is the empty string.
+	std::string strings(1, '\0');
+	std::vector<SubmeshEntry> entries(header.SubmeshCount);
+	std::vector<MeshLodRange> lods;
+
+	for (uint i = 0; i < header.SubmeshCount; i++)
+	{
+		const MeshData& mesh = model.Meshes[i];
+		SubmeshEntry& entry = entries[i];
+
+		entry.FirstVertex = header.VertexCount;
+		entry.VertexCount = mesh.Vertices.size();
+		entry.FirstLod = lods.size();
+		entry.LodCount = 1 + mesh.Lods.size();
+
+		MeshLodRange lod = { 0, (uint)mesh.Indices.size(), 0.0f };
+		lods.push_back(lod);
+		for (const MeshLod& meshLod : mesh.Lods)
+		{
+			lod.FirstIndex += lod.IndexCount;
+			lod.IndexCount = meshLod.Indices.size();
+			lod.Error = meshLod.Error;
+			lods.push_back(lod);
+		}
+
+		entry.IndexCount = lod.FirstIndex + lod.IndexCount;
+		entry.IndexSize = GetIndexSize(entry.VertexCount);
+		// Every submesh's indices are aligned to their size.
+		header.IndexSize = (header.IndexSize + entry.IndexSize - 1) / entry.IndexSize * entry.IndexSize;
+		entry.IndexOffset = header.IndexSize;
+		entry.Bounds = GetMeshBounds(mesh);
+		entry.NameOffset = AddString(mesh.Name, strings);
+		entry.DiffuseOffset = AddString(mesh.DiffuseTexture, strings);
+		entry.SpecularOffset = AddString(mesh.SpecularTexture, strings);
+
+		if (i == 0)
+			header.Bounds = entry.Bounds;
+		else
+			header.Bounds.Merge(entry.Bounds);
+
+		header.VertexCount += entry.VertexCount;
+		header.IndexSize += (unsigned long long)entry.IndexCount * entry.IndexSize;
+	}
+
+	header.LodCount = lods.size();
+	const unsigned long long directorySize = sizeof(Header) + entries.size() * sizeof(SubmeshEntry) + lods.size() * sizeof(MeshLodRange);
+
+	header.VertexOffset = Align(directorySize);
+	header.IndexOffset = Align(header.VertexOffset + (unsigned long long)header.VertexCount * sizeof(VertexData));
+	header.StringOffset = header.IndexOffset + header.IndexSize;
+	header.StringSize = strings.size();
+
+	const char padding[BlobAlignment] = { };
+
+	stream.write((const char*)&header, sizeof(header));
+	stream.write((const char*)entries.data(), entries.size() * sizeof(SubmeshEntry));
+	stream.write((const char*)lods.data(), lods.size() * sizeof(MeshLodRange));
+	stream.write(padding, header.VertexOffset - directorySize);
+
+	for (const MeshData& mesh : model.Meshes)
+		stream.write((const char*)mesh.Vertices.data(), mesh.Vertices.size() * sizeof(VertexData));
+
+	stream.write(padding, header.IndexOffset - header.VertexOffset - (unsigned long long)header.VertexCount * sizeof(VertexData));
+
+	std::vector<ushort> shortIndices;
+	unsigned long long indexOffset = 0;
+	for (uint i = 0; i < header.SubmeshCount; i++)
+	{
+		const MeshData& mesh = model.Meshes[i];
+		stream.write(padding, entries[i].IndexOffset - indexOffset);
+
+		WriteIndices(stream, mesh.Indices, entries[i].IndexSize, shortIndices);
+		for (const MeshLod& lod : mesh.Lods)
+			WriteIndices(stream, lod.Indices, entries[i].IndexSize, shortIndices);
+
+		indexOffset = entries[i].IndexOffset + (unsigned long long)entries[i].IndexCount * entries[i].IndexSize;
+	}
+
+	stream.write(strings.data(), strings.size());
+
+	return !stream.fail();
+}
+
+unsigned long long Align(const unsigned long long offset)
+{
+	return (offset + BlobAlignment - 1) / BlobAlignment * BlobAlignment;
+}
+
+BoundingBox GetMeshBounds(const MeshData& mesh)
+{
+	if (mesh.Vertices.empty())
+		return BoundingBox();
+
+	BoundingBox bounds(mesh.Vertices[0].Position, mesh.Vertices[0].Position);
+	for (const VertexData& vertex : mesh.Vertices)
+		bounds.Merge(BoundingBox(vertex.Position, vertex.Position));
+
+	return bounds;
+}
+
+uint AddString(const std::string& value, std::string& strings)
+{
+	if (value.empty())
+		return 0;
+
+	const uint offset = strings.size();
+	strings.append(value.c_str(), value.size() + 1);
+
+	return offset;
+}
+
+uint GetIndexSize(const uint vertexCount)
+{
+	return vertexCount <= 65536 ? sizeof(ushort) : sizeof(uint);
+}
+
+void WriteIndices(std::ofstream& stream, const std::vector<uint>& indices, const uint indexSize, std::vector<ushort>& shortIndices)
+{
+	if (indexSize == sizeof(ushort))
+	{
+		shortIndices.assign(indices.begin(), indices.end());
+		stream.write((const char*)shortIndices.data(), shortIndices.size() * sizeof(ushort));
+	}
+	else
+		stream.write((const char*)indices.data(), indices.size() * sizeof(uint));
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+===========================================================================
+MeshFile.h
+
+The engine's cooked mesh format. A mesh file is opened as a view and its
+vertex and index blobs are handed to the vertex and index buffers as
+they lie in the file, so loading a model needs no parsing and no
+intermediate copies. Models imported from other formats are cooked
+into a file next to the source and reloaded from it while the source
+is unchanged.
+
+Layout of a *.smesh file:
+	header (source hash, vertex size, counts, bounds, blob offsets)
+	SubmeshEntry submeshes[SubmeshCount]
+	MeshLodRange lods[LodCount], the levels of detail of every submesh in order
+	VertexData vertices[VertexCount], every submesh's vertices in order
+	indices of every submesh, relative to its first vertex, all its levels
+	of detail one after another, 16-bit for submeshes with up to 65536
+	vertices and 32-bit otherwise
+	names and texture paths, null-terminated
+===========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <CustomTypes.h>
+#include "System/FileSystem.h"
+#include "Math/BoundingBox.h"
+#include "Graphics/DrawingEnums.h"
+#include "ModelData.h"
+
+namespace sedge
+{
+	struct VertexData;
+
+	// Points into the mapped file, valid while the file stays open.
+	struct Submesh
+	{
+		const char* Name;
+		const char* DiffuseTexture; // empty if the material has none
+		const char* SpecularTexture;
+		const VertexData* Vertices;
+		uint VertexCount;
+		const void* Indices;
+		uint IndexCount; // of all levels of detail
+		ValueType IndexType;
+		const MeshLodRange* Lods; // the full mesh first
+		uint LodCount;
+		BoundingBox Bounds;
+	};
+
+	class MeshFile
+	{
+	private:
+		struct Header;
+		struct SubmeshEntry;
+
+		FileView _file;
+		const Header* _header;
+		const SubmeshEntry* _submeshes;
+		const MeshLodRange* _lods;
+
+	public:
+		MeshFile();
+
+		// Fails without logging if the file is missing, malformed or, unless sourceHash is 0,
+		// was cooked from another version of the source.
+		bool Open(const char*const path, const unsigned long long sourceHash = 0);
+		void Close();
+
+		inline bool IsOpen() const { return _header != nullptr; }
+
+		uint GetSubmeshCount() const;
+		Submesh GetSubmesh(const uint index) const;
+		BoundingBox GetBounds() const;
+		unsigned long long GetSourceHash() const;
+
+		static std::string GetCachePath(const char*const sourcePath);
+		static bool IsMeshFile(const char*const path);
+
+		static bool Write(const char*const path, const unsigned long long sourceHash, const ModelData& model);
+
+	private:
+		MeshFile(const MeshFile& tRef) = delete;
+		MeshFile& operator = (const MeshFile& tRef) = delete;
+	};
+}
\ No newline at end of file
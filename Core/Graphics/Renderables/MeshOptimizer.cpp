@@ -0,0 +1,422 @@
+/*
+===========================================================================
+MeshOptimizer.cpp
+
+Implements the MeshOptimizer class.
+The vertex cache pass follows Tom Forsyth's "Linear-Speed Vertex Cache
+Optimisation", the overdraw pass the cluster sorting of Sander, Nehab and
+Barczak's "Fast Triangle Reordering for Vertex Locality and Reduced
+Overdraw".
+===========================================================================
+*/
+
+#include "MeshOptimizer.h"
+#include "ModelData.h"
+#include "Graphics/Structures/VertexData.h"
+#include "System/ThreadPool.h"
+#include "System/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace sedge;
+
+// The cache the Forsyth scores model, an LRU cache larger than any real one works for all of them.
+static const uint ScoringCacheSize = 32;
+static const uint MaxValence = 32; // valence boosts are tabulated up to this many remaining triangles
+static const uint OverdrawCacheSize = 16;
+static const uint InvalidIndex = 0xffffffff;
+
+static const struct VertexScoreTables
+{
+	float Cache[ScoringCacheSize];
+	float Valence[MaxValence + 1];
+
+	VertexScoreTables()
+	{
+		// The last triangle's vertices get a fixed score, so that the next triangle does not simply reuse them all.
+		for (uint i = 0; i < ScoringCacheSize; i++)
+			Cache[i] = i < 3 ? 0.75f : powf(1.0f - (float)(i - 3) / (ScoringCacheSize - 3), 1.5f);
+
+		// Vertices with few triangles left are finished first, so they leave no stragglers behind.
+		Valence[0] = 0.0f;
+		for (uint i = 1; i <= MaxValence; i++)
+			Valence[i] = 2.0f / sqrtf((float)i);
+	}
+} VertexScores;
+
+struct TriangleCluster
+{
+	uint Begin; // first triangle
+	uint End;
+	float SortKey;
+};
+
+static float GetVertexScore(const int cachePosition, const uint remainingTriangles);
+// Returns the number of misses of the triangle. A vertex is cached if it missed at most cacheSize misses ago.
+static uint SimulateTriangle(const uint*const triangle, std::vector<uint>& missTimes, uint& time, const uint cacheSize);
+
+void MeshOptimizer::Optimize(ModelData& model)
+{
+	std::vector<VertexCacheStatistics> before(model.Meshes.size());
+	std::vector<VertexCacheStatistics> after(model.Meshes.size());
+
+	ThreadPool::GetShared().ParallelFor(0, model.Meshes.size(), 1, [&](const uint begin, const uint end)
+	{
+		for (uint i = begin; i < end; i++)
+			Optimize(model.Meshes[i], &before[i], &after[i]);
+	});
+
+	for (uint i = 0; i < model.Meshes.size(); i++)
+	{
+		if (model.Meshes[i].Indices.empty())
+			continue;
+
+		LOG_INFO("Mesh \"", model.Meshes[i].Name, "\": ACMR ", before[i].ACMR, " -> ", after[i].ACMR,
+			", ATVR ", before[i].ATVR, " -> ", after[i].ATVR);
+	}
+}
+
+void MeshOptimizer::Optimize(MeshData& mesh, VertexCacheStatistics*const before, VertexCacheStatistics*const after)
+{
+	if (before != nullptr)
+		*before = AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+
+	OptimizeVertexCache(mesh.Indices, mesh.Vertices.size());
+	OptimizeOverdraw(mesh.Indices, mesh.Vertices);
+
+	for (MeshLod& lod : mesh.Lods)
+	{
+		OptimizeVertexCache(lod.Indices, mesh.Vertices.size());
+		OptimizeOverdraw(lod.Indices, mesh.Vertices);
+	}
+
+	OptimizeVertexFetch(mesh.Vertices, mesh.Indices, &mesh.Lods);
+
+	if (after != nullptr)
+		*after = AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint>& indices, const uint vertexCount)
+{
+	const uint triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return;
+
+	// The triangles of every vertex, the ones not emitted yet are kept at the front of each list.
+	std::vector<uint> remaining(vertexCount, 0);
+	for (uint index : indices)
+		remaining[index]++;
+
+	std::vector<uint> offsets(vertexCount + 1, 0);
+	for (uint i = 0; i < vertexCount; i++)
+		offsets[i + 1] = offsets[i] + remaining[i];
+
+	std::vector<uint> adjacency(indices.size());
+	std::vector<uint> fill(offsets.begin(), offsets.end() - 1);
+	for (uint i = 0; i < indices.size(); i++)
+		adjacency[fill[indices[i]]++] = i / 3;
+
+	std::vector<int> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (uint i = 0; i < vertexCount; i++)
+		vertexScores[i] = GetVertexScore(-1, remaining[i]);
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	uint bestTriangle = 0;
+	for (uint i = 0; i < triangleCount; i++)
+	{
+		triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+		if (triangleScores[i] > triangleScores[bestTriangle])
+			bestTriangle = i;
+	}
+
+	std::vector<uint> result;
+	result.reserve(indices.size());
+
+	uint cache[ScoringCacheSize + 3];
+	uint newCache[ScoringCacheSize + 3];
+	uint cacheCount = 0;
+	uint cursor = 0; // triangles before it have all been emitted
+
+	for (uint emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+	{
+		// None of the cached vertices has triangles left, continue with the next one in the input.
+		if (bestTriangle == InvalidIndex)
+		{
+			while (emitted[cursor])
+				cursor++;
+
+			bestTriangle = cursor;
+		}
+
+		const uint*const triangle = &indices[bestTriangle * 3];
+		result.insert(result.end(), triangle, triangle + 3);
+		emitted[bestTriangle] = true;
+
+		// The triangle's vertices move to the front of the cache.
+		uint newCount = 0;
+		for (uint i = 0; i < 3; i++)
+		{
+			const uint vertex = triangle[i];
+			uint* list = &adjacency[offsets[vertex]];
+			for (uint j = 0; j < remaining[vertex]; j++)
+			{
+				if (list[j] == bestTriangle)
+				{
+					std::swap(list[j], list[remaining[vertex] - 1]);
+					break;
+				}
+			}
+
+			remaining[vertex]--;
+			newCache[newCount++] = vertex;
+		}
+
+		for (uint i = 0; i < cacheCount; i++)
+		{
+			const uint vertex = cache[i];
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+				newCache[newCount++] = vertex;
+		}
+
+		// Vertices pushed out of the cache are rescored once more before they are dropped.
+		for (uint i = 0; i < newCount; i++)
+		{
+			const uint vertex = newCache[i];
+			cachePositions[vertex] = i < ScoringCacheSize ? (int)i : -1;
+			vertexScores[vertex] = GetVertexScore(cachePositions[vertex], remaining[vertex]);
+		}
+
+		bestTriangle = InvalidIndex;
+		float bestScore = -1.0f;
+		for (uint i = 0; i < newCount; i++)
+		{
+			const uint vertex = newCache[i];
+			const uint* list = &adjacency[offsets[vertex]];
+			for (uint j = 0; j < remaining[vertex]; j++)
+			{
+				const uint candidate = list[j];
+				const uint*const corners = &indices[candidate * 3];
+				const float score = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+				triangleScores[candidate] = score;
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = candidate;
+				}
+			}
+		}
+
+		cacheCount = std::min(newCount, ScoringCacheSize);
+		std::copy(newCache, newCache + cacheCount, cache);
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint>& indices, const std::vector<VertexData>& vertices, const float threshold)
+{
+	const uint triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Triangles whose vertices all miss the cache begin hard clusters, the order can change there for free.
+	std::vector<uint> missTimes(vertices.size(), 0);
+	uint time = OverdrawCacheSize + 1;
+
+	std::vector<uint> hardBoundaries;
+	for (uint i = 0; i < triangleCount; i++)
+	{
+		if (SimulateTriangle(&indices[i * 3], missTimes, time, OverdrawCacheSize) == 3)
+			hardBoundaries.push_back(i);
+	}
+
+	if (hardBoundaries.empty() || hardBoundaries[0] != 0)
+		hardBoundaries.insert(hardBoundaries.begin(), 0);
+	hardBoundaries.push_back(triangleCount);
+
+	// Hard clusters are split further wherever the part before the split is about as cache efficient as the whole.
+	std::vector<TriangleCluster> clusters;
+	for (uint c = 0; c + 1 < hardBoundaries.size(); c++)
+	{
+		const uint begin = hardBoundaries[c];
+		const uint end = hardBoundaries[c + 1];
+
+		time += OverdrawCacheSize + 1;
+		uint clusterMisses = 0;
+		for (uint i = begin; i < end; i++)
+			clusterMisses += SimulateTriangle(&indices[i * 3], missTimes, time, OverdrawCacheSize);
+
+		const float targetACMR = threshold * clusterMisses / (end - begin);
+
+		time += OverdrawCacheSize + 1;
+		uint clusterBegin = begin;
+		uint misses = 0;
+		for (uint i = begin; i < end; i++)
+		{
+			misses += SimulateTriangle(&indices[i * 3], missTimes, time, OverdrawCacheSize);
+
+			if (i + 1 < end && misses <= targetACMR * (i + 1 - clusterBegin))
+			{
+				TriangleCluster cluster = { clusterBegin, i + 1, 0.0f };
+				clusters.push_back(cluster);
+				clusterBegin = i + 1;
+				misses = 0;
+				time += OverdrawCacheSize + 1;
+			}
+		}
+
+		TriangleCluster cluster = { clusterBegin, end, 0.0f };
+		clusters.push_back(cluster);
+	}
+
+	if (clusters.size() < 2)
+		return;
+
+	// Clusters further out along their own facing direction are drawn first.
+	std::vector<Vector3> centroids(clusters.size(), Vector3(0.0f));
+	std::vector<Vector3> normals(clusters.size(), Vector3(0.0f));
+	std::vector<float> areas(clusters.size(), 0.0f);
+	Vector3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+
+	for (uint c = 0; c < clusters.size(); c++)
+	{
+		for (uint i = clusters[c].Begin; i < clusters[c].End; i++)
+		{
+			const Vector3& a = vertices[indices[i * 3]].Position;
+			const Vector3& b = vertices[indices[i * 3 + 1]].Position;
+			const Vector3& p = vertices[indices[i * 3 + 2]].Position;
+
+			const Vector3 ab(b.x - a.x, b.y - a.y, b.z - a.z);
+			const Vector3 ap(p.x - a.x, p.y - a.y, p.z - a.z);
+			const Vector3 normal(ab.y * ap.z - ab.z * ap.y, ab.z * ap.x - ab.x * ap.z, ab.x * ap.y - ab.y * ap.x);
+			const float area = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+
+			centroids[c].x += (a.x + b.x + p.x) * area;
+			centroids[c].y += (a.y + b.y + p.y) * area;
+			centroids[c].z += (a.z + b.z + p.z) * area;
+			normals[c].x += normal.x;
+			normals[c].y += normal.y;
+			normals[c].z += normal.z;
+			areas[c] += area;
+		}
+
+		meshCentroid.x += centroids[c].x;
+		meshCentroid.y += centroids[c].y;
+		meshCentroid.z += centroids[c].z;
+		meshArea += areas[c];
+	}
+
+	const float meshScale = meshArea > 0.0f ? 1.0f / (meshArea * 3.0f) : 0.0f;
+	meshCentroid = Vector3(meshCentroid.x * meshScale, meshCentroid.y * meshScale, meshCentroid.z * meshScale);
+
+	for (uint c = 0; c < clusters.size(); c++)
+	{
+		const float scale = areas[c] > 0.0f ? 1.0f / (areas[c] * 3.0f) : 0.0f;
+		const float length = sqrtf(normals[c].x * normals[c].x + normals[c].y * normals[c].y + normals[c].z * normals[c].z);
+		if (length == 0.0f)
+			continue;
+
+		clusters[c].SortKey = ((centroids[c].x * scale - meshCentroid.x) * normals[c].x
+			+ (centroids[c].y * scale - meshCentroid.y) * normals[c].y
+			+ (centroids[c].z * scale - meshCentroid.z) * normals[c].z) / length;
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster& a, const TriangleCluster& b)
+	{
+		return a.SortKey > b.SortKey;
+	});
+
+	std::vector<uint> result;
+	result.reserve(indices.size());
+	for (const TriangleCluster& cluster : clusters)
+		result.insert(result.end(), indices.begin() + cluster.Begin * 3, indices.begin() + cluster.End * 3);
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<VertexData>& vertices, std::vector<uint>& indices, std::vector<MeshLod>*const lods)
+{
+	std::vector<uint> remap(vertices.size(), InvalidIndex);
+	uint vertexCount = 0;
+
+	for (uint& index : indices)
+	{
+		if (remap[index] == InvalidIndex)
+			remap[index] = vertexCount++;
+
+		index = remap[index];
+	}
+
+	// Levels of detail only use vertices of the full mesh.
+	if (lods != nullptr)
+	{
+		for (MeshLod& lod : *lods)
+		{
+			for (uint& index : lod.Indices)
+				index = remap[index];
+		}
+	}
+
+	std::vector<VertexData> result(vertexCount);
+	for (uint i = 0; i < vertices.size(); i++)
+	{
+		if (remap[i] != InvalidIndex)
+			result[remap[i]] = vertices[i];
+	}
+
+	vertices.swap(result);
+}
+
+VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<uint>& indices, const uint vertexCount, const uint cacheSize)
+{
+	VertexCacheStatistics statistics = { 0.0f, 0.0f };
+
+	const uint triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return statistics;
+
+	std::vector<uint> missTimes(vertexCount, 0);
+	uint time = cacheSize + 1;
+	uint misses = 0;
+	for (uint i = 0; i < triangleCount; i++)
+		misses += SimulateTriangle(&indices[i * 3], missTimes, time, cacheSize);
+
+	uint usedVertices = 0;
+	for (uint missTime : missTimes)
+		usedVertices += missTime != 0 ? 1 : 0;
+
+	statistics.ACMR = (float)misses / triangleCount;
+	statistics.ATVR = (float)misses / usedVertices;
+
+	return statistics;
+}
+
+float GetVertexScore(const int cachePosition, const uint remainingTriangles)
+{
+	if (remainingTriangles == 0)
+		return -1.0f;
+
+	const float cacheScore = cachePosition >= 0 ? VertexScores.Cache[cachePosition] : 0.0f;
+
+	return cacheScore + VertexScores.Valence[std::min(remainingTriangles, MaxValence)];
+}
+
+uint SimulateTriangle(const uint*const triangle, std::vector<uint>& missTimes, uint& time, const uint cacheSize)
+{
+	uint misses = 0;
+	for (uint i = 0; i < 3; i++)
+	{
+		const uint vertex = triangle[i];
+		if (time - missTimes[vertex] > cacheSize)
+		{
+			missTimes[vertex] = time++;
+			misses++;
+		}
+	}
+
+	return misses;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+===========================================================================
+MeshOptimizer.h
+
+Reorders imported meshes for the GPU before they are cooked:
+	1. triangles for the post-transform vertex cache, with Forsyth's
+	   linear-speed algorithm,
+	2. clusters of those triangles so that surfaces facing away from the
+	   centre of the mesh are drawn first and hide what lies behind them,
+	   at a bounded loss of cache efficiency,
+	3. vertices in the order the triangles first use them, so vertex
+	   fetches stream through memory. Unused vertices are dropped.
+
+Cache efficiency is reported as ACMR, vertex shader invocations per
+triangle, and ATVR, invocations per unique vertex (1 is the optimum).
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	struct VertexData;
+	struct MeshData;
+	struct MeshLod;
+	struct ModelData;
+
+	struct VertexCacheStatistics
+	{
+		float ACMR;
+		float ATVR;
+	};
+
+	class MeshOptimizer
+	{
+	public:
+		// Optimizes every mesh of the model on the shared thread pool and logs the statistics.
+		static void Optimize(ModelData& model);
+		// Runs all the passes in order, on the full mesh and on every level of detail.
+		static void Optimize(MeshData& mesh, VertexCacheStatistics*const before = nullptr, VertexCacheStatistics*const after = nullptr);
+
+		static void OptimizeVertexCache(std::vector<uint>& indices, const uint vertexCount);
+		// Expects cache-optimized indices. Clusters are only split where the ACMR of the
+		// resulting order stays within threshold times that of the input.
+		static void OptimizeOverdraw(std::vector<uint>& indices, const std::vector<VertexData>& vertices, const float threshold = 1.05f);
+		// The levels of detail, if any, are remapped along with the full mesh.
+		static void OptimizeVertexFetch(std::vector<VertexData>& vertices, std::vector<uint>& indices, std::vector<MeshLod>*const lods = nullptr);
+
+		// Simulates a FIFO cache of the given size, the model most hardware is tuned for.
+		static VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint>& indices, const uint vertexCount, const uint cacheSize = 16);
+
+	private:
+		MeshOptimizer();
+		MeshOptimizer(const MeshOptimizer& tRef) = delete;
+		MeshOptimizer& operator = (const MeshOptimizer& tRef) = delete;
+	};
+}
\ No newline at end of file
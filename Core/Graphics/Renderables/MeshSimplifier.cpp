@@ -0,0 +1,473 @@
+/*
+===========================================================================
+MeshSimplifier.cpp
+
+Implements the MeshSimplifier class.
+Collapses are applied in passes: all candidate edges are sorted by cost
+and the cheapest ones are collapsed, as long as they do not touch a
+neighbourhood already changed in the same pass and do not flip any
+triangle. The indices are compacted between passes.
+===========================================================================
+*/
+
+#include "MeshSimplifier.h"
+#include "ModelData.h"
+#include "Graphics/Structures/VertexData.h"
+#include "System/ThreadPool.h"
+#include "System/Logger.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace sedge;
+
+enum VertexKind
+{
+	VertexManifold, // may collapse onto any neighbour
+	VertexBorder, // may only slide along its border
+	VertexLocked
+};
+
+// The area-weighted mean squared distance to a set of planes: v^T Q v / W. Dividing by the total area
+// keeps the error a squared distance in model units however large or many the triangles are.
+struct Quadric
+{
+	double A2, B2, C2, D2, AB, AC, AD, BC, BD, CD;
+	double W;
+
+	void Reset()
+	{
+		A2 = B2 = C2 = D2 = AB = AC = AD = BC = BD = CD = 0.0;
+		W = 0.0;
+	}
+
+	void AddPlane(const double a, const double b, const double c, const double d, const double weight)
+	{
+		AddConstraint(a, b, c, d, weight);
+		W += weight;
+	}
+
+	// A plane that adds to the error without adding to the weight it is averaged over.
+	void AddConstraint(const double a, const double b, const double c, const double d, const double weight)
+	{
+		A2 += a * a * weight;
+		B2 += b * b * weight;
+		C2 += c * c * weight;
+		D2 += d * d * weight;
+		AB += a * b * weight;
+		AC += a * c * weight;
+		AD += a * d * weight;
+		BC += b * c * weight;
+		BD += b * d * weight;
+		CD += c * d * weight;
+	}
+
+	void Add(const Quadric& other)
+	{
+		A2 += other.A2;
+		B2 += other.B2;
+		C2 += other.C2;
+		D2 += other.D2;
+		AB += other.AB;
+		AC += other.AC;
+		AD += other.AD;
+		BC += other.BC;
+		BD += other.BD;
+		CD += other.CD;
+		W += other.W;
+	}
+
+	double GetError(const Vector3& p) const
+	{
+		if (W == 0.0)
+			return 0.0;
+
+		const double x = p.x;
+		const double y = p.y;
+		const double z = p.z;
+		const double error = A2 * x * x + B2 * y * y + C2 * z * z + D2
+			+ 2.0 * (AB * x * y + AC * x * z + AD * x + BC * y * z + BD * y + CD * z);
+
+		return error > 0.0 ? error / W : 0.0;
+	}
+};
+
+struct Collapse
+{
+	uint From;
+	uint To;
+	float Cost;
+};
+
+// Borders keep their shape much more firmly than the surface.
+static const float BorderWeight = 10.0f;
+static const float NormalWeight = 0.25f;
+
+static inline unsigned long long GetEdgeKey(const uint a, const uint b) { return (unsigned long long)a << 32 | b; }
+static void WeldPositions(const std::vector<VertexData>& vertices, std::vector<uint>& positionIds, std::vector<uint>& wedgeCounts);
+static Vector3 GetNormal(const Vector3& a, const Vector3& b, const Vector3& c);
+static bool FlipsTriangle(const Vector3& moved, const Vector3& target, const Vector3& b, const Vector3& c);
+
+void MeshSimplifier::GenerateLods(ModelData& model, const MeshLodSettings& settings)
+{
+	ThreadPool::GetShared().ParallelFor(0, model.Meshes.size(), 1, [&](const uint begin, const uint end)
+	{
+		for (uint i = begin; i < end; i++)
+			GenerateLods(model.Meshes[i], settings);
+	});
+
+	for (const MeshData& mesh : model.Meshes)
+	{
+		if (mesh.Lods.empty())
+			continue;
+
+		std::string levels = std::to_string(mesh.Indices.size() / 3);
+		for (const MeshLod& lod : mesh.Lods)
+			levels += " -> " + std::to_string(lod.Indices.size() / 3);
+
+		LOG_INFO("Mesh \"", mesh.Name, "\": ", levels, " triangles, error ", mesh.Lods.back().Error);
+	}
+}
+
+void MeshSimplifier::GenerateLods(MeshData& mesh, const MeshLodSettings& settings)
+{
+	mesh.Lods.clear();
+	if (mesh.Indices.empty())
+		return;
+
+	Vector3 minimum = mesh.Vertices[0].Position;
+	Vector3 maximum = mesh.Vertices[0].Position;
+	for (const VertexData& vertex : mesh.Vertices)
+	{
+		minimum = Vector3(std::min(minimum.x, vertex.Position.x), std::min(minimum.y, vertex.Position.y), std::min(minimum.z, vertex.Position.z));
+		maximum = Vector3(std::max(maximum.x, vertex.Position.x), std::max(maximum.y, vertex.Position.y), std::max(maximum.z, vertex.Position.z));
+	}
+
+	const Vector3 extents((maximum.x - minimum.x) * 0.5f, (maximum.y - minimum.y) * 0.5f, (maximum.z - minimum.z) * 0.5f);
+	const float maxError = settings.MaxError * sqrtf(extents.x * extents.x + extents.y * extents.y + extents.z * extents.z);
+
+	float error = 0.0f;
+	for (uint level = 1; level < settings.MaxLevels && error < maxError; level++)
+	{
+		// Every level is simplified from the previous one, their errors add up at worst.
+		const std::vector<uint>& source = level == 1 ? mesh.Indices : mesh.Lods.back().Indices;
+		const uint targetIndexCount = (uint)(source.size() / 3 * settings.Ratio) * 3;
+
+		MeshLod lod;
+		lod.Error = error + Simplify(mesh.Vertices, source, targetIndexCount, maxError - error, settings.AttributeWeight, lod.Indices);
+
+		// A level that saves little is not worth its memory.
+		if (lod.Indices.empty() || lod.Indices.size() > source.size() * (1.0f + settings.Ratio) * 0.5f)
+			break;
+
+		error = lod.Error;
+		mesh.Lods.push_back(lod);
+	}
+}
+
+float MeshSimplifier::Simplify(const std::vector<VertexData>& vertices, const std::vector<uint>& indices,
+	const uint targetIndexCount, const float maxError, const float attributeWeight, std::vector<uint>& result)
+{
+	result = indices;
+
+	const uint vertexCount = vertices.size();
+	if (result.size() <= targetIndexCount || vertexCount == 0)
+		return 0.0f;
+
+	// Vertices sharing a position are wedges of a seam, their attributes differ.
+	std::vector<uint> positionIds;
+	std::vector<uint> wedgeCounts;
+	WeldPositions(vertices, positionIds, wedgeCounts);
+
+	std::unordered_set<unsigned long long> edges;
+	for (uint i = 0; i < result.size(); i += 3)
+	{
+		for (uint j = 0; j < 3; j++)
+			edges.insert(GetEdgeKey(positionIds[result[i + j]], positionIds[result[i + (j + 1) % 3]]));
+	}
+
+	// An edge without its opposite half lies on the border.
+	std::vector<uint> borderEdgeCounts(vertexCount, 0);
+	std::unordered_set<unsigned long long> borderEdges;
+	std::vector<Quadric> quadrics(vertexCount);
+	for (Quadric& quadric : quadrics)
+		quadric.Reset();
+
+	for (uint i = 0; i < result.size(); i += 3)
+	{
+		const uint corners[3] = { result[i], result[i + 1], result[i + 2] };
+		const Vector3& p0 = vertices[corners[0]].Position;
+		const Vector3& p1 = vertices[corners[1]].Position;
+		const Vector3& p2 = vertices[corners[2]].Position;
+
+		const Vector3 normal = GetNormal(p0, p1, p2);
+		const float area = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if (area == 0.0f)
+			continue;
+
+		const Vector3 unit(normal.x / area, normal.y / area, normal.z / area);
+		const double distance = -(unit.x * p0.x + unit.y * p0.y + unit.z * p0.z);
+		for (uint j = 0; j < 3; j++)
+			quadrics[corners[j]].AddPlane(unit.x, unit.y, unit.z, distance, area * 0.5f);
+
+		for (uint j = 0; j < 3; j++)
+		{
+			const uint a = corners[j];
+			const uint b = corners[(j + 1) % 3];
+			if (edges.count(GetEdgeKey(positionIds[b], positionIds[a])) != 0)
+				continue;
+
+			borderEdges.insert(GetEdgeKey(a, b));
+			borderEdgeCounts[a]++;
+			borderEdgeCounts[b]++;
+
+			// A plane through the border edge, perpendicular to the triangle. Left out of the average, leaving the
+			// border weighs the squared edge length relative to the area around the vertex, which does not depend on scale.
+			const Vector3& pa = vertices[a].Position;
+			const Vector3& pb = vertices[b].Position;
+			const Vector3 edge(pb.x - pa.x, pb.y - pa.y, pb.z - pa.z);
+			const Vector3 side(edge.y * unit.z - edge.z * unit.y, edge.z * unit.x - edge.x * unit.z, edge.x * unit.y - edge.y * unit.x);
+			const float length = sqrtf(side.x * side.x + side.y * side.y + side.z * side.z);
+			if (length == 0.0f)
+				continue;
+
+			const double sideDistance = -(side.x * pa.x + side.y * pa.y + side.z * pa.z) / length;
+			const double weight = (edge.x * edge.x + edge.y * edge.y + edge.z * edge.z) * BorderWeight;
+			quadrics[a].AddConstraint(side.x / length, side.y / length, side.z / length, sideDistance, weight);
+			quadrics[b].AddConstraint(side.x / length, side.y / length, side.z / length, sideDistance, weight);
+		}
+	}
+
+	// Border vertices with more than two border edges are corners, they stay where they are like seams.
+	std::vector<VertexKind> kinds(vertexCount, VertexManifold);
+	for (uint i = 0; i < vertexCount; i++)
+	{
+		if (wedgeCounts[positionIds[i]] > 1 || borderEdgeCounts[i] > 2)
+			kinds[i] = VertexLocked;
+		else if (borderEdgeCounts[i] > 0)
+			kinds[i] = borderEdgeCounts[i] == 2 ? VertexBorder : VertexLocked;
+	}
+
+	const float maxCost = maxError * maxError;
+	float resultCost = 0.0f;
+
+	std::vector<uint> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+	std::vector<uint> offsets(vertexCount + 1);
+	std::vector<uint> adjacency;
+	std::vector<Collapse> collapses;
+
+	while (result.size() > targetIndexCount)
+	{
+		// The triangles around every vertex.
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for (uint index : result)
+			offsets[index + 1]++;
+		for (uint i = 0; i < vertexCount; i++)
+			offsets[i + 1] += offsets[i];
+
+		adjacency.resize(result.size());
+		std::vector<uint> fill(offsets.begin(), offsets.end() - 1);
+		for (uint i = 0; i < result.size(); i++)
+			adjacency[fill[result[i]]++] = i / 3;
+
+		collapses.clear();
+		for (uint i = 0; i < result.size(); i += 3)
+		{
+			for (uint j = 0; j < 3; j++)
+			{
+				const uint a = result[i + j];
+				const uint b = result[i + (j + 1) % 3];
+
+				// Both directions of the edge are considered, the cheaper valid one is kept.
+				Collapse best = { 0, 0, -1.0f };
+				for (uint direction = 0; direction < 2; direction++)
+				{
+					const uint from = direction == 0 ? a : b;
+					const uint to = direction == 0 ? b : a;
+
+					if (kinds[from] == VertexLocked)
+						continue;
+					if (kinds[from] == VertexBorder && (kinds[to] == VertexManifold ||
+						(borderEdges.count(GetEdgeKey(from, to)) == 0 && borderEdges.count(GetEdgeKey(to, from)) == 0)))
+						continue;
+
+					const VertexData& source = vertices[from];
+					const VertexData& target = vertices[to];
+					const float dx = target.Position.x - source.Position.x;
+					const float dy = target.Position.y - source.Position.y;
+					const float dz = target.Position.z - source.Position.z;
+					const float du = target.UV.x - source.UV.x;
+					const float dv = target.UV.y - source.UV.y;
+					const float nx = target.Normal.x - source.Normal.x;
+					const float ny = target.Normal.y - source.Normal.y;
+					const float nz = target.Normal.z - source.Normal.z;
+
+					// Attribute changes are scaled by the edge length to be comparable to distances.
+					const float attributeCost = attributeWeight * (dx * dx + dy * dy + dz * dz) *
+						(du * du + dv * dv + NormalWeight * (nx * nx + ny * ny + nz * nz));
+					const float cost = (float)quadrics[from].GetError(target.Position) + attributeCost;
+
+					if (best.Cost < 0.0f || cost < best.Cost)
+					{
+						best.From = from;
+						best.To = to;
+						best.Cost = cost;
+					}
+				}
+
+				if (best.Cost >= 0.0f && best.Cost <= maxCost)
+					collapses.push_back(best);
+			}
+		}
+
+		if (collapses.empty())
+			break;
+
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Cost < b.Cost; });
+
+		for (uint i = 0; i < vertexCount; i++)
+			remap[i] = i;
+		std::fill(touched.begin(), touched.end(), false);
+
+		// Every collapse removes about two triangles, stop once that reaches the target.
+		const uint collapseLimit = (result.size() - targetIndexCount) / 6 + 1;
+		uint collapseCount = 0;
+
+		for (const Collapse& collapse : collapses)
+		{
+			if (collapseCount >= collapseLimit)
+				break;
+
+			if (touched[collapse.From] || touched[collapse.To])
+				continue;
+
+			const Vector3& target = vertices[collapse.To].Position;
+			bool flips = false;
+			for (uint k = offsets[collapse.From]; k < offsets[collapse.From + 1] && !flips; k++)
+			{
+				const uint* triangle = &result[adjacency[k] * 3];
+				if (triangle[0] == collapse.To || triangle[1] == collapse.To || triangle[2] == collapse.To)
+					continue;
+
+				// Rotate the triangle so the moved vertex comes first, keeping its winding.
+				const uint corner = triangle[0] == collapse.From ? 0 : (triangle[1] == collapse.From ? 1 : 2);
+				flips = FlipsTriangle(vertices[collapse.From].Position, target,
+					vertices[triangle[(corner + 1) % 3]].Position, vertices[triangle[(corner + 2) % 3]].Position);
+			}
+
+			if (flips)
+				continue;
+
+			// The neighbourhood is frozen for the rest of the pass, the flip test above relies on it.
+			for (uint k = offsets[collapse.From]; k < offsets[collapse.From + 1]; k++)
+			{
+				const uint* triangle = &result[adjacency[k] * 3];
+				touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+			}
+
+			// The border edges of the removed vertex now end at the target.
+			if (kinds[collapse.From] == VertexBorder)
+			{
+				for (uint k = offsets[collapse.From]; k < offsets[collapse.From + 1]; k++)
+				{
+					const uint* triangle = &result[adjacency[k] * 3];
+					for (uint j = 0; j < 3; j++)
+					{
+						const uint a = triangle[j];
+						const uint b = triangle[(j + 1) % 3];
+						if ((a == collapse.From || b == collapse.From) && borderEdges.count(GetEdgeKey(a, b)) != 0)
+							borderEdges.insert(GetEdgeKey(a == collapse.From ? collapse.To : a, b == collapse.From ? collapse.To : b));
+					}
+				}
+			}
+
+			remap[collapse.From] = collapse.To;
+			quadrics[collapse.To].Add(quadrics[collapse.From]);
+			resultCost = std::max(resultCost, collapse.Cost);
+			collapseCount++;
+		}
+
+		if (collapseCount == 0)
+			break;
+
+		uint writeIndex = 0;
+		for (uint i = 0; i < result.size(); i += 3)
+		{
+			const uint a = remap[result[i]];
+			const uint b = remap[result[i + 1]];
+			const uint c = remap[result[i + 2]];
+			if (a == b || b == c || c == a)
+				continue;
+
+			result[writeIndex++] = a;
+			result[writeIndex++] = b;
+			result[writeIndex++] = c;
+		}
+
+		result.resize(writeIndex);
+	}
+
+	return sqrtf(resultCost);
+}
+
+void WeldPositions(const std::vector<VertexData>& vertices, std::vector<uint>& positionIds, std::vector<uint>& wedgeCounts)
+{
+	struct PositionHash
+	{
+		size_t operator () (const Vector3& p) const
+		{
+			uint bits[3];
+			memcpy(bits, &p.x, sizeof(float));
+			memcpy(bits + 1, &p.y, sizeof(float));
+			memcpy(bits + 2, &p.z, sizeof(float));
+
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+
+	struct PositionEqual
+	{
+		bool operator () (const Vector3& a, const Vector3& b) const { return a.x == b.x && a.y == b.y && a.z == b.z; }
+	};
+
+	std::unordered_map<Vector3, uint, PositionHash, PositionEqual> ids(vertices.size());
+	positionIds.resize(vertices.size());
+	wedgeCounts.clear();
+
+	for (uint i = 0; i < vertices.size(); i++)
+	{
+		auto it = ids.find(vertices[i].Position);
+		if (it == ids.end())
+		{
+			it = ids.insert(std::make_pair(vertices[i].Position, (uint)wedgeCounts.size())).first;
+			wedgeCounts.push_back(0);
+		}
+
+		positionIds[i] = it->second;
+		wedgeCounts[it->second]++;
+	}
+}
+
+Vector3 GetNormal(const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	const Vector3 ab(b.x - a.x, b.y - a.y, b.z - a.z);
+	const Vector3 ac(c.x - a.x, c.y - a.y, c.z - a.z);
+
+	return Vector3(ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x);
+}
+
+bool FlipsTriangle(const Vector3& moved, const Vector3& target, const Vector3& b, const Vector3& c)
+{
+	const Vector3 before = GetNormal(moved, b, c);
+	const Vector3 after = GetNormal(target, b, c);
+
+	// Slivers whose normal turns by more than about 75 degrees count as flipped too.
+	const float dot = before.x * after.x + before.y * after.y + before.z * after.z;
+	const float lengths = sqrtf((before.x * before.x + before.y * before.y + before.z * before.z) *
+		(after.x * after.x + after.y * after.y + after.z * after.z));
+
+	return dot <= 0.25f * lengths;
+}
\ No newline at end of file
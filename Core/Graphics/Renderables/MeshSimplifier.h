@@ -0,0 +1,58 @@
+/*
+===========================================================================
+MeshSimplifier.h
+
+Generates levels of detail for imported meshes with quadric error metric
+edge collapses (Garland and Heckbert). Vertices are only ever collapsed
+onto one of their neighbours, so the simplified meshes reuse the
+original vertices with their exact attributes. Changing UVs or normals
+across an edge adds to the cost of collapsing it.
+
+Mesh borders are kept in place, so meshes of different materials that
+meet at a border do not open cracks, and vertices on attribute seams
+never move.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	struct VertexData;
+	struct MeshData;
+	struct ModelData;
+
+	struct MeshLodSettings
+	{
+		uint MaxLevels; // including the full mesh
+		float Ratio; // triangles of every level relative to the previous one
+		float MaxError; // relative to the radius of the mesh, coarser levels are not generated
+		float AttributeWeight;
+
+		MeshLodSettings()
+			: MaxLevels(4), Ratio(0.5f), MaxError(0.05f), AttributeWeight(1.0f) { }
+	};
+
+	class MeshSimplifier
+	{
+	public:
+		// Simplifies every mesh of the model on the shared thread pool and logs the levels.
+		static void GenerateLods(ModelData& model, const MeshLodSettings& settings = MeshLodSettings());
+		// Replaces the levels of detail of the mesh. A level is dropped, and the chain ends,
+		// when it would exceed the error limit or not get close to its triangle count.
+		static void GenerateLods(MeshData& mesh, const MeshLodSettings& settings = MeshLodSettings());
+
+		// Collapses edges until at most targetIndexCount indices are left or the next collapse would
+		// exceed maxError, in model units. Returns the error of the result.
+		static float Simplify(const std::vector<VertexData>& vertices, const std::vector<uint>& indices,
+			const uint targetIndexCount, const float maxError, const float attributeWeight, std::vector<uint>& result);
+
+	private:
+		MeshSimplifier();
+		MeshSimplifier(const MeshSimplifier& tRef) = delete;
+		MeshSimplifier& operator = (const MeshSimplifier& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -8,6 +8,7 @@ Implements the Model class.
 
 #include "Model.h"
 #include "Mesh.h"
+#include "System/MemoryManagement.h"
 
 using namespace sedge;
 using namespace std;
@@ -15,6 +16,19 @@ using namespace std;
 Model::Model(const vector<Mesh*> meshes)
 	: _meshes(meshes)
 {
+	for (uint i = 0; i < _meshes.size(); i++)
+	{
+		if (i == 0)
+			_bounds = _meshes[i]->GetBounds();
+		else
+			_bounds.Merge(_meshes[i]->GetBounds());
+	}
+}
+
+Model::~Model()
+{
+	for (auto mesh : _meshes)
+		SafeDelete(mesh);
 }
 
 void Model::Draw() const
@@ -22,3 +36,9 @@ void Model::Draw() const
 	for (uint i = 0; i < _meshes.size(); i++)
 		_meshes[i]->Draw();
 }
+
+void Model::SelectLod(const LodView& view, const Matrix4& modelMatrix)
+{
+	for (uint i = 0; i < _meshes.size(); i++)
+		_meshes[i]->SelectLod(view, modelMatrix);
+}
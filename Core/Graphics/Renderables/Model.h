@@ -12,6 +12,7 @@ TODO: implement transformation for a model (that is for all meshes in a model).
 
 #include <vector>
 #include "Renderable3D.h"
+#include "Math/BoundingBox.h"
 
 namespace sedge
 {
@@ -21,10 +22,17 @@ namespace sedge
 	{
 	private:
 		std::vector<Mesh*> _meshes;
+		BoundingBox _bounds;
 
 	public:
+		// The model owns the meshes.
 		Model(const std::vector<Mesh*> meshes);
+		~Model();
+
+		inline const BoundingBox& GetBounds() const { return _bounds; }
 
 		virtual void Draw() const override;
+		// Every mesh picks its own level, by its own bounds.
+		virtual void SelectLod(const LodView& view, const Matrix4& modelMatrix) override;
 	};
 }
\ No newline at end of file
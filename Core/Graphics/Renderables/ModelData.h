@@ -0,0 +1,49 @@
+/*
+===========================================================================
+ModelData.h
+
+Imported model geometry kept in system memory: one indexed mesh per
+material, ready to be turned into Mesh objects by the ModelFactory.
+Levels of detail reuse the vertices of the full mesh, so all of them
+share one vertex buffer and only their indices differ.
+===========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <CustomTypes.h>
+#include "Graphics/Structures/VertexData.h"
+
+namespace sedge
+{
+	struct MeshLod
+	{
+		std::vector<uint> Indices;
+		float Error; // the largest deviation from the full mesh, in model units
+	};
+
+	// Where a level of detail lies in a mesh's index buffer, the levels of a mesh are stored one after another.
+	struct MeshLodRange
+	{
+		uint FirstIndex;
+		uint IndexCount;
+		float Error;
+	};
+
+	struct MeshData
+	{
+		std::string Name; // of the material the mesh is drawn with
+		std::string DiffuseTexture; // empty if the material has none
+		std::string SpecularTexture;
+		std::vector<VertexData> Vertices;
+		std::vector<uint> Indices;
+		std::vector<MeshLod> Lods; // coarser levels, finest first
+	};
+
+	struct ModelData
+	{
+		std::vector<MeshData> Meshes;
+	};
+}
\ No newline at end of file
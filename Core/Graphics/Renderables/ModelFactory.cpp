@@ -0,0 +1,198 @@
+/*
+===========================================================================
+ModelFactory.cpp
+
+Implements the ModelFactory class.
+===========================================================================
+*/
+
+#include "ModelFactory.h"
+#include "Model.h"
+#include "ModelData.h"
+#include "MeshFactory.h"
+#include "ObjLoader.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Graphics/AssetManagers/TextureManager.h"
+#include "Graphics/Textures/TextureCache.h"
+#include "System/Logger.h"
+#include "System/AsyncFileReader.h"
+#include "System/ThreadPool.h"
+#include <memory>
+
+using namespace sedge;
+using namespace std;
+
+static bool PrepareModel(const char*const path, FileView& source, MeshFile& file, ModelData& data);
+static void AddTextureRef(const char*const path, TextureManager*const textureManager, vector<Texture2DRef>& textures);
+
+Model*const ModelFactory::CreateModel(const char*const path, TextureManager*const textureManager)
+{
+	MeshFile file;
+
+	if (MeshFile::IsMeshFile(path))
+	{
+		if (!file.Open(path))
+		{
+			LOG_ERROR("\"", path, "\" is not a valid mesh file");
+			return nullptr;
+		}
+
+		return CreateModel(file, textureManager);
+	}
+
+	// The source is needed either way, to check the cooked file or to import it, so it is read
+	// in the background while the cooked file is opened.
+	FileView source;
+	future<bool> sourceRead = AsyncFileReader::GetShared().Read(path, source);
+
+	file.Open(MeshFile::GetCachePath(path).c_str());
+
+	if (!sourceRead.get())
+	{
+		LOG_ERROR("Model \"", path, "\" was not found");
+		return nullptr;
+	}
+
+	ModelData data;
+	if (!PrepareModel(path, source, file, data))
+		return nullptr;
+
+	return file.IsOpen() ? CreateModel(file, textureManager) : CreateModel(data, textureManager);
+}
+
+Model*const ModelFactory::CreateModel(const ModelData& data, TextureManager*const textureManager)
+{
+	vector<Mesh*> meshes;
+
+	for (const MeshData& meshData : data.Meshes)
+	{
+		if (meshData.Indices.empty())
+			continue;
+
+		vector<Texture2DRef> diffTextures;
+		vector<Texture2DRef> specTextures;
+		AddTextureRef(meshData.DiffuseTexture.c_str(), textureManager, diffTextures);
+		AddTextureRef(meshData.SpecularTexture.c_str(), textureManager, specTextures);
+
+		meshes.push_back(MeshFactory::CreateMesh(meshData, diffTextures, specTextures));
+	}
+
+	return new Model(meshes);
+}
+
+Model*const ModelFactory::CreateModel(const MeshFile& file, TextureManager*const textureManager)
+{
+	vector<Mesh*> meshes;
+
+	for (uint i = 0; i < file.GetSubmeshCount(); i++)
+	{
+		const Submesh submesh = file.GetSubmesh(i);
+		if (submesh.IndexCount == 0)
+			continue;
+
+		vector<Texture2DRef> diffTextures;
+		vector<Texture2DRef> specTextures;
+		AddTextureRef(submesh.DiffuseTexture, textureManager, diffTextures);
+		AddTextureRef(submesh.SpecularTexture, textureManager, specTextures);
+
+		meshes.push_back(MeshFactory::CreateMesh(submesh.Name, submesh.Vertices, submesh.VertexCount,
+			submesh.Indices, submesh.IndexCount, submesh.IndexType, submesh.Bounds, submesh.Lods, submesh.LodCount, diffTextures, specTextures));
+	}
+
+	return new Model(meshes);
+}
+
+void ModelFactory::CreateModelAsync(const char*const path, TextureManager*const textureManager, const ModelCreatedCallback& onCreated)
+{
+	// Shared by the steps on the pool and on the main thread.
+	struct ModelLoad
+	{
+		string Path;
+		MeshFile File;
+		ModelData Data;
+		bool Prepared;
+	};
+
+	shared_ptr<ModelLoad> load = make_shared<ModelLoad>();
+	load->Path = path;
+	load->Prepared = false;
+
+	// Meshes and textures are created where the graphics context is current.
+	auto create = [load, textureManager, onCreated]()
+	{
+		Model* model = nullptr;
+		if (load->Prepared)
+			model = load->File.IsOpen() ? CreateModel(load->File, textureManager) : CreateModel(load->Data, textureManager);
+
+		onCreated(model);
+	};
+
+	if (MeshFile::IsMeshFile(path))
+	{
+		ThreadPool::GetShared().Enqueue([load, create]()
+		{
+			load->Prepared = load->File.Open(load->Path.c_str());
+			if (!load->Prepared)
+				LOG_ERROR("\"", load->Path, "\" is not a valid mesh file");
+
+			ThreadPool::GetShared().EnqueueOnMainThread(create);
+		});
+
+		return;
+	}
+
+	AsyncFileReader::GetShared().Read(path, IOPriorityNormal, [load, create](FileView& source)
+	{
+		if (source.IsOpen())
+		{
+			load->File.Open(MeshFile::GetCachePath(load->Path.c_str()).c_str());
+			load->Prepared = PrepareModel(load->Path.c_str(), source, load->File, load->Data);
+		}
+		else
+			LOG_ERROR("Model \"", load->Path, "\" was not found");
+
+		ThreadPool::GetShared().EnqueueOnMainThread(create);
+	});
+}
+
+// Leaves the cooked file open if it is up to date with the source, otherwise imports and cooks the source into data.
+bool PrepareModel(const char*const path, FileView& source, MeshFile& file, ModelData& data)
+{
+	// A mismatching hash means the source was edited after cooking.
+	const unsigned long long sourceHash = TextureCache::Hash(source.GetData(), source.GetSize());
+	if (file.IsOpen() && file.GetSourceHash() == sourceHash)
+		return true;
+
+	file.Close();
+
+	if (!ObjLoader::Load(path, source.GetData(), source.GetSize(), data, ThreadPool::GetShared()))
+		return false;
+
+	source.Close();
+
+	// Done once here, the cooked file keeps the levels of detail and the optimized order.
+	MeshSimplifier::GenerateLods(data);
+	MeshOptimizer::Optimize(data);
+
+	const string cachePath = MeshFile::GetCachePath(path);
+	if (!MeshFile::Write(cachePath.c_str(), sourceHash, data))
+		LOG_WARNING("Failed to write mesh file \"", cachePath, "\"");
+
+	return true;
+}
+
+void AddTextureRef(const char*const path, TextureManager*const textureManager, vector<Texture2DRef>& textures)
+{
+	if (path[0] == '\0' || textureManager == nullptr)
+		return;
+
+	// Materials commonly share textures, each one is loaded once.
+	if (!textureManager->FindTex2D(path).IsValid())
+		textureManager->AddTex2DAsync(path, path);
+
+	Texture2DRef texture = textureManager->GetTex2DRef(path);
+	if (texture.IsValid())
+		textures.push_back(texture);
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+/*
+===========================================================================
+ModelFactory.h
+
+Creates Model objects from model files, one mesh per material.
+Source models are cooked into mesh files on their first load.
+===========================================================================
+*/
+
+#pragma once
+
+#include <functional>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	class Model;
+	class TextureManager;
+	struct ModelData;
+	class MeshFile;
+
+	// Called on the main thread, with nullptr if the model could not be loaded. The callback owns the model.
+	typedef std::function<void(Model*const model)> ModelCreatedCallback;
+
+	class ModelFactory
+	{
+	public:
+		// Material textures are loaded asynchronously through the texture manager, named by their paths.
+		// Without a texture manager the meshes are drawn with vertex colours only.
+		// The path may point to an OBJ file or a cooked mesh file. Blocks until the model is read and,
+		// the first time, imported and cooked.
+		static Model*const CreateModel(const char*const path, TextureManager*const textureManager = nullptr);
+		static Model*const CreateModel(const ModelData& data, TextureManager*const textureManager = nullptr);
+		static Model*const CreateModel(const MeshFile& file, TextureManager*const textureManager = nullptr);
+
+		// Reads, imports and cooks the model on the shared thread pool, then creates it on the main thread
+		// in ThreadPool::RunMainThreadJobs. The texture manager must stay alive until then.
+		static void CreateModelAsync(const char*const path, TextureManager*const textureManager, const ModelCreatedCallback& onCreated);
+	};
+}
\ No newline at end of file
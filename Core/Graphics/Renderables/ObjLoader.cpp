@@ -0,0 +1,641 @@
+/*
+===========================================================================
+ObjLoader.cpp
+
+Implements the ObjLoader class.
+===========================================================================
+*/
+
+#include "ObjLoader.h"
+#include "System/FileSystem.h"
+#include "System/ThreadPool.h"
+#include "System/FileUtils.h"
+#include "System/Logger.h"
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <unordered_map>
+
+using namespace sedge;
+
+static const uint MinChunkSize = 256 * 1024;
+static const uint ChunksPerThread = 4;
+static const int MissingIndex = INT_MIN;
+static const char*const DefaultMaterial = "default";
+
+// Absolute indices are 0-based indices into the whole file. Relative ones are stored as the 0-based
+// index within the chunk, which is negative when they point before its start, and flagged in Relative.
+struct ObjCorner
+{
+	int Position;
+	int UV;
+	int Normal;
+	uint Relative; // bit 0 for the position, 1 for the UV and 2 for the normal
+};
+
+struct MaterialSwitch
+{
+	uint Triangle; // the first triangle of the chunk drawn with the material
+	std::string Material;
+};
+
+struct ObjChunk
+{
+	const char* Begin;
+	const char* End;
+	std::vector<Vector3> Positions;
+	std::vector<Vector2> UVs;
+	std::vector<Vector3> Normals;
+	std::vector<ObjCorner> Corners; // three per triangle
+	std::vector<MaterialSwitch> Switches;
+	std::vector<std::string> Libraries;
+	uint PositionOffset;
+	uint UVOffset;
+	uint NormalOffset;
+	bool Valid;
+};
+
+struct ObjMaterial
+{
+	Color Diffuse;
+	std::string DiffuseTexture;
+	std::string SpecularTexture;
+};
+
+// The triangles of one chunk that use a material.
+struct TriangleRange
+{
+	uint Chunk;
+	uint Begin;
+	uint End;
+};
+
+static void ParseChunk(ObjChunk& chunk);
+static bool ParseCorner(const char*& cursor, const char*const end, ObjChunk& chunk, ObjCorner& corner);
+static void LoadMaterials(const std::string& path, const std::string& directory, std::unordered_map<std::string, ObjMaterial>& materials);
+static bool BuildMesh(const std::vector<ObjChunk>& chunks, const std::vector<TriangleRange>& ranges,
+	const std::vector<Vector3>& positions, const std::vector<Vector2>& uvs, const std::vector<Vector3>& normals, MeshData& mesh);
+static int ResolveIndex(const int index, const bool relative, const uint offset, const uint count);
+static const char* SkipSpaces(const char* cursor, const char*const end);
+static const char* SkipLine(const char* cursor, const char*const end);
+static std::string ReadRestOfLine(const char* cursor, const char*const end);
+static const char* ParseFloat(const char* cursor, const char*const end, float& value);
+static const char* ParseInt(const char* cursor, const char*const end, int& value);
+
+bool ObjLoader::Load(const char*const path, ModelData& model)
+{
+	return Load(path, model, ThreadPool::GetShared());
+}
+
+bool ObjLoader::Load(const char*const path, ModelData& model, ThreadPool& pool)
+{
+	FileView file;
+	if (!file.Open(path))
+	{
+		model.Meshes.clear();
+		LOG_ERROR("Failed to open model \"", path, "\"");
+		return false;
+	}
+
+	return Load(path, file.GetData(), file.GetSize(), model, pool);
+}
+
+bool ObjLoader::Load(const char*const path, const byte*const fileData, const unsigned long long fileSize, ModelData& model, ThreadPool& pool)
+{
+	model.Meshes.clear();
+
+	const char*const data = (const char*)fileData;
+	const char*const dataEnd = data + fileSize;
+
+	// Chunks end right after a line break so that no line is split.
+	const unsigned long long maxChunks = (unsigned long long)(pool.GetThreadCount() + 1) * ChunksPerThread;
+	unsigned long long chunkCount = fileSize / MinChunkSize + 1;
+	chunkCount = chunkCount < maxChunks ? chunkCount : maxChunks;
+	const unsigned long long chunkSize = fileSize / chunkCount + 1;
+
+	std::vector<ObjChunk> chunks;
+	const char* cursor = data;
+	while (cursor < dataEnd)
+	{
+		const char* chunkEnd = (unsigned long long)(dataEnd - cursor) > chunkSize ? cursor + chunkSize : dataEnd;
+		chunkEnd = SkipLine(chunkEnd, dataEnd);
+
+		ObjChunk chunk;
+		chunk.Begin = cursor;
+		chunk.End = chunkEnd;
+		chunks.push_back(chunk);
+		cursor = chunkEnd;
+	}
+
+	pool.ParallelFor(0, chunks.size(), 1, [&chunks](const uint begin, const uint end)
+	{
+		for (uint i = begin; i < end; i++)
+			ParseChunk(chunks[i]);
+	});
+
+	// Stitch the chunks: vertex attribute offsets and the material every chunk starts with.
+	std::vector<Vector3> positions;
+	std::vector<Vector2> uvs;
+	std::vector<Vector3> normals;
+	std::vector<std::string> libraries;
+	std::vector<std::string> materialNames;
+	std::unordered_map<std::string, uint> materialIndices;
+	std::vector<std::vector<TriangleRange>> materialRanges;
+	uint material = UINT_MAX;
+
+	for (uint i = 0; i < chunks.size(); i++)
+	{
+		ObjChunk& chunk = chunks[i];
+		if (!chunk.Valid)
+		{
+			LOG_ERROR("Model \"", path, "\" contains a malformed face");
+			return false;
+		}
+
+		chunk.PositionOffset = positions.size();
+		chunk.UVOffset = uvs.size();
+		chunk.NormalOffset = normals.size();
+		positions.insert(positions.end(), chunk.Positions.begin(), chunk.Positions.end());
+		uvs.insert(uvs.end(), chunk.UVs.begin(), chunk.UVs.end());
+		normals.insert(normals.end(), chunk.Normals.begin(), chunk.Normals.end());
+		libraries.insert(libraries.end(), chunk.Libraries.begin(), chunk.Libraries.end());
+
+		const uint triangleCount = chunk.Corners.size() / 3;
+		uint triangle = 0;
+
+		for (uint s = 0; s <= chunk.Switches.size(); s++)
+		{
+			const uint rangeEnd = s < chunk.Switches.size() ? chunk.Switches[s].Triangle : triangleCount;
+
+			if (rangeEnd > triangle)
+			{
+				if (material == UINT_MAX)
+				{
+					material = materialNames.size();
+					materialIndices[DefaultMaterial] = material;
+					materialNames.push_back(DefaultMaterial);
+					materialRanges.push_back(std::vector<TriangleRange>());
+				}
+
+				TriangleRange range = { i, triangle, rangeEnd };
+				materialRanges[material].push_back(range);
+				triangle = rangeEnd;
+			}
+
+			if (s < chunk.Switches.size())
+			{
+				const std::string& name = chunk.Switches[s].Material;
+				auto it = materialIndices.find(name);
+				if (it == materialIndices.end())
+				{
+					material = materialNames.size();
+					materialIndices[name] = material;
+					materialNames.push_back(name);
+					materialRanges.push_back(std::vector<TriangleRange>());
+				}
+				else
+					material = it->second;
+			}
+		}
+	}
+
+	const std::string pathString(path);
+	const size_t separator = pathString.find_last_of("/\\");
+	const std::string directory = separator == std::string::npos ? "" : pathString.substr(0, separator + 1);
+
+	std::unordered_map<std::string, ObjMaterial> materials;
+	for (const std::string& library : libraries)
+		LoadMaterials(directory + library, directory, materials);
+
+	model.Meshes.resize(materialNames.size());
+	std::atomic<bool> valid(true);
+
+	pool.ParallelFor(0, materialNames.size(), 1, [&](const uint begin, const uint end)
+	{
+		for (uint i = begin; i < end; i++)
+		{
+			MeshData& mesh = model.Meshes[i];
+			mesh.Name = materialNames[i];
+
+			auto it = materials.find(mesh.Name);
+			const ObjMaterial* objMaterial = it != materials.end() ? &it->second : nullptr;
+			if (objMaterial != nullptr)
+			{
+				mesh.DiffuseTexture = objMaterial->DiffuseTexture;
+				mesh.SpecularTexture = objMaterial->SpecularTexture;
+			}
+
+			if (!BuildMesh(chunks, materialRanges[i], positions, uvs, normals, mesh))
+				valid = false;
+
+			const Color color = objMaterial != nullptr ? objMaterial->Diffuse : Color(0xffffffff);
+			for (VertexData& vertex : mesh.Vertices)
+				vertex.Color = color;
+		}
+	});
+
+	if (!valid)
+	{
+		LOG_ERROR("Model \"", path, "\" references vertex data that does not exist");
+		model.Meshes.clear();
+		return false;
+	}
+
+	return true;
+}
+
+void ParseChunk(ObjChunk& chunk)
+{
+	chunk.Valid = true;
+
+	const char* cursor = chunk.Begin;
+	const char*const end = chunk.End;
+	std::vector<ObjCorner> polygon;
+
+	while (cursor < end)
+	{
+		cursor = SkipSpaces(cursor, end);
+		if (cursor >= end)
+			break;
+
+		const char first = cursor[0];
+		const char second = cursor + 1 < end ? cursor[1] : 0;
+
+		if (first == 'v' && (second == ' ' || second == '\t'))
+		{
+			Vector3 position;
+			cursor = ParseFloat(cursor + 1, end, position.x);
+			cursor = ParseFloat(cursor, end, position.y);
+			cursor = ParseFloat(cursor, end, position.z);
+			chunk.Positions.push_back(position);
+		}
+		else if (first == 'v' && second == 't')
+		{
+			Vector2 uv;
+			cursor = ParseFloat(cursor + 2, end, uv.x);
+			cursor = ParseFloat(cursor, end, uv.y);
+			chunk.UVs.push_back(uv);
+		}
+		else if (first == 'v' && second == 'n')
+		{
+			Vector3 normal;
+			cursor = ParseFloat(cursor + 2, end, normal.x);
+			cursor = ParseFloat(cursor, end, normal.y);
+			cursor = ParseFloat(cursor, end, normal.z);
+			chunk.Normals.push_back(normal);
+		}
+		else if (first == 'f' && (second == ' ' || second == '\t'))
+		{
+			polygon.clear();
+			cursor++;
+
+			while (true)
+			{
+				cursor = SkipSpaces(cursor, end);
+				if (cursor >= end || *cursor == '\n' || *cursor == '\r' || *cursor == '#')
+					break;
+
+				ObjCorner corner;
+				if (!ParseCorner(cursor, end, chunk, corner))
+				{
+					chunk.Valid = false;
+					return;
+				}
+
+				polygon.push_back(corner);
+			}
+
+			for (uint i = 2; i < polygon.size(); i++)
+			{
+				chunk.Corners.push_back(polygon[0]);
+				chunk.Corners.push_back(polygon[i - 1]);
+				chunk.Corners.push_back(polygon[i]);
+			}
+		}
+		else if (end - cursor > 7 && strncmp(cursor, "usemtl", 6) == 0 && (cursor[6] == ' ' || cursor[6] == '\t'))
+		{
+			MaterialSwitch materialSwitch;
+			materialSwitch.Triangle = chunk.Corners.size() / 3;
+			materialSwitch.Material = ReadRestOfLine(cursor + 7, end);
+			chunk.Switches.push_back(materialSwitch);
+		}
+		else if (end - cursor > 7 && strncmp(cursor, "mtllib", 6) == 0 && (cursor[6] == ' ' || cursor[6] == '\t'))
+		{
+			chunk.Libraries.push_back(ReadRestOfLine(cursor + 7, end));
+		}
+
+		cursor = SkipLine(cursor, end);
+	}
+}
+
+bool ParseCorner(const char*& cursor, const char*const end, ObjChunk& chunk, ObjCorner& corner)
+{
+	int indices[3] = { MissingIndex, MissingIndex, MissingIndex };
+	const int counts[3] = { (int)chunk.Positions.size(), (int)chunk.UVs.size(), (int)chunk.Normals.size() };
+	uint relative = 0;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (cursor < end && *cursor != '/')
+		{
+			int index = 0;
+			const char*const start = cursor;
+			cursor = ParseInt(cursor, end, index);
+			if (cursor == start || index == 0 || index == MissingIndex)
+				return false;
+
+			// Relative indices may point into the chunks before, they are only checked once those are counted.
+			if (index > 0)
+				indices[i] = index - 1;
+			else
+			{
+				indices[i] = counts[i] + index;
+				relative |= 1 << i;
+			}
+		}
+
+		if (cursor >= end || *cursor != '/')
+			break;
+
+		cursor++;
+	}
+
+	if (indices[0] == MissingIndex)
+		return false;
+
+	corner.Position = indices[0];
+	corner.UV = indices[1];
+	corner.Normal = indices[2];
+	corner.Relative = relative;
+
+	return true;
+}
+
+void LoadMaterials(const std::string& path, const std::string& directory, std::unordered_map<std::string, ObjMaterial>& materials)
+{
+	FileView file;
+	if (!file.Open(path.c_str()))
+	{
+		LOG_WARNING("Failed to open material library \"", path, "\"");
+		return;
+	}
+
+	const char* cursor = (const char*)file.GetData();
+	const char*const end = cursor + file.GetSize();
+	ObjMaterial* material = nullptr;
+
+	while (cursor < end)
+	{
+		cursor = SkipSpaces(cursor, end);
+
+		if (end - cursor > 7 && strncmp(cursor, "newmtl ", 7) == 0)
+		{
+			material = &materials[ReadRestOfLine(cursor + 7, end)];
+			material->Diffuse = Color(0xffffffff);
+		}
+		else if (material != nullptr && end - cursor > 3 && strncmp(cursor, "Kd ", 3) == 0)
+		{
+			float red = 1.0f;
+			float green = 1.0f;
+			float blue = 1.0f;
+			const char* values = ParseFloat(cursor + 3, end, red);
+			values = ParseFloat(values, end, green);
+			ParseFloat(values, end, blue);
+			material->Diffuse = Color(Vector4(red, green, blue, 1.0f));
+		}
+		else if (material != nullptr && end - cursor > 7 && strncmp(cursor, "map_Kd ", 7) == 0)
+		{
+			material->DiffuseTexture = directory + ReadRestOfLine(cursor + 7, end);
+		}
+		else if (material != nullptr && end - cursor > 7 && strncmp(cursor, "map_Ks ", 7) == 0)
+		{
+			material->SpecularTexture = directory + ReadRestOfLine(cursor + 7, end);
+		}
+
+		cursor = SkipLine(cursor, end);
+	}
+}
+
+bool BuildMesh(const std::vector<ObjChunk>& chunks, const std::vector<TriangleRange>& ranges,
+	const std::vector<Vector3>& positions, const std::vector<Vector2>& uvs, const std::vector<Vector3>& normals, MeshData& mesh)
+{
+	uint cornerCount = 0;
+	for (const TriangleRange& range : ranges)
+		cornerCount += (range.End - range.Begin) * 3;
+
+	// Open addressing over the resolved attribute indices, the table is kept at most half full.
+	uint tableSize = 16;
+	while (tableSize < cornerCount * 2)
+		tableSize *= 2;
+
+	struct TableEntry
+	{
+		int Position;
+		int UV;
+		int Normal;
+		uint Vertex;
+	};
+
+	std::vector<TableEntry> table(tableSize);
+	for (TableEntry& entry : table)
+		entry.Position = -1;
+
+	mesh.Vertices.clear();
+	mesh.Indices.clear();
+	mesh.Indices.reserve(cornerCount);
+	bool missingNormals = false;
+
+	for (const TriangleRange& range : ranges)
+	{
+		const ObjChunk& chunk = chunks[range.Chunk];
+
+		for (uint i = range.Begin * 3; i < range.End * 3; i++)
+		{
+			const ObjCorner& corner = chunk.Corners[i];
+			const int position = ResolveIndex(corner.Position, (corner.Relative & 1) != 0, chunk.PositionOffset, positions.size());
+			const int uv = ResolveIndex(corner.UV, (corner.Relative & 2) != 0, chunk.UVOffset, uvs.size());
+			const int normal = ResolveIndex(corner.Normal, (corner.Relative & 4) != 0, chunk.NormalOffset, normals.size());
+
+			if (position < 0 || (corner.UV != MissingIndex && uv < 0) || (corner.Normal != MissingIndex && normal < 0))
+				return false;
+
+			uint slot = ((uint)position * 73856093u ^ (uint)uv * 19349663u ^ (uint)normal * 83492791u) & (tableSize - 1);
+			while (table[slot].Position != -1 &&
+				(table[slot].Position != position || table[slot].UV != uv || table[slot].Normal != normal))
+				slot = (slot + 1) & (tableSize - 1);
+
+			TableEntry& entry = table[slot];
+			if (entry.Position == -1)
+			{
+				entry.Position = position;
+				entry.UV = uv;
+				entry.Normal = normal;
+				entry.Vertex = mesh.Vertices.size();
+
+				VertexData vertex;
+				vertex.Position = positions[position];
+				vertex.UV = uv >= 0 ? uvs[uv] : Vector2(0.0f, 0.0f);
+				vertex.Normal = normal >= 0 ? normals[normal] : Vector3(0.0f, 0.0f, 0.0f);
+				mesh.Vertices.push_back(vertex);
+
+				missingNormals |= normal < 0;
+			}
+
+			mesh.Indices.push_back(entry.Vertex);
+		}
+	}
+
+	if (!missingNormals)
+		return true;
+
+	// Vertices without a normal get the area-weighted average of the faces around them.
+	std::vector<Vector3> accumulated(mesh.Vertices.size(), Vector3(0.0f, 0.0f, 0.0f));
+	for (uint i = 0; i < mesh.Indices.size(); i += 3)
+	{
+		const Vector3& a = mesh.Vertices[mesh.Indices[i]].Position;
+		const Vector3& b = mesh.Vertices[mesh.Indices[i + 1]].Position;
+		const Vector3& c = mesh.Vertices[mesh.Indices[i + 2]].Position;
+		const Vector3 faceNormal = Vector3::GetCrossProduct(b - a, c - a);
+
+		for (uint k = 0; k < 3; k++)
+			accumulated[mesh.Indices[i + k]] += faceNormal;
+	}
+
+	for (uint i = 0; i < mesh.Vertices.size(); i++)
+	{
+		VertexData& vertex = mesh.Vertices[i];
+		if (vertex.Normal.x == 0.0f && vertex.Normal.y == 0.0f && vertex.Normal.z == 0.0f && accumulated[i].GetLength() > 0.0f)
+			vertex.Normal = Vector3::Normalize(accumulated[i]);
+	}
+
+	return true;
+}
+
+// Returns -1 for missing or out of range indices.
+int ResolveIndex(const int index, const bool relative, const uint offset, const uint count)
+{
+	if (index == MissingIndex)
+		return -1;
+
+	const long long resolved = relative ? (long long)offset + index : index;
+
+	return resolved >= 0 && resolved < count ? (int)resolved : -1;
+}
+
+const char* SkipSpaces(const char* cursor, const char*const end)
+{
+	while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+		cursor++;
+
+	return cursor;
+}
+
+// Returns the start of the next line.
+const char* SkipLine(const char* cursor, const char*const end)
+{
+	while (cursor < end && *cursor != '\n')
+		cursor++;
+
+	return cursor < end ? cursor + 1 : end;
+}
+
+std::string ReadRestOfLine(const char* cursor, const char*const end)
+{
+	cursor = SkipSpaces(cursor, end);
+
+	const char* lineEnd = cursor;
+	while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r')
+		lineEnd++;
+
+	while (lineEnd > cursor && (lineEnd[-1] == ' ' || lineEnd[-1] == '\t'))
+		lineEnd--;
+
+	return std::string(cursor, lineEnd);
+}
+
+// Accepts the decimal forms OBJ exporters write, with an optional exponent. Leaves the value
+// untouched and returns the cursor unchanged if there is no number.
+const char* ParseFloat(const char* cursor, const char*const end, float& value)
+{
+	static const double Powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+
+	cursor = SkipSpaces(cursor, end);
+	const char*const start = cursor;
+
+	bool negative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+		negative = *cursor++ == '-';
+
+	double mantissa = 0.0;
+	int digits = 0;
+	while (cursor < end && *cursor >= '0' && *cursor <= '9')
+	{
+		mantissa = mantissa * 10.0 + (*cursor++ - '0');
+		digits++;
+	}
+
+	int exponent = 0;
+	if (cursor < end && *cursor == '.')
+	{
+		cursor++;
+		while (cursor < end && *cursor >= '0' && *cursor <= '9')
+		{
+			mantissa = mantissa * 10.0 + (*cursor++ - '0');
+			exponent--;
+			digits++;
+		}
+	}
+
+	if (digits == 0)
+		return start;
+
+	if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+	{
+		int explicitExponent = 0;
+		const char*const next = ParseInt(cursor + 1, end, explicitExponent);
+		if (next != cursor + 1)
+		{
+			exponent += explicitExponent;
+			cursor = next;
+		}
+	}
+
+	double result = mantissa;
+	while (exponent < -18)
+	{
+		result /= Powers[18];
+		exponent += 18;
+	}
+
+	while (exponent > 18)
+	{
+		result *= Powers[18];
+		exponent -= 18;
+	}
+
+	result = exponent < 0 ? result / Powers[-exponent] : result * Powers[exponent];
+	value = (float)(negative ? -result : result);
+
+	return cursor;
+}
+
+const char* ParseInt(const char* cursor, const char*const end, int& value)
+{
+	const char*const start = cursor;
+
+	bool negative = false;
+	if (cursor < end && (*cursor == '-' || *cursor == '+'))
+		negative = *cursor++ == '-';
+
+	const char*const digitsStart = cursor;
+	long long result = 0;
+	while (cursor < end && *cursor >= '0' && *cursor <= '9' && result < INT_MAX)
+		result = result * 10 + (*cursor++ - '0');
+
+	if (cursor == digitsStart)
+		return start;
+
+	value = (int)(negative ? -result : result);
+
+	return cursor;
+}
\ No newline at end of file
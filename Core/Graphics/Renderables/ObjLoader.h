@@ -0,0 +1,41 @@
+/*
+===========================================================================
+ObjLoader.h
+
+Imports Wavefront OBJ models with their MTL materials.
+The file is read through a view and split into chunks at line boundaries that
+are parsed on the thread pool. The chunks are then stitched together,
+faces are grouped by material and every material's corners are merged
+into unique vertices, again one material per task.
+
+Supported: v, vt, vn, f (polygons are triangulated as fans, negative
+indices are allowed), usemtl, mtllib, and the Kd, map_Kd and map_Ks
+material statements. Everything else is skipped.
+===========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <CustomTypes.h>
+#include "ModelData.h"
+
+namespace sedge
+{
+	class ThreadPool;
+
+	class ObjLoader
+	{
+	public:
+		static bool Load(const char*const path, ModelData& model, ThreadPool& pool);
+		static bool Load(const char*const path, ModelData& model);
+		// Parses a file that is already in memory, the path locates material libraries and names the model in messages.
+		static bool Load(const char*const path, const byte*const data, const unsigned long long size, ModelData& model, ThreadPool& pool);
+
+	private:
+		ObjLoader();
+		ObjLoader(const ObjLoader& tRef) = delete;
+		ObjLoader& operator = (const ObjLoader& tRef) = delete;
+	};
+}
\ No newline at end of file
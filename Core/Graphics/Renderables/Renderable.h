@@ -10,9 +10,18 @@ Declares the Renderable class, which is the base class for all elements that can
 
 #include <CustomTypes.h>
 #include "Math/Matrix4.h"
+#include "Math/Vector3.h"
 
 namespace sedge
 {
+	// What level of detail selection needs to know about the camera.
+	struct LodView
+	{
+		Vector3 CameraPosition;
+		float PixelScale; // pixels covered by one unit at a distance of one unit
+		float MaxScreenError; // in pixels
+	};
+
 	class Renderable
 	{
 	protected:
@@ -21,8 +30,12 @@ namespace sedge
 	public:
 		Renderable(const Matrix4& modelMatrix = Matrix4::GetIdentity()) 
 			: ModelMatrix(modelMatrix) { }
+		virtual ~Renderable() { }
 
 		virtual void Draw() const = 0;
+		// Renderables without levels of detail ignore this. The model matrix is the one the renderable will be drawn
+		// with, which is not necessarily the one last set, e.g. when drawing an interpolated frame.
+		virtual void SelectLod(const LodView& view, const Matrix4& modelMatrix) { }
 
 		const Matrix4& GetModelMatrix() const { return ModelMatrix; }
 		void SetModelMatrix(const Matrix4& modelMatrix) { ModelMatrix = modelMatrix; }
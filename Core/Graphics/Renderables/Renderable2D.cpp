@@ -15,17 +15,17 @@ Implements the Renderable2D class.
 using namespace sedge;
 
 Renderable2D::Renderable2D()
-	: Col(0xffffffff), Position(0, 0, 0), Size(0, 0), Texture(nullptr)
+	: Col(0xffffffff), Position(0, 0, 0), Size(0, 0), Texture(nullptr), UVMin(0, 0), UVMax(1, 1)
 {
 }
 
 Renderable2D::Renderable2D(const Vector3& position, const Size2D& size, const Color& color)
-	: Position(position), Size(size), Col(color), Texture(nullptr)
+	: Position(position), Size(size), Col(color), Texture(nullptr), UVMin(0, 0), UVMax(1, 1)
 {
 }
 
 Renderable2D::Renderable2D(const Vector3& position, const Size2D& size, Texture2D*const texture)
-	: Position(position), Size(size), Col(0xffffffff), Texture(texture)
+	: Position(position), Size(size), Col(0xffffffff), Texture(texture), UVMin(0, 0), UVMax(1, 1)
 {
 }
 
@@ -48,6 +48,13 @@ void Renderable2D::SetZIndex(const float zIndex)
 	Position.z = zIndex;
 }
 
+void Renderable2D::SetTexture(Texture2D*const texture, const Vector2& uvMin, const Vector2& uvMax)
+{
+	Texture = texture;
+	UVMin = uvMin;
+	UVMax = uvMax;
+}
+
 void Renderable2D::Submit(Renderer2D*const renderer) const
 {
 	renderer->Submit(this);
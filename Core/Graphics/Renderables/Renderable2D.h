@@ -26,6 +26,8 @@ namespace sedge
 		Size2D Size;
 		Color Col;
 		Texture2D* Texture;
+		Vector2 UVMin; // the part of the texture shown, the whole texture by default
+		Vector2 UVMax;
 
 	protected:
 		Renderable2D();
@@ -40,10 +42,13 @@ namespace sedge
 		inline const Size2D& GetSize() const { return Size; }
 		inline const Color& GetColor() const { return Col; }
 		virtual const ID GetTextureID() const;
+		inline const Vector2& GetUVMin() const { return UVMin; }
+		inline const Vector2& GetUVMax() const { return UVMax; }
 
 		virtual void SetColor(const Color& color);
 		virtual void SetPosition(const Vector2& position);
 		virtual void SetZIndex(const float zIndex);
+		virtual void SetTexture(Texture2D*const texture, const Vector2& uvMin = Vector2(0, 0), const Vector2& uvMax = Vector2(1, 1));
 
 		virtual void Submit(Renderer2D*const renderer) const;
 	};
@@ -17,7 +17,7 @@ void Renderable3D::Draw() const
 {
 	VBO->Bind();
 	IBO->Bind();
-	GraphicsAPI::DrawTrianglesIndexed(IBO->GetCount());
+	GraphicsAPI::DrawElements(Triangles, IBO->GetCount(), IBO->GetIndexType(), nullptr);
 }
 
 void Renderable3D::Submit(Renderer3D*const renderer)
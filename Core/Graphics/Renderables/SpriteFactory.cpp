@@ -8,6 +8,10 @@ Implements the SpriteFactory class
 
 #include "SpriteFactory.h"
 #include "Graphics/Renderables/Sprite.h"
+#include "Graphics/Renderables/Label.h"
+#include "Graphics/Text/Font.h"
+#include "Graphics/Textures/TextureAtlas.h"
+#include "System/Logger.h"
 
 using namespace sedge;
 
@@ -20,3 +24,30 @@ Sprite*const SpriteFactory::CreateSprite(const Vector2& position, const float zI
 {
 	return new Sprite(position, zIndex, size, color);
 }
+
+
+Sprite*const SpriteFactory::CreateSprite(const Vector2& position, const float zIndex, const Size2D& size, const TextureAtlas& atlas, const char*const region)
+{
+	const AtlasRegion* atlasRegion = atlas.GetRegion(region);
+	if (!atlasRegion)
+	{
+		LOG_ERROR("Atlas region \"", region, "\" was not found");
+		return nullptr;
+	}
+
+	Sprite* sprite = new Sprite(position, zIndex, size, Color(0xffffffff));
+	sprite->SetTexture(atlas.GetPageTexture(atlasRegion->Page), atlasRegion->UVMin, atlasRegion->UVMax);
+
+	return sprite;
+}
+
+Label*const SpriteFactory::CreateLabel(const std::string& text, Font*const font, const Vector2& position, const float zIndex, const float lineHeight, const Color& color)
+{
+	if (font == nullptr)
+	{
+		LOG_ERROR("Cannot create label \"", text, "\" without a font");
+		return nullptr;
+	}
+
+	return new Label(text, font, position, zIndex, lineHeight, color);
+}
@@ -2,12 +2,13 @@
 ===========================================================================
 SpriteFactory.h
 
-Declares LabelFactory class that is responsible for creating Label instances.
+Declares the SpriteFactory class that is responsible for creating Sprite and Label instances.
 ===========================================================================
 */
 
 #pragma once
 
+#include <string>
 #include <CustomTypes.h>
 #include "Graphics/Structures/Color.h"
 
@@ -18,6 +19,7 @@ namespace sedge
 	struct Size2D;
 
 	class Texture2D;
+	class TextureAtlas;
 	class Sprite;
 	class Label;
 	class Font;
@@ -27,5 +29,9 @@ namespace sedge
 	public:
 		static Sprite*const CreateSprite(const Vector2& position, const float zIndex, const Size2D& size, Texture2D*const texture);
 		static Sprite*const CreateSprite(const Vector2& position, const float zIndex, const Size2D& size, const Color& color = 0xffffffff);
+		// Shows one region of an uploaded atlas, returns nullptr if there is no such region.
+		static Sprite*const CreateSprite(const Vector2& position, const float zIndex, const Size2D& size, const TextureAtlas& atlas, const char*const region);
+		// The line height is in layer units, the text is scaled to it from the pixel size of the font.
+		static Label*const CreateLabel(const std::string& text, Font*const font, const Vector2& position, const float zIndex, const float lineHeight, const Color& color = 0xffffffff);
 	};
 }
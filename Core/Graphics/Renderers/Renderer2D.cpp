@@ -13,6 +13,7 @@ Implements the Renderer2D class
 #include "Graphics/Structures/VertexLayout.h"
 #include "Graphics/Textures/Texture2D.h"
 #include "Graphics/Renderables/Renderable2D.h"
+#include "Graphics/Text/Font.h"
 #include "Graphics/GraphicsAPI.h"
 
 #include "System/MemoryManagement.h"
@@ -24,7 +25,7 @@ using namespace sedge;
 static uint* FillIndexBuffer(const uint maxElement);
 
 Renderer2D::Renderer2D(const uint maxVertices)
-	: _maxVertices(maxVertices)
+	: _maxVertices(maxVertices), _maxIndices(maxVertices / 4 * 6)
 {
 	if (_maxVertices == 0)
 	{
@@ -35,9 +36,8 @@ Renderer2D::Renderer2D(const uint maxVertices)
 	_vbo = new VertexBuffer(sizeof(VertexDataS), _maxVertices, VertexLayout::GetDefaultSpriteVertexLayout());
 	_vbo->Bind();
 
-	const uint maxIndices = (const uint)(_maxVertices * 1.5);
-	uint* indices = FillIndexBuffer(maxIndices);
-	_ibo = new IndexBuffer(maxIndices, indices);
+	uint* indices = FillIndexBuffer(_maxIndices);
+	_ibo = new IndexBuffer(_maxIndices, indices);
 	SafeDeleteArray(indices);
 
 	_indexCount = 0;
@@ -60,98 +60,64 @@ void Renderer2D::Submit(const Renderable2D*const sprite)
 {
 	const Vector3& position = sprite->GetPosition();
 	const Size2D& size = sprite->GetSize();
-	const Color& color = sprite->GetColor();
 	const float samplerIndex = GetSamplerIndexByTID(sprite->GetTextureID());
 
-	_buffer->Position = Vector3(position.x, position.y - size.height, position.z);
+	SubmitQuad(Vector2(position.x, position.y - size.height), Vector2(position.x + size.width, position.y), position.z,
+		sprite->GetUVMin(), sprite->GetUVMax(), sprite->GetColor(), samplerIndex);
+}
+
+void Renderer2D::RenderText(const std::string& text, Font*const font, const Vector3& position, const float scale, const Color& color)
+{
+	const TextLayout& layout = font->GetLayout(text);
+	const float baseline = position.y - font->GetAscent() * scale;
+	const float samplerOffset = font->IsDistanceField() ? (const float)DistanceFieldSamplerOffset : 0.0f;
+
+	for (const GlyphQuad& quad : layout.Quads)
+	{
+		const float samplerIndex = GetSamplerIndexByTID(font->GetPageTexture(quad.Page)->GetID()) + samplerOffset;
+
+		SubmitQuad(Vector2(position.x + quad.Min.x * scale, baseline + quad.Min.y * scale),
+			Vector2(position.x + quad.Max.x * scale, baseline + quad.Max.y * scale), position.z,
+			quad.UVMin, quad.UVMax, color, samplerIndex);
+	}
+}
+
+void Renderer2D::SubmitQuad(const Vector2& min, const Vector2& max, const float z, const Vector2& uvMin, const Vector2& uvMax, const Color& color, const float samplerIndex)
+{
+	if (_indexCount + 6 > _maxIndices)
+	{
+		End();
+		Flush();
+		Begin();
+	}
+
+	_buffer->Position = Vector3(min.x, min.y, z);
 	_buffer->Color = color;
-	_buffer->UV = Vector2(0, 0);
+	_buffer->UV = Vector2(uvMin.x, uvMin.y);
 	_buffer->TextureID = samplerIndex;
 	_buffer++;
 
-	_buffer->Position = Vector3(position.x, position.y, position.z);
+	_buffer->Position = Vector3(min.x, max.y, z);
 	_buffer->Color = color;
-	_buffer->UV = Vector2(0, 1);
+	_buffer->UV = Vector2(uvMin.x, uvMax.y);
 	_buffer->TextureID = samplerIndex;
 	_buffer++;
 
-	_buffer->Position = Vector3(position.x + size.width, position.y, position.z);
+	_buffer->Position = Vector3(max.x, max.y, z);
 	_buffer->Color = color;
-	_buffer->UV = Vector2(1, 1);
+	_buffer->UV = Vector2(uvMax.x, uvMax.y);
 	_buffer->TextureID = samplerIndex;
 	_buffer++;
 
-	_buffer->Position = Vector3(position.x + size.width, position.y - size.height, position.z);
+	_buffer->Position = Vector3(max.x, min.y, z);
 	_buffer->Color = color;
-	_buffer->UV = Vector2(1, 0);
+	_buffer->UV = Vector2(uvMax.x, uvMin.y);
 	_buffer->TextureID = samplerIndex;
 	_buffer++;
 
 	_indexCount += 6;
 }
 
-//void Renderer2D::RenderText(const char* text, const Font*const font, const Vector3& position, const Color& color)
-//{
-//	const float samplerIndex = GetSamplerIndexByTID(font->GetAtlasID());
-//
-//	const float scaleX = font->GetScaleX();
-//	const float scaleY = font->GetScaleY();
-//	
-//	float x = position.x;
-//
-//	for (uint i = 0; i < strlen(text); i++)
-//	{
-//		texture_glyph_t*const glyph = texture_font_get_glyph(font->GetFontFace(), text[i]);
-//
-//		if (glyph)
-//		{
-//			if (i > 0)
-//			{
-//				const float kerning = texture_glyph_get_kerning(glyph, text[i - 1]);
-//				x += kerning / scaleX;
-//			}
-//
-//			const float x0 = x + glyph->offset_x / scaleX;
-//			const float y0 = position.y + glyph->offset_y / scaleY;
-//			const float x1 = x0 + glyph->width / scaleX;
-//			const float y1 = y0 - glyph->height / scaleY;
-//
-//			const float u0 = glyph->s0;
-//			const float v0 = glyph->t0;
-//			const float u1 = glyph->s1;
-//			const float v1 = glyph->t1;
-//
-//			x += glyph->advance_x / scaleX;
-//
-//			_buffer->Position = Vector3(x0, y1, 0);
-//			_buffer->UV = Vector2(u0, v1);
-//			_buffer->TextureID = samplerIndex;
-//			_buffer->Color = color;
-//			_buffer++;
-//
-//			_buffer->Position = Vector3(x0, y0, 0);
-//			_buffer->UV = Vector2(u0, v0);
-//			_buffer->TextureID = samplerIndex;
-//			_buffer->Color = color;
-//			_buffer++;
-//
-//			_buffer->Position = Vector3(x1, y0, 0);
-//			_buffer->UV = Vector2(u1, v0);
-//			_buffer->TextureID = samplerIndex;
-//			_buffer->Color = color;
-//			_buffer++;
-//
-//			_buffer->Position = Vector3(x1, y1, 0);
-//			_buffer->UV = Vector2(u1, v1);
-//			_buffer->TextureID = samplerIndex;
-//			_buffer->Color = color;
-//			_buffer++;
-//
-//			_indexCount += 6;
-//		}
-//	}
-//}
-
 void Renderer2D::End()
 {
 	_vbo->Unmap();
@@ -171,8 +137,10 @@ void Renderer2D::Flush()
 	GraphicsAPI::DrawTrianglesIndexed(_indexCount);
 
 	_indexCount = 0;
+	_textureIDs.clear();
 }
 
+// Sampler indices are 1-based for the shader, -1 means an untextured quad.
 const float Renderer2D::GetSamplerIndexByTID(const ID texID)
 {
 	if (texID == 0)
@@ -181,10 +149,10 @@ const float Renderer2D::GetSamplerIndexByTID(const ID texID)
 	for (uint i = 0; i < _textureIDs.size(); ++i)
 	{
 		if (_textureIDs[i] == texID)
-			return (const float)i;
+			return (const float)(i + 1);
 	}
 
-	if (_textureIDs.size() >= 32)
+	if (_textureIDs.size() >= MaxTextureSlots)
 	{
 		End();
 		Flush();
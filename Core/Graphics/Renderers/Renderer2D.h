@@ -10,6 +10,7 @@ TODO: make this an instanced renderer.
 #pragma once
 
 #include <vector>
+#include <string>
 #include <CustomTypes.h>
 
 namespace sedge
@@ -22,6 +23,7 @@ namespace sedge
 	class Label;
 	class Font;
 	struct Color;
+	struct Vector2;
 	struct Vector3;
 
 	class Renderer2D
@@ -36,6 +38,13 @@ namespace sedge
 		std::vector<uint> _textureIDs;
 
 		const uint _maxVertices;
+		const uint _maxIndices;
+
+	public:
+		// Textures a single batch can sample, matches the sampler array of the sprite shader.
+		static const uint MaxTextureSlots = 32;
+		// Sampler indices of distance field glyph pages are offset by MaxTextureSlots, which selects the distance field path of the shader.
+		static const uint DistanceFieldSamplerOffset = MaxTextureSlots;
 
 	public:
 		Renderer2D(const uint maxVertices = 100000);
@@ -43,11 +52,14 @@ namespace sedge
 
 		void Begin();
 		void Submit(const Renderable2D*const sprite);
-		void RenderText(const char* text, const Font*const font, const Vector3& position, const Color& color);
+		// Draws the cached layout of the text, position is its top left corner and scale maps font pixels to layer units.
+		void RenderText(const std::string& text, Font*const font, const Vector3& position, const float scale, const Color& color);
 		void End();
 		void Flush();
 
 	private:
+		// Flushes the batch first if the buffers are full.
+		void SubmitQuad(const Vector2& min, const Vector2& max, const float z, const Vector2& uvMin, const Vector2& uvMax, const Color& color, const float samplerIndex);
 		const float GetSamplerIndexByTID(const ID texID);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+/*
+===========================================================================
+ShaderCache.cpp
+
+Implements the ShaderCache class.
+===========================================================================
+*/
+
+#include "ShaderCache.h"
+#include "Graphics/GraphicsAPI.h"
+#include "System/FileSystem.h"
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+using namespace sedge;
+
+static const char CacheMagic[4] = { 'S', 'P', 'R', 'G' };
+static const uint CacheVersion = 1;
+static const unsigned long long HashBasis = 14695981039346656037ull;
+
+struct CacheHeader
+{
+	char Magic[4];
+	uint Version;
+	unsigned long long SourceHash;
+	unsigned long long DriverHash;
+	uint Format;
+	uint Length;
+};
+
+static unsigned long long Hash(const void*const data, const size_t size, unsigned long long hash);
+
+std::string ShaderCache::GetCachePath(const char*const vertexPath, const char*const fragmentPath, const std::string& permutationKey)
+{
+	unsigned long long hash = Hash(fragmentPath, strlen(fragmentPath) + 1, HashBasis);
+	hash = Hash(permutationKey.data(), permutationKey.size(), hash);
+
+	char name[24];
+	snprintf(name, sizeof(name), ".%08x.sprg", (uint)(hash ^ hash >> 32));
+
+	return std::string(vertexPath) + name;
+}
+
+unsigned long long ShaderCache::HashSources(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	// The terminator keeps text moved from the end of one stage to the start of the other from hashing the same.
+	const unsigned long long hash = Hash(vertexSource.c_str(), vertexSource.size() + 1, HashBasis);
+
+	return Hash(fragmentSource.data(), fragmentSource.size(), hash);
+}
+
+bool ShaderCache::IsSupported()
+{
+	static const bool supported = GraphicsAPI::GetProgramBinaryFormatCount() > 0;
+
+	return supported;
+}
+
+bool ShaderCache::Load(const char*const cachePath, const unsigned long long sourceHash, const ID programID)
+{
+	FileView file;
+	if (!file.Open(cachePath))
+		return false;
+
+	return Load(file, sourceHash, programID);
+}
+
+bool ShaderCache::Load(const FileView& file, const unsigned long long sourceHash, const ID programID)
+{
+	if (!IsSupported() || !file.IsOpen())
+		return false;
+
+	const CacheHeader* header = (const CacheHeader*)file.GetData();
+
+	const bool valid = file.GetSize() >= sizeof(CacheHeader)
+		&& memcmp(header->Magic, CacheMagic, sizeof(CacheMagic)) == 0
+		&& header->Version == CacheVersion
+		&& header->SourceHash == sourceHash
+		&& header->DriverHash == GetDriverHash()
+		&& sizeof(CacheHeader) + (unsigned long long)header->Length <= file.GetSize();
+
+	if (!valid)
+		return false;
+
+	return GraphicsAPI::LoadProgramBinary(programID, header->Format, file.GetData() + sizeof(CacheHeader), header->Length);
+}
+
+bool ShaderCache::Write(const char*const cachePath, const unsigned long long sourceHash, const ID programID)
+{
+	if (!IsSupported())
+		return false;
+
+	CacheHeader header;
+	memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+	header.Version = CacheVersion;
+	header.SourceHash = sourceHash;
+	header.DriverHash = GetDriverHash();
+	header.Format = 0;
+	header.Length = GraphicsAPI::GetProgramBinaryLength(programID);
+
+	if (header.Length == 0)
+		return false;
+
+	std::vector<byte> binary(header.Length);
+	GraphicsAPI::GetProgramBinary(programID, header.Length, &header.Format, binary.data());
+
+	std::ofstream stream(FileSystem::GetNativePath(cachePath), std::ios::binary);
+	if (!stream)
+		return false;
+
+	stream.write((const char*)&header, sizeof(header));
+	stream.write((const char*)binary.data(), binary.size());
+
+	return !stream.fail();
+}
+
+unsigned long long ShaderCache::GetDriverHash()
+{
+	static unsigned long long driverHash = 0;
+
+	if (driverHash == 0)
+	{
+		const char*const renderer = GraphicsAPI::GetRenderingDevice();
+		const char*const version = GraphicsAPI::GetVersion();
+
+		driverHash = HashBasis;
+		if (renderer != nullptr)
+			driverHash = Hash(renderer, strlen(renderer) + 1, driverHash);
+		if (version != nullptr)
+			driverHash = Hash(version, strlen(version), driverHash);
+	}
+
+	return driverHash;
+}
+
+unsigned long long Hash(const void*const data, const size_t size, unsigned long long hash)
+{
+	const byte* bytes = (const byte*)data;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
\ No newline at end of file
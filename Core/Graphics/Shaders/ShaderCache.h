@@ -0,0 +1,50 @@
+/*
+===========================================================================
+ShaderCache.h
+
+Keeps linked shader programs as driver binaries next to their vertex
+shader, so later launches skip compiling and linking. A binary is only
+used if it was built from the same preprocessed sources, permutation
+included, by the same driver; anything else rebuilds it from source.
+
+Layout of a *.sprg file:
+	header (source hash, driver hash, binary format, binary length)
+	the program binary
+===========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <CustomTypes.h>
+#include "System/FileSystem.h"
+
+namespace sedge
+{
+	class ShaderCache
+	{
+	public:
+		// Every permutation of a program gets its own file, named after a hash of the fragment path and permutation key.
+		static std::string GetCachePath(const char*const vertexPath, const char*const fragmentPath, const std::string& permutationKey);
+
+		// 64-bit FNV-1a hash of the final sources of both stages.
+		static unsigned long long HashSources(const std::string& vertexSource, const std::string& fragmentSource);
+
+		// Needs a current context. False if the driver does not support program binaries.
+		static bool IsSupported();
+
+		// Links the program from the cached binary. Fails without logging if the file is missing or stale.
+		static bool Load(const char*const cachePath, const unsigned long long sourceHash, const ID programID);
+		static bool Load(const FileView& file, const unsigned long long sourceHash, const ID programID);
+		// The program must have been linked with the binary retrievable hint set.
+		static bool Write(const char*const cachePath, const unsigned long long sourceHash, const ID programID);
+
+	private:
+		// Hash of the renderer and version strings, binaries from another driver version are never loaded.
+		static unsigned long long GetDriverHash();
+
+		ShaderCache();
+		ShaderCache(const ShaderCache& tRef) = delete;
+		ShaderCache& operator = (const ShaderCache& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -14,7 +14,7 @@ Implements ShaderFactory class
 
 using namespace sedge;
 
-ShaderProgram* ShaderFactory::CreateShaderProgram(const char*const name, const char*const vertexPath, const char*const fragmentPath)
+ShaderProgram* ShaderFactory::CreateShaderProgram(const char*const name, const char*const vertexPath, const char*const fragmentPath, const char*const defines)
 {
 	if (strcmp(name, "") == 0)
 	{
@@ -34,7 +34,7 @@ ShaderProgram* ShaderFactory::CreateShaderProgram(const char*const name, const c
 		return nullptr;
 	}
 
-	ShaderProgram* program = new ShaderProgram(name, vertexPath, fragmentPath);
+	ShaderProgram* program = new ShaderProgram(name, vertexPath, fragmentPath, defines);
 
 	if (!program->Load())
 	{
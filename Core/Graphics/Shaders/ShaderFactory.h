@@ -17,7 +17,8 @@ namespace sedge
 	public:
 		ShaderFactory() {}
 		~ShaderFactory() {}
-		static ShaderProgram* CreateShaderProgram(const char*const name, const char*const vertexPath, const char*const fragmentPath);
+		// Defines are "NAME[=VALUE]" entries separated by ';' and select a permutation of the program.
+		static ShaderProgram* CreateShaderProgram(const char*const name, const char*const vertexPath, const char*const fragmentPath, const char*const defines = nullptr);
 
 	private:
 		ShaderFactory(const ShaderFactory& tRef) = delete;
@@ -0,0 +1,237 @@
+/*
+===========================================================================
+ShaderPreprocessor.cpp
+
+Implements the ShaderPreprocessor class.
+===========================================================================
+*/
+
+#include "ShaderPreprocessor.h"
+#include "System/Logger.h"
+#include "System/FileUtils.h"
+#include <map>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+
+using namespace sedge;
+
+static bool ExpandFile(const std::string& path, const std::string*const text, ShaderSource& source, std::vector<std::string>& includeStack);
+static bool ParseDirective(const std::string& line, const char*const directive, std::string& argument);
+static bool IsMentioned(const std::string& text, const std::string& name);
+static bool IsIdentifierChar(const char c);
+static std::string Trim(const std::string& value);
+
+bool ShaderPreprocessor::Expand(const char*const path, ShaderSource& source)
+{
+	source.Text.clear();
+	source.Files.clear();
+	source.VersionEnd = 0;
+
+	std::vector<std::string> includeStack;
+
+	return ExpandFile(FileUtils::NormalizePath(path), nullptr, source, includeStack);
+}
+
+bool ShaderPreprocessor::Expand(const char*const path, const std::string& text, ShaderSource& source)
+{
+	source.Text.clear();
+	source.Files.clear();
+	source.VersionEnd = 0;
+
+	std::vector<std::string> includeStack;
+
+	return ExpandFile(FileUtils::NormalizePath(path), &text, source, includeStack);
+}
+
+std::vector<ShaderDefine> ShaderPreprocessor::ParseDefines(const char*const defines, const ShaderSource*const sources, const uint sourceCount)
+{
+	std::map<std::string, std::string> sorted;
+	std::stringstream stream(defines != nullptr ? defines : "");
+	std::string entry;
+
+	while (std::getline(stream, entry, ';'))
+	{
+		const size_t separator = entry.find('=');
+		const std::string name = Trim(entry.substr(0, separator));
+		if (name.empty())
+			continue;
+
+		sorted[name] = separator != std::string::npos ? Trim(entry.substr(separator + 1)) : std::string();
+	}
+
+	std::vector<ShaderDefine> result;
+	for (const auto& define : sorted)
+	{
+		bool mentioned = false;
+		for (uint i = 0; i < sourceCount && !mentioned; i++)
+			mentioned = IsMentioned(sources[i].Text, define.first);
+
+		if (!mentioned)
+			continue;
+
+		ShaderDefine shaderDefine = { define.first, define.second };
+		result.push_back(shaderDefine);
+	}
+
+	return result;
+}
+
+std::string ShaderPreprocessor::GetPermutationKey(const std::vector<ShaderDefine>& defines)
+{
+	std::string key;
+	for (const ShaderDefine& define : defines)
+	{
+		if (!key.empty())
+			key += ';';
+
+		key += define.Name;
+		if (!define.Value.empty())
+			key += '=' + define.Value;
+	}
+
+	return key;
+}
+
+std::string ShaderPreprocessor::Finalize(const ShaderSource& source, const std::vector<ShaderDefine>& defines)
+{
+	std::string text = source.Text.substr(0, source.VersionEnd);
+
+	for (const ShaderDefine& define : defines)
+		text += "#define " + define.Name + (define.Value.empty() ? "" : ' ' + define.Value) + '\n';
+
+	text.append(source.Text, source.VersionEnd, std::string::npos);
+
+	return text;
+}
+
+// Reads the file unless its text is given.
+bool ExpandFile(const std::string& path, const std::string*const text, ShaderSource& source, std::vector<std::string>& includeStack)
+{
+	if (text == nullptr && !FileUtils::CheckFileExists(path.c_str()))
+	{
+		LOG_ERROR("Shader source \"", path, "\" was not found");
+		return false;
+	}
+
+	const uint fileIndex = source.Files.size();
+	source.Files.push_back(path);
+	includeStack.push_back(path);
+
+	const size_t directoryEnd = path.find_last_of('/');
+	const std::string directory = directoryEnd != std::string::npos ? path.substr(0, directoryEnd + 1) : std::string();
+
+	if (fileIndex > 0)
+		source.Text += "#line 1 " + std::to_string(fileIndex) + '\n';
+
+	std::stringstream stream(text != nullptr ? *text : FileUtils::ReadFromFile(path));
+	std::string line;
+	std::string argument;
+	uint lineNumber = 0;
+
+	while (std::getline(stream, line))
+	{
+		lineNumber++;
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		if (ParseDirective(line, "version", argument))
+		{
+			if (fileIndex == 0 && source.VersionEnd == 0)
+			{
+				source.Text += line + '\n';
+				source.VersionEnd = source.Text.size();
+				source.Text += "#line " + std::to_string(lineNumber + 1) + " 0\n";
+			}
+			else
+			{
+				LOG_WARNING("Ignoring #version in \"", path, "\", only the root shader file may declare it");
+				source.Text += '\n';
+			}
+		}
+		else if (ParseDirective(line, "include", argument))
+		{
+			if (argument.size() < 2 || !((argument.front() == '"' && argument.back() == '"') || (argument.front() == '<' && argument.back() == '>')))
+			{
+				LOG_ERROR("Malformed #include in \"", path, "\" at line ", lineNumber);
+				return false;
+			}
+
+			const std::string includePath = FileUtils::NormalizePath(directory + argument.substr(1, argument.size() - 2));
+
+			if (std::find(includeStack.begin(), includeStack.end(), includePath) != includeStack.end())
+			{
+				LOG_ERROR("\"", path, "\" includes \"", includePath, "\" which is already being included");
+				return false;
+			}
+
+			// Already expanded earlier in this stage, the empty line keeps the numbering.
+			if (std::find(source.Files.begin(), source.Files.end(), includePath) != source.Files.end())
+			{
+				source.Text += '\n';
+				continue;
+			}
+
+			if (!ExpandFile(includePath, nullptr, source, includeStack))
+				return false;
+
+			source.Text += "#line " + std::to_string(lineNumber + 1) + ' ' + std::to_string(fileIndex) + '\n';
+		}
+		else
+			source.Text += line + '\n';
+	}
+
+	includeStack.pop_back();
+
+	return true;
+}
+
+bool ParseDirective(const std::string& line, const char*const directive, std::string& argument)
+{
+	size_t position = line.find_first_not_of(" \t");
+	if (position == std::string::npos || line[position] != '#')
+		return false;
+
+	position = line.find_first_not_of(" \t", position + 1);
+	const size_t length = strlen(directive);
+	if (position == std::string::npos || line.compare(position, length, directive) != 0)
+		return false;
+
+	position += length;
+	if (position < line.size() && IsIdentifierChar(line[position]))
+		return false;
+
+	argument = Trim(line.substr(position));
+
+	return true;
+}
+
+// A whole-word search, good enough to tell whether a define can make a difference.
+bool IsMentioned(const std::string& text, const std::string& name)
+{
+	size_t position = text.find(name);
+	while (position != std::string::npos)
+	{
+		const size_t end = position + name.size();
+		if ((position == 0 || !IsIdentifierChar(text[position - 1])) && (end == text.size() || !IsIdentifierChar(text[end])))
+			return true;
+
+		position = text.find(name, end);
+	}
+
+	return false;
+}
+
+bool IsIdentifierChar(const char c)
+{
+	return c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+std::string Trim(const std::string& value)
+{
+	const size_t first = value.find_first_not_of(" \t");
+	if (first == std::string::npos)
+		return std::string();
+
+	return value.substr(first, value.find_last_not_of(" \t") - first + 1);
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+===========================================================================
+ShaderPreprocessor.h
+
+Expands #include directives in GLSL sources and turns a list of defines
+into a permutation of a shader. Includes are resolved relative to the
+including file and every file is expanded at most once per stage, so
+shared headers need no include guards.
+
+The expanded text carries #line directives whose source string number is
+the index of the file in ShaderSource::Files, which is how compiler
+messages are mapped back to the file they came from.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	struct ShaderSource
+	{
+		std::string Text;
+		std::vector<std::string> Files; // the root file first, then every include in the order it was expanded
+		uint VersionEnd; // offset just past the #version line, 0 if there is none
+	};
+
+	struct ShaderDefine
+	{
+		std::string Name;
+		std::string Value; // empty for plain #define NAME
+	};
+
+	class ShaderPreprocessor
+	{
+	public:
+		// Fails if a file cannot be read or includes itself through any chain of includes.
+		static bool Expand(const char*const path, ShaderSource& source);
+		// The same with the text of the root file already read, includes are still read from disk.
+		static bool Expand(const char*const path, const std::string& text, ShaderSource& source);
+
+		// Parses "NAME[=VALUE]" entries separated by ';'. Names none of the sources mention are dropped
+		// and the rest are sorted by name, so every set of defines that produces the same code
+		// gets the same permutation key. Later entries override earlier ones with the same name.
+		static std::vector<ShaderDefine> ParseDefines(const char*const defines, const ShaderSource*const sources, const uint sourceCount);
+		// "NAME;NAME=VALUE;...", empty for the plain shader.
+		static std::string GetPermutationKey(const std::vector<ShaderDefine>& defines);
+
+		// The source handed to the compiler, the defines go right after the #version line.
+		static std::string Finalize(const ShaderSource& source, const std::vector<ShaderDefine>& defines);
+
+	private:
+		ShaderPreprocessor();
+		ShaderPreprocessor(const ShaderPreprocessor& tRef) = delete;
+		ShaderPreprocessor& operator = (const ShaderPreprocessor& tRef) = delete;
+	};
+}
\ No newline at end of file
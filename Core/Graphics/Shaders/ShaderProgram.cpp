@@ -1,80 +1,154 @@
 #include "ShaderProgram.h"
+#include "ShaderCache.h"
 #include "System/Logger.h"
 #include "System/FileUtils.h"
+#include "System/AsyncFileReader.h"
 #include "Graphics/GraphicsAPI.h"
 #include "System/MemoryManagement.h"
 #include "Math/Vector2.h"
 #include "Math/Vector3.h"
 #include "Math/Vector4.h"
 #include "Math/Matrix4.h"
+#include <algorithm>
 
 using namespace sedge;
 
-ShaderProgram::ShaderProgram(const char*const name, const char*const vertexPath, const char*const fragmentPath)
-	: _name(name), _vertexPath(vertexPath), _fragmentPath(fragmentPath)
+ShaderProgram::ShaderProgram(const char*const name, const char*const vertexPath, const char*const fragmentPath, const char*const defines)
+	: _name(name), _vertexPath(vertexPath), _fragmentPath(fragmentPath), _defines(defines != nullptr ? defines : "")
 {
 	_programID = GraphicsAPI::CreateShaderProgram();
 }
 
 ShaderProgram::~ShaderProgram()
 {
-	GraphicsAPI::DetachShader(_programID, _vertexID);
-	GraphicsAPI::DetachShader(_programID, _fragmentID);
 	GraphicsAPI::DeleteShaderProgram(_programID);
 }
 
 const bool ShaderProgram::Load()
 {
-	// Create and compile vertex shader.
-	_vertexID = GraphicsAPI::CreateShader(Vertex);
-	std::string vertexSource = FileUtils::ReadFromFile(_vertexPath);
+	ShaderProgramSource source;
+	if (!Prepare(_vertexPath.c_str(), _fragmentPath.c_str(), _defines.c_str(), source) || !Build(source, _programID))
+		return false;
 
-	if (vertexSource == "")
+	_permutationKey = source.PermutationKey;
+	_dependencies = source.Dependencies;
+
+	return true;
+}
+
+const bool ShaderProgram::Prepare(const char*const vertexPath, const char*const fragmentPath, const char*const defines, ShaderProgramSource& source)
+{
+	// Both stages are read at once, their includes are usually few and already cached by the OS.
+	FileView files[2];
+	AsyncFileReader& reader = AsyncFileReader::GetShared();
+	std::future<bool> reads[2] = { reader.Read(vertexPath, files[0]), reader.Read(fragmentPath, files[1]) };
+	const bool found[2] = { reads[0].get(), reads[1].get() };
+	const char*const paths[2] = { vertexPath, fragmentPath };
+
+	for (uint i = 0; i < 2; i++)
 	{
-		LOG_ERROR("Cannot find vertex shader source");
-		return false;
+		if (!found[i])
+		{
+			LOG_ERROR("Shader source \"", paths[i], "\" was not found");
+			return false;
+		}
+
+		const std::string text((const char*)files[i].GetData(), (size_t)files[i].GetSize());
+		if (!ShaderPreprocessor::Expand(paths[i], text, source.Stages[i]))
+			return false;
 	}
 
-	GraphicsAPI::LoadShaderSource(_vertexID, vertexSource.c_str());
+	const std::vector<ShaderDefine> usedDefines = ShaderPreprocessor::ParseDefines(defines, source.Stages, 2);
+	source.PermutationKey = ShaderPreprocessor::GetPermutationKey(usedDefines);
 
-	if (!Compile(_vertexID))
+	source.Dependencies = source.Stages[0].Files;
+	for (const std::string& file : source.Stages[1].Files)
 	{
-		GraphicsAPI::DeleteShader(_vertexID);
-		return false;
+		if (std::find(source.Dependencies.begin(), source.Dependencies.end(), file) == source.Dependencies.end())
+			source.Dependencies.push_back(file);
 	}
 
-	// Create and compile fragment shader.
-	_fragmentID = GraphicsAPI::CreateShader(Fragment);
-	std::string fragmentSource = FileUtils::ReadFromFile(_fragmentPath);
+	source.Texts[0] = ShaderPreprocessor::Finalize(source.Stages[0], usedDefines);
+	source.Texts[1] = ShaderPreprocessor::Finalize(source.Stages[1], usedDefines);
+	source.Hash = ShaderCache::HashSources(source.Texts[0], source.Texts[1]);
+	source.CachePath = ShaderCache::GetCachePath(vertexPath, fragmentPath, source.PermutationKey);
+	source.BinaryRead = reader.Read(source.CachePath.c_str(), source.Binary, IOPriorityNormal);
+
+	return true;
+}
 
-	if (fragmentSource == "")
+const bool ShaderProgram::Reload(ShaderProgramSource& source)
+{
+	const ID programID = GraphicsAPI::CreateShaderProgram();
+
+	if (!Build(source, programID))
 	{
-		LOG_ERROR("Cannot find fragment shader source");
+		GraphicsAPI::DeleteShaderProgram(programID);
 		return false;
 	}
 
-	GraphicsAPI::LoadShaderSource(_fragmentID, fragmentSource.c_str());
+	GraphicsAPI::CopyUniforms(_programID, programID);
+	GraphicsAPI::DeleteShaderProgram(_programID);
+
+	_programID = programID;
+	_permutationKey = source.PermutationKey;
+	_dependencies = source.Dependencies;
+
+	// The old program may have been the current one, uniforms set without binding must not go to it.
+	Bind();
+
+	return true;
+}
+
+const bool ShaderProgram::Build(ShaderProgramSource& source, const ID programID)
+{
+	// A binary built from the same sources by the same driver makes compiling unnecessary.
+	const bool cached = source.BinaryRead.valid() && source.BinaryRead.get() && ShaderCache::Load(source.Binary, source.Hash, programID);
+
+	// A stale binary is rewritten below, which fails on some systems while the file is still mapped.
+	source.Binary.Close();
 
-	if (!Compile(_fragmentID))
+	if (cached)
+		return true;
+
+	// Create and compile vertex shader.
+	const ID vertexID = GraphicsAPI::CreateShader(Vertex);
+	GraphicsAPI::LoadShaderSource(vertexID, source.Texts[0].c_str());
+
+	if (!Compile(vertexID, source.Stages[0]))
+		return false;
+
+	// Create and compile fragment shader.
+	const ID fragmentID = GraphicsAPI::CreateShader(Fragment);
+	GraphicsAPI::LoadShaderSource(fragmentID, source.Texts[1].c_str());
+
+	if (!Compile(fragmentID, source.Stages[1]))
 	{
-		GraphicsAPI::DeleteShader(_vertexID);
-		GraphicsAPI::DeleteShader(_fragmentID);
+		GraphicsAPI::DeleteShader(vertexID);
 		return false;
 	}
 
-	GraphicsAPI::AttachShader(_programID, _vertexID);
-	GraphicsAPI::AttachShader(_programID, _fragmentID);
+	GraphicsAPI::AttachShader(programID, vertexID);
+	GraphicsAPI::AttachShader(programID, fragmentID);
 
-	GraphicsAPI::LinkShaderProgram(_programID);
-	GraphicsAPI::ValidateShaderProgram(_programID);
+	const bool linked = Link(programID);
 
-	GraphicsAPI::DeleteShader(_vertexID);
-	GraphicsAPI::DeleteShader(_fragmentID);
+	// The linked program does not need the shaders anymore.
+	GraphicsAPI::DetachShader(programID, vertexID);
+	GraphicsAPI::DetachShader(programID, fragmentID);
+	GraphicsAPI::DeleteShader(vertexID);
+	GraphicsAPI::DeleteShader(fragmentID);
+
+	if (!linked)
+		return false;
+
+	if (ShaderCache::IsSupported() && !ShaderCache::Write(source.CachePath.c_str(), source.Hash, programID))
+		LOG_WARNING("Failed to write shader cache \"", source.CachePath, "\"");
 
 	return true;
 }
 
-const bool ShaderProgram::Compile(const ID shaderID)
+const bool ShaderProgram::Compile(const ID shaderID, const ShaderSource& source)
 {
 	// If the shader failed to compile, display the info log and return
 	if (!GraphicsAPI::CompileShader(shaderID))
@@ -82,6 +156,9 @@ const bool ShaderProgram::Compile(const ID shaderID)
 		char* info = GraphicsAPI::GetShaderInfoLog(shaderID);
 
 		LOG_ERROR("shader compilation failed: ", info);
+		// The log refers to files by the source string numbers of the #line directives.
+		for (uint i = 0; i < source.Files.size(); i++)
+			LOG_ERROR("source string ", i, ": ", source.Files[i]);
 		
 		SafeDeleteArray(info);
 
@@ -93,6 +170,29 @@ const bool ShaderProgram::Compile(const ID shaderID)
 	return true;
 }
 
+const bool ShaderProgram::Link(const ID programID)
+{
+	if (ShaderCache::IsSupported())
+		GraphicsAPI::SetProgramBinaryRetrievable(programID);
+
+	GraphicsAPI::LinkShaderProgram(programID);
+
+	if (!GraphicsAPI::GetProgramLinkStatus(programID))
+	{
+		char* info = GraphicsAPI::GetProgramInfoLog(programID);
+
+		LOG_ERROR("shader program linking failed: ", info);
+
+		SafeDeleteArray(info);
+
+		return false;
+	}
+
+	GraphicsAPI::ValidateShaderProgram(programID);
+
+	return true;
+}
+
 void ShaderProgram::SetProjection(const Matrix4& matrix)
 {
 	Bind();
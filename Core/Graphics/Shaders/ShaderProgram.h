@@ -2,6 +2,10 @@
 
 #include <CustomTypes.h>
 #include <string>
+#include <vector>
+#include <future>
+#include "ShaderPreprocessor.h"
+#include "System/FileSystem.h"
 
 namespace sedge
 {
@@ -10,25 +14,48 @@ namespace sedge
 	struct Vector4;
 	struct Matrix4;
 
+	// Everything needed to build a program, prepared without touching the graphics API.
+	struct ShaderProgramSource
+	{
+		ShaderSource Stages[2]; // vertex, fragment
+		std::string Texts[2]; // as handed to the compiler
+		std::string PermutationKey;
+		std::vector<std::string> Dependencies;
+		unsigned long long Hash;
+		std::string CachePath;
+		FileView Binary; // the cached program, read in the background while the source waits to be built
+		std::future<bool> BinaryRead;
+
+		~ShaderProgramSource() { if (BinaryRead.valid()) BinaryRead.wait(); }
+	};
+
 	class ShaderProgram
 	{
 	private:
 		std::string _name;
 		std::string _vertexPath;
 		std::string _fragmentPath;
+		std::string _defines;
+		std::string _permutationKey;
+		std::vector<std::string> _dependencies;
 		ID _programID;
-		ID _vertexID;
-		ID _fragmentID;
 
 	private:
-		ShaderProgram(const char*const name, const char*const vertexPath, const char*const fragmentPath);
+		ShaderProgram(const char*const name, const char*const vertexPath, const char*const fragmentPath, const char*const defines);
 
 	public:
 		~ShaderProgram();
 
 	public:
 		const char*const GetName() const { return _name.c_str(); }
+		const char*const GetVertexPath() const { return _vertexPath.c_str(); }
+		const char*const GetFragmentPath() const { return _fragmentPath.c_str(); }
+		const char*const GetDefines() const { return _defines.c_str(); }
 		const ID GetProgramID() const { return _programID; }
+		// Only the defines the sources actually use, sorted by name.
+		const char*const GetPermutationKey() const { return _permutationKey.c_str(); }
+		// Both stages' files and everything they include, with normalized paths.
+		const std::vector<std::string>& GetDependencies() const { return _dependencies; }
 
 		void Bind() const;
 		void Unbind() const;
@@ -45,10 +72,20 @@ namespace sedge
 		void SetView(const Matrix4& viewMatrix);
 		void SetModel(const Matrix4& modelMatrix);
 
+		// Reads and preprocesses the sources, safe to call from any thread. Waits for the reads, so the rendering
+		// thread only calls it for the first build of a program, reloads prepare their sources on the thread pool.
+		static const bool Prepare(const char*const vertexPath, const char*const fragmentPath, const char*const defines, ShaderProgramSource& source);
+		// Builds a new program from prepared sources and swaps it in, keeping the values of the uniforms both versions share.
+		// The current program stays if the new one fails to build. Must be called on the rendering thread.
+		const bool Reload(ShaderProgramSource& source);
+
 		friend class ShaderFactory;
 
 	private:
 		const bool Load();
-		const bool Compile(const ID shaderID);
+		// Takes the program from the binary cache or compiles and links it.
+		const bool Build(ShaderProgramSource& source, const ID programID);
+		const bool Compile(const ID shaderID, const ShaderSource& source);
+		const bool Link(const ID programID);
 	};
 }
\ No newline at end of file
@@ -41,5 +41,8 @@ namespace sedge
 	{
 		Vector3 Position;
 		Vector2 UV;
+		Vector2 Morph; // x - height at the next coarser LOD, y - LOD level the vertex morphs at
+		Color Splat; // weights of the terrain layers
+		Vector3 Normal;
 	};
 }
\ No newline at end of file
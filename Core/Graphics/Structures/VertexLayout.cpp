@@ -86,6 +86,9 @@ VertexLayout VertexLayout::GetDefaultTerrainVertexLayout()
 	VertexLayout layout;
 	layout.AddEntry("position", 0, 3, Float, false, structSize, (const void*)(offsetof(VertexDataTerrain, Position)));
 	layout.AddEntry("uv", 1, 2, Float, false, structSize, (const void*)(offsetof(VertexDataTerrain, UV)));
+	layout.AddEntry("morph", 2, 2, Float, false, structSize, (const void*)(offsetof(VertexDataTerrain, Morph)));
+	layout.AddEntry("splat", 3, 4, Ubyte, true, structSize, (const void*)(offsetof(VertexDataTerrain, Splat)));
+	layout.AddEntry("normal", 4, 3, Float, false, structSize, (const void*)(offsetof(VertexDataTerrain, Normal)));
 
 	return layout;
-}
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+/*
+===========================================================================
+Heightmap.cpp
+
+Implements the Heightmap class.
+===========================================================================
+*/
+
+#include "Heightmap.h"
+#include "System/ImageUtils.h"
+#include "System/Logger.h"
+#include "System/ThreadPool.h"
+#include <cmath>
+
+using namespace sedge;
+
+static float GetLatticeValue(const int x, const int z, const uint seed);
+static float GetValueNoise(const float x, const float z, const uint seed);
+
+Heightmap::Heightmap(const uint width, const uint depth)
+	: _width(width), _depth(depth), _heights(width * depth, 0.0f)
+{
+}
+
+const float Heightmap::GetHeight(const int x, const int z) const
+{
+	const int cx = x < 0 ? 0 : (x >= (int)_width ? (int)_width - 1 : x);
+	const int cz = z < 0 ? 0 : (z >= (int)_depth ? (int)_depth - 1 : z);
+
+	return _heights[cz * _width + cx];
+}
+
+void Heightmap::SetHeight(const uint x, const uint z, const float height)
+{
+	_heights[z * _width + x] = height;
+}
+
+Heightmap* Heightmap::LoadFromFile(const char*const path, const float heightScale)
+{
+	int width;
+	int height;
+	int components;
+
+	byte* imagePixels = ImageUtils::LoadImage(path, &width, &height, &components);
+
+	if (!imagePixels)
+	{
+		LOG_ERROR("Failed to load heightmap \"", path, "\"");
+		return nullptr;
+	}
+
+	Heightmap* heightmap = new Heightmap(width, height);
+
+	// Only the first channel is used, grayscale images are expected.
+	for (int z = 0; z < height; z++)
+	{
+		for (int x = 0; x < width; x++)
+			heightmap->_heights[z * width + x] = imagePixels[(z * width + x) * components] / 255.0f * heightScale;
+	}
+
+	ImageUtils::ReleaseImage(imagePixels);
+
+	return heightmap;
+}
+
+Heightmap* Heightmap::CreateProcedural(const uint width, const uint depth, const float heightScale, const uint seed)
+{
+	Heightmap* heightmap = new Heightmap(width, depth);
+
+	const int octaves = 6;
+
+	ThreadPool::GetShared().ParallelFor(0, depth, 16, [=](const uint rowBegin, const uint rowEnd)
+	{
+		for (uint z = rowBegin; z < rowEnd; z++)
+		{
+			for (uint x = 0; x < width; x++)
+			{
+				float frequency = 1.0f / 128.0f;
+				float amplitude = 1.0f;
+				float sum = 0.0f;
+				float norm = 0.0f;
+
+				for (int i = 0; i < octaves; i++)
+				{
+					sum += GetValueNoise(x * frequency, z * frequency, seed + i) * amplitude;
+					norm += amplitude;
+					frequency *= 2.0f;
+					amplitude *= 0.5f;
+				}
+
+				heightmap->_heights[z * width + x] = sum / norm * heightScale;
+			}
+		}
+	});
+
+	return heightmap;
+}
+
+float GetLatticeValue(const int x, const int z, const uint seed)
+{
+	uint hash = (uint)x * 374761393u + (uint)z * 668265263u + seed * 2147483647u;
+	hash = (hash ^ (hash >> 13)) * 1274126177u;
+	hash ^= hash >> 16;
+
+	return (hash & 0xffff) / 65535.0f;
+}
+
+float GetValueNoise(const float x, const float z, const uint seed)
+{
+	const int x0 = (int)floorf(x);
+	const int z0 = (int)floorf(z);
+
+	float tx = x - x0;
+	float tz = z - z0;
+	tx = tx * tx * (3.0f - 2.0f * tx);
+	tz = tz * tz * (3.0f - 2.0f * tz);
+
+	const float v00 = GetLatticeValue(x0, z0, seed);
+	const float v10 = GetLatticeValue(x0 + 1, z0, seed);
+	const float v01 = GetLatticeValue(x0, z0 + 1, seed);
+	const float v11 = GetLatticeValue(x0 + 1, z0 + 1, seed);
+
+	const float top = v00 + (v10 - v00) * tx;
+	const float bottom = v01 + (v11 - v01) * tx;
+
+	return top + (bottom - top) * tz;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+/*
+===========================================================================
+Heightmap.h
+
+A grid of height samples that terrain geometry is built from.
+Can be loaded from a grayscale image or generated procedurally.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	class Heightmap
+	{
+	private:
+		uint _width;
+		uint _depth;
+		std::vector<float> _heights;
+
+	public:
+		Heightmap(const uint width, const uint depth);
+
+		inline uint GetWidth() const { return _width; }
+		inline uint GetDepth() const { return _depth; }
+		inline const float* GetData() const { return _heights.data(); }
+
+		// Coordinates outside of the map are clamped to its edges.
+		const float GetHeight(const int x, const int z) const;
+		void SetHeight(const uint x, const uint z, const float height);
+
+		static Heightmap* LoadFromFile(const char*const path, const float heightScale);
+		static Heightmap* CreateProcedural(const uint width, const uint depth, const float heightScale, const uint seed);
+	};
+}
\ No newline at end of file
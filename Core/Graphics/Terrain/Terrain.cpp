@@ -1,93 +1,319 @@
+/*
+===========================================================================
+Terrain.cpp
+
+Implements the Terrain class.
+Every chunk holds a (ChunkSize + 1)^2 grid of shared vertices, while one index
+buffer per level of detail describes the grid triangulation for all chunks.
+Level i uses every 2^i-th vertex; vertices that are dropped by the next level
+carry the height they would have there, so the shader can morph them away
+before a chunk switches levels and no popping is visible.
+Streamed terrains know the bounds and level errors of every tile up front,
+so culling and LOD selection work before any tile is resident.
+===========================================================================
+*/
+
 #include "Terrain.h"
+#include "TerrainChunk.h"
+#include "TerrainTileFile.h"
+#include "TerrainStreamer.h"
+#include "Heightmap.h"
 #include "System/MemoryManagement.h"
-#include "Graphics/Buffers/VertexBuffer.h"
+#include "System/Logger.h"
+#include "System/ThreadPool.h"
 #include "Graphics/Buffers/IndexBuffer.h"
 #include "Graphics/Structures/VertexData.h"
-#include "Graphics/Structures/VertexLayout.h"
-#include "Graphics/GraphicsAPI.h"
 #include "Graphics/Textures/Texture2D.h"
+#include "Graphics/Shaders/ShaderProgram.h"
+#include "Logic/Cameras/Camera.h"
+#include "Math/BoundingBox.h"
+#include "Math/Frustum.h"
+#include "Math/Converters.h"
+#include "Math/Vector2.h"
+#include <algorithm>
+#include <mutex>
+#include <cmath>
 
 using namespace sedge;
 
-const int MAX_TILES = 1048576;
+Terrain::Terrain(Texture2D*const texture, Heightmap*const heightmap, const TerrainParameters& parameters)
+	: _chunkDiagonal(0.0f), _texture(texture), _heightmap(heightmap), _tileFile(nullptr), _streamer(nullptr), _parameters(parameters)
+{
+	for (uint i = 0; i < LayerCount; i++)
+		_layers[i] = nullptr;
 
-static uint* FillIndexBuffer(const uint maxIndices);
+	const uint supportedLevels = _parameters.GetSupportedLodLevels();
+	if (supportedLevels != _parameters.LodLevels)
+	{
+		LOG_WARNING("Terrain chunk size ", _parameters.ChunkSize, " does not support ", _parameters.LodLevels, " LOD levels");
+		_parameters.LodLevels = supportedLevels;
+	}
 
-Terrain::Terrain(Texture2D*const texture)
-	: _texture(texture)
-{
+	GenerateIndices();
 	GenerateTerrain();
+	BuildQuadtree();
+}
+
+Terrain::Terrain(Texture2D*const texture, const char*const tilesPath, const TerrainParameters& parameters)
+	: _chunkDiagonal(0.0f), _texture(texture), _heightmap(nullptr), _tileFile(nullptr), _streamer(nullptr), _parameters(parameters)
+{
+	for (uint i = 0; i < LayerCount; i++)
+		_layers[i] = nullptr;
+
+	_tileFile = new TerrainTileFile();
+	if (!_tileFile->Open(tilesPath))
+	{
+		SafeDelete(_tileFile);
+		return;
+	}
+
+	const TerrainParameters& fileParameters = _tileFile->GetParameters();
+	_parameters.ChunkCount = fileParameters.ChunkCount;
+	_parameters.ChunkSize = fileParameters.ChunkSize;
+	_parameters.TileSize = fileParameters.TileSize;
+	_parameters.LodLevels = fileParameters.LodLevels;
+	_levelErrors = _tileFile->GetLevelErrors();
+
+	const uint tileCount = _tileFile->GetTileCount();
+	_chunks.assign(tileCount, nullptr);
+	_chunkBounds.resize(tileCount);
+	for (uint i = 0; i < tileCount; i++)
+		_chunkBounds[i] = _tileFile->GetTileBounds(i);
+
+	GenerateIndices();
+	BuildQuadtree();
+
+	_streamer = new TerrainStreamer(*_tileFile, _parameters);
 }
 
 Terrain::~Terrain()
 {
-	SafeDelete(_vbo);
-	SafeDelete(_ibo);
+	// The streamer reads from the tile file until it is stopped.
+	SafeDelete(_streamer);
+	SafeDelete(_tileFile);
+
+	for (auto chunk : _chunks)
+		SafeDelete(chunk);
+
+	for (auto ibo : _lodIndexBuffers)
+		SafeDelete(ibo);
+
+	SafeDelete(_heightmap);
 }
 
-void Terrain::Draw() const
+void Terrain::SetMaxScreenError(const float pixels, const float viewportHeight)
 {
-	Texture2D::ActivateTexture(0);
-	_texture->Bind();
-	_vbo->Bind();
-	_ibo->Bind();
-	GraphicsAPI::DrawTrianglesIndexed(_ibo->GetCount());
+	_parameters.MaxScreenError = pixels;
+	_parameters.ViewportHeight = viewportHeight;
 }
 
-void Terrain::GenerateTerrain()
+void Terrain::SetLayerTexture(const uint index, Texture2D*const texture)
 {
-	const int vertexCount = MAX_TILES * 4;
-	VertexDataTerrain* vertices = new VertexDataTerrain[vertexCount];
-	const int indexCount = (int)(vertexCount * 1.5);
+	if (index >= LayerCount)
+	{
+		LOG_ERROR("Terrain layer index ", index, " is out of range");
+		return;
+	}
+
+	_layers[index] = texture;
+}
+
+void Terrain::Update(const Camera& camera)
+{
+	if (!_streamer)
+		return;
+
+	_streamer->Update(camera.GetPosition(), _evictions);
+	for (const uint index : _evictions)
+		SafeDelete(_chunks[index]);
+
+	_streamer->CollectLoadedTiles(_streamedTiles);
+	for (TerrainStreamedTile* tile : _streamedTiles)
+	{
+		_chunks[tile->Index] = new TerrainChunk(tile->Vertices.data(), tile->Vertices.size(), _chunkBounds[tile->Index]);
+		SafeDelete(tile);
+	}
 
-	float quarterSize = (float)(sqrt(MAX_TILES) / 2);
+	_streamedTiles.clear();
+}
+
+void Terrain::Draw(const Camera& camera, ShaderProgram*const shader)
+{
+	if (_chunks.empty())
+		return;
+
+	const Frustum frustum(camera.GetProjection(), camera.GetView());
+	const Vector3& cameraPosition = camera.GetPosition();
+
+	UpdateLodRanges(camera);
+	_quadtree.Select(frustum, cameraPosition, _lodRanges, _selection);
 
-	VertexDataTerrain* vertex = vertices;
+	int layerUnits[LayerCount];
+	for (uint i = 0; i < LayerCount; i++)
+	{
+		layerUnits[i] = (int)i;
+		Texture2D::ActivateTexture(i);
+		(_layers[i] ? _layers[i] : _texture)->Bind();
+	}
+
+	shader->SetUniform1iv("layers", LayerCount, layerUnits);
+	shader->SetUniform3f("cameraPosition", cameraPosition);
 
-	for (float z = -quarterSize + 1; z <= quarterSize; z++)
+	for (uint level = 0; level < _parameters.LodLevels; level++)
 	{
-		for (float x = -quarterSize + 1; x <= quarterSize; x++)
+		bool levelBound = false;
+
+		for (const TerrainSelection& item : _selection)
 		{
-			vertex->Position = Vector3(x - 1, 0, z);
-			vertex->UV = Vector2(0, 0);
-			vertex++;
+			if (item.Level != level || !_chunks[item.ChunkIndex])
+				continue;
 
-			vertex->Position = Vector3(x - 1, 0, z + 1);
-			vertex->UV = Vector2(0, 1);
-			vertex++;
+			if (!levelBound)
+			{
+				// Vertices of this level are fully morphed once they reach the next level's range.
+				const bool isLastLevel = level + 1 >= _parameters.LodLevels;
+				const float morphEnd = isLastLevel ? 2e9f : _lodRanges[level + 1];
+				const float morphStart = isLastLevel ? 1e9f : morphEnd - (morphEnd - _lodRanges[level]) * 0.5f;
 
-			vertex->Position = Vector3(x, 0, z + 1);
-			vertex->UV = Vector2(1, 1);
-			vertex++;
+				shader->SetUniform1f("lodLevel", (float)level);
+				shader->SetUniform2f("morphRange", Vector2(morphStart, morphEnd));
+				_lodIndexBuffers[level]->Bind();
+				levelBound = true;
+			}
 
-			vertex->Position = Vector3(x, 0, z);
-			vertex->UV = Vector2(1, 0);
-			vertex++;
+			_chunks[item.ChunkIndex]->Draw(_lodIndexBuffers[level]);
 		}
 	}
 
-	_vbo = new VertexBuffer(sizeof(VertexDataTerrain), vertexCount, VertexLayout::GetDefaultTerrainVertexLayout(), vertices);
-	SafeDeleteArray(vertices);
+	Texture2D::ActivateTexture(0);
+}
+
+void Terrain::UpdateLodRanges(const Camera& camera)
+{
+	// Distance at which a world-space error of 1 projects onto 1 pixel.
+	const float pixelScale = _parameters.ViewportHeight / (2.0f * tanf(DegToRad(camera.GetFOV()) * 0.5f));
+
+	_lodRanges.resize(_parameters.LodLevels);
+	_lodRanges[0] = 0.0f;
+
+	for (uint level = 1; level < _parameters.LodLevels; level++)
+	{
+		const float errorDistance = _levelErrors[level] * pixelScale / _parameters.MaxScreenError;
+
+		// Keep neighbouring chunks at most one level apart and leave room for morphing.
+		const float minDistance = _lodRanges[level - 1] + 2.0f * _chunkDiagonal;
+
+		_lodRanges[level] = errorDistance > minDistance ? errorDistance : minDistance;
+	}
+}
+
+void Terrain::GenerateTerrain()
+{
+	const uint chunkVertexCount = (_parameters.ChunkSize + 1) * (_parameters.ChunkSize + 1);
+
+	std::vector<VertexDataTerrain> vertices;
+	GenerateVertices(*_heightmap, _parameters, ThreadPool::GetShared(), vertices, _chunkBounds, _levelErrors);
+
+	_chunks.reserve(_chunkBounds.size());
+	for (uint i = 0; i < _chunkBounds.size(); i++)
+		_chunks.push_back(new TerrainChunk(&vertices[i * chunkVertexCount], chunkVertexCount, _chunkBounds[i]));
+}
+
+void Terrain::GenerateVertices(const Heightmap& heightmap, const TerrainParameters& parameters, ThreadPool& pool,
+	std::vector<VertexDataTerrain>& vertices, std::vector<BoundingBox>& chunkBounds, std::vector<float>& levelErrors)
+{
+	const uint chunkVertexCount = (parameters.ChunkSize + 1) * (parameters.ChunkSize + 1);
+	const uint chunkCount = parameters.ChunkCount * parameters.ChunkCount;
+
+	vertices.resize(chunkCount * chunkVertexCount);
+	chunkBounds.resize(chunkCount);
+
+	std::vector<float> stepErrors(parameters.LodLevels, 0.0f);
+	std::mutex stepErrorsMutex;
 
-	uint* indices = FillIndexBuffer(indexCount);
-	_ibo = new IndexBuffer(indexCount, indices);
-	SafeDeleteArray(indices);
+	pool.ParallelFor(0, parameters.ChunkCount, 1, [&](const uint rowBegin, const uint rowEnd)
+	{
+		std::vector<float> rangeErrors(parameters.LodLevels, 0.0f);
+		TerrainTile tile;
+
+		for (uint chunkZ = rowBegin; chunkZ < rowEnd; chunkZ++)
+		{
+			for (uint chunkX = 0; chunkX < parameters.ChunkCount; chunkX++)
+			{
+				const uint index = chunkZ * parameters.ChunkCount + chunkX;
+
+				TerrainTileFile::ExtractTile(heightmap, chunkX, chunkZ, parameters.ChunkSize, tile);
+				TerrainChunk::BuildVertices(tile, parameters, &vertices[index * chunkVertexCount], rangeErrors.data());
+
+				float minHeight;
+				float maxHeight;
+				tile.GetHeightRange(minHeight, maxHeight);
+				chunkBounds[index] = parameters.GetChunkBounds(chunkX, chunkZ, minHeight, maxHeight);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(stepErrorsMutex);
+		for (uint level = 0; level < parameters.LodLevels; level++)
+			stepErrors[level] = rangeErrors[level] > stepErrors[level] ? rangeErrors[level] : stepErrors[level];
+	});
+
+	// The error of a level accumulates the errors of all the steps leading to it.
+	levelErrors.resize(parameters.LodLevels);
+	levelErrors[0] = 0.0f;
+	for (uint level = 1; level < parameters.LodLevels; level++)
+		levelErrors[level] = levelErrors[level - 1] + stepErrors[level - 1];
 }
 
-uint* FillIndexBuffer(const uint maxIndices)
+void Terrain::GenerateIndices()
 {
-	uint* indices = new uint[maxIndices];
+	const uint chunkSize = _parameters.ChunkSize;
+	const uint gridSize = chunkSize + 1;
 
-	for (uint i = 0, offset = 0; i < maxIndices; i += 6, offset += 4)
+	std::vector<uint> indices;
+
+	for (uint level = 0; level < _parameters.LodLevels; level++)
 	{
-		indices[i] = offset + 0;
-		indices[i + 1] = offset + 1;
-		indices[i + 2] = offset + 2;
+		const uint step = 1 << level;
+		const uint quads = chunkSize / step;
+
+		indices.resize(quads * quads * 6);
 
-		indices[i + 3] = offset + 2;
-		indices[i + 4] = offset + 3;
-		indices[i + 5] = offset + 0;
+		ThreadPool::GetShared().ParallelFor(0, quads, 16, [&](const uint rowBegin, const uint rowEnd)
+		{
+			for (uint row = rowBegin; row < rowEnd; row++)
+			{
+				const uint z = row * step;
+				uint* index = &indices[row * quads * 6];
+
+				for (uint x = 0; x < chunkSize; x += step)
+				{
+					const uint a = z * gridSize + x;
+					const uint b = (z + step) * gridSize + x;
+					const uint c = (z + step) * gridSize + x + step;
+					const uint d = z * gridSize + x + step;
+
+					*index++ = a;
+					*index++ = b;
+					*index++ = c;
+
+					*index++ = c;
+					*index++ = d;
+					*index++ = a;
+				}
+			}
+		});
+
+		_lodIndexBuffers.push_back(new IndexBuffer(indices.size(), indices.data()));
+	}
+}
+
+void Terrain::BuildQuadtree()
+{
+	for (const BoundingBox& bounds : _chunkBounds)
+	{
+		const float diagonal = (bounds.Max - bounds.Min).GetLength();
+		_chunkDiagonal = diagonal > _chunkDiagonal ? diagonal : _chunkDiagonal;
 	}
 
-	return indices;
+	_quadtree.Build(_chunkBounds, _parameters.ChunkCount);
 }
\ No newline at end of file
@@ -1,27 +1,88 @@
+/*
+===========================================================================
+Terrain.h
+
+Declares a heightmap-driven terrain split into square chunks.
+Chunks outside of the camera frustum are not drawn, visible chunks are
+drawn at a level of detail chosen from a screen-space error metric.
+A terrain is either built from a heightmap in memory or streamed from a
+tile file around the camera.
+===========================================================================
+*/
+
 #pragma once
 
+#include <vector>
 #include <CustomTypes.h>
+#include "TerrainQuadtree.h"
+#include "TerrainParameters.h"
 
 namespace sedge
 {
-	class VertexBuffer;
 	class IndexBuffer;
 	class Texture2D;
+	class Camera;
+	class ShaderProgram;
+	class Heightmap;
+	class TerrainChunk;
+	class TerrainTileFile;
+	class TerrainStreamer;
+	class ThreadPool;
+	struct TerrainStreamedTile;
+	struct VertexDataTerrain;
 
 	class Terrain
 	{
+	public:
+		static const uint LayerCount = 4;
+
 	private:
-		VertexBuffer* _vbo;
-		IndexBuffer* _ibo;
+		std::vector<TerrainChunk*> _chunks; // nullptr for tiles that are not streamed in
+		std::vector<BoundingBox> _chunkBounds;
+		std::vector<IndexBuffer*> _lodIndexBuffers;
+		std::vector<float> _levelErrors;
+		std::vector<float> _lodRanges;
+		std::vector<TerrainSelection> _selection;
+		std::vector<uint> _evictions;
+		std::vector<TerrainStreamedTile*> _streamedTiles;
+		TerrainQuadtree _quadtree;
+		float _chunkDiagonal;
 		Texture2D*const _texture;
+		Texture2D* _layers[LayerCount];
+		Heightmap* _heightmap;
+		TerrainTileFile* _tileFile;
+		TerrainStreamer* _streamer;
+		TerrainParameters _parameters;
 
 	public:
-		Terrain(Texture2D*const texture);
+		Terrain(Texture2D*const texture, Heightmap*const heightmap, const TerrainParameters& parameters = TerrainParameters());
+		// Layout and LOD settings are taken from the file, the rest from the parameters.
+		Terrain(Texture2D*const texture, const char*const tilesPath, const TerrainParameters& parameters = TerrainParameters());
 		~Terrain();
 
-		void Draw() const;
+		inline const TerrainParameters& GetParameters() const { return _parameters; }
+		inline const Heightmap*const GetHeightmap() const { return _heightmap; }
+		inline uint GetChunkCount() const { return _chunks.size(); }
+		inline bool IsStreamed() const { return _streamer != nullptr; }
+		inline uint GetVisibleChunkCount() const { return _selection.size(); }
+
+		void SetMaxScreenError(const float pixels, const float viewportHeight);
+		// Layers without a texture fall back to the base texture.
+		void SetLayerTexture(const uint index, Texture2D*const texture);
+
+		// Evicts and uploads streamed tiles, must be called on the rendering thread.
+		void Update(const Camera& camera);
+		void Draw(const Camera& camera, ShaderProgram*const shader);
+
+		// Builds the vertices of all chunks into one buffer, chunk after chunk, splitting the chunk rows
+		// between the pool's threads. Does not touch the graphics API.
+		static void GenerateVertices(const Heightmap& heightmap, const TerrainParameters& parameters, ThreadPool& pool,
+			std::vector<VertexDataTerrain>& vertices, std::vector<BoundingBox>& chunkBounds, std::vector<float>& levelErrors);
 
 	private:
 		void GenerateTerrain();
+		void GenerateIndices();
+		void BuildQuadtree();
+		void UpdateLodRanges(const Camera& camera);
 	};
 }
\ No newline at end of file
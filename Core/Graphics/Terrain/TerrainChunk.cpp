@@ -0,0 +1,114 @@
+/*
+===========================================================================
+TerrainChunk.cpp
+
+Implements the TerrainChunk class.
+===========================================================================
+*/
+
+#include "TerrainChunk.h"
+#include "TerrainTileFile.h"
+#include "TerrainParameters.h"
+#include "System/MemoryManagement.h"
+#include "Graphics/Buffers/VertexBuffer.h"
+#include "Graphics/Buffers/IndexBuffer.h"
+#include "Graphics/Structures/VertexData.h"
+#include "Graphics/Structures/VertexLayout.h"
+#include "Graphics/GraphicsAPI.h"
+#include <cmath>
+
+using namespace sedge;
+
+static uint GetVertexLevel(const uint x, const uint z, const uint maxLevel);
+static float GetMorphHeight(const TerrainTile& tile, const int x, const int z, const uint level);
+
+TerrainChunk::TerrainChunk(const VertexDataTerrain*const vertices, const uint vertexCount, const BoundingBox& bounds)
+	: _bounds(bounds)
+{
+	_vbo = new VertexBuffer(sizeof(VertexDataTerrain), vertexCount, VertexLayout::GetDefaultTerrainVertexLayout(), vertices);
+}
+
+TerrainChunk::~TerrainChunk()
+{
+	SafeDelete(_vbo);
+}
+
+void TerrainChunk::Draw(const IndexBuffer*const ibo) const
+{
+	_vbo->Bind();
+	GraphicsAPI::DrawTrianglesIndexed(ibo->GetCount());
+}
+
+void TerrainChunk::BuildVertices(const TerrainTile& tile, const TerrainParameters& parameters, VertexDataTerrain*const vertices, float*const stepErrors)
+{
+	const uint gridSize = parameters.ChunkSize + 1;
+	const int halfSize = parameters.GetHalfSize();
+	const uint maxLevel = parameters.LodLevels - 1;
+	const int originX = tile.X * parameters.ChunkSize;
+	const int originZ = tile.Z * parameters.ChunkSize;
+
+	VertexDataTerrain* vertex = vertices;
+
+	for (int z = 0; z < (int)gridSize; z++)
+	{
+		for (int x = 0; x < (int)gridSize; x++)
+		{
+			const int mapX = originX + x;
+			const int mapZ = originZ + z;
+			const float height = tile.GetHeight(x, z);
+
+			// Central differences, the apron provides the samples across the tile border.
+			const float dx = tile.GetHeight(x - 1, z) - tile.GetHeight(x + 1, z);
+			const float dz = tile.GetHeight(x, z - 1) - tile.GetHeight(x, z + 1);
+
+			vertex->Position = Vector3((mapX - halfSize) * parameters.TileSize, height, (mapZ - halfSize) * parameters.TileSize);
+			vertex->UV = Vector2((float)mapX, (float)mapZ);
+			vertex->Normal = Vector3::Normalize(Vector3(dx, 2.0f * parameters.TileSize, dz));
+			vertex->Splat = Color(tile.Splat[z * gridSize + x]);
+
+			const uint level = GetVertexLevel(x, z, maxLevel);
+			if (level < maxLevel)
+			{
+				const float morphHeight = GetMorphHeight(tile, x, z, level);
+				const float error = fabsf(height - morphHeight);
+
+				if (stepErrors)
+					stepErrors[level] = error > stepErrors[level] ? error : stepErrors[level];
+
+				vertex->Morph = Vector2(morphHeight, (float)level);
+			}
+			else
+			{
+				vertex->Morph = Vector2(height, -1.0f);
+			}
+
+			vertex++;
+		}
+	}
+}
+
+// Returns the coarsest level the vertex is still a part of.
+uint GetVertexLevel(const uint x, const uint z, const uint maxLevel)
+{
+	uint level = 0;
+	while (level < maxLevel && (x & (1 << level)) == 0 && (z & (1 << level)) == 0)
+		level++;
+
+	return level;
+}
+
+// Returns the height of the coarser triangle edge the vertex lies on once it is dropped.
+// Chunk sizes are divisible by the coarsest step, so the neighbours never leave the tile.
+float GetMorphHeight(const TerrainTile& tile, const int x, const int z, const uint level)
+{
+	const int step = 1 << level;
+	const bool oddX = ((x >> level) & 1) != 0;
+	const bool oddZ = ((z >> level) & 1) != 0;
+
+	if (oddX && oddZ)
+		return (tile.GetHeight(x - step, z - step) + tile.GetHeight(x + step, z + step)) * 0.5f;
+	if (oddX)
+		return (tile.GetHeight(x - step, z) + tile.GetHeight(x + step, z)) * 0.5f;
+
+	return (tile.GetHeight(x, z - step) + tile.GetHeight(x, z + step)) * 0.5f;
+}
\ No newline at end of file
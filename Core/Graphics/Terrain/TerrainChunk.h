@@ -0,0 +1,45 @@
+/*
+===========================================================================
+TerrainChunk.h
+
+A square piece of terrain with its own vertex grid and bounding box.
+All chunks of a terrain share the same index buffer.
+===========================================================================
+*/
+
+#pragma once
+
+#include <CustomTypes.h>
+#include "Math/BoundingBox.h"
+
+namespace sedge
+{
+	class VertexBuffer;
+	class IndexBuffer;
+	struct VertexDataTerrain;
+	struct TerrainTile;
+	struct TerrainParameters;
+
+	class TerrainChunk
+	{
+	private:
+		VertexBuffer* _vbo;
+		BoundingBox _bounds;
+
+	public:
+		TerrainChunk(const VertexDataTerrain*const vertices, const uint vertexCount, const BoundingBox& bounds);
+		~TerrainChunk();
+
+		inline const BoundingBox& GetBounds() const { return _bounds; }
+
+		void Draw(const IndexBuffer*const ibo) const;
+
+		// Fills (ChunkSize + 1)^2 vertices of the tile and raises stepErrors[i] (if given) to the largest
+		// height change caused by dropping the vertices of level i. Only the tile's own samples are read.
+		static void BuildVertices(const TerrainTile& tile, const TerrainParameters& parameters, VertexDataTerrain*const vertices, float*const stepErrors);
+
+	private:
+		TerrainChunk(const TerrainChunk& tRef) = delete;
+		TerrainChunk& operator = (const TerrainChunk& tRef) = delete;
+	};
+}
\ No newline at end of file
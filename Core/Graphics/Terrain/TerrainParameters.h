@@ -0,0 +1,53 @@
+/*
+===========================================================================
+TerrainParameters.h
+
+Describes the layout, level of detail and streaming settings of a terrain.
+===========================================================================
+*/
+
+#pragma once
+
+#include <CustomTypes.h>
+#include "Math/BoundingBox.h"
+
+namespace sedge
+{
+	struct TerrainParameters
+	{
+		uint ChunkCount; // chunks per side
+		uint ChunkSize; // quads per chunk side, must be divisible by 2^(LodLevels - 1)
+		float TileSize; // world size of a single quad
+		uint LodLevels; // level i skips every 2^i - 1 vertices of the chunk grid
+		float MaxScreenError; // allowed height error in pixels
+		float ViewportHeight; // in pixels
+		float StreamingRadius; // tiles closer to the camera than this are kept loaded
+		uint StreamingBudget; // bytes of vertex data that may be resident at once
+
+		TerrainParameters()
+			: ChunkCount(16), ChunkSize(64), TileSize(1.0f), LodLevels(5), MaxScreenError(2.0f), ViewportHeight(720.0f),
+			StreamingRadius(400.0f), StreamingBudget(64 * 1024 * 1024) { }
+
+		inline int GetHalfSize() const { return (int)(ChunkCount * ChunkSize / 2); }
+
+		inline BoundingBox GetChunkBounds(const uint chunkX, const uint chunkZ, const float minHeight, const float maxHeight) const
+		{
+			const int x0 = (int)(chunkX * ChunkSize) - GetHalfSize();
+			const int z0 = (int)(chunkZ * ChunkSize) - GetHalfSize();
+
+			return BoundingBox(
+				Vector3(x0 * TileSize, minHeight, z0 * TileSize),
+				Vector3((x0 + (int)ChunkSize) * TileSize, maxHeight, (z0 + (int)ChunkSize) * TileSize));
+		}
+
+		// Returns the largest number of LOD levels (up to LodLevels) the chunk size can be split into.
+		inline uint GetSupportedLodLevels() const
+		{
+			uint levels = LodLevels == 0 ? 1 : LodLevels;
+			while (levels > 1 && ChunkSize % (1 << (levels - 1)) != 0)
+				levels--;
+
+			return levels;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*
+===========================================================================
+TerrainQuadtree.cpp
+
+Implements the TerrainQuadtree class.
+===========================================================================
+*/
+
+#include "TerrainQuadtree.h"
+#include "Math/Frustum.h"
+
+using namespace sedge;
+
+void TerrainQuadtree::Build(const std::vector<BoundingBox>& chunkBounds, const uint chunkCount)
+{
+	_nodes.clear();
+
+	if (chunkCount > 0)
+		BuildNode(chunkBounds, chunkCount, 0, 0, chunkCount, chunkCount);
+}
+
+void TerrainQuadtree::Select(const Frustum& frustum, const Vector3& cameraPosition, const std::vector<float>& lodRanges, std::vector<TerrainSelection>& selection) const
+{
+	selection.clear();
+
+	if (!_nodes.empty())
+		SelectNode(0, frustum, cameraPosition, lodRanges, selection);
+}
+
+int TerrainQuadtree::BuildNode(const std::vector<BoundingBox>& chunkBounds, const uint chunkCount, const uint x0, const uint z0, const uint x1, const uint z1)
+{
+	const int nodeIndex = (int)_nodes.size();
+	_nodes.push_back(Node());
+
+	Node node;
+	node.ChunkIndex = -1;
+	for (int i = 0; i < 4; i++)
+		node.Children[i] = -1;
+
+	if (x1 - x0 == 1 && z1 - z0 == 1)
+	{
+		node.ChunkIndex = z0 * chunkCount + x0;
+		node.Bounds = chunkBounds[node.ChunkIndex];
+		_nodes[nodeIndex] = node;
+
+		return nodeIndex;
+	}
+
+	const uint midX = (x0 + x1 + 1) / 2;
+	const uint midZ = (z0 + z1 + 1) / 2;
+	const uint ranges[4][4] =
+	{
+		{ x0, z0, midX, midZ },
+		{ midX, z0, x1, midZ },
+		{ x0, midZ, midX, z1 },
+		{ midX, midZ, x1, z1 }
+	};
+
+	bool hasBounds = false;
+	for (int i = 0; i < 4; i++)
+	{
+		if (ranges[i][0] >= ranges[i][2] || ranges[i][1] >= ranges[i][3])
+			continue;
+
+		node.Children[i] = BuildNode(chunkBounds, chunkCount, ranges[i][0], ranges[i][1], ranges[i][2], ranges[i][3]);
+
+		if (hasBounds)
+			node.Bounds.Merge(_nodes[node.Children[i]].Bounds);
+		else
+			node.Bounds = _nodes[node.Children[i]].Bounds;
+
+		hasBounds = true;
+	}
+
+	_nodes[nodeIndex] = node;
+
+	return nodeIndex;
+}
+
+void TerrainQuadtree::SelectNode(const int nodeIndex, const Frustum& frustum, const Vector3& cameraPosition, const std::vector<float>& lodRanges, std::vector<TerrainSelection>& selection) const
+{
+	const Node& node = _nodes[nodeIndex];
+
+	if (!frustum.IsBoxVisible(node.Bounds))
+		return;
+
+	if (node.ChunkIndex >= 0)
+	{
+		const float distanceSquared = node.Bounds.GetDistanceSquared(cameraPosition);
+
+		uint level = 0;
+		while (level + 1 < lodRanges.size() && distanceSquared >= lodRanges[level + 1] * lodRanges[level + 1])
+			level++;
+
+		TerrainSelection item;
+		item.ChunkIndex = node.ChunkIndex;
+		item.Level = level;
+		selection.push_back(item);
+
+		return;
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (node.Children[i] >= 0)
+			SelectNode(node.Children[i], frustum, cameraPosition, lodRanges, selection);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*
+===========================================================================
+TerrainQuadtree.h
+
+A quadtree built over the chunk grid of a terrain.
+Used to cull chunks hierarchically and to pick a level of detail for
+every visible chunk based on its distance to the camera.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <CustomTypes.h>
+#include "Math/BoundingBox.h"
+
+namespace sedge
+{
+	class Frustum;
+
+	struct TerrainSelection
+	{
+		uint ChunkIndex;
+		uint Level;
+	};
+
+	class TerrainQuadtree
+	{
+	private:
+		struct Node
+		{
+			BoundingBox Bounds;
+			int Children[4]; // -1 if there is no child
+			int ChunkIndex; // -1 for non-leaf nodes
+		};
+
+		std::vector<Node> _nodes;
+
+	public:
+		TerrainQuadtree() {}
+
+		// chunkBounds holds the bounds of a chunkCount x chunkCount grid, row by row.
+		void Build(const std::vector<BoundingBox>& chunkBounds, const uint chunkCount);
+
+		// lodRanges[i] is the distance from which level i may be used, lodRanges[0] is always 0.
+		void Select(const Frustum& frustum, const Vector3& cameraPosition, const std::vector<float>& lodRanges, std::vector<TerrainSelection>& selection) const;
+
+	private:
+		int BuildNode(const std::vector<BoundingBox>& chunkBounds, const uint chunkCount, const uint x0, const uint z0, const uint x1, const uint z1);
+		void SelectNode(const int nodeIndex, const Frustum& frustum, const Vector3& cameraPosition, const std::vector<float>& lodRanges, std::vector<TerrainSelection>& selection) const;
+	};
+}
\ No newline at end of file
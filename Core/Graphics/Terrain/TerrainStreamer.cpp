@@ -0,0 +1,201 @@
+/*
+===========================================================================
+TerrainStreamer.cpp
+
+Implements the TerrainStreamer class.
+===========================================================================
+*/
+
+#include "TerrainStreamer.h"
+#include "TerrainTileFile.h"
+#include "TerrainChunk.h"
+#include "System/MemoryManagement.h"
+#include "System/Logger.h"
+#include <algorithm>
+
+using namespace sedge;
+
+TerrainStreamer::TerrainStreamer(const TerrainTileFile& file, const TerrainParameters& parameters)
+	: _file(file), _parameters(parameters), _frame(0), _running(true)
+{
+	const uint tileBytes = (_parameters.ChunkSize + 1) * (_parameters.ChunkSize + 1) * sizeof(VertexDataTerrain);
+	_maxTiles = _parameters.StreamingBudget / tileBytes;
+
+	if (_maxTiles == 0)
+	{
+		LOG_WARNING("Terrain streaming budget of ", _parameters.StreamingBudget, " bytes is smaller than a single tile");
+		_maxTiles = 1;
+	}
+
+	_records.resize(_file.GetTileCount());
+	for (TileRecord& record : _records)
+	{
+		record.State = Unloaded;
+		record.LastUsed = 0;
+		record.Tile = nullptr;
+	}
+
+	_worker = std::thread(&TerrainStreamer::ProcessRequests, this);
+}
+
+TerrainStreamer::~TerrainStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_running = false;
+	}
+
+	_condition.notify_all();
+	_worker.join();
+
+	for (TileRecord& record : _records)
+		SafeDelete(record.Tile);
+}
+
+void TerrainStreamer::Update(const Vector3& cameraPosition, std::vector<uint>& evictions)
+{
+	evictions.clear();
+	_frame++;
+
+	const float radiusSquared = _parameters.StreamingRadius * _parameters.StreamingRadius;
+
+	_desired.clear();
+	for (uint i = 0; i < _records.size(); i++)
+	{
+		const float distanceSquared = _file.GetTileBounds(i).GetDistanceSquared(cameraPosition);
+		if (distanceSquared <= radiusSquared)
+			_desired.push_back(std::make_pair(distanceSquared, i));
+	}
+
+	std::sort(_desired.begin(), _desired.end());
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		// Requests that were not picked up yet are rebuilt from scratch, the camera may have moved away.
+		for (const uint index : _requests)
+			_records[index].State = Unloaded;
+		_requests.clear();
+
+		uint committed = 0;
+		for (const TileRecord& record : _records)
+		{
+			if (record.State == Loading || record.State == Loaded || record.State == Resident)
+				committed++;
+		}
+
+		for (const auto& item : _desired)
+			_records[item.second].LastUsed = _frame;
+
+		for (const auto& item : _desired)
+		{
+			TileRecord& record = _records[item.second];
+			if (record.State != Unloaded)
+				continue;
+
+			if (committed >= _maxTiles)
+			{
+				if (!EvictLeastRecentlyUsed(evictions))
+					break;
+
+				committed--;
+			}
+
+			record.State = Queued;
+			_requests.push_back(item.second);
+			committed++;
+		}
+	}
+
+	if (!_requests.empty())
+		_condition.notify_one();
+}
+
+void TerrainStreamer::CollectLoadedTiles(std::vector<TerrainStreamedTile*>& tiles)
+{
+	tiles.clear();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	for (const uint index : _loaded)
+	{
+		TileRecord& record = _records[index];
+		record.State = Resident;
+		tiles.push_back(record.Tile);
+		record.Tile = nullptr;
+	}
+
+	_loaded.clear();
+}
+
+void TerrainStreamer::ProcessRequests()
+{
+	TerrainTile tile;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	while (true)
+	{
+		_condition.wait(lock, [this] { return !_running || !_requests.empty(); });
+
+		if (!_running)
+			return;
+
+		const uint index = _requests.front();
+		_requests.pop_front();
+		_records[index].State = Loading;
+
+		lock.unlock();
+
+		TerrainStreamedTile* streamedTile = nullptr;
+		if (_file.ReadTile(index, tile))
+		{
+			streamedTile = new TerrainStreamedTile();
+			streamedTile->Index = index;
+			streamedTile->Vertices.resize(tile.Splat.size());
+			TerrainChunk::BuildVertices(tile, _parameters, streamedTile->Vertices.data(), nullptr);
+		}
+		else
+		{
+			LOG_ERROR("Failed to read terrain tile ", index, " from \"", _file.GetPath(), "\"");
+		}
+
+		lock.lock();
+
+		TileRecord& record = _records[index];
+		if (streamedTile)
+		{
+			record.State = Loaded;
+			record.Tile = streamedTile;
+			_loaded.push_back(index);
+		}
+		else
+		{
+			record.State = Failed;
+		}
+	}
+}
+
+// Must be called with the mutex locked. Tiles used in the current frame are never evicted.
+bool TerrainStreamer::EvictLeastRecentlyUsed(std::vector<uint>& evictions)
+{
+	int victim = -1;
+
+	for (uint i = 0; i < _records.size(); i++)
+	{
+		const TileRecord& record = _records[i];
+		if (record.State != Resident || record.LastUsed == _frame)
+			continue;
+
+		if (victim < 0 || record.LastUsed < _records[victim].LastUsed)
+			victim = (int)i;
+	}
+
+	if (victim < 0)
+		return false;
+
+	_records[victim].State = Unloaded;
+	evictions.push_back((uint)victim);
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+/*
+===========================================================================
+TerrainStreamer.h
+
+Streams terrain tiles around the camera from a tile file.
+A background thread reads tiles and builds their vertices, the owner then
+uploads them on the rendering thread. Resident tiles are kept within a
+memory budget, the least recently used ones are evicted first.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <CustomTypes.h>
+#include "TerrainParameters.h"
+#include "Graphics/Structures/VertexData.h"
+
+namespace sedge
+{
+	class TerrainTileFile;
+
+	struct TerrainStreamedTile
+	{
+		uint Index; // row-major chunk index
+		std::vector<VertexDataTerrain> Vertices;
+	};
+
+	class TerrainStreamer
+	{
+	private:
+		enum TileState
+		{
+			Unloaded,
+			Queued,
+			Loading,
+			Loaded, // built by the worker, waiting to be collected
+			Resident,
+			Failed
+		};
+
+		struct TileRecord
+		{
+			TileState State;
+			unsigned long long LastUsed;
+			TerrainStreamedTile* Tile;
+		};
+
+		const TerrainTileFile& _file;
+		TerrainParameters _parameters;
+		std::vector<TileRecord> _records;
+		std::vector<std::pair<float, uint>> _desired;
+		std::deque<uint> _requests;
+		std::vector<uint> _loaded;
+		uint _maxTiles;
+		unsigned long long _frame;
+
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		std::thread _worker;
+		bool _running;
+
+	public:
+		TerrainStreamer(const TerrainTileFile& file, const TerrainParameters& parameters);
+		~TerrainStreamer();
+
+		// Requests the tiles within the streaming radius, nearest first, and returns the indices of the
+		// resident tiles that had to be evicted to stay within the budget.
+		void Update(const Vector3& cameraPosition, std::vector<uint>& evictions);
+
+		// Hands over the tiles finished since the last call, the caller becomes their owner.
+		void CollectLoadedTiles(std::vector<TerrainStreamedTile*>& tiles);
+
+	private:
+		void ProcessRequests();
+		bool EvictLeastRecentlyUsed(std::vector<uint>& evictions);
+
+		TerrainStreamer(const TerrainStreamer& tRef) = delete;
+		TerrainStreamer& operator = (const TerrainStreamer& tRef) = delete;
+	};
+}
\ No newline at end of file
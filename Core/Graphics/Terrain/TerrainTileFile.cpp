@@ -0,0 +1,220 @@
+/*
+===========================================================================
+TerrainTileFile.cpp
+
+Implements the TerrainTileFile class.
+===========================================================================
+*/
+
+#include "TerrainTileFile.h"
+#include "TerrainChunk.h"
+#include "Heightmap.h"
+#include "Graphics/Structures/VertexData.h"
+#include "System/Logger.h"
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace sedge;
+
+static const char TileFileMagic[4] = { 'S', 'T', 'T', 'F' };
+static const uint TileFileVersion = 2;
+
+struct TileFileHeader
+{
+	char Magic[4];
+	uint Version;
+	uint ChunkCount;
+	uint ChunkSize;
+	float TileSize;
+	uint LodLevels;
+};
+
+static uint GetSplatWeights(const Heightmap& heightmap, const int x, const int z, const float tileSize, const float maxHeight);
+
+bool TerrainTileFile::Open(const char*const path)
+{
+	if (!_file.Open(path))
+	{
+		LOG_ERROR("Terrain tile file \"", path, "\" was not found");
+		return false;
+	}
+
+	const byte* bytes = _file.GetData();
+	const unsigned long long size = _file.GetSize();
+
+	TileFileHeader header;
+	if (size < sizeof(header))
+		memset(&header, 0, sizeof(header));
+	else
+		memcpy(&header, bytes, sizeof(header));
+
+	if (memcmp(header.Magic, TileFileMagic, sizeof(TileFileMagic)) != 0 || header.Version != TileFileVersion)
+	{
+		LOG_ERROR("\"", path, "\" is not a valid terrain tile file");
+		_file.Close();
+		return false;
+	}
+
+	const unsigned long long tileCount = (unsigned long long)header.ChunkCount * header.ChunkCount;
+	if (sizeof(header) + header.LodLevels * sizeof(float) + tileCount * sizeof(TileEntry) > size)
+	{
+		LOG_ERROR("Terrain tile file \"", path, "\" is truncated");
+		_file.Close();
+		return false;
+	}
+
+	_path = path;
+	_parameters.ChunkCount = header.ChunkCount;
+	_parameters.ChunkSize = header.ChunkSize;
+	_parameters.TileSize = header.TileSize;
+	_parameters.LodLevels = header.LodLevels;
+
+	// The directory is not aligned for its 64-bit offsets, so it is copied out rather than pointed into.
+	_levelErrors.resize(header.LodLevels);
+	memcpy(_levelErrors.data(), bytes + sizeof(header), _levelErrors.size() * sizeof(float));
+
+	_entries.resize(tileCount);
+	memcpy(_entries.data(), bytes + sizeof(header) + _levelErrors.size() * sizeof(float), _entries.size() * sizeof(TileEntry));
+
+	return true;
+}
+
+BoundingBox TerrainTileFile::GetTileBounds(const uint index) const
+{
+	const TileEntry& entry = _entries[index];
+
+	return _parameters.GetChunkBounds(index % _parameters.ChunkCount, index / _parameters.ChunkCount, entry.MinHeight, entry.MaxHeight);
+}
+
+bool TerrainTileFile::ReadTile(const uint index, TerrainTile& tile) const
+{
+	const unsigned long long offset = _entries[index].Offset;
+	if (offset > _file.GetSize() || GetTileByteSize() > _file.GetSize() - offset)
+		return false;
+
+	tile.X = index % _parameters.ChunkCount;
+	tile.Z = index / _parameters.ChunkCount;
+	tile.Size = _parameters.ChunkSize;
+	tile.Heights.resize(GetHeightCount());
+	tile.Splat.resize(GetSplatCount());
+
+	const byte* data = _file.GetData() + offset;
+	memcpy(tile.Heights.data(), data, tile.Heights.size() * sizeof(float));
+	memcpy(tile.Splat.data(), data + tile.Heights.size() * sizeof(float), tile.Splat.size() * sizeof(uint));
+
+	return true;
+}
+
+bool TerrainTileFile::Write(const char*const path, const Heightmap& heightmap, const TerrainParameters& parameters)
+{
+	std::ofstream stream(FileSystem::GetNativePath(path), std::ios::binary);
+
+	if (!stream)
+	{
+		LOG_ERROR("Cannot create terrain tile file \"", path, "\"");
+		return false;
+	}
+
+	TileFileHeader header;
+	memcpy(header.Magic, TileFileMagic, sizeof(TileFileMagic));
+	header.Version = TileFileVersion;
+	header.ChunkCount = parameters.ChunkCount;
+	header.ChunkSize = parameters.ChunkSize;
+	header.TileSize = parameters.TileSize;
+	header.LodLevels = parameters.GetSupportedLodLevels();
+
+	TerrainParameters tileParameters = parameters;
+	tileParameters.LodLevels = header.LodLevels;
+
+	const uint tileCount = header.ChunkCount * header.ChunkCount;
+	const uint gridSize = header.ChunkSize + 1;
+	const float maxHeight = *std::max_element(heightmap.GetData(), heightmap.GetData() + heightmap.GetWidth() * heightmap.GetDepth());
+
+	std::vector<TileEntry> entries(tileCount);
+	std::vector<float> stepErrors(header.LodLevels, 0.0f);
+	std::vector<VertexDataTerrain> vertices(gridSize * gridSize);
+	TerrainTile tile;
+
+	// The payload goes first, header and directory are filled in once the errors are known.
+	unsigned long long offset = sizeof(header) + header.LodLevels * sizeof(float) + tileCount * sizeof(TileEntry);
+	stream.seekp(offset);
+
+	for (uint i = 0; i < tileCount; i++)
+	{
+		ExtractTile(heightmap, i % header.ChunkCount, i / header.ChunkCount, header.ChunkSize, tile);
+
+		const int originX = tile.X * header.ChunkSize;
+		const int originZ = tile.Z * header.ChunkSize;
+		for (uint z = 0; z < gridSize; z++)
+		{
+			for (uint x = 0; x < gridSize; x++)
+				tile.Splat[z * gridSize + x] = GetSplatWeights(heightmap, originX + x, originZ + z, header.TileSize, maxHeight);
+		}
+
+		TerrainChunk::BuildVertices(tile, tileParameters, vertices.data(), stepErrors.data());
+
+		entries[i].Offset = offset;
+		tile.GetHeightRange(entries[i].MinHeight, entries[i].MaxHeight);
+
+		stream.write((const char*)tile.Heights.data(), tile.Heights.size() * sizeof(float));
+		stream.write((const char*)tile.Splat.data(), tile.Splat.size() * sizeof(uint));
+		offset += tile.Heights.size() * sizeof(float) + tile.Splat.size() * sizeof(uint);
+	}
+
+	std::vector<float> levelErrors(header.LodLevels, 0.0f);
+	for (uint level = 1; level < header.LodLevels; level++)
+		levelErrors[level] = levelErrors[level - 1] + stepErrors[level - 1];
+
+	stream.seekp(0);
+	stream.write((const char*)&header, sizeof(header));
+	stream.write((const char*)levelErrors.data(), levelErrors.size() * sizeof(float));
+	stream.write((const char*)entries.data(), entries.size() * sizeof(TileEntry));
+
+	if (!stream)
+	{
+		LOG_ERROR("Failed to write terrain tile file \"", path, "\"");
+		return false;
+	}
+
+	return true;
+}
+
+void TerrainTileFile::ExtractTile(const Heightmap& heightmap, const uint chunkX, const uint chunkZ, const uint chunkSize, TerrainTile& tile)
+{
+	const int apronSize = chunkSize + 3;
+	const int originX = chunkX * chunkSize - 1;
+	const int originZ = chunkZ * chunkSize - 1;
+
+	tile.X = chunkX;
+	tile.Z = chunkZ;
+	tile.Size = chunkSize;
+	tile.Heights.resize(apronSize * apronSize);
+	tile.Splat.assign((chunkSize + 1) * (chunkSize + 1), 0x000000ff);
+
+	for (int z = 0; z < apronSize; z++)
+	{
+		for (int x = 0; x < apronSize; x++)
+			tile.Heights[z * apronSize + x] = heightmap.GetHeight(originX + x, originZ + z);
+	}
+}
+
+// Layer 0 covers flat ground, layer 1 steep slopes and layer 2 high altitudes.
+uint GetSplatWeights(const Heightmap& heightmap, const int x, const int z, const float tileSize, const float maxHeight)
+{
+	const float dx = (heightmap.GetHeight(x + 1, z) - heightmap.GetHeight(x - 1, z)) / (2.0f * tileSize);
+	const float dz = (heightmap.GetHeight(x, z + 1) - heightmap.GetHeight(x, z - 1)) / (2.0f * tileSize);
+	const float slope = sqrtf(dx * dx + dz * dz);
+	const float altitude = maxHeight > 0.0f ? heightmap.GetHeight(x, z) / maxHeight : 0.0f;
+
+	const float rock = std::min(std::max((slope - 0.3f) / 0.5f, 0.0f), 1.0f);
+	const float peak = (1.0f - rock) * std::min(std::max((altitude - 0.6f) / 0.3f, 0.0f), 1.0f);
+	const float ground = 1.0f - rock - peak;
+
+	const uint r = (uint)(ground * 255.0f + 0.5f);
+	const uint g = (uint)(rock * 255.0f + 0.5f);
+	const uint b = r + g < 255 ? 255 - r - g : 0;
+
+	return b << 16 | g << 8 | r;
+}
\ No newline at end of file
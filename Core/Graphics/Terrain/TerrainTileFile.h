@@ -0,0 +1,97 @@
+/*
+===========================================================================
+TerrainTileFile.h
+
+Declares the on-disk format terrain tiles are streamed from. The file
+stays open as a view while tiles are streamed, so reading a tile is a
+copy out of the mapping.
+
+Layout:
+	header
+	float levelErrors[LodLevels]
+	TileEntry entries[ChunkCount * ChunkCount]
+	per tile: float heights[(ChunkSize + 3)^2], uint splat[(ChunkSize + 1)^2]
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <CustomTypes.h>
+#include "System/FileSystem.h"
+#include "TerrainParameters.h"
+#include "Math/BoundingBox.h"
+
+namespace sedge
+{
+	class Heightmap;
+
+	struct TerrainTile
+	{
+		uint X; // chunk coordinates
+		uint Z;
+		uint Size; // quads per side
+		std::vector<float> Heights; // (Size + 3)^2 samples, the outer ring belongs to the neighbours and is only used for normals
+		std::vector<uint> Splat; // (Size + 1)^2 packed RGBA weights of the 4 terrain layers
+
+		// Local coordinates range from -1 to Size + 1.
+		inline float GetHeight(const int x, const int z) const { return Heights[(z + 1) * (Size + 3) + x + 1]; }
+
+		void GetHeightRange(float& minHeight, float& maxHeight) const
+		{
+			minHeight = maxHeight = GetHeight(0, 0);
+			for (int z = 0; z <= (int)Size; z++)
+			{
+				for (int x = 0; x <= (int)Size; x++)
+				{
+					const float height = GetHeight(x, z);
+					minHeight = height < minHeight ? height : minHeight;
+					maxHeight = height > maxHeight ? height : maxHeight;
+				}
+			}
+		}
+	};
+
+	class TerrainTileFile
+	{
+	private:
+		struct TileEntry
+		{
+			unsigned long long Offset;
+			float MinHeight;
+			float MaxHeight;
+		};
+
+		std::string _path;
+		FileView _file;
+		TerrainParameters _parameters;
+		std::vector<float> _levelErrors;
+		std::vector<TileEntry> _entries;
+
+	public:
+		TerrainTileFile() {}
+
+		bool Open(const char*const path);
+
+		inline const char* GetPath() const { return _path.c_str(); }
+		inline const TerrainParameters& GetParameters() const { return _parameters; }
+		inline const std::vector<float>& GetLevelErrors() const { return _levelErrors; }
+		inline uint GetTileCount() const { return _entries.size(); }
+		inline uint GetTileByteSize() const { return GetHeightCount() * sizeof(float) + GetSplatCount() * sizeof(uint); }
+
+		BoundingBox GetTileBounds(const uint index) const;
+
+		// Thread-safe.
+		bool ReadTile(const uint index, TerrainTile& tile) const;
+
+		// Cuts the heightmap into tiles, derives splat weights from slope and altitude and writes the result.
+		static bool Write(const char*const path, const Heightmap& heightmap, const TerrainParameters& parameters);
+
+		static void ExtractTile(const Heightmap& heightmap, const uint chunkX, const uint chunkZ, const uint chunkSize, TerrainTile& tile);
+
+	private:
+		inline uint GetHeightCount() const { return (_parameters.ChunkSize + 3) * (_parameters.ChunkSize + 3); }
+		inline uint GetSplatCount() const { return (_parameters.ChunkSize + 1) * (_parameters.ChunkSize + 1); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,391 @@
+/*
+===========================================================================
+Font.cpp
+
+Implements the Font class.
+===========================================================================
+*/
+
+#include "Font.h"
+#include "Graphics/Textures/TextureAtlas.h"
+#include "Graphics/Textures/TextureCache.h"
+#include "System/ImageUtils.h"
+#include "System/FileSystem.h"
+#include "System/MemoryManagement.h"
+#include "System/ThreadPool.h"
+#include "System/Logger.h"
+#include <cmath>
+#include <fstream>
+
+using namespace sedge;
+
+static const int AtlasPageSize = 512;
+static const int DistanceFieldPageSize = 1024;
+static const int AtlasPadding = 1;
+static const int DistanceFieldSpread = 4; // pixels at the baked size
+
+static const char CacheMagic[4] = { 'S', 'D', 'F', 'C' };
+static const uint CacheVersion = 1;
+
+struct CacheHeader
+{
+	char Magic[4];
+	uint Version;
+	unsigned long long SourceHash;
+	float Size;
+	int Spread;
+	uint GlyphCount;
+	uint Reserved;
+};
+
+struct CacheGlyphEntry
+{
+	uint Codepoint;
+	uint Index;
+	float Advance;
+	int OffsetX;
+	int OffsetY;
+	int Width;
+	int Height;
+	uint DataOffset;
+};
+
+static void GetPrebakedCodepoints(std::vector<uint>& codepoints);
+
+static uint DecodeUTF8(const std::string& text, uint& position);
+
+Font::Font(const char*const name, const char*const path, const float size, const FontRendering rendering)
+	: _name(name), _path(path), _size(size), _scale(0.0f), _ascent(0.0f), _lineHeight(0.0f), _rendering(rendering), _atlas(nullptr)
+{
+}
+
+Font::~Font()
+{
+	SafeDelete(_atlas);
+}
+
+bool Font::Load()
+{
+	if (!_file.Open(_path.c_str()))
+		return false;
+
+	int ascent = 0;
+	int descent = 0;
+	int lineGap = 0;
+	_file.GetVerticalMetrics(ascent, descent, lineGap);
+
+	_scale = _file.GetScaleForPixelHeight(_size);
+	_ascent = ascent * _scale;
+	_lineHeight = (ascent - descent + lineGap) * _scale;
+	_atlas = new TextureAtlas((_name + "_glyphs").c_str(), IsDistanceField() ? DistanceFieldPageSize : AtlasPageSize, AtlasPadding);
+
+	if (!IsDistanceField())
+		return true;
+
+	const unsigned long long sourceHash = TextureCache::HashFile(_path.c_str());
+	if (LoadCache(sourceHash))
+		return true;
+
+	std::vector<uint> codepoints;
+	std::vector<GlyphBitmap> bitmaps;
+	GetPrebakedCodepoints(codepoints);
+	BakeGlyphs(codepoints, bitmaps);
+
+	if (!WriteCache(sourceHash, codepoints, bitmaps))
+		LOG_WARNING("Failed to write font cache \"", GetCachePath(), "\"");
+
+	return true;
+}
+
+const TextLayout& Font::GetLayout(const std::string& text)
+{
+	auto it = _layouts.find(text);
+	if (it != _layouts.end())
+		return it->second;
+
+	if (_layouts.size() >= MaxCachedLayouts)
+		_layouts.clear();
+
+	TextLayout& layout = _layouts[text];
+	LayoutText(text, layout);
+	_atlas->Upload();
+
+	return layout;
+}
+
+Texture2D* Font::GetPageTexture(const uint page) const
+{
+	return _atlas->GetPageTexture(page);
+}
+
+const Glyph& Font::GetGlyph(const uint codepoint)
+{
+	auto it = _glyphs.find(codepoint);
+	if (it != _glyphs.end())
+		return it->second;
+
+	// Glyphs outside the prebaked set are rendered here and are not added to the cache file.
+	Glyph glyph;
+	GlyphBitmap bitmap;
+	RenderGlyph(codepoint, glyph, bitmap);
+	AddGlyph(codepoint, glyph, bitmap);
+
+	return _glyphs[codepoint];
+}
+
+void Font::RenderGlyph(const uint codepoint, Glyph& glyph, GlyphBitmap& bitmap) const
+{
+	glyph.Index = _file.GetGlyphIndex(codepoint);
+	glyph.Region = -1;
+
+	int advance = 0;
+	int leftSideBearing = 0;
+	_file.GetHorizontalMetrics(glyph.Index, advance, leftSideBearing);
+	glyph.Advance = advance * _scale;
+
+	if (IsDistanceField())
+		_file.RenderDistanceField(glyph.Index, _scale, DistanceFieldSpread, bitmap);
+	else
+		_file.RasterizeGlyph(glyph.Index, _scale, bitmap);
+
+	glyph.OffsetX = bitmap.OffsetX;
+	glyph.OffsetY = bitmap.OffsetY;
+	glyph.Width = bitmap.Width;
+	glyph.Height = bitmap.Height;
+}
+
+void Font::AddGlyph(const uint codepoint, const Glyph& glyph, const GlyphBitmap& bitmap)
+{
+	Glyph& added = _glyphs[codepoint];
+	added = glyph;
+
+	if (bitmap.Width <= 0 || bitmap.Height <= 0)
+		return;
+
+	// White pixels with the coverage or distance in alpha, so the vertex colour tints the text.
+	std::vector<byte> pixels(bitmap.Width * bitmap.Height * 2);
+	for (uint i = 0; i < bitmap.Coverage.size(); i++)
+	{
+		pixels[i * 2] = 255;
+		pixels[i * 2 + 1] = bitmap.Coverage[i];
+	}
+
+	ImageData image;
+	image.Pixels = pixels.data();
+	image.Width = bitmap.Width;
+	image.Height = bitmap.Height;
+	image.Components = 2;
+
+	added.Region = _atlas->Add(std::to_string(codepoint).c_str(), image);
+}
+
+void Font::BakeGlyphs(const std::vector<uint>& codepoints, std::vector<GlyphBitmap>& bitmaps)
+{
+	std::vector<Glyph> glyphs(codepoints.size());
+	bitmaps.resize(codepoints.size());
+
+	ThreadPool::GetShared().ParallelFor(0, codepoints.size(), 4, [&](const uint begin, const uint end)
+	{
+		for (uint i = begin; i < end; i++)
+			RenderGlyph(codepoints[i], glyphs[i], bitmaps[i]);
+	});
+
+	// Packing stays on this thread and in a fixed order, so every load produces the same atlas.
+	for (uint i = 0; i < codepoints.size(); i++)
+		AddGlyph(codepoints[i], glyphs[i], bitmaps[i]);
+}
+
+std::string Font::GetCachePath() const
+{
+	return _path + "." + std::to_string((int)_size) + ".sdf";
+}
+
+bool Font::LoadCache(const unsigned long long sourceHash)
+{
+	FileView file;
+	if (sourceHash == 0 || !file.Open(GetCachePath().c_str()))
+		return false;
+
+	const byte* data = file.GetData();
+	const CacheHeader* header = (const CacheHeader*)data;
+	if (file.GetSize() < sizeof(CacheHeader) || memcmp(header->Magic, CacheMagic, sizeof(CacheMagic)) != 0 ||
+		header->Version != CacheVersion || header->SourceHash != sourceHash || header->Size != _size ||
+		header->Spread != DistanceFieldSpread)
+		return false;
+
+	const unsigned long long entriesEnd = sizeof(CacheHeader) + (unsigned long long)header->GlyphCount * sizeof(CacheGlyphEntry);
+	if (file.GetSize() < entriesEnd)
+		return false;
+
+	const CacheGlyphEntry* entries = (const CacheGlyphEntry*)(data + sizeof(CacheHeader));
+	for (uint i = 0; i < header->GlyphCount; i++)
+	{
+		const CacheGlyphEntry& entry = entries[i];
+		if (entry.Width < 0 || entry.Height < 0 || entry.DataOffset + (unsigned long long)entry.Width * entry.Height > file.GetSize())
+			return false;
+	}
+
+	for (uint i = 0; i < header->GlyphCount; i++)
+	{
+		const CacheGlyphEntry& entry = entries[i];
+
+		Glyph glyph;
+		glyph.Index = entry.Index;
+		glyph.Region = -1;
+		glyph.Advance = entry.Advance;
+		glyph.OffsetX = entry.OffsetX;
+		glyph.OffsetY = entry.OffsetY;
+		glyph.Width = entry.Width;
+		glyph.Height = entry.Height;
+
+		GlyphBitmap bitmap;
+		bitmap.Width = entry.Width;
+		bitmap.Height = entry.Height;
+		bitmap.Coverage.assign(data + entry.DataOffset, data + entry.DataOffset + entry.Width * entry.Height);
+
+		AddGlyph(entry.Codepoint, glyph, bitmap);
+	}
+
+	return true;
+}
+
+bool Font::WriteCache(const unsigned long long sourceHash, const std::vector<uint>& codepoints, const std::vector<GlyphBitmap>& bitmaps) const
+{
+	if (sourceHash == 0)
+		return false;
+
+	std::ofstream stream(FileSystem::GetNativePath(GetCachePath().c_str()), std::ios::binary);
+	if (!stream)
+		return false;
+
+	CacheHeader header;
+	memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+	header.Version = CacheVersion;
+	header.SourceHash = sourceHash;
+	header.Size = _size;
+	header.Spread = DistanceFieldSpread;
+	header.GlyphCount = codepoints.size();
+	header.Reserved = 0;
+
+	std::vector<CacheGlyphEntry> entries(codepoints.size());
+	uint offset = sizeof(CacheHeader) + entries.size() * sizeof(CacheGlyphEntry);
+	for (uint i = 0; i < codepoints.size(); i++)
+	{
+		const Glyph& glyph = _glyphs.at(codepoints[i]);
+		CacheGlyphEntry& entry = entries[i];
+		entry.Codepoint = codepoints[i];
+		entry.Index = glyph.Index;
+		entry.Advance = glyph.Advance;
+		entry.OffsetX = glyph.OffsetX;
+		entry.OffsetY = glyph.OffsetY;
+		entry.Width = glyph.Width;
+		entry.Height = glyph.Height;
+		entry.DataOffset = offset;
+		offset += bitmaps[i].Coverage.size();
+	}
+
+	stream.write((const char*)&header, sizeof(header));
+	stream.write((const char*)entries.data(), entries.size() * sizeof(CacheGlyphEntry));
+	for (const GlyphBitmap& bitmap : bitmaps)
+		stream.write((const char*)bitmap.Coverage.data(), bitmap.Coverage.size());
+
+	return !stream.fail();
+}
+
+void Font::LayoutText(const std::string& text, TextLayout& layout)
+{
+	layout.Quads.clear();
+	layout.Width = 0.0f;
+	layout.Height = _lineHeight;
+
+	float x = 0.0f;
+	float y = 0.0f;
+	uint previous = 0;
+
+	for (uint position = 0; position < text.size();)
+	{
+		const uint codepoint = DecodeUTF8(text, position);
+
+		if (codepoint == (uint)'\n')
+		{
+			x = 0.0f;
+			y -= _lineHeight;
+			layout.Height += _lineHeight;
+			previous = 0;
+			continue;
+		}
+
+		const Glyph& glyph = GetGlyph(codepoint);
+
+		if (previous != 0)
+			x += _file.GetKerning(previous, glyph.Index) * _scale;
+
+		if (glyph.Region >= 0)
+		{
+			const AtlasRegion& region = _atlas->GetRegion(glyph.Region);
+
+			// Bitmap pen positions are rounded so glyph texels map onto whole pixels at the native size.
+			const float penX = IsDistanceField() ? x : floorf(x + 0.5f);
+
+			GlyphQuad quad;
+			quad.Min = Vector2(penX + glyph.OffsetX, y + glyph.OffsetY);
+			quad.Max = Vector2(quad.Min.x + glyph.Width, quad.Min.y + glyph.Height);
+			quad.UVMin = region.UVMin;
+			quad.UVMax = region.UVMax;
+			quad.Page = region.Page;
+			layout.Quads.push_back(quad);
+		}
+
+		x += glyph.Advance;
+		layout.Width = x > layout.Width ? x : layout.Width;
+		previous = glyph.Index;
+	}
+}
+
+// Printable ASCII and Latin-1, the characters most labels are made of.
+void GetPrebakedCodepoints(std::vector<uint>& codepoints)
+{
+	for (uint codepoint = 0x20; codepoint < 0x7f; codepoint++)
+		codepoints.push_back(codepoint);
+
+	for (uint codepoint = 0xa0; codepoint < 0x100; codepoint++)
+		codepoints.push_back(codepoint);
+}
+
+// Invalid sequences decode to U+FFFD.
+uint DecodeUTF8(const std::string& text, uint& position)
+{
+	const byte first = (byte)text[position++];
+	if (first < 0x80)
+		return first;
+
+	int length = 0;
+	uint codepoint = 0;
+	if ((first & 0xe0) == 0xc0)
+	{
+		length = 1;
+		codepoint = first & 0x1f;
+	}
+	else if ((first & 0xf0) == 0xe0)
+	{
+		length = 2;
+		codepoint = first & 0x0f;
+	}
+	else if ((first & 0xf8) == 0xf0)
+	{
+		length = 3;
+		codepoint = first & 0x07;
+	}
+	else
+		return 0xfffd;
+
+	for (int i = 0; i < length; i++)
+	{
+		if (position >= text.size() || ((byte)text[position] & 0xc0) != 0x80)
+			return 0xfffd;
+
+		codepoint = codepoint << 6 | ((byte)text[position++] & 0x3f);
+	}
+
+	return codepoint;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+===========================================================================
+Font.h
+
+A font at one pixel size. Glyphs are rasterized the first time they are
+used and packed into a texture atlas, and the quads of every laid out
+string are cached, so drawing unchanged text costs no rasterization or
+layout at all.
+
+Distance field fonts store the distance to the glyph outline instead of
+coverage, so a single atlas stays sharp at every label size. Their
+common glyphs are baked on all worker threads when the font is loaded
+and kept in a cache file next to the font, later loads only read it.
+===========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <CustomTypes.h>
+#include "FontFile.h"
+#include "Math/Vector2.h"
+
+namespace sedge
+{
+	class Texture2D;
+	class TextureAtlas;
+
+	enum FontRendering
+	{
+		FontRenderingBitmap,
+		FontRenderingDistanceField
+	};
+
+	struct Glyph
+	{
+		uint Index; // in the font file
+		int Region; // in the atlas, -1 for glyphs without pixels
+		float Advance;
+		int OffsetX;
+		int OffsetY;
+		int Width;
+		int Height;
+	};
+
+	// A glyph placed in a string, in pixels relative to the first baseline, y pointing up.
+	struct GlyphQuad
+	{
+		Vector2 Min;
+		Vector2 Max;
+		Vector2 UVMin;
+		Vector2 UVMax;
+		uint Page;
+	};
+
+	struct TextLayout
+	{
+		std::vector<GlyphQuad> Quads;
+		float Width;
+		float Height;
+	};
+
+	class Font
+	{
+	private:
+		std::string _name;
+		std::string _path;
+		float _size;
+		float _scale;
+		float _ascent;
+		float _lineHeight;
+		FontRendering _rendering;
+		FontFile _file;
+		TextureAtlas* _atlas;
+		std::unordered_map<uint, Glyph> _glyphs;
+		std::unordered_map<std::string, TextLayout> _layouts;
+
+	public:
+		// Layouts past this count are dropped all at once, which keeps changing text such as counters bounded.
+		static const uint MaxCachedLayouts = 256;
+
+	public:
+		// Distance field fonts are baked at the given size and scaled when drawn.
+		Font(const char*const name, const char*const path, const float size, const FontRendering rendering = FontRenderingBitmap);
+		~Font();
+
+		bool Load();
+
+		// Rasterizes missing glyphs and uploads them, must be called on the rendering thread.
+		const TextLayout& GetLayout(const std::string& text);
+		Texture2D* GetPageTexture(const uint page) const;
+
+		inline const char* GetName() const { return _name.c_str(); }
+		inline float GetSize() const { return _size; }
+		inline float GetAscent() const { return _ascent; }
+		inline float GetLineHeight() const { return _lineHeight; }
+		inline bool IsDistanceField() const { return _rendering == FontRenderingDistanceField; }
+
+	private:
+		const Glyph& GetGlyph(const uint codepoint);
+		// Only reads the font file, so glyphs can be rendered on several threads at once.
+		void RenderGlyph(const uint codepoint, Glyph& glyph, GlyphBitmap& bitmap) const;
+		void AddGlyph(const uint codepoint, const Glyph& glyph, const GlyphBitmap& bitmap);
+		void BakeGlyphs(const std::vector<uint>& codepoints, std::vector<GlyphBitmap>& bitmaps);
+		std::string GetCachePath() const;
+		bool LoadCache(const unsigned long long sourceHash);
+		bool WriteCache(const unsigned long long sourceHash, const std::vector<uint>& codepoints, const std::vector<GlyphBitmap>& bitmaps) const;
+		void LayoutText(const std::string& text, TextLayout& layout);
+
+		Font(const Font& tRef) = delete;
+		Font& operator = (const Font& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,728 @@
+/*
+===========================================================================
+FontFile.cpp
+
+Implements the FontFile class.
+The rasterizer follows the accumulation approach of font-rs: every edge
+adds the signed area it covers to a buffer, and a running sum over the
+buffer gives the coverage of each pixel.
+===========================================================================
+*/
+
+#include "FontFile.h"
+#include "System/Logger.h"
+#include <cmath>
+#include <cstring>
+
+using namespace sedge;
+
+static const int MaxCompositeDepth = 8;
+
+// The fixed-offset fields read from each table end here.
+static const uint HeadSize = 54;
+static const uint HheaSize = 36;
+static const uint MaxpSize = 6;
+static const uint CmapHeaderSize = 4;
+static const uint GlyphHeaderSize = 10;
+
+static void FlattenQuadratic(const float x0, const float y0, const float x1, const float y1, const float x2, const float y2, std::vector<GlyphEdge>& edges);
+static void AddEdge(const float x0, const float y0, const float x1, const float y1, std::vector<GlyphEdge>& edges);
+static void AccumulateEdge(const GlyphEdge& edge, const int width, const int height, float*const accumulation);
+static float GetDistanceSquared(const GlyphEdge& edge, const float x, const float y);
+
+FontFile::FontFile()
+	: _data(nullptr), _size(0), _glyf(0), _loca(0), _hmtx(0), _kern(0), _cmap(0), _unitsPerEm(0), _indexToLocFormat(0),
+	_glyphCount(0), _horizontalMetricCount(0), _ascent(0), _descent(0), _lineGap(0)
+{
+}
+
+bool FontFile::Open(const char*const path)
+{
+	Close();
+
+	if (!_file.Open(path) || _file.GetSize() == 0)
+	{
+		LOG_ERROR("Font file \"", path, "\" was not found");
+		return false;
+	}
+
+	_data = _file.GetData();
+	_size = (uint)_file.GetSize();
+
+	uint head = 0;
+	uint hhea = 0;
+	uint maxp = 0;
+	uint cmap = 0;
+	uint headLength = 0;
+	uint hheaLength = 0;
+	uint maxpLength = 0;
+	uint cmapLength = 0;
+	uint hmtxLength = 0;
+
+	const uint tableCount = _size >= 12 ? ReadU16(4) : 0;
+	for (uint i = 0; i < tableCount && 12 + i * 16 + 16 <= _size; i++)
+	{
+		const uint record = 12 + i * 16;
+		const uint offset = ReadU32(record + 8);
+		const uint length = ReadU32(record + 12);
+		if (offset > _size || length > _size - offset)
+			continue;
+
+		const char* tag = (const char*)&_data[record];
+		if (memcmp(tag, "head", 4) == 0) { head = offset; headLength = length; }
+		else if (memcmp(tag, "hhea", 4) == 0) { hhea = offset; hheaLength = length; }
+		else if (memcmp(tag, "maxp", 4) == 0) { maxp = offset; maxpLength = length; }
+		else if (memcmp(tag, "cmap", 4) == 0) { cmap = offset; cmapLength = length; }
+		else if (memcmp(tag, "glyf", 4) == 0) _glyf = offset;
+		else if (memcmp(tag, "loca", 4) == 0) _loca = offset;
+		else if (memcmp(tag, "hmtx", 4) == 0) { _hmtx = offset; hmtxLength = length; }
+		else if (memcmp(tag, "kern", 4) == 0) _kern = offset;
+	}
+
+	if (!head || !hhea || !maxp || !cmap || !_glyf || !_loca || !_hmtx)
+	{
+		LOG_ERROR("\"", path, "\" is not a TrueType font with glyph outlines");
+		Close();
+		return false;
+	}
+
+	if (headLength < HeadSize || hheaLength < HheaSize || maxpLength < MaxpSize || cmapLength < CmapHeaderSize)
+	{
+		LOG_ERROR("Font \"", path, "\" has truncated tables");
+		Close();
+		return false;
+	}
+
+	_unitsPerEm = ReadU16(head + 18);
+	_indexToLocFormat = ReadS16(head + 50);
+	_glyphCount = ReadU16(maxp + 4);
+	_ascent = ReadS16(hhea + 4);
+	_descent = ReadS16(hhea + 6);
+	_lineGap = ReadS16(hhea + 8);
+	_horizontalMetricCount = ReadU16(hhea + 34);
+
+	// Every glyph takes its advance from the metrics, at least one of them must be there.
+	if (_horizontalMetricCount == 0 || (uint)_horizontalMetricCount * 4 > hmtxLength)
+	{
+		LOG_ERROR("Font \"", path, "\" has no valid horizontal metrics");
+		Close();
+		return false;
+	}
+
+	// Unicode subtables, full repertoire first.
+	const uint subtableCount = ReadU16(cmap + 2);
+	for (uint i = 0; i < subtableCount && CmapHeaderSize + i * 8 + 8 <= cmapLength; i++)
+	{
+		const uint record = cmap + CmapHeaderSize + i * 8;
+		const uint platform = ReadU16(record);
+		const uint encoding = ReadU16(record + 2);
+		const uint subtableOffset = ReadU32(record + 4);
+		if (subtableOffset >= cmapLength)
+			continue;
+
+		const uint subtable = cmap + subtableOffset;
+		const uint format = ReadU16(subtable);
+
+		if (format == 12 && (platform == 0 || (platform == 3 && encoding == 10)))
+		{
+			_cmap = subtable;
+			break;
+		}
+
+		if (format == 4 && (platform == 0 || (platform == 3 && encoding == 1)))
+			_cmap = subtable;
+	}
+
+	if (!_cmap)
+	{
+		LOG_ERROR("Font \"", path, "\" has no Unicode character map");
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FontFile::Close()
+{
+	_file.Close();
+	_data = nullptr;
+	_size = 0;
+}
+
+uint FontFile::GetGlyphIndex(const uint codepoint) const
+{
+	if (ReadU16(_cmap) == 12)
+	{
+		const uint groupCount = ReadU32(_cmap + 12);
+		uint low = 0;
+		uint high = groupCount;
+
+		while (low < high)
+		{
+			const uint middle = (low + high) / 2;
+			const uint group = _cmap + 16 + middle * 12;
+
+			if (codepoint < ReadU32(group))
+				high = middle;
+			else if (codepoint > ReadU32(group + 4))
+				low = middle + 1;
+			else
+				return ReadU32(group + 8) + codepoint - ReadU32(group);
+		}
+
+		return 0;
+	}
+
+	if (codepoint > 0xffff)
+		return 0;
+
+	const uint segmentCount = ReadU16(_cmap + 6) / 2;
+	const uint endCodes = _cmap + 14;
+	const uint startCodes = endCodes + segmentCount * 2 + 2;
+	const uint deltas = startCodes + segmentCount * 2;
+	const uint rangeOffsets = deltas + segmentCount * 2;
+
+	for (uint i = 0; i < segmentCount; i++)
+	{
+		if (codepoint > ReadU16(endCodes + i * 2))
+			continue;
+
+		const uint start = ReadU16(startCodes + i * 2);
+		if (codepoint < start)
+			return 0;
+
+		const uint delta = ReadU16(deltas + i * 2);
+		const uint rangeOffset = ReadU16(rangeOffsets + i * 2);
+		if (rangeOffset == 0)
+			return (codepoint + delta) & 0xffff;
+
+		const uint glyph = ReadU16(rangeOffsets + i * 2 + rangeOffset + (codepoint - start) * 2);
+
+		return glyph == 0 ? 0 : (glyph + delta) & 0xffff;
+	}
+
+	return 0;
+}
+
+float FontFile::GetScaleForPixelHeight(const float pixelHeight) const
+{
+	return pixelHeight / (float)(_ascent - _descent);
+}
+
+void FontFile::GetVerticalMetrics(int& ascent, int& descent, int& lineGap) const
+{
+	ascent = _ascent;
+	descent = _descent;
+	lineGap = _lineGap;
+}
+
+void FontFile::GetHorizontalMetrics(const uint glyph, int& advance, int& leftSideBearing) const
+{
+	if ((int)glyph < _horizontalMetricCount)
+	{
+		advance = ReadU16(_hmtx + glyph * 4);
+		leftSideBearing = ReadS16(_hmtx + glyph * 4 + 2);
+		return;
+	}
+
+	// Trailing glyphs share the last advance and only store their bearings.
+	advance = ReadU16(_hmtx + (_horizontalMetricCount - 1) * 4);
+	leftSideBearing = ReadS16(_hmtx + _horizontalMetricCount * 4 + (glyph - _horizontalMetricCount) * 2);
+}
+
+int FontFile::GetKerning(const uint leftGlyph, const uint rightGlyph) const
+{
+	if (!_kern || ReadU16(_kern + 2) == 0)
+		return 0;
+
+	// The first subtable, if it holds horizontal format 0 pairs.
+	const uint subtable = _kern + 4;
+	if ((ReadU16(subtable + 4) & 0xff01) != 0x0001)
+		return 0;
+
+	const uint pairCount = ReadU16(subtable + 6);
+	const uint pairs = subtable + 14;
+	const uint key = leftGlyph << 16 | rightGlyph;
+	uint low = 0;
+	uint high = pairCount;
+
+	while (low < high)
+	{
+		const uint middle = (low + high) / 2;
+		const uint pairKey = ReadU32(pairs + middle * 6);
+
+		if (key < pairKey)
+			high = middle;
+		else if (key > pairKey)
+			low = middle + 1;
+		else
+			return ReadS16(pairs + middle * 6 + 4);
+	}
+
+	return 0;
+}
+
+bool FontFile::RasterizeGlyph(const uint glyph, const float scale, GlyphBitmap& bitmap) const
+{
+	std::vector<GlyphEdge> edges;
+	if (!GetGlyphEdges(glyph, scale, 0, edges, bitmap))
+		return false;
+
+	if (bitmap.Width == 0 || bitmap.Height == 0)
+		return true;
+
+	// One extra row takes the area right of the last column.
+	std::vector<float> accumulation(bitmap.Width * (bitmap.Height + 1), 0.0f);
+	for (const GlyphEdge& edge : edges)
+		AccumulateEdge(edge, bitmap.Width, bitmap.Height, accumulation.data());
+
+	bitmap.Coverage.resize(bitmap.Width * bitmap.Height);
+	float sum = 0.0f;
+	for (int i = 0; i < bitmap.Width * bitmap.Height; i++)
+	{
+		sum += accumulation[i];
+		const float coverage = fabsf(sum);
+		bitmap.Coverage[i] = (byte)((coverage < 1.0f ? coverage : 1.0f) * 255.0f + 0.5f);
+	}
+
+	return true;
+}
+
+bool FontFile::RenderDistanceField(const uint glyph, const float scale, const int spread, GlyphBitmap& bitmap) const
+{
+	std::vector<GlyphEdge> edges;
+	if (!GetGlyphEdges(glyph, scale, spread, edges, bitmap))
+		return false;
+
+	if (edges.empty())
+	{
+		bitmap = GlyphBitmap();
+		return true;
+	}
+
+	// The sign comes from the coverage, so overlapping contours need no special care.
+	std::vector<float> accumulation(bitmap.Width * (bitmap.Height + 1), 0.0f);
+	for (const GlyphEdge& edge : edges)
+		AccumulateEdge(edge, bitmap.Width, bitmap.Height, accumulation.data());
+
+	bitmap.Coverage.resize(bitmap.Width * bitmap.Height);
+	const float maxDistanceSquared = (float)(spread * spread);
+	float sum = 0.0f;
+
+	for (int y = 0; y < bitmap.Height; y++)
+	{
+		for (int x = 0; x < bitmap.Width; x++)
+		{
+			const int i = y * bitmap.Width + x;
+			sum += accumulation[i];
+
+			float distanceSquared = maxDistanceSquared;
+			for (const GlyphEdge& edge : edges)
+			{
+				const float candidate = GetDistanceSquared(edge, x + 0.5f, y + 0.5f);
+				distanceSquared = candidate < distanceSquared ? candidate : distanceSquared;
+			}
+
+			const float distance = fabsf(sum) >= 0.5f ? sqrtf(distanceSquared) : -sqrtf(distanceSquared);
+			bitmap.Coverage[i] = (byte)(127.5f + distance / spread * 127.5f + 0.5f);
+		}
+	}
+
+	return true;
+}
+
+bool FontFile::GetGlyphEdges(const uint glyph, const float scale, const int padding, std::vector<GlyphEdge>& edges, GlyphBitmap& bitmap) const
+{
+	bitmap = GlyphBitmap();
+	edges.clear();
+
+	uint offset = 0;
+	uint length = 0;
+	if (!GetGlyphLocation(glyph, offset, length))
+		return false;
+
+	if (length == 0)
+		return true;
+
+	std::vector<Contour> contours;
+	if (!GetOutline(glyph, contours, 0))
+		return false;
+
+	const int left = (int)floorf(ReadS16(offset + 2) * scale) - padding;
+	const int bottom = (int)floorf(ReadS16(offset + 4) * scale) - padding;
+	const int right = (int)ceilf(ReadS16(offset + 6) * scale) + padding;
+	const int top = (int)ceilf(ReadS16(offset + 8) * scale) + padding;
+
+	bitmap.Width = right - left;
+	bitmap.Height = top - bottom;
+	bitmap.OffsetX = left;
+	bitmap.OffsetY = bottom;
+
+	for (Contour& contour : contours)
+	{
+		// Insert the implied on-curve points between consecutive control points.
+		Contour points;
+		for (uint i = 0; i < contour.size(); i++)
+		{
+			const OutlinePoint& point = contour[i];
+			const OutlinePoint& next = contour[(i + 1) % contour.size()];
+
+			OutlinePoint scaled = { point.X * scale - left, point.Y * scale - bottom, point.OnCurve };
+			points.push_back(scaled);
+
+			if (!point.OnCurve && !next.OnCurve)
+			{
+				OutlinePoint middle = { (point.X + next.X) * 0.5f * scale - left, (point.Y + next.Y) * 0.5f * scale - bottom, true };
+				points.push_back(middle);
+			}
+		}
+
+		uint start = 0;
+		while (start < points.size() && !points[start].OnCurve)
+			start++;
+
+		if (start == points.size())
+			continue;
+
+		const uint count = points.size();
+		OutlinePoint current = points[start];
+
+		for (uint i = 1; i <= count;)
+		{
+			const OutlinePoint& point = points[(start + i) % count];
+
+			if (point.OnCurve)
+			{
+				AddEdge(current.X, current.Y, point.X, point.Y, edges);
+				current = point;
+				i++;
+			}
+			else
+			{
+				const OutlinePoint& end = points[(start + i + 1) % count];
+				FlattenQuadratic(current.X, current.Y, point.X, point.Y, end.X, end.Y, edges);
+				current = end;
+				i += 2;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FontFile::GetGlyphLocation(const uint glyph, uint& offset, uint& length) const
+{
+	if ((int)glyph >= _glyphCount)
+		return false;
+
+	uint start = 0;
+	uint end = 0;
+	if (_indexToLocFormat == 0)
+	{
+		start = ReadU16(_loca + glyph * 2) * 2;
+		end = ReadU16(_loca + glyph * 2 + 2) * 2;
+	}
+	else
+	{
+		start = ReadU32(_loca + glyph * 4);
+		end = ReadU32(_loca + glyph * 4 + 4);
+	}
+
+	offset = _glyf + start;
+	length = end > start ? end - start : 0;
+
+	return (unsigned long long)_glyf + start + length <= _size;
+}
+
+bool FontFile::GetOutline(const uint glyph, std::vector<Contour>& contours, const int depth) const
+{
+	uint offset = 0;
+	uint length = 0;
+	if (depth > MaxCompositeDepth || !GetGlyphLocation(glyph, offset, length))
+		return false;
+
+	if (length == 0)
+		return true;
+
+	if (length < GlyphHeaderSize)
+		return false;
+
+	// Reads are kept inside the file, parsing past the glyph is caught once per pass.
+	const uint glyphEnd = offset + length;
+	const int contourCount = ReadS16(offset);
+
+	if (contourCount >= 0)
+	{
+		const uint endPoints = offset + 10;
+		const uint pointCount = contourCount > 0 ? ReadU16(endPoints + (contourCount - 1) * 2) + 1 : 0;
+		uint position = endPoints + contourCount * 2;
+		position += 2 + ReadU16(position);
+		if (position > glyphEnd)
+			return false;
+
+		// Flags are run-length encoded.
+		std::vector<byte> flags(pointCount);
+		for (uint i = 0; i < pointCount;)
+		{
+			const byte flag = ReadU8(position++);
+			flags[i++] = flag;
+
+			if (flag & 8)
+			{
+				for (uint repeat = ReadU8(position++); repeat > 0 && i < pointCount; repeat--)
+					flags[i++] = flag;
+			}
+
+			if (position > glyphEnd)
+				return false;
+		}
+
+		// Coordinates are deltas, either a byte with a sign flag or a signed short.
+		std::vector<OutlinePoint> points(pointCount);
+		int x = 0;
+		for (uint i = 0; i < pointCount; i++)
+		{
+			if (flags[i] & 2)
+			{
+				const int delta = ReadU8(position++);
+				x += flags[i] & 16 ? delta : -delta;
+			}
+			else if (!(flags[i] & 16))
+			{
+				x += ReadS16(position);
+				position += 2;
+			}
+
+			points[i].X = (float)x;
+			points[i].OnCurve = (flags[i] & 1) != 0;
+		}
+
+		int y = 0;
+		for (uint i = 0; i < pointCount; i++)
+		{
+			if (flags[i] & 4)
+			{
+				const int delta = ReadU8(position++);
+				y += flags[i] & 32 ? delta : -delta;
+			}
+			else if (!(flags[i] & 32))
+			{
+				y += ReadS16(position);
+				position += 2;
+			}
+
+			points[i].Y = (float)y;
+		}
+
+		if (position > glyphEnd)
+			return false;
+
+		uint first = 0;
+		for (int i = 0; i < contourCount; i++)
+		{
+			const uint last = ReadU16(endPoints + i * 2);
+			if (last >= pointCount || last < first)
+				return false;
+
+			contours.push_back(Contour(points.begin() + first, points.begin() + last + 1));
+			first = last + 1;
+		}
+
+		return true;
+	}
+
+	// A composite glyph places transformed copies of other glyphs.
+	uint position = offset + GlyphHeaderSize;
+	uint flags = 0;
+	do
+	{
+		if (position + 4 > glyphEnd)
+			return false;
+
+		flags = ReadU16(position);
+		const uint component = ReadU16(position + 2);
+		position += 4;
+
+		float dx = 0.0f;
+		float dy = 0.0f;
+		if (flags & 1)
+		{
+			dx = (float)ReadS16(position);
+			dy = (float)ReadS16(position + 2);
+			position += 4;
+		}
+		else
+		{
+			dx = (float)(signed char)ReadU8(position);
+			dy = (float)(signed char)ReadU8(position + 1);
+			position += 2;
+		}
+
+		// Matching points instead of offsets are not supported.
+		if (!(flags & 2))
+			dx = dy = 0.0f;
+
+		float a = 1.0f, b = 0.0f, c = 0.0f, d = 1.0f;
+		if (flags & 8)
+		{
+			a = d = ReadS16(position) / 16384.0f;
+			position += 2;
+		}
+		else if (flags & 0x40)
+		{
+			a = ReadS16(position) / 16384.0f;
+			d = ReadS16(position + 2) / 16384.0f;
+			position += 4;
+		}
+		else if (flags & 0x80)
+		{
+			a = ReadS16(position) / 16384.0f;
+			b = ReadS16(position + 2) / 16384.0f;
+			c = ReadS16(position + 4) / 16384.0f;
+			d = ReadS16(position + 6) / 16384.0f;
+			position += 8;
+		}
+
+		std::vector<Contour> componentContours;
+		if (!GetOutline(component, componentContours, depth + 1))
+			return false;
+
+		for (Contour& contour : componentContours)
+		{
+			for (OutlinePoint& point : contour)
+			{
+				const float x = point.X;
+				point.X = a * x + c * point.Y + dx;
+				point.Y = b * x + d * point.Y + dy;
+			}
+
+			contours.push_back(contour);
+		}
+	} while (flags & 0x20);
+
+	return true;
+}
+
+// Splits the curve into enough lines to stay within a tenth of a pixel of it.
+void FlattenQuadratic(const float x0, const float y0, const float x1, const float y1, const float x2, const float y2, std::vector<GlyphEdge>& edges)
+{
+	const float ddx = x0 - 2.0f * x1 + x2;
+	const float ddy = y0 - 2.0f * y1 + y2;
+	const float deviation = sqrtf(ddx * ddx + ddy * ddy);
+
+	int segments = (int)ceilf(sqrtf(deviation / 0.8f));
+	segments = segments < 1 ? 1 : (segments > 32 ? 32 : segments);
+
+	float previousX = x0;
+	float previousY = y0;
+	for (int i = 1; i <= segments; i++)
+	{
+		const float t = (float)i / segments;
+		const float u = 1.0f - t;
+		const float x = u * u * x0 + 2.0f * u * t * x1 + t * t * x2;
+		const float y = u * u * y0 + 2.0f * u * t * y1 + t * t * y2;
+
+		AddEdge(previousX, previousY, x, y, edges);
+		previousX = x;
+		previousY = y;
+	}
+}
+
+void AddEdge(const float x0, const float y0, const float x1, const float y1, std::vector<GlyphEdge>& edges)
+{
+	GlyphEdge edge = { x0, y0, x1, y1 };
+	edges.push_back(edge);
+}
+
+// Adds the signed area between the edge and the right side of the bitmap, split over the pixels it crosses.
+void AccumulateEdge(const GlyphEdge& edge, const int width, const int height, float*const accumulation)
+{
+	if (edge.Y0 == edge.Y1)
+		return;
+
+	const float direction = edge.Y0 < edge.Y1 ? 1.0f : -1.0f;
+	float startX = edge.Y0 < edge.Y1 ? edge.X0 : edge.X1;
+	float startY = edge.Y0 < edge.Y1 ? edge.Y0 : edge.Y1;
+	const float endX = edge.Y0 < edge.Y1 ? edge.X1 : edge.X0;
+	const float endY = edge.Y0 < edge.Y1 ? edge.Y1 : edge.Y0;
+	const float dxdy = (endX - startX) / (endY - startY);
+
+	if (startY < 0.0f)
+	{
+		startX -= startY * dxdy;
+		startY = 0.0f;
+	}
+
+	const int lastRow = (int)ceilf(endY) < height ? (int)ceilf(endY) : height;
+	float x = startX;
+
+	for (int row = (int)startY; row < lastRow; row++)
+	{
+		const int rowStart = row * width;
+		const float top = row + 1.0f < endY ? row + 1.0f : endY;
+		const float dy = top - (row > startY ? row : startY);
+		float nextX = x + dxdy * dy;
+		const float d = dy * direction;
+
+		float x0 = x < nextX ? x : nextX;
+		float x1 = x < nextX ? nextX : x;
+		x0 = x0 < 0.0f ? 0.0f : (x0 > width ? (float)width : x0);
+		x1 = x1 < 0.0f ? 0.0f : (x1 > width ? (float)width : x1);
+
+		const float x0Floor = floorf(x0);
+		const int x0i = (int)x0Floor;
+		const float x1Ceil = ceilf(x1);
+		const int x1i = (int)x1Ceil;
+
+		if (x1i <= x0i + 1)
+		{
+			const float middle = 0.5f * (x0 + x1) - x0Floor;
+			accumulation[rowStart + x0i] += d - d * middle;
+			accumulation[rowStart + x0i + 1] += d * middle;
+		}
+		else
+		{
+			const float s = 1.0f / (x1 - x0);
+			const float x0f = x0 - x0Floor;
+			const float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+			const float x1f = x1 - x1Ceil + 1.0f;
+			const float am = 0.5f * s * x1f * x1f;
+
+			accumulation[rowStart + x0i] += d * a0;
+
+			if (x1i == x0i + 2)
+				accumulation[rowStart + x0i + 1] += d * (1.0f - a0 - am);
+			else
+			{
+				const float a1 = s * (1.5f - x0f);
+				accumulation[rowStart + x0i + 1] += d * (a1 - a0);
+
+				for (int column = x0i + 2; column < x1i - 1; column++)
+					accumulation[rowStart + column] += d * s;
+
+				const float a2 = a1 + (x1i - x0i - 3) * s;
+				accumulation[rowStart + x1i - 1] += d * (1.0f - a2 - am);
+			}
+
+			accumulation[rowStart + x1i] += d * am;
+		}
+
+		x = nextX;
+	}
+}
+
+float GetDistanceSquared(const GlyphEdge& edge, const float x, const float y)
+{
+	const float dx = edge.X1 - edge.X0;
+	const float dy = edge.Y1 - edge.Y0;
+	const float lengthSquared = dx * dx + dy * dy;
+
+	float t = lengthSquared > 0.0f ? ((x - edge.X0) * dx + (y - edge.Y0) * dy) / lengthSquared : 0.0f;
+	t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+
+	const float px = edge.X0 + dx * t - x;
+	const float py = edge.Y0 + dy * t - y;
+
+	return px * px + py * py;
+}
\ No newline at end of file
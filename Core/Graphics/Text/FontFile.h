@@ -0,0 +1,112 @@
+/*
+===========================================================================
+FontFile.h
+
+Reads TrueType fonts: character mapping, metrics, kerning and glyph outlines.
+Glyphs are rasterized with antialiasing by accumulating the signed area
+every outline edge covers in each pixel, or rendered as signed distance
+fields that stay sharp when scaled.
+Only the quadratic outlines of the glyf table are supported, CFF-based
+OpenType fonts are rejected.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <CustomTypes.h>
+#include "System/FileSystem.h"
+
+namespace sedge
+{
+	struct GlyphBitmap
+	{
+		std::vector<byte> Coverage; // rows from the bottom up
+		int Width;
+		int Height;
+		int OffsetX; // from the pen position to the left edge, in pixels
+		int OffsetY; // from the baseline to the bottom edge, y pointing up
+
+		GlyphBitmap() : Width(0), Height(0), OffsetX(0), OffsetY(0) { }
+	};
+
+	// A straight piece of a flattened outline, in bitmap pixels.
+	struct GlyphEdge
+	{
+		float X0;
+		float Y0;
+		float X1;
+		float Y1;
+	};
+
+	class FontFile
+	{
+	private:
+		struct OutlinePoint
+		{
+			float X;
+			float Y;
+			bool OnCurve;
+		};
+
+		typedef std::vector<OutlinePoint> Contour;
+
+		FileView _file;
+		const byte* _data; // the whole font, read in place
+		uint _size;
+		uint _glyf;
+		uint _loca;
+		uint _hmtx;
+		uint _kern;
+		uint _cmap; // the chosen subtable
+		int _unitsPerEm;
+		int _indexToLocFormat;
+		int _glyphCount;
+		int _horizontalMetricCount;
+		int _ascent;
+		int _descent;
+		int _lineGap;
+
+	public:
+		FontFile();
+
+		bool Open(const char*const path);
+		void Close();
+		inline bool IsOpen() const { return _data != nullptr; }
+
+		// 0 is the missing glyph.
+		uint GetGlyphIndex(const uint codepoint) const;
+
+		// The scale that maps the distance from the highest ascender to the lowest descender to the given height.
+		float GetScaleForPixelHeight(const float pixelHeight) const;
+
+		// In font units, descent is negative.
+		void GetVerticalMetrics(int& ascent, int& descent, int& lineGap) const;
+		void GetHorizontalMetrics(const uint glyph, int& advance, int& leftSideBearing) const;
+		// Only the legacy kern table is read, fonts that keep kerning in GPOS get 0.
+		int GetKerning(const uint leftGlyph, const uint rightGlyph) const;
+
+		// Glyphs without an outline, such as the space, give an empty bitmap.
+		bool RasterizeGlyph(const uint glyph, const float scale, GlyphBitmap& bitmap) const;
+		// Stores the distance to the outline instead of coverage: 128 on the outline, 255 at spread pixels inside
+		// and 0 at spread pixels outside. The bitmap is padded by spread pixels.
+		bool RenderDistanceField(const uint glyph, const float scale, const int spread, GlyphBitmap& bitmap) const;
+
+		// Flattens the outline into edges relative to the bitmap the glyph would be rasterized into,
+		// padded by the given number of pixels on every side.
+		bool GetGlyphEdges(const uint glyph, const float scale, const int padding, std::vector<GlyphEdge>& edges, GlyphBitmap& bitmap) const;
+
+	private:
+		bool GetGlyphLocation(const uint glyph, uint& offset, uint& length) const;
+		bool GetOutline(const uint glyph, std::vector<Contour>& contours, const int depth) const;
+
+		// Reads past the end of the font give 0, so offsets taken from a malformed font never leave the file.
+		inline uint ReadU8(const uint offset) const { return offset < _size ? _data[offset] : 0; }
+		inline uint ReadU16(const uint offset) const { return ReadU8(offset) << 8 | ReadU8(offset + 1); }
+		inline int ReadS16(const uint offset) const { return (short)ReadU16(offset); }
+		inline uint ReadU32(const uint offset) const { return ReadU16(offset) << 16 | ReadU16(offset + 2); }
+
+		FontFile(const FontFile& tRef) = delete;
+		FontFile& operator = (const FontFile& tRef) = delete;
+	};
+}
\ No newline at end of file
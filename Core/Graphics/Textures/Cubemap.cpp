@@ -7,8 +7,9 @@ implements the Cubemap class
 */
 
 #include "Cubemap.h"
-#include "System/ImageUtils.h"
+#include "TextureCache.h"
 #include "System/Logger.h"
+#include "System/ThreadPool.h"
 #include "Graphics/GraphicsAPI.h"
 
 using namespace sedge;
@@ -21,39 +22,41 @@ Cubemap::Cubemap(const char*const name, const vector<std::string>& paths, const
 
 bool Cubemap::Load()
 {
-	int width;
-	int height;
-	int components;
+	TextureData faces[FaceCount];
+	ImageData images[FaceCount];
+	const uint count = _paths.size() < FaceCount ? _paths.size() : FaceCount;
 
-	Bind();
-
-	for (uint i = 0; i < _paths.size(); i++)
+	// The faces are independent, so they are loaded in parallel.
+	ThreadPool::GetShared().ParallelFor(0, count, 1, [&](const uint begin, const uint end)
 	{
-		byte* imagePixels = ImageUtils::LoadImage(_paths[i].c_str(), &width, &height, &components);
+		for (uint i = begin; i < end; i++)
+		{
+			if (TextureCache::Load(_paths[i].c_str(), faces[i]))
+				images[i] = faces[i].GetLevels()[0];
+		}
+	});
 
-		if (!imagePixels)
+	return Upload(images, count);
+}
+
+bool Cubemap::Upload(const ImageData*const images, const uint count)
+{
+	for (uint i = 0; i < count; i++)
+	{
+		if (!images[i].Pixels)
 		{
 			LOG_ERROR("Failed to load texture \"", Name.c_str(), "\"");
-			ImageUtils::ReleaseImage(imagePixels);
 			return false;
 		}
+	}
 
-		ColorCode format;
-		switch (components)
-		{
-		case 1:
-			format = Mono;
-			break;
-		case 3:
-			format = Rgb;
-			break;
-		case 4:
-			format = Rgba;
-			break;
-		}
-		
-		GraphicsAPI::LoadCubemapImage(i, 0, format, width, height, 0, format, UnsignedByte, imagePixels);
-		ImageUtils::ReleaseImage(imagePixels);
+	Bind();
+
+	MemorySize = 0;
+	for (uint i = 0; i < count; i++)
+	{
+		UploadImageLevel(Target, i, 0, images[i]);
+		MemorySize += ImageUtils::GetDataSize(images[i]);
 	}
 
 	SetFilterMode(FilterMode);
@@ -24,6 +24,14 @@ namespace sedge
 
 		friend class TextureFactory;
 
+	public:
+		static const uint FaceCount = 6;
+
+		inline const std::vector<std::string>& GetPaths() const { return _paths; }
+
+	protected:
+		virtual bool Upload(const ImageData*const images, const uint count) override;
+
 	private:
 		virtual bool Load() override;
 	};
@@ -8,11 +8,12 @@ Implements Texture class.
 
 #include "Texture.h"
 #include "Graphics/GraphicsAPI.h"
+#include "System/ImageUtils.h"
 
 using namespace sedge;
 
 Texture::Texture(const char* name, const char* path, const TextureTarget target, const TextureWrapMode wrapMode, const TextureFilterMode filterMode)
-	: Name(name), Path(path), Target(target), WrapMode(wrapMode), FilterMode(filterMode)
+	: Name(name), Path(path), Target(target), WrapMode(wrapMode), FilterMode(filterMode), MemorySize(0)
 {
 	GraphicsAPI::GenTextures(1, &TextureID);
 }
@@ -22,6 +23,23 @@ Texture::~Texture()
 	GraphicsAPI::DeleteTextures(1, &TextureID);
 }
 
+bool Texture::Replace(const ImageData*const images, const uint count)
+{
+	ID previousID = TextureID;
+	GraphicsAPI::GenTextures(1, &TextureID);
+
+	if (!Upload(images, count))
+	{
+		GraphicsAPI::DeleteTextures(1, &TextureID);
+		TextureID = previousID;
+		return false;
+	}
+
+	GraphicsAPI::DeleteTextures(1, &previousID);
+
+	return true;
+}
+
 void Texture::Bind() const
 {
 	GraphicsAPI::BindTexture(Target, TextureID);
@@ -51,6 +69,41 @@ void Texture::SetWrapMode(TextureWrapMode wrapMode)
 	GraphicsAPI::SetTextureWrapMode(Target, WrapR, wrapMode);
 }
 
+ColorCode Texture::GetColorCode(const int components)
+{
+	switch (components)
+	{
+	case 1:
+		return Mono;
+	case 3:
+		return Rgb;
+	}
+
+	return Rgba;
+}
+
+void Texture::UploadImageLevel(const TextureTarget target, const uint face, const int level, const ImageData& image)
+{
+	if (image.Format == BlockNone)
+	{
+		const ColorCode format = GetColorCode(image.Components);
+		if (target == TexCube)
+			GraphicsAPI::LoadCubemapImage(face, level, format, image.Width, image.Height, 0, format, UnsignedByte, image.Pixels);
+		else
+			GraphicsAPI::LoadTex2DImage(level, format, image.Width, image.Height, 0, format, UnsignedByte, image.Pixels);
+
+		return;
+	}
+
+	const CompressedFormat format = image.Format == BlockBC1 ? CompressedBC1 : (image.Format == BlockBC3 ? CompressedBC3 : CompressedBC7);
+	const uint size = ImageUtils::GetDataSize(image);
+
+	if (target == TexCube)
+		GraphicsAPI::LoadCompressedCubemapImage(face, level, format, image.Width, image.Height, size, image.Pixels);
+	else
+		GraphicsAPI::LoadCompressedTex2DImage(level, format, image.Width, image.Height, size, image.Pixels);
+}
+
 void Texture::SetFilterMode(TextureFilterMode filterMode)
 {
 	FilterMode = filterMode;
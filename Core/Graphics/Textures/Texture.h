@@ -14,6 +14,8 @@ Base class for texture objects.
 
 namespace sedge
 {
+	struct ImageData;
+
 	class Texture
 	{
 	protected:
@@ -23,9 +25,10 @@ namespace sedge
 		TextureTarget Target;
 		TextureWrapMode WrapMode;
 		TextureFilterMode FilterMode;
+		unsigned long long MemorySize; // of the uploaded images, 0 until they are uploaded
 
 	protected:
-		Texture() {}
+		Texture() : MemorySize(0) {}
 		Texture(const char* name, const char* path, const TextureTarget target, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear);
 		virtual ~Texture();
 
@@ -36,6 +39,7 @@ namespace sedge
 		const TextureTarget GetTarget() const { return Target; }
 		const TextureWrapMode GetWrapMode() const { return WrapMode; }
 		const TextureFilterMode GetFilterMode() const { return FilterMode; }
+		const unsigned long long GetMemorySize() const { return MemorySize; }
 
 		virtual void Bind() const;
 		virtual void Unbind() const;
@@ -46,7 +50,20 @@ namespace sedge
 		virtual void SetWrapMode(const TextureWrapMode Mode);
 		virtual void SetFilterMode(const TextureFilterMode Mode);
 
+	protected:
+		// Replaces the texture contents with already decoded images, must be called on the rendering thread.
+		virtual bool Upload(const ImageData*const images, const uint count) = 0;
+		// Uploads the images into a new texture object and swaps it in, the old contents stay if that fails.
+		bool Replace(const ImageData*const images, const uint count);
+
+		static ColorCode GetColorCode(const int components);
+
+		// Loads one level of an image into the bound texture, face is ignored for 2D textures.
+		static void UploadImageLevel(const TextureTarget target, const uint face, const int level, const ImageData& image);
+
 	private:
 		virtual bool Load() = 0;
+
+		friend class TextureLoader;
 	};
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ implements the Texture2D class
 
 #include "Texture2D.h"
 #include "Graphics/GraphicsAPI.h"
-#include "System/ImageUtils.h"
+#include "TextureCache.h"
 #include "System/Logger.h"
 
 using namespace sedge;
@@ -20,41 +20,58 @@ Texture2D::Texture2D(const char*const name, const char*const path, const Texture
 
 bool Texture2D::Load()
 {
-	byte* imagePixels = ImageUtils::LoadImage(Path.c_str(), &_width, &_height, &_components);
+	TextureData data;
 
-	if (!imagePixels)
+	if (!TextureCache::Load(Path.c_str(), data))
 	{
 		LOG_ERROR("Failed to load texture \"", Name.c_str(), "\"");
-		ImageUtils::ReleaseImage(imagePixels);
 		return false;
 	}
 
-	ColorCode format;
-	switch (_components)
-	{
-	case 1:
-		format = Mono;
-		break;
-	case 3:
-		format = Rgb;
-		break;
-	case 4:
-		format = Rgba;
-		break;
-	}
+	return Upload(data.GetLevels(), data.GetLevelCount());
+}
+
+// Several images are treated as a ready mip chain, a single one gets its mipmaps generated.
+bool Texture2D::Upload(const ImageData*const images, const uint count)
+{
+	if (count == 0 || !images[0].Pixels)
+		return false;
+
+	_width = images[0].Width;
+	_height = images[0].Height;
+	_components = images[0].Components;
 
 	Bind();
 
-	GraphicsAPI::LoadTex2DImage(0, format, _width, _height, 0, format, UnsignedByte, imagePixels);
+	MemorySize = 0;
+	for (uint level = 0; level < count; level++)
+	{
+		UploadImageLevel(Target, 0, level, images[level]);
+		MemorySize += ImageUtils::GetDataSize(images[level]);
+	}
 
 	SetFilterMode(FilterMode);
 	SetWrapMode(WrapMode);
 
-	GraphicsAPI::GenerateMipmap(Target);
+	// The driver cannot generate mipmaps for compressed formats.
+	if (count == 1 && images[0].Format == BlockNone)
+	{
+		GraphicsAPI::GenerateMipmap(Target);
+		MemorySize = MemorySize * 4 / 3;
+	}
 
 	Unbind();
 
-	ImageUtils::ReleaseImage(imagePixels);
-
 	return true;
+}
+
+void Texture2D::UpdateRegion(const int x, const int y, const ImageData& image)
+{
+	Bind();
+	GraphicsAPI::LoadTex2DSubImage(0, x, y, image.Width, image.Height, GetColorCode(image.Components), UnsignedByte, image.Pixels);
+
+	if (FilterMode >= NearestMipmapNearest)
+		GraphicsAPI::GenerateMipmap(Target);
+
+	Unbind();
 }
\ No newline at end of file
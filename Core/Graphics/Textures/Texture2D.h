@@ -31,10 +31,16 @@ namespace sedge
 		inline int GetHeight() const { return _height; }
 		inline int GetComponentsCount() const { return _components; }
 		inline TextureType GetType() const { return _type; }
-		
+
+		// Replaces a part of the base level, the image must have as many components as the texture.
+		void UpdateRegion(const int x, const int y, const ImageData& image);
+
 	public:
 		virtual bool Load() override;
 
+	protected:
+		virtual bool Upload(const ImageData*const images, const uint count) override;
+
 		friend class TextureFactory;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,269 @@
+/*
+===========================================================================
+TextureAtlas.cpp
+
+Implements the AtlasPacker and TextureAtlas classes.
+===========================================================================
+*/
+
+#include "TextureAtlas.h"
+#include "Texture2D.h"
+#include "TextureFactory.h"
+#include "System/ImageUtils.h"
+#include "System/Logger.h"
+#include "System/MemoryManagement.h"
+#include <climits>
+
+using namespace sedge;
+
+AtlasPacker::AtlasPacker(const int width, const int height)
+	: _width(width), _height(height)
+{
+	Reset();
+}
+
+void AtlasPacker::Reset()
+{
+	SkylineNode node;
+	node.X = 0;
+	node.Y = 0;
+	node.Width = _width;
+
+	_skyline.clear();
+	_skyline.push_back(node);
+	_usedArea = 0;
+}
+
+// Picks the position with the lowest top edge, ties go to the narrower skyline segment.
+bool AtlasPacker::Pack(const int width, const int height, int& x, int& y)
+{
+	int bestIndex = -1;
+	int bestTop = INT_MAX;
+	int bestWidth = INT_MAX;
+
+	for (uint i = 0; i < _skyline.size(); i++)
+	{
+		const int fitY = Fit(i, width, height);
+		if (fitY < 0)
+			continue;
+
+		if (fitY + height < bestTop || (fitY + height == bestTop && _skyline[i].Width < bestWidth))
+		{
+			bestIndex = i;
+			bestTop = fitY + height;
+			bestWidth = _skyline[i].Width;
+			x = _skyline[i].X;
+			y = fitY;
+		}
+	}
+
+	if (bestIndex < 0)
+		return false;
+
+	SkylineNode node;
+	node.X = x;
+	node.Y = y + height;
+	node.Width = width;
+	_skyline.insert(_skyline.begin() + bestIndex, node);
+
+	// Shrink or remove the segments now covered by the new one.
+	for (uint i = bestIndex + 1; i < _skyline.size(); i++)
+	{
+		const SkylineNode& previous = _skyline[i - 1];
+		const int overlap = previous.X + previous.Width - _skyline[i].X;
+		if (overlap <= 0)
+			break;
+
+		_skyline[i].X += overlap;
+		_skyline[i].Width -= overlap;
+
+		if (_skyline[i].Width > 0)
+			break;
+
+		_skyline.erase(_skyline.begin() + i);
+		i--;
+	}
+
+	for (uint i = 0; i + 1 < _skyline.size(); i++)
+	{
+		if (_skyline[i].Y == _skyline[i + 1].Y)
+		{
+			_skyline[i].Width += _skyline[i + 1].Width;
+			_skyline.erase(_skyline.begin() + i + 1);
+			i--;
+		}
+	}
+
+	_usedArea += width * height;
+
+	return true;
+}
+
+int AtlasPacker::Fit(const uint index, const int width, const int height) const
+{
+	if (_skyline[index].X + width > _width)
+		return -1;
+
+	int y = _skyline[index].Y;
+	int widthLeft = width;
+
+	for (uint i = index; widthLeft > 0; i++)
+	{
+		y = _skyline[i].Y > y ? _skyline[i].Y : y;
+		if (y + height > _height)
+			return -1;
+
+		widthLeft -= _skyline[i].Width;
+	}
+
+	return y;
+}
+
+TextureAtlas::TextureAtlas(const char*const name, const int pageSize, const int padding)
+	: _name(name), _pageSize(pageSize), _padding(padding)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	for (AtlasPage* page : _pages)
+	{
+		SafeDelete(page->Texture);
+		SafeDelete(page);
+	}
+}
+
+int TextureAtlas::Add(const char*const name, const ImageData& image)
+{
+	const int paddedWidth = image.Width + _padding * 2;
+	const int paddedHeight = image.Height + _padding * 2;
+
+	if (image.Format != BlockNone || paddedWidth > _pageSize || paddedHeight > _pageSize)
+	{
+		LOG_ERROR("Image \"", name, "\" cannot be added to atlas \"", _name, "\"");
+		return -1;
+	}
+
+	int x = 0;
+	int y = 0;
+	uint pageIndex = 0;
+
+	while (pageIndex < _pages.size() && !_pages[pageIndex]->Packer.Pack(paddedWidth, paddedHeight, x, y))
+		pageIndex++;
+
+	if (pageIndex == _pages.size())
+	{
+		_pages.push_back(new AtlasPage(_pageSize));
+		_pages.back()->Packer.Pack(paddedWidth, paddedHeight, x, y);
+	}
+
+	// Pages are always RGBA, other images are expanded first.
+	std::vector<byte> expanded;
+	ImageData rgba = image;
+	if (image.Components != 4)
+	{
+		expanded.resize(image.Width * image.Height * 4);
+		rgba.Pixels = expanded.data();
+		ImageUtils::ExpandToRGBA(image, rgba);
+	}
+
+	CopyImage(*_pages[pageIndex], rgba, x, y);
+
+	AtlasRegion region;
+	region.Page = pageIndex;
+	region.X = x + _padding;
+	region.Y = y + _padding;
+	region.Width = image.Width;
+	region.Height = image.Height;
+	region.UVMin = Vector2((float)region.X / _pageSize, (float)region.Y / _pageSize);
+	region.UVMax = Vector2((float)(region.X + region.Width) / _pageSize, (float)(region.Y + region.Height) / _pageSize);
+
+	_regions.push_back(region);
+	_regionsByName[name] = _regions.size() - 1;
+
+	return _regions.size() - 1;
+}
+
+int TextureAtlas::AddFromFile(const char*const name, const char*const path)
+{
+	ImageData image;
+	if (!ImageUtils::LoadImage(path, image))
+	{
+		LOG_ERROR("Failed to load image \"", path, "\"");
+		return -1;
+	}
+
+	const int region = Add(name, image);
+	ImageUtils::ReleaseImage(image);
+
+	return region;
+}
+
+void TextureAtlas::Upload()
+{
+	for (uint i = 0; i < _pages.size(); i++)
+	{
+		AtlasPage& page = *_pages[i];
+		if (page.DirtyBottom <= page.DirtyTop)
+			continue;
+
+		if (!page.Texture)
+		{
+			ImageData image;
+			image.Pixels = page.Pixels.data();
+			image.Width = _pageSize;
+			image.Height = _pageSize;
+			image.Components = 4;
+
+			page.Texture = TextureFactory::CreateTexture2DFromImage((_name + "_page" + std::to_string(i)).c_str(), image);
+		}
+		else
+		{
+			// Rows are contiguous, so the changed band of full-width rows is a valid sub-image.
+			ImageData band;
+			band.Pixels = page.Pixels.data() + page.DirtyTop * _pageSize * 4;
+			band.Width = _pageSize;
+			band.Height = page.DirtyBottom - page.DirtyTop;
+			band.Components = 4;
+
+			page.Texture->UpdateRegion(0, page.DirtyTop, band);
+		}
+
+		page.DirtyTop = _pageSize;
+		page.DirtyBottom = 0;
+	}
+}
+
+const AtlasRegion* TextureAtlas::GetRegion(const char*const name) const
+{
+	auto it = _regionsByName.find(name);
+
+	return it == _regionsByName.end() ? nullptr : &_regions[it->second];
+}
+
+// Copies the image to (x + padding, y + padding) and repeats its edge pixels over the padding.
+void TextureAtlas::CopyImage(AtlasPage& page, const ImageData& image, const int x, const int y)
+{
+	const int paddedWidth = image.Width + _padding * 2;
+	const int paddedHeight = image.Height + _padding * 2;
+
+	for (int row = 0; row < paddedHeight; row++)
+	{
+		int sourceY = row - _padding;
+		sourceY = sourceY < 0 ? 0 : (sourceY >= image.Height ? image.Height - 1 : sourceY);
+
+		const byte* source = image.Pixels + sourceY * image.Width * 4;
+		byte* target = page.Pixels.data() + ((y + row) * _pageSize + x) * 4;
+
+		for (int column = 0; column < paddedWidth; column++)
+		{
+			int sourceX = column - _padding;
+			sourceX = sourceX < 0 ? 0 : (sourceX >= image.Width ? image.Width - 1 : sourceX);
+
+			memcpy(target + column * 4, source + sourceX * 4, 4);
+		}
+	}
+
+	page.DirtyTop = y < page.DirtyTop ? y : page.DirtyTop;
+	page.DirtyBottom = y + paddedHeight > page.DirtyBottom ? y + paddedHeight : page.DirtyBottom;
+}
\ No newline at end of file
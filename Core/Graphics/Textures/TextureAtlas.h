@@ -0,0 +1,116 @@
+/*
+===========================================================================
+TextureAtlas.h
+
+Packs many small images into a few large textures, so sprites and glyphs
+that share a page can be drawn in one batch.
+Rectangles are placed with a bottom-left skyline packer. Every image is
+surrounded by a border of its repeated edge pixels, so filtering never
+picks up a neighbouring image.
+===========================================================================
+*/
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string>
+#include <CustomTypes.h>
+#include "Math/Vector2.h"
+
+namespace sedge
+{
+	class Texture2D;
+	struct ImageData;
+
+	// Places rectangles into a fixed-size area without moving the ones already placed.
+	class AtlasPacker
+	{
+	private:
+		struct SkylineNode
+		{
+			int X;
+			int Y;
+			int Width;
+		};
+
+		int _width;
+		int _height;
+		int _usedArea;
+		std::vector<SkylineNode> _skyline;
+
+	public:
+		AtlasPacker(const int width, const int height);
+
+		// Returns false if the rectangle does not fit anymore.
+		bool Pack(const int width, const int height, int& x, int& y);
+		void Reset();
+
+		inline int GetWidth() const { return _width; }
+		inline int GetHeight() const { return _height; }
+		inline float GetOccupancy() const { return (float)_usedArea / (_width * _height); }
+
+	private:
+		// The lowest y the rectangle can be placed at, starting at the given node, or -1.
+		int Fit(const uint index, const int width, const int height) const;
+	};
+
+	struct AtlasRegion
+	{
+		uint Page;
+		int X;
+		int Y;
+		int Width;
+		int Height;
+		Vector2 UVMin;
+		Vector2 UVMax;
+	};
+
+	class TextureAtlas
+	{
+	private:
+		struct AtlasPage
+		{
+			AtlasPacker Packer;
+			std::vector<byte> Pixels; // RGBA
+			Texture2D* Texture;
+			int DirtyTop; // rows changed since the last upload
+			int DirtyBottom;
+
+			AtlasPage(const int size) : Packer(size, size), Pixels(size * size * 4), Texture(nullptr), DirtyTop(0), DirtyBottom(size) { }
+		};
+
+		std::string _name;
+		int _pageSize;
+		int _padding;
+		std::vector<AtlasPage*> _pages;
+		std::vector<AtlasRegion> _regions;
+		std::map<std::string, uint> _regionsByName;
+
+	public:
+		TextureAtlas(const char*const name, const int pageSize = 2048, const int padding = 2);
+		~TextureAtlas();
+
+		// Copies the image into the atlas and returns the index of its region, or -1 if it is larger than a page.
+		// Pages are not uploaded until Upload is called.
+		int Add(const char*const name, const ImageData& image);
+		int AddFromFile(const char*const name, const char*const path);
+
+		// Creates the textures of new pages and refreshes the changed ones.
+		void Upload();
+
+		const AtlasRegion* GetRegion(const char*const name) const;
+		inline const AtlasRegion& GetRegion(const uint index) const { return _regions[index]; }
+		inline uint GetRegionCount() const { return _regions.size(); }
+
+		inline uint GetPageCount() const { return _pages.size(); }
+		inline Texture2D* GetPageTexture(const uint page) const { return _pages[page]->Texture; }
+		inline int GetPageSize() const { return _pageSize; }
+
+	private:
+		void CopyImage(AtlasPage& page, const ImageData& image, const int x, const int y);
+
+		TextureAtlas(const TextureAtlas& tRef) = delete;
+		TextureAtlas& operator = (const TextureAtlas& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,282 @@
+/*
+===========================================================================
+TextureCache.cpp
+
+Implements the TextureCache class.
+===========================================================================
+*/
+
+#include "TextureCache.h"
+#include "System/Logger.h"
+#include "System/ThreadPool.h"
+#include <fstream>
+
+using namespace sedge;
+
+static const char CacheMagic[4] = { 'S', 'T', 'E', 'X' };
+static const uint CacheVersion = 2;
+// Larger than any texture the GPU takes, keeps the sizes computed from a corrupt file from overflowing.
+static const uint MaxLevelSize = 16384;
+
+static TextureCompression CacheCompression = TextureCompressionDefault;
+static BlockCompressionQuality CacheQuality = BlockQualityNormal;
+
+struct CacheHeader
+{
+	char Magic[4];
+	uint Version;
+	unsigned long long SourceHash;
+	uint Width;
+	uint Height;
+	uint Components;
+	uint Format;
+	uint LevelCount;
+	uint Reserved;
+};
+
+struct CacheLevelEntry
+{
+	unsigned long long Offset;
+	uint Size;
+	uint Width;
+	uint Height;
+	uint Reserved;
+};
+
+TextureData::~TextureData()
+{
+	ImageUtils::ReleaseImage(_source);
+}
+
+void TextureCache::SetCompression(const TextureCompression compression, const BlockCompressionQuality quality)
+{
+	CacheCompression = compression;
+	CacheQuality = quality;
+}
+
+std::string TextureCache::GetCachePath(const char*const sourcePath)
+{
+	return std::string(sourcePath) + ".stex";
+}
+
+bool TextureCache::Load(const char*const sourcePath, TextureData& data)
+{
+	FileView source;
+	if (!source.Open(sourcePath))
+		return false;
+
+	return Load(sourcePath, source, data);
+}
+
+bool TextureCache::Load(const char*const sourcePath, const FileView& source, TextureData& data)
+{
+	if (!source.IsOpen())
+		return false;
+
+	const unsigned long long sourceHash = Hash(source.GetData(), source.GetSize());
+	const std::string cachePath = GetCachePath(sourcePath);
+	if (LoadCached(cachePath.c_str(), sourceHash, data))
+		return true;
+
+	if (!Decode(source, data))
+		return false;
+
+	if (!Write(cachePath.c_str(), sourceHash, data))
+		LOG_WARNING("Failed to write texture cache \"", cachePath, "\"");
+
+	return true;
+}
+
+unsigned long long TextureCache::HashFile(const char*const path)
+{
+	FileView file;
+	if (!file.Open(path))
+		return 0;
+
+	return Hash(file.GetData(), file.GetSize());
+}
+
+unsigned long long TextureCache::Hash(const byte*const data, const unsigned long long size)
+{
+	unsigned long long hash = 14695981039346656037ull;
+
+	for (unsigned long long i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+bool TextureCache::LoadCached(const char*const cachePath, const unsigned long long sourceHash, TextureData& data)
+{
+	if (!data._file.Open(cachePath))
+		return false;
+
+	const byte* bytes = data._file.GetData();
+	const unsigned long long size = data._file.GetSize();
+	const CacheHeader* header = (const CacheHeader*)bytes;
+
+	const bool valid = size >= sizeof(CacheHeader)
+		&& memcmp(header->Magic, CacheMagic, sizeof(CacheMagic)) == 0
+		&& header->Version == CacheVersion
+		&& header->Components >= 1 && header->Components <= 4
+		&& header->Format == (uint)GetBlockFormat(header->Components)
+		&& header->LevelCount >= 1
+		&& size >= sizeof(CacheHeader) + (unsigned long long)header->LevelCount * sizeof(CacheLevelEntry);
+
+	// A mismatching hash means the source was edited after cooking.
+	if (!valid || header->SourceHash != sourceHash)
+	{
+		data._file.Close();
+		return false;
+	}
+
+	const CacheLevelEntry* entries = (const CacheLevelEntry*)(bytes + sizeof(CacheHeader));
+
+	data._levels.resize(header->LevelCount);
+	for (uint i = 0; i < header->LevelCount; i++)
+	{
+		ImageData& level = data._levels[i];
+		level.Pixels = (byte*)(bytes + entries[i].Offset);
+		level.Width = entries[i].Width;
+		level.Height = entries[i].Height;
+		level.Components = header->Components;
+		level.Format = (BlockFormat)header->Format;
+
+		// The upload reads as much as the level's size and format call for, which must lie within the file.
+		if (entries[i].Width < 1 || entries[i].Width > MaxLevelSize || entries[i].Height < 1 || entries[i].Height > MaxLevelSize
+			|| entries[i].Size < ImageUtils::GetDataSize(level) || entries[i].Offset > size || entries[i].Size > size - entries[i].Offset)
+		{
+			data._levels.clear();
+			data._file.Close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool TextureCache::Decode(const FileView& source, TextureData& data)
+{
+	if (!ImageUtils::LoadImage(source.GetData(), source.GetSize(), data._source))
+		return false;
+
+	const uint levelCount = ImageUtils::GetMipLevelCount(data._source.Width, data._source.Height);
+	const int components = data._source.Components;
+
+	// All the smaller levels share one allocation.
+	unsigned long long storageSize = 0;
+	int width = data._source.Width;
+	int height = data._source.Height;
+	for (uint i = 1; i < levelCount; i++)
+	{
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		storageSize += width * height * components;
+	}
+
+	data._storage.resize(storageSize);
+	data._levels.resize(levelCount);
+	data._levels[0] = data._source;
+
+	// Colour images are treated as sRGB, and alpha keeps transparent texels from darkening their neighbours.
+	const ImageFilterSettings filterSettings(ImageFilterKaiser, components >= 3, components == 4);
+
+	byte* pixels = data._storage.data();
+	for (uint i = 1; i < levelCount; i++)
+	{
+		ImageData& level = data._levels[i];
+		level.Pixels = pixels;
+		ImageUtils::GenerateMipLevel(data._levels[i - 1], level, filterSettings);
+		pixels += level.Width * level.Height * components;
+	}
+
+	const BlockFormat format = GetBlockFormat(components);
+	if (format == BlockNone)
+		return true;
+
+	// Every level is compressed from the uncompressed chain, which is released afterwards.
+	unsigned long long compressedSize = 0;
+	for (uint i = 0; i < levelCount; i++)
+	{
+		ImageData level = data._levels[i];
+		level.Format = format;
+		compressedSize += ImageUtils::GetDataSize(level);
+	}
+
+	std::vector<byte> compressed(compressedSize);
+	std::vector<ImageData> compressedLevels(levelCount);
+
+	byte* blocks = compressed.data();
+	for (uint i = 0; i < levelCount; i++)
+	{
+		ImageData& level = compressedLevels[i];
+		level.Pixels = blocks;
+		BlockCompression::Compress(data._levels[i], format, CacheQuality, level, ThreadPool::GetShared());
+		blocks += ImageUtils::GetDataSize(level);
+	}
+
+	data._storage.swap(compressed);
+	data._levels.swap(compressedLevels);
+	ImageUtils::ReleaseImage(data._source);
+
+	return true;
+}
+
+BlockFormat TextureCache::GetBlockFormat(const int components)
+{
+	if (components < 3)
+		return BlockNone;
+
+	switch (CacheCompression)
+	{
+	case TextureCompressionDefault:
+		return components == 4 ? BlockBC3 : BlockBC1;
+	case TextureCompressionBC7:
+		return BlockBC7;
+	default:
+		return BlockNone;
+	}
+}
+
+bool TextureCache::Write(const char*const cachePath, const unsigned long long sourceHash, const TextureData& data)
+{
+	std::ofstream stream(FileSystem::GetNativePath(cachePath), std::ios::binary);
+	if (!stream)
+		return false;
+
+	const ImageData& base = data._levels[0];
+
+	CacheHeader header;
+	memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+	header.Version = CacheVersion;
+	header.SourceHash = sourceHash;
+	header.Width = base.Width;
+	header.Height = base.Height;
+	header.Components = base.Components;
+	header.Format = base.Format;
+	header.LevelCount = data._levels.size();
+	header.Reserved = 0;
+
+	std::vector<CacheLevelEntry> entries(header.LevelCount);
+	unsigned long long offset = sizeof(CacheHeader) + entries.size() * sizeof(CacheLevelEntry);
+	for (uint i = 0; i < header.LevelCount; i++)
+	{
+		const ImageData& level = data._levels[i];
+		entries[i].Offset = offset;
+		entries[i].Size = ImageUtils::GetDataSize(level);
+		entries[i].Width = level.Width;
+		entries[i].Height = level.Height;
+		entries[i].Reserved = 0;
+		offset += entries[i].Size;
+	}
+
+	stream.write((const char*)&header, sizeof(header));
+	stream.write((const char*)entries.data(), entries.size() * sizeof(CacheLevelEntry));
+	for (uint i = 0; i < header.LevelCount; i++)
+		stream.write((const char*)data._levels[i].Pixels, entries[i].Size);
+
+	return !stream.fail();
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+===========================================================================
+TextureCache.h
+
+Keeps decoded textures with their full mip chains in a binary file next
+to the source image, so later loads only map the file and upload it.
+Colour images are stored block-compressed, so they also take less video
+memory and upload without any conversion.
+
+Layout of a *.stex file:
+	header (source hash, size, block format, level count)
+	LevelEntry levels[LevelCount]
+	pixel data of every level, largest first
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <CustomTypes.h>
+#include "System/ImageUtils.h"
+#include "System/FileSystem.h"
+#include "System/BlockCompression.h"
+
+namespace sedge
+{
+	// The mip chain of a texture image. Levels point into a cache file view or into owned memory.
+	class TextureData
+	{
+	private:
+		std::vector<ImageData> _levels;
+		std::vector<byte> _storage;
+		ImageData _source; // decoded by stb_image
+		FileView _file;
+
+	public:
+		TextureData() {}
+		~TextureData();
+
+		inline const ImageData* GetLevels() const { return _levels.data(); }
+		inline uint GetLevelCount() const { return _levels.size(); }
+
+	private:
+		TextureData(const TextureData& tRef) = delete;
+		TextureData& operator = (const TextureData& tRef) = delete;
+
+		friend class TextureCache;
+	};
+
+	enum TextureCompression
+	{
+		TextureCompressionNone,
+		TextureCompressionDefault, // BC1 for RGB, BC3 for RGBA
+		TextureCompressionBC7
+	};
+
+	class TextureCache
+	{
+	public:
+		// Should be called before any textures are loaded. Caches cooked with another
+		// compression are rebuilt on the next load, a quality change alone does not do that.
+		static void SetCompression(const TextureCompression compression, const BlockCompressionQuality quality);
+
+		static std::string GetCachePath(const char*const sourcePath);
+
+		// Maps the cached file if it was cooked from the current source, otherwise decodes the source,
+		// builds the mip chain and rewrites the cache. Safe to call from several threads for different files.
+		static bool Load(const char*const sourcePath, TextureData& data);
+		// The same with the source already read, e.g. by the asynchronous file reader.
+		static bool Load(const char*const sourcePath, const FileView& source, TextureData& data);
+
+		// 64-bit FNV-1a hash of the file contents, 0 if the file cannot be read.
+		static unsigned long long HashFile(const char*const path);
+		static unsigned long long Hash(const byte*const data, const unsigned long long size);
+
+	private:
+		static bool LoadCached(const char*const cachePath, const unsigned long long sourceHash, TextureData& data);
+		static bool Decode(const FileView& source, TextureData& data);
+		// Images with one or two components are always kept uncompressed.
+		static BlockFormat GetBlockFormat(const int components);
+		static bool Write(const char*const cachePath, const unsigned long long sourceHash, const TextureData& data);
+
+		TextureCache();
+		TextureCache(const TextureCache& tRef) = delete;
+		TextureCache& operator = (const TextureCache& tRef) = delete;
+	};
+}
\ No newline at end of file
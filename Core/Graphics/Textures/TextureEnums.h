@@ -51,4 +51,11 @@ namespace sedge
 		Rgb,
 		Rgba
 	};
+
+	enum CompressedFormat
+	{
+		CompressedBC1,
+		CompressedBC3,
+		CompressedBC7
+	};
 }
\ No newline at end of file
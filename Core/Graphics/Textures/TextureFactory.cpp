@@ -10,14 +10,23 @@ Implements TextureFactory class
 #include "System/FileUtils.h"
 #include "System/Logger.h"
 #include "System/MemoryManagement.h"
+#include "System/ImageUtils.h"
 #include "Texture2D.h"
 #include "Cubemap.h"
 
 using namespace sedge;
 
+static byte PlaceholderPixel[4] = { 128, 128, 128, 255 };
+
+static ImageData GetPlaceholderImage();
+
 Texture2D* TextureFactory::CreateDefaultTexture()
 {
-	return nullptr;
+	Texture2D* texture = new Texture2D("default", "");
+	const ImageData placeholder = GetPlaceholderImage();
+	texture->Upload(&placeholder, 1);
+
+	return texture;
 }
 
 Texture2D* TextureFactory::CreateTexture2DFromFile(const char* name, const char* path, TextureType type, TextureWrapMode wrapMode, TextureFilterMode filterMode)
@@ -46,6 +55,26 @@ Texture2D* TextureFactory::CreateTexture2DFromFile(const char* name, const char*
 	return texture;
 }
 
+Texture2D* TextureFactory::CreateTexture2DFromImage(const char*const name, const ImageData& image, const TextureWrapMode wrapMode, const TextureFilterMode filterMode)
+{
+	if (strcmp(name, "") == 0)
+	{
+		LOG_ERROR("Cannot create a texture with an empty name string");
+		return nullptr;
+	}
+
+	Texture2D* texture = new Texture2D(name, "", Diffuse, wrapMode, filterMode);
+
+	if (!texture->Upload(&image, 1))
+	{
+		LOG_ERROR("Failed to create texture: ", name);
+		SafeDelete(texture);
+		return nullptr;
+	}
+
+	return texture;
+}
+
 Cubemap* TextureFactory::CreateCubemapFromFile(const char*const name, const std::vector<std::string>& paths, const TextureWrapMode wrapMode, const TextureFilterMode filterMode)
 {
 	if (strcmp(name, "") == 0)
@@ -79,4 +108,73 @@ Cubemap* TextureFactory::CreateCubemapFromFile(const char*const name, const std:
 	}
 
 	return texture;
+}
+
+Texture2D* TextureFactory::CreateTexture2DPlaceholder(const char*const name, const char*const path, const TextureType type, const TextureWrapMode wrapMode, const TextureFilterMode filterMode)
+{
+	if (strcmp(name, "") == 0)
+	{
+		LOG_ERROR("Cannot create a texture with an empty name string");
+		return nullptr;
+	}
+
+	if (!FileUtils::CheckFileExists(path))
+	{
+		LOG_ERROR("Texture file \"", path, "\"was not found");
+		return nullptr;
+	}
+
+	Texture2D* texture = new Texture2D(name, path, type, wrapMode, filterMode);
+
+	const ImageData placeholder = GetPlaceholderImage();
+	texture->Upload(&placeholder, 1);
+
+	return texture;
+}
+
+Cubemap* TextureFactory::CreateCubemapPlaceholder(const char*const name, const std::vector<std::string>& paths, const TextureWrapMode wrapMode, const TextureFilterMode filterMode)
+{
+	if (strcmp(name, "") == 0)
+	{
+		LOG_ERROR("Cannot create a texture with an empty name string");
+		return nullptr;
+	}
+
+	if (paths.size() != Cubemap::FaceCount)
+	{
+		LOG_ERROR("Cubemap \"", name, "\" needs ", Cubemap::FaceCount, " faces");
+		return nullptr;
+	}
+
+	for (uint i = 0; i < paths.size(); i++)
+	{
+		if (!FileUtils::CheckFileExists(paths[i].c_str()))
+		{
+			LOG_ERROR("Texture file \"", paths[i].c_str(), "\"was not found");
+			return nullptr;
+		}
+	}
+
+	Cubemap* texture = new Cubemap(name, paths, wrapMode, filterMode);
+
+	const ImageData placeholders[Cubemap::FaceCount] =
+	{
+		GetPlaceholderImage(), GetPlaceholderImage(), GetPlaceholderImage(),
+		GetPlaceholderImage(), GetPlaceholderImage(), GetPlaceholderImage()
+	};
+	texture->Upload(placeholders, Cubemap::FaceCount);
+
+	return texture;
+}
+
+// A single grey pixel shown until the actual image arrives.
+ImageData GetPlaceholderImage()
+{
+	ImageData image;
+	image.Pixels = PlaceholderPixel;
+	image.Width = 1;
+	image.Height = 1;
+	image.Components = 4;
+
+	return image;
 }
\ No newline at end of file
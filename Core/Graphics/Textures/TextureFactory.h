@@ -22,8 +22,14 @@ namespace sedge
 	public:
 		static Texture2D* CreateDefaultTexture();
 		static Texture2D* CreateTexture2DFromFile(const char*const name, const char*const path, const TextureType type = Diffuse, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear);
+		static Texture2D* CreateTexture2DFromImage(const char*const name, const ImageData& image, const TextureWrapMode wrapMode = ClampToEdge, const TextureFilterMode filterMode = Linear);
 		static Cubemap* CreateCubemapFromFile(const char*const name, const std::vector<std::string>& paths, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear);
 
+		// Return a placeholder texture for the files, to be handed to a TextureLoader that replaces its contents
+		// once the images are decoded. The files are only checked for existence.
+		static Texture2D* CreateTexture2DPlaceholder(const char*const name, const char*const path, const TextureType type = Diffuse, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear);
+		static Cubemap* CreateCubemapPlaceholder(const char*const name, const std::vector<std::string>& paths, const TextureWrapMode wrapMode = Repeat, const TextureFilterMode filterMode = Linear);
+
 	private:
 		TextureFactory();
 		TextureFactory(const TextureFactory& tRef) = delete;
@@ -0,0 +1,125 @@
+/*
+===========================================================================
+TextureLoader.cpp
+
+Implements the TextureLoader class.
+===========================================================================
+*/
+
+#include "TextureLoader.h"
+#include "Texture.h"
+#include "System/MemoryManagement.h"
+#include "System/Logger.h"
+
+using namespace sedge;
+
+TextureLoader::TextureLoader(AsyncFileReader& reader)
+	: _reader(reader), _pendingRequests(0)
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+	// Pending reads reference the requests, so wait for them before freeing anything.
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idleCondition.wait(lock, [this] { return _pendingRequests == _decoded.size(); });
+
+	for (Request* request : _decoded)
+		ReleaseRequest(request);
+}
+
+void TextureLoader::Load(Texture*const texture, const std::vector<std::string>& paths, const TextureLoadedCallback& onLoaded, const bool replace)
+{
+	if (paths.empty())
+		return;
+
+	Request* request = new Request();
+	request->Target = texture;
+	request->Paths = paths;
+	request->Images.resize(paths.size(), nullptr);
+	request->PendingImages = paths.size();
+	request->OnLoaded = onLoaded;
+	request->Replace = replace;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_pendingRequests++;
+	}
+
+	const IOPriority priority = replace ? IOPriorityHigh : IOPriorityNormal;
+	for (uint i = 0; i < paths.size(); i++)
+		_reader.Read(paths[i].c_str(), priority, [this, request, i](FileView& source) { DecodeImage(request, i, source); });
+}
+
+void TextureLoader::Update()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_decoded.empty())
+			return;
+
+		_uploads.swap(_decoded);
+		_pendingRequests -= _uploads.size();
+	}
+
+	for (Request* request : _uploads)
+	{
+		bool decoded = true;
+		for (uint i = 0; i < request->Images.size(); i++)
+		{
+			if (!request->Images[i])
+			{
+				LOG_ERROR("Failed to load texture \"", request->Paths[i], "\"");
+				decoded = false;
+			}
+		}
+
+		// Cubemaps take one image per face, 2D textures the mip chain of their only image.
+		_uploadImages.clear();
+		if (decoded && request->Target->GetTarget() == TexCube)
+		{
+			for (const TextureData* image : request->Images)
+				_uploadImages.push_back(image->GetLevels()[0]);
+		}
+		else if (decoded)
+		{
+			_uploadImages.assign(request->Images[0]->GetLevels(), request->Images[0]->GetLevels() + request->Images[0]->GetLevelCount());
+		}
+
+		const bool loaded = decoded && (request->Replace
+			? request->Target->Replace(_uploadImages.data(), _uploadImages.size())
+			: request->Target->Upload(_uploadImages.data(), _uploadImages.size()));
+
+		if (request->OnLoaded)
+			request->OnLoaded(request->Target, loaded);
+
+		ReleaseRequest(request);
+	}
+
+	_uploads.clear();
+}
+
+void TextureLoader::DecodeImage(Request*const request, const uint index, const FileView& source)
+{
+	TextureData* data = new TextureData();
+	if (TextureCache::Load(request->Paths[index].c_str(), source, *data))
+		request->Images[index] = data;
+	else
+		SafeDelete(data);
+
+	// The last decoded image hands the whole request over to the rendering thread.
+	if (--request->PendingImages == 0)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_decoded.push_back(request);
+		_idleCondition.notify_all();
+	}
+}
+
+void TextureLoader::ReleaseRequest(Request* request)
+{
+	for (TextureData* image : request->Images)
+		SafeDelete(image);
+
+	SafeDelete(request);
+}
\ No newline at end of file
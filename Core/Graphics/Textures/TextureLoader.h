@@ -0,0 +1,75 @@
+/*
+===========================================================================
+TextureLoader.h
+
+Loads textures in the background.
+Source images are read by the asynchronous file reader and checked
+against the texture cache (or decoded and cooked into it) on its thread
+pool, the results are queued and uploaded on the rendering thread by
+Update. Until then a texture keeps whatever contents it had, normally a
+placeholder.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <CustomTypes.h>
+#include "TextureCache.h"
+#include "System/AsyncFileReader.h"
+
+namespace sedge
+{
+	class Texture;
+
+	// Called on the rendering thread once the texture is uploaded or failed to load.
+	typedef std::function<void(Texture*const texture, const bool loaded)> TextureLoadedCallback;
+
+	class TextureLoader
+	{
+	private:
+		struct Request
+		{
+			Texture* Target;
+			std::vector<std::string> Paths;
+			std::vector<TextureData*> Images;
+			std::atomic<uint> PendingImages;
+			TextureLoadedCallback OnLoaded;
+			bool Replace;
+		};
+
+		AsyncFileReader& _reader;
+		std::vector<Request*> _decoded;
+		std::vector<Request*> _uploads;
+		std::vector<ImageData> _uploadImages;
+		uint _pendingRequests;
+		std::mutex _mutex;
+		std::condition_variable _idleCondition;
+
+	public:
+		explicit TextureLoader(AsyncFileReader& reader);
+		~TextureLoader();
+
+		// One path per image of the texture, e.g. six for a cubemap. With replace set the images go into
+		// a new texture object that is swapped in on upload, which is how changed files are reloaded.
+		// Reloads are read ahead of regular loads, someone is looking at the texture waiting for them.
+		void Load(Texture*const texture, const std::vector<std::string>& paths, const TextureLoadedCallback& onLoaded = nullptr, const bool replace = false);
+
+		// Uploads all textures decoded since the last call, must be called on the rendering thread.
+		void Update();
+
+		inline bool IsIdle() { std::lock_guard<std::mutex> lock(_mutex); return _pendingRequests == 0; }
+
+	private:
+		void DecodeImage(Request*const request, const uint index, const FileView& source);
+		static void ReleaseRequest(Request* request);
+
+		TextureLoader(const TextureLoader& tRef) = delete;
+		TextureLoader& operator = (const TextureLoader& tRef) = delete;
+	};
+}
\ No newline at end of file
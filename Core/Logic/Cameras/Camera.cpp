@@ -90,12 +90,12 @@ void Camera::SetFar(const float far)
 	UpdatePerspective();
 }
 
-const Matrix4& Camera::GetProjection()
+const Matrix4& Camera::GetProjection() const
 {
 	return ProjectionMatrix;
 }
 
-const Matrix4& Camera::GetView()
+const Matrix4& Camera::GetView() const
 {
 	return ViewMatrix;
 }
\ No newline at end of file
@@ -45,8 +45,8 @@ namespace sedge
 		virtual void SetPosition(const Vector3& position);
 		void SetUp(const Vector3& up);
 
-		const Matrix4& GetProjection();
-		const Matrix4& GetView();
+		const Matrix4& GetProjection() const;
+		const Matrix4& GetView() const;
 
 	protected:
 		Camera();
@@ -21,6 +21,11 @@ void Actor::Draw()
 	_renderable->Draw();
 }
 
+void Actor::SelectLod(const LodView& view, const Matrix4& modelMatrix)
+{
+	_renderable->SelectLod(view, modelMatrix);
+}
+
 void Actor::UpdateModelMatrix()
 {
 	Entity::UpdateModelMatrix();
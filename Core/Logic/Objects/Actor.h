@@ -18,6 +18,7 @@ namespace sedge
 		const Renderable*const GetRenderable() const { return _renderable; }
 
 		virtual void Draw() override;
+		virtual void SelectLod(const LodView& view, const Matrix4& modelMatrix) override;
 
 	protected:
 		virtual void UpdateModelMatrix() override;
@@ -17,6 +17,7 @@ namespace sedge
 	class Renderable;
 	struct Vector3;
 	struct Matrix4;
+	struct LodView;
 
 	class Entity
 	{
@@ -31,6 +32,7 @@ namespace sedge
 		virtual ~Entity() {}
 
 		virtual void Draw() = 0;
+		virtual void SelectLod(const LodView& view, const Matrix4& modelMatrix) { }
 
 		inline virtual const Vector3& GetPosition() const { return Position; }
 		inline virtual const Vector3& GetScale() const { return Scale; }
@@ -0,0 +1,64 @@
+/*
+===========================================================================
+FrameSnapshot.h
+
+What the simulation hands to rendering for one frame: the camera and
+the entities to draw with their transforms, copied when the frame was
+captured. Rendering only reads the snapshot, so the simulation can move
+on to the next frame meanwhile.
+
+A snapshot is captured after every update and keeps the state of the
+update before as well, frames rendered between two updates interpolate
+between the two.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include "Logic/Cameras/Camera.h"
+#include "Math/Matrix4.h"
+
+namespace sedge
+{
+	class Entity;
+
+	// A camera frozen at the state it had when the frame was captured.
+	class FrameCamera : public Camera
+	{
+	public:
+		inline void Capture(const Camera& camera) { Camera::operator=(camera); }
+
+		inline void Interpolate(const Camera& from, const Camera& to, const float alpha)
+		{
+			Fov = from.GetFOV() + (to.GetFOV() - from.GetFOV()) * alpha;
+			AspectRatio = to.GetAspectRatio();
+			Near = to.GetNear();
+			Far = to.GetFar();
+			Position = from.GetPosition() + (to.GetPosition() - from.GetPosition()) * alpha;
+			ViewDirection = from.GetViewDirection() + (to.GetViewDirection() - from.GetViewDirection()) * alpha;
+			Up = from.GetUp() + (to.GetUp() - from.GetUp()) * alpha;
+
+			UpdatePerspective();
+			UpdateView();
+		}
+	};
+
+	struct DrawItem
+	{
+		// Drawn, not read for its transform. Entities must outlive the frames they are captured in.
+		Entity* Target;
+		Matrix4 PreviousModel;
+		Matrix4 Model;
+	};
+
+	struct FrameSnapshot
+	{
+		FrameCamera PreviousView;
+		FrameCamera View;
+		std::vector<DrawItem> Items;
+		bool Captured; // false until the first update, when there is no previous state yet
+
+		FrameSnapshot() : Captured(false) {}
+	};
+}
\ No newline at end of file
@@ -8,6 +8,7 @@ Implements the Scene class
 
 #include "Scene.h"
 #include "Entity.h"
+#include "FrameSnapshot.h"
 #include "Logic/Cameras/Camera.h"
 #include "System/MemoryManagement.h"
 #include "Graphics/Shaders/ShaderProgram.h"
@@ -15,10 +16,17 @@ Implements the Scene class
 #include "Graphics/Terrain/Terrain.h"
 #include "Graphics/Renderables/Skybox.h"
 #include "Graphics/GraphicsAPI.h"
+#include "Graphics/Renderables/Renderable.h"
+#include "Math/Converters.h"
+#include <cmath>
 
 using namespace sedge;
 
+static Matrix4 InterpolateModel(const Matrix4& from, const Matrix4& to, const float alpha);
+
 Scene::Scene(Camera*const camera, ShaderProgram*const mainShader)
+	: _shaderSkybox(nullptr), _shaderTerrain(nullptr), _skybox(nullptr), _terrain(nullptr),
+	_maxScreenError(1.0f), _viewportHeight(720.0f)
 {
 	_camera = camera;
 	_mainShader = mainShader;
@@ -29,32 +37,63 @@ void Scene::AddEntity(Entity*const entity)
 	_entities.push_back(entity);
 }
 
+void Scene::SetMaxScreenError(const float pixels, const float viewportHeight)
+{
+	_maxScreenError = pixels;
+	_viewportHeight = viewportHeight;
+}
+
 void Scene::RemoveEntity(Entity*const entity)
 {
 }
 
 void Scene::Update()
 {
-	UpdateCamera();
+}
+
+void Scene::Capture(FrameSnapshot& frame) const
+{
+	if (_camera)
+	{
+		frame.PreviousView = frame.View;
+		frame.View.Capture(*_camera);
 
-	const Vector3& cameraPosition = _camera->GetPosition();
-	const Vector3& cameraDirection = _camera->GetViewDirection();
+		if (!frame.Captured)
+			frame.PreviousView = frame.View;
+	}
 
-	_mainShader->Bind();
-	_mainShader->SetUniform3f("spotLight.position", cameraPosition);
-	_mainShader->SetUniform3f("spotLight.direction", _camera->GetViewDirection());
-	_mainShader->SetUniform3f("viewPos", cameraPosition);
+	// Entities new to the frame start out where they are.
+	const uint previousCount = frame.Items.size();
+	frame.Items.resize(_entities.size());
+	for (uint i = 0; i < _entities.size(); i++)
+	{
+		DrawItem& item = frame.Items[i];
+		const Matrix4& model = _entities[i]->GetModelMatrix();
+
+		item.PreviousModel = i < previousCount && item.Target == _entities[i] ? item.Model : model;
+		item.Target = _entities[i];
+		item.Model = model;
+	}
+
+	frame.Captured = true;
 }
 
-void Scene::Draw()
+void Scene::Draw(const FrameSnapshot& frame, const float alpha)
 {
-	const Matrix4& projection = _camera->GetProjection();
-	const Matrix4& view = _camera->GetView();
+	FrameCamera camera;
+	camera.Interpolate(frame.PreviousView, frame.View, alpha);
+
+	const Matrix4& projection = camera.GetProjection();
+	const Matrix4& view = camera.GetView();
+
+	// Streamed terrain tiles are uploaded here, where the graphics context is current.
+	if (_terrain)
+		_terrain->Update(camera);
 
 	_shaderTerrain->Bind();
 	_shaderTerrain->SetProjection(projection);
 	_shaderTerrain->SetView(view);
-	_terrain->Draw();
+	_terrain->Draw(camera, _shaderTerrain);
 
 	_shaderSkybox->Bind();
 	_shaderSkybox->SetProjection(projection);
@@ -66,11 +105,22 @@ void Scene::Draw()
 	_mainShader->Bind();
 	_mainShader->SetProjection(projection);
 	_mainShader->SetView(view);
+	_mainShader->SetUniform3f("spotLight.position", camera.GetPosition());
+	_mainShader->SetUniform3f("spotLight.direction", camera.GetViewDirection());
+	_mainShader->SetUniform3f("viewPos", camera.GetPosition());
 
-	for (uint i = 0; i < _entities.size(); i++)
+	LodView lodView;
+	lodView.CameraPosition = camera.GetPosition();
+	lodView.PixelScale = _viewportHeight / (2.0f * tanf(DegToRad(camera.GetFOV()) * 0.5f));
+	lodView.MaxScreenError = _maxScreenError;
+
+	// Only the snapshot's transforms are read, the simulation may be changing the entities' own meanwhile.
+	for (const DrawItem& item : frame.Items)
 	{
-		_mainShader->SetModel(_entities[i]->GetModelMatrix());
-		_entities[i]->Draw();
+		const Matrix4 model = InterpolateModel(item.PreviousModel, item.Model, alpha);
+		item.Target->SelectLod(lodView, model);
+		_mainShader->SetModel(model);
+		item.Target->Draw();
 	}
 }
 
@@ -87,9 +137,6 @@ void Scene::SetSkybox(Skybox*const skybox, ShaderProgram*const shaderSkybox)
 	if (_skybox)
 		SafeDelete(_skybox);
 
-	if (_shaderSkybox)
-		SafeDelete(_shaderSkybox);
-
 	_skybox = skybox;
 	_shaderSkybox = shaderSkybox;
 }
@@ -99,32 +146,26 @@ void Scene::SetTerrain(Terrain*const terrain, ShaderProgram*const shaderTerrain)
 	if (_terrain)
 		SafeDelete(_terrain);
 
-	if (_shaderTerrain)
-		SafeDelete(_shaderTerrain);
-
 	_terrain = terrain;
 	_shaderTerrain = shaderTerrain;
 }
 
-void Scene::UpdateCamera()
-{
-	if (!_camera)
-		return;
-
-	_mainShader->Bind();
-	_mainShader->SetProjection(_camera->GetProjection());
-	_mainShader->SetView(_camera->GetView());
-}
-
 Scene::~Scene()
 {
 	SafeDelete(_camera);
-	SafeDelete(_shaderTerrain);
-	SafeDelete(_shaderSkybox);
 	SafeDelete(_skybox);
 	SafeDelete(_terrain);
-	SafeDelete(_mainShader);
 
 	for (auto entity : _entities)
 		SafeDelete(entity);
+}
+
+// Blending the matrices rather than the transforms they were built from is close enough for the change of a single update.
+Matrix4 InterpolateModel(const Matrix4& from, const Matrix4& to, const float alpha)
+{
+	Matrix4 model(to);
+	for (uint i = 0; i < 16; i++)
+		model.data[i] = from.data[i] + (to.data[i] - from.data[i]) * alpha;
+
+	return model;
 }
\ No newline at end of file
@@ -12,17 +12,21 @@ namespace sedge
 	class Camera;
 	class Skybox;
 	class Terrain;
+	struct FrameSnapshot;
 
 	class Scene
 	{
 	private:
 		std::vector<Entity*> _entities;
 		Camera* _camera;
+		// The shaders are owned by the shader manager.
 		ShaderProgram* _mainShader;
 		ShaderProgram* _shaderSkybox;
 		ShaderProgram* _shaderTerrain;
 		Skybox* _skybox;
 		Terrain* _terrain;
+		float _maxScreenError; // in pixels, for the levels of detail of the entities
+		float _viewportHeight;
 
 	public:
 		Scene(Camera*const camera, ShaderProgram*const mainShader);
@@ -37,13 +41,17 @@ namespace sedge
 		void SetCamera(Camera*const camera);
 		void SetSkybox(Skybox*const skybox, ShaderProgram*const shaderSkybox);
 		void SetTerrain(Terrain*const terrain, ShaderProgram*const shaderTerrain);
+		// The entities' levels of detail are picked so that their errors stay below the given size on the screen.
+		void SetMaxScreenError(const float pixels, const float viewportHeight);
 		void AddEntity(Entity*const entity);
 		void RemoveEntity(Entity*const entity);
 
+		// Runs on the simulation thread when the engine runs one, must not touch the graphics API.
 		virtual void Update();
-		virtual void Draw();
-
-	private:
-		void UpdateCamera();
+		// Copies what Draw needs, so the scene can change while the frame is drawn. The frame's
+		// previous state is taken from what was captured into it before.
+		virtual void Capture(FrameSnapshot& frame) const;
+		// Draws the state alpha of the way from the previous capture to the last one.
+		virtual void Draw(const FrameSnapshot& frame, const float alpha);
 	};
 }
\ No newline at end of file
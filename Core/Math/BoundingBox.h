@@ -0,0 +1,47 @@
+/*
+===========================================================================
+BoundingBox.h
+
+Represents an axis-aligned bounding box.
+===========================================================================
+*/
+
+#pragma once
+
+#include "Math/Vector3.h"
+
+namespace sedge
+{
+	struct BoundingBox
+	{
+		Vector3 Min;
+		Vector3 Max;
+
+		BoundingBox() { }
+		BoundingBox(const Vector3& min, const Vector3& max)
+			: Min(min), Max(max) { }
+
+		inline Vector3 GetCenter() const { return (Min + Max) * 0.5f; }
+		inline Vector3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+		void Merge(const BoundingBox& other)
+		{
+			Min.x = other.Min.x < Min.x ? other.Min.x : Min.x;
+			Min.y = other.Min.y < Min.y ? other.Min.y : Min.y;
+			Min.z = other.Min.z < Min.z ? other.Min.z : Min.z;
+			Max.x = other.Max.x > Max.x ? other.Max.x : Max.x;
+			Max.y = other.Max.y > Max.y ? other.Max.y : Max.y;
+			Max.z = other.Max.z > Max.z ? other.Max.z : Max.z;
+		}
+
+		// Returns the squared distance from a point to the closest point of the box (0 if inside).
+		const float GetDistanceSquared(const Vector3& point) const
+		{
+			const float dx = point.x < Min.x ? Min.x - point.x : (point.x > Max.x ? point.x - Max.x : 0.0f);
+			const float dy = point.y < Min.y ? Min.y - point.y : (point.y > Max.y ? point.y - Max.y : 0.0f);
+			const float dz = point.z < Min.z ? Min.z - point.z : (point.z > Max.z ? point.z - Max.z : 0.0f);
+
+			return dx * dx + dy * dy + dz * dz;
+		}
+	};
+}
\ No newline at end of file
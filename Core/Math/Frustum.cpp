@@ -0,0 +1,73 @@
+/*
+===========================================================================
+Frustum.cpp
+
+Implements the Frustum class.
+Planes are extracted with the Gribb-Hartmann method.
+===========================================================================
+*/
+
+#include "Frustum.h"
+#include "Matrix4.h"
+#include "BoundingBox.h"
+#include <cmath>
+
+using namespace sedge;
+
+Frustum::Frustum(const Matrix4& projection, const Matrix4& view)
+{
+	Update(projection, view);
+}
+
+void Frustum::Update(const Matrix4& projection, const Matrix4& view)
+{
+	// Column-major multiplication of projection * view.
+	float m[16];
+	for (int column = 0; column < 4; column++)
+	{
+		for (int row = 0; row < 4; row++)
+		{
+			float sum = 0.0f;
+			for (int e = 0; e < 4; e++)
+				sum += projection.data[row + e * 4] * view.data[e + column * 4];
+			m[row + column * 4] = sum;
+		}
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		_planes[i * 2 + 0] = Vector4(m[3] + m[i], m[7] + m[4 + i], m[11] + m[8 + i], m[15] + m[12 + i]);
+		_planes[i * 2 + 1] = Vector4(m[3] - m[i], m[7] - m[4 + i], m[11] - m[8 + i], m[15] - m[12 + i]);
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		Vector4& plane = _planes[i];
+		const float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f)
+		{
+			plane.x /= length;
+			plane.y /= length;
+			plane.z /= length;
+			plane.w /= length;
+		}
+	}
+}
+
+const bool Frustum::IsBoxVisible(const BoundingBox& box) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4& plane = _planes[i];
+
+		// Test the box corner that lies furthest along the plane normal.
+		const float x = plane.x >= 0.0f ? box.Max.x : box.Min.x;
+		const float y = plane.y >= 0.0f ? box.Max.y : box.Min.y;
+		const float z = plane.z >= 0.0f ? box.Max.z : box.Min.z;
+
+		if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
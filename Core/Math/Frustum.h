@@ -0,0 +1,32 @@
+/*
+===========================================================================
+Frustum.h
+
+Declares a view frustum built from a projection-view matrix.
+Used to cull bounding volumes that are not visible to the camera.
+===========================================================================
+*/
+
+#pragma once
+
+#include "Math/Vector4.h"
+
+namespace sedge
+{
+	struct Matrix4;
+	struct BoundingBox;
+
+	class Frustum
+	{
+	private:
+		Vector4 _planes[6]; // left, right, bottom, top, near, far; xyz - normal, w - distance
+
+	public:
+		Frustum() {}
+		Frustum(const Matrix4& projection, const Matrix4& view);
+
+		void Update(const Matrix4& projection, const Matrix4& view);
+
+		const bool IsBoxVisible(const BoundingBox& box) const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+/*
+===========================================================================
+SIMD.h
+
+Detects the vector instruction sets the compiler targets.
+Code using intrinsics checks the S3_* macros and keeps a scalar path.
+===========================================================================
+*/
+
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define S3_SSE2
+	#include <emmintrin.h>
+#endif
\ No newline at end of file
@@ -103,8 +103,18 @@ void Window::SetVSync(const bool vsync)
 }
 
 void Window::UpdateWindowState()
+{
+	Present();
+	PollEvents();
+}
+
+void Window::Present()
 {
 	glfwSwapBuffers((GLFWwindow*)_handle);
+}
+
+void Window::PollEvents()
+{
 	glfwPollEvents();
 }
 
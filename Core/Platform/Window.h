@@ -40,7 +40,11 @@ namespace sedge
 
 		bool Initialize();
 		void UpdateContextState();
+		// Presents the frame and polls events, the two steps below.
 		void UpdateWindowState();
+		void Present();
+		// Input callbacks run in here, on the calling thread.
+		void PollEvents();
 		void Clear();
 
 		inline const char* GetTitle() const { return _title.c_str(); }
@@ -0,0 +1,541 @@
+/*
+===========================================================================
+AsyncFileReader.cpp
+
+Implements the AsyncFileReader class. The io_uring backend talks to the
+kernel directly: the submission and completion rings are mapped into
+this process, reads are queued by writing entries into the submission
+ring and completions are taken from the completion ring. An eventfd is
+polled through the ring as well, so the thread wakes up for new
+requests while it waits for completions.
+===========================================================================
+*/
+
+#include "AsyncFileReader.h"
+#include "ThreadPool.h"
+#include "Logger.h"
+#include <vector>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace sedge;
+
+// Entries of the submission ring. One of them is always taken by the poll on the wake-up event.
+static const uint QueueDepth = 64;
+static const unsigned long long WakeTag = 0; // user data of the wake-up poll, requests use their address
+
+struct AsyncFileReader::Request
+{
+	std::string Path;
+	IOPriority Priority;
+	FileReadCallback OnRead;
+	std::promise<bool> Promise; // for requests without a callback
+	FileView* Target; // nullptr to read into View
+	FileView View;
+	FileLocation Location;
+	std::vector<byte> Stored; // the compressed bytes of packed files
+	int File;
+	unsigned long long BytesRead;
+#ifdef __linux__
+	iovec Vector;
+#endif
+
+	inline FileView& GetView() { return Target != nullptr ? *Target : View; }
+};
+
+#ifdef __linux__
+
+struct AsyncFileReader::Ring
+{
+	int Descriptor;
+	int WakeEvent;
+	unsigned long long WakeCount;
+	void* SubmissionMemory;
+	size_t SubmissionMemorySize;
+	void* CompletionMemory; // the same mapping as SubmissionMemory on kernels that map both rings at once
+	size_t CompletionMemorySize;
+	io_uring_sqe* Entries;
+	size_t EntriesSize;
+	uint* SubmissionTail;
+	uint LocalTail; // entries up to here are filled in but not yet visible to the kernel
+	uint SubmissionMask;
+	uint* SubmissionArray;
+	uint* CompletionHead;
+	uint* CompletionTail;
+	uint CompletionMask;
+	io_uring_cqe* Completions;
+	uint Unsubmitted;
+
+	bool Create();
+	void Destroy();
+	io_uring_sqe* GetEntry();
+	void SubmitWakePoll();
+	// Submits the queued entries and waits until at least one completion is available.
+	bool SubmitAndWait();
+};
+
+#else
+
+struct AsyncFileReader::Ring
+{
+};
+
+#endif
+
+AsyncFileReader::AsyncFileReader(ThreadPool& pool)
+	: _pool(pool), _pendingRequests(0), _readsInFlight(0), _running(true), _ring(nullptr)
+{
+#ifdef __linux__
+	_ring = new Ring();
+	if (_ring->Create())
+		_thread = std::thread(&AsyncFileReader::RunRing, this);
+	else
+	{
+		LOG_WARNING("io_uring is not available, files are read on the thread pool instead");
+		delete _ring;
+		_ring = nullptr;
+	}
+#endif
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+	WaitIdle();
+
+	if (_ring == nullptr)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_running = false;
+	}
+
+	Wake();
+	_thread.join();
+
+#ifdef __linux__
+	_ring->Destroy();
+#endif
+	delete _ring;
+}
+
+void AsyncFileReader::Read(const char*const path, const IOPriority priority, const FileReadCallback& onRead)
+{
+	Request* request = new Request();
+	request->Path = path;
+	request->Priority = priority;
+	request->OnRead = onRead;
+	request->Target = nullptr;
+	request->File = -1;
+
+	Enqueue(request);
+}
+
+std::future<bool> AsyncFileReader::Read(const char*const path, FileView& view, const IOPriority priority)
+{
+	view.Close();
+
+	// The fallback would tie up a pool worker while the caller, possibly another one, waits for it.
+	// Opening a view does not read anything yet, so it is done right away instead.
+	if (_ring == nullptr)
+	{
+		std::promise<bool> promise;
+		promise.set_value(FileSystem::Open(path, view));
+
+		return promise.get_future();
+	}
+
+	Request* request = new Request();
+	request->Path = path;
+	request->Priority = priority;
+	request->Target = &view;
+	request->File = -1;
+
+	std::future<bool> result = request->Promise.get_future();
+	Enqueue(request);
+
+	return result;
+}
+
+void AsyncFileReader::WaitIdle()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idleCondition.wait(lock, [this] { return _pendingRequests == 0; });
+}
+
+AsyncFileReader& AsyncFileReader::GetShared()
+{
+	static AsyncFileReader reader(ThreadPool::GetShared());
+
+	return reader;
+}
+
+void AsyncFileReader::Enqueue(Request*const request)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_queues[request->Priority].push_back(request);
+		_pendingRequests++;
+	}
+
+	// Every task takes whichever request is most urgent when it runs, not necessarily the one that queued it.
+	if (_ring != nullptr)
+		Wake();
+	else
+		_pool.Enqueue([this]() { ProcessRequest(); });
+}
+
+// The mutex must be held.
+AsyncFileReader::Request* AsyncFileReader::TakeNextRequest()
+{
+	for (uint i = 0; i < IOPriorityCount; i++)
+	{
+		if (_queues[i].empty())
+			continue;
+
+		Request* request = _queues[i].front();
+		_queues[i].pop_front();
+
+		return request;
+	}
+
+	return nullptr;
+}
+
+void AsyncFileReader::ProcessRequest()
+{
+	Request* request = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		request = TakeNextRequest();
+	}
+
+	Finish(request, FileSystem::Open(request->Path.c_str(), request->GetView()));
+}
+
+void AsyncFileReader::Finish(Request*const request, const bool success)
+{
+	if (!success)
+		request->GetView().Close();
+
+	if (request->OnRead)
+		request->OnRead(request->GetView());
+	else
+		request->Promise.set_value(success);
+
+	delete request;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_pendingRequests--;
+	_idleCondition.notify_all();
+}
+
+#ifdef __linux__
+
+void AsyncFileReader::RunRing()
+{
+	_ring->SubmitWakePoll();
+
+	while (true)
+	{
+		// Free slots go to the most urgent requests.
+		while (true)
+		{
+			Request* request = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_readsInFlight + 1 >= QueueDepth || (request = TakeNextRequest()) == nullptr)
+					break;
+
+				_readsInFlight++;
+			}
+
+			if (!StartRead(request))
+				CompleteRead(request, false);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_running && _readsInFlight == 0)
+				return;
+		}
+
+		if (!_ring->SubmitAndWait())
+			continue;
+
+		uint head = *_ring->CompletionHead;
+		const uint tail = __atomic_load_n(_ring->CompletionTail, __ATOMIC_ACQUIRE);
+
+		for (; head != tail; head++)
+		{
+			const io_uring_cqe& completion = _ring->Completions[head & _ring->CompletionMask];
+
+			if (completion.user_data == WakeTag)
+			{
+				// Resets the event before polling it again.
+				if (read(_ring->WakeEvent, &_ring->WakeCount, sizeof(_ring->WakeCount)) < 0 && errno != EAGAIN)
+					LOG_WARNING("Failed to reset the wake-up event of the file reader");
+
+				_ring->SubmitWakePoll();
+				continue;
+			}
+
+			Request* request = (Request*)completion.user_data;
+
+			if (completion.res == -EINTR || completion.res == -EAGAIN)
+				SubmitRead(request);
+			// Running into the end of the file early means it was truncated after it was located.
+			else if (completion.res <= 0)
+				CompleteRead(request, false);
+			else
+			{
+				request->BytesRead += completion.res;
+				if (request->BytesRead < request->Location.StoredSize)
+					SubmitRead(request);
+				else
+					CompleteRead(request, true);
+			}
+		}
+
+		__atomic_store_n(_ring->CompletionHead, head, __ATOMIC_RELEASE);
+	}
+}
+
+bool AsyncFileReader::StartRead(Request*const request)
+{
+	if (!FileSystem::Locate(request->Path.c_str(), request->Location))
+		return false;
+
+	if (request->Location.StoredSize == 0)
+	{
+		CompleteRead(request, true);
+		return true;
+	}
+
+	request->File = open(request->Location.NativePath.c_str(), O_RDONLY | O_CLOEXEC);
+	if (request->File < 0)
+		return false;
+
+	// Stored files are read straight into the view, compressed ones are decompressed into it later.
+	if (request->Location.Compression == PackCompressionNone)
+		request->GetView()._buffer.resize((size_t)request->Location.Size);
+	else
+		request->Stored.resize((size_t)request->Location.StoredSize);
+
+	request->BytesRead = 0;
+	SubmitRead(request);
+
+	return true;
+}
+
+void AsyncFileReader::SubmitRead(Request*const request)
+{
+	byte* destination = request->Location.Compression == PackCompressionNone ? request->GetView()._buffer.data() : request->Stored.data();
+
+	request->Vector.iov_base = destination + request->BytesRead;
+	request->Vector.iov_len = (size_t)(request->Location.StoredSize - request->BytesRead);
+
+	io_uring_sqe* entry = _ring->GetEntry();
+	entry->opcode = IORING_OP_READV;
+	entry->fd = request->File;
+	entry->addr = (unsigned long long)&request->Vector;
+	entry->len = 1;
+	entry->off = request->Location.Offset + request->BytesRead;
+	entry->user_data = (unsigned long long)request;
+}
+
+void AsyncFileReader::CompleteRead(Request*const request, const bool success)
+{
+	if (request->File >= 0)
+	{
+		close(request->File);
+		request->File = -1;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_readsInFlight--;
+	}
+
+	// Callbacks do the actual loading, so they go to the pool together with decompression.
+	// Waiting threads only need the data, which is cheap enough to finish here.
+	if (request->OnRead)
+		_pool.Enqueue([this, request, success]() { Finish(request, success && Unpack(request)); });
+	else
+		Finish(request, success && Unpack(request));
+}
+
+bool AsyncFileReader::Unpack(Request*const request)
+{
+	FileView& view = request->GetView();
+	const FileLocation& location = request->Location;
+
+	if (location.Compression != PackCompressionNone)
+	{
+		view._buffer.resize((size_t)location.Size);
+		if (!PackFile::Decompress(location.Compression, request->Stored.data(), location.StoredSize, view._buffer.data(), location.Size))
+		{
+			LOG_ERROR("Pack entry \"", request->Path, "\" is corrupt");
+			return false;
+		}
+
+		request->Stored.clear();
+		request->Stored.shrink_to_fit();
+	}
+
+	view._data = view._buffer.data();
+	view._size = location.Size;
+	view._open = true;
+
+	return true;
+}
+
+void AsyncFileReader::Wake()
+{
+	const unsigned long long value = 1;
+	if (write(_ring->WakeEvent, &value, sizeof(value)) < 0)
+		LOG_WARNING("Failed to wake up the file reader");
+}
+
+bool AsyncFileReader::Ring::Create()
+{
+	io_uring_params parameters;
+	memset(&parameters, 0, sizeof(parameters));
+
+	Descriptor = syscall(__NR_io_uring_setup, QueueDepth, &parameters);
+	if (Descriptor < 0)
+		return false;
+
+	WakeEvent = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	SubmissionMemorySize = parameters.sq_off.array + parameters.sq_entries * sizeof(uint);
+	CompletionMemorySize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+	EntriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+	Unsubmitted = 0;
+
+	const bool singleMapping = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMapping)
+		SubmissionMemorySize = CompletionMemorySize = SubmissionMemorySize > CompletionMemorySize ? SubmissionMemorySize : CompletionMemorySize;
+
+	SubmissionMemory = mmap(nullptr, SubmissionMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Descriptor, IORING_OFF_SQ_RING);
+	CompletionMemory = singleMapping ? SubmissionMemory
+		: mmap(nullptr, CompletionMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Descriptor, IORING_OFF_CQ_RING);
+	Entries = (io_uring_sqe*)mmap(nullptr, EntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Descriptor, IORING_OFF_SQES);
+
+	if (WakeEvent < 0 || SubmissionMemory == MAP_FAILED || CompletionMemory == MAP_FAILED || Entries == MAP_FAILED)
+	{
+		Destroy();
+		return false;
+	}
+
+	byte* submission = (byte*)SubmissionMemory;
+	SubmissionTail = (uint*)(submission + parameters.sq_off.tail);
+	LocalTail = *SubmissionTail;
+	SubmissionMask = *(uint*)(submission + parameters.sq_off.ring_mask);
+	SubmissionArray = (uint*)(submission + parameters.sq_off.array);
+
+	byte* completion = (byte*)CompletionMemory;
+	CompletionHead = (uint*)(completion + parameters.cq_off.head);
+	CompletionTail = (uint*)(completion + parameters.cq_off.tail);
+	CompletionMask = *(uint*)(completion + parameters.cq_off.ring_mask);
+	Completions = (io_uring_cqe*)(completion + parameters.cq_off.cqes);
+
+	return true;
+}
+
+void AsyncFileReader::Ring::Destroy()
+{
+	if (Entries != nullptr && Entries != MAP_FAILED)
+		munmap(Entries, EntriesSize);
+	if (CompletionMemory != nullptr && CompletionMemory != MAP_FAILED && CompletionMemory != SubmissionMemory)
+		munmap(CompletionMemory, CompletionMemorySize);
+	if (SubmissionMemory != nullptr && SubmissionMemory != MAP_FAILED)
+		munmap(SubmissionMemory, SubmissionMemorySize);
+	if (WakeEvent >= 0)
+		close(WakeEvent);
+
+	close(Descriptor);
+}
+
+// Only the ring thread submits, so there are no other producers to synchronize with.
+io_uring_sqe* AsyncFileReader::Ring::GetEntry()
+{
+	const uint index = LocalTail & SubmissionMask;
+
+	io_uring_sqe* entry = &Entries[index];
+	memset(entry, 0, sizeof(io_uring_sqe));
+	SubmissionArray[index] = index;
+
+	LocalTail++;
+	Unsubmitted++;
+
+	return entry;
+}
+
+void AsyncFileReader::Ring::SubmitWakePoll()
+{
+	io_uring_sqe* entry = GetEntry();
+	entry->opcode = IORING_OP_POLL_ADD;
+	entry->fd = WakeEvent;
+	entry->poll_events = POLLIN;
+	entry->user_data = WakeTag;
+}
+
+bool AsyncFileReader::Ring::SubmitAndWait()
+{
+	// Publishes the filled in entries.
+	__atomic_store_n(SubmissionTail, LocalTail, __ATOMIC_RELEASE);
+
+	const int submitted = syscall(__NR_io_uring_enter, Descriptor, Unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+	if (submitted < 0)
+	{
+		if (errno != EINTR)
+			LOG_ERROR("io_uring_enter failed with error ", errno);
+
+		return false;
+	}
+
+	Unsubmitted -= submitted;
+
+	return true;
+}
+
+#else
+
+void AsyncFileReader::RunRing()
+{
+}
+
+bool AsyncFileReader::StartRead(Request*const request)
+{
+	return false;
+}
+
+void AsyncFileReader::SubmitRead(Request*const request)
+{
+}
+
+void AsyncFileReader::CompleteRead(Request*const request, const bool success)
+{
+}
+
+bool AsyncFileReader::Unpack(Request*const request)
+{
+	return false;
+}
+
+void AsyncFileReader::Wake()
+{
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+/*
+===========================================================================
+AsyncFileReader.h
+
+Reads whole files in the background so that loaders never block on the
+disk. Requests wait in one queue per priority and are issued highest
+priority first, a bounded number at a time, which keeps the disk busy
+without letting a burst of low priority streaming starve urgent reads.
+
+On Linux the reads go through io_uring: a single thread submits them and
+reaps their completions, and completed files are handed to the thread
+pool. Elsewhere, or when io_uring is unavailable, pool workers open the
+files through the file system as views instead. Files are located
+through the file system either way, so archives and mounts apply.
+===========================================================================
+*/
+
+#pragma once
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <CustomTypes.h>
+#include "FileSystem.h"
+
+namespace sedge
+{
+	class ThreadPool;
+
+	enum IOPriority
+	{
+		IOPriorityHigh, // needed right now, e.g. something a frame waits for
+		IOPriorityNormal,
+		IOPriorityLow, // prefetching and streaming ahead
+		IOPriorityCount
+	};
+
+	// Called on a pool thread, the view is closed if the file could not be read.
+	typedef std::function<void(FileView& file)> FileReadCallback;
+
+	class AsyncFileReader
+	{
+	private:
+		struct Request;
+		struct Ring;
+
+		ThreadPool& _pool;
+		std::deque<Request*> _queues[IOPriorityCount];
+		uint _pendingRequests; // queued, being read or in their callbacks
+		uint _readsInFlight;
+		std::mutex _mutex;
+		std::condition_variable _idleCondition;
+		std::thread _thread;
+		bool _running;
+		Ring* _ring; // nullptr when the pool reads the files
+
+	public:
+		explicit AsyncFileReader(ThreadPool& pool);
+		// Waits for all pending requests.
+		~AsyncFileReader();
+
+		void Read(const char*const path, const IOPriority priority, const FileReadCallback& onRead);
+		// The contents go into view, which must stay alive until the future is ready. Meant for threads
+		// that need several files at once, waiting for the future is safe on pool threads.
+		std::future<bool> Read(const char*const path, FileView& view, const IOPriority priority = IOPriorityHigh);
+
+		void WaitIdle();
+		inline bool IsUsingIOUring() const { return _ring != nullptr; }
+
+		// A reader feeding the shared thread pool.
+		static AsyncFileReader& GetShared();
+
+	private:
+		void Enqueue(Request*const request);
+		Request* TakeNextRequest();
+
+		// Pool fallback.
+		void ProcessRequest();
+
+		// io_uring, the ring thread starts and completes the reads, Unpack runs wherever the request is finished.
+		void RunRing();
+		bool StartRead(Request*const request);
+		void SubmitRead(Request*const request);
+		void CompleteRead(Request*const request, const bool success);
+		bool Unpack(Request*const request);
+		void Wake();
+
+		void Finish(Request*const request, const bool success);
+
+		AsyncFileReader(const AsyncFileReader& tRef) = delete;
+		AsyncFileReader& operator = (const AsyncFileReader& tRef) = delete;
+	};
+}
\ No newline at end of file
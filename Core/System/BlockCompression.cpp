@@ -0,0 +1,609 @@
+/*
+===========================================================================
+BlockCompression.cpp
+
+Implements the BlockCompression class.
+BC1 and BC3 colors use the 4-color mode, BC3 alpha the 8-alpha mode.
+BC7 blocks are always written in mode 6 (one subset, RGBA endpoints with
+per-endpoint p-bits and 4-bit indices), which suits most photographic and
+hand-painted textures.
+===========================================================================
+*/
+
+#include "BlockCompression.h"
+#include "ThreadPool.h"
+#include "Platform/SIMD.h"
+#include <cmath>
+#include <cstring>
+#include <cfloat>
+
+using namespace sedge;
+
+// The pixels of a block split into channels, so several pixels can be processed at once.
+struct BlockChannels
+{
+	float Values[4][16]; // r, g, b, a
+};
+
+static const float BC1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+static const int BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static void LoadBlock(const ImageData& image, const int blockX, const int blockY, byte*const block);
+static void SplitChannels(const byte*const block, BlockChannels& channels);
+static float FindNearestIndices(const float (*values)[16], const int channelCount, const float (*palette)[4], const int paletteSize, byte*const indices);
+static void GetEndpoints(const BlockChannels& channels, const int channelCount, const BlockCompressionQuality quality, float*const endpoint0, float*const endpoint1);
+static bool RefineEndpoints(const BlockChannels& channels, const int channelCount, const byte*const indices, const float*const weights, float*const endpoint0, float*const endpoint1);
+static float EncodeColorBlock(const BlockChannels& channels, const float*const endpoint0, const float*const endpoint1, byte*const output, byte*const indices, float*const palette0, float*const palette1);
+static void EncodeAlphaBlock(const BlockChannels& channels, byte*const output);
+static float EncodeBC7Mode6(const BlockChannels& channels, const float*const endpoint0, const float*const endpoint1, byte*const output, byte*const indices, float*const reconstructed0, float*const reconstructed1);
+static void CompressColorBlock(const BlockChannels& channels, const BlockCompressionQuality quality, byte*const output);
+
+void BlockCompression::Compress(const ImageData& source, const BlockFormat format, const BlockCompressionQuality quality, ImageData& destination, ThreadPool& pool)
+{
+	const int blocksX = (source.Width + 3) / 4;
+	const int blocksY = (source.Height + 3) / 4;
+	const int blockSize = format == BlockBC1 ? 8 : 16;
+
+	destination.Width = source.Width;
+	destination.Height = source.Height;
+	destination.Components = source.Components;
+	destination.Format = format;
+
+	pool.ParallelFor(0, blocksY, 1, [&](const uint rowBegin, const uint rowEnd)
+	{
+		byte block[64];
+
+		for (uint blockY = rowBegin; blockY < rowEnd; blockY++)
+		{
+			for (int blockX = 0; blockX < blocksX; blockX++)
+			{
+				byte* output = destination.Pixels + (blockY * blocksX + blockX) * blockSize;
+				LoadBlock(source, blockX, blockY, block);
+
+				switch (format)
+				{
+				case BlockBC1:
+					CompressBlockBC1(block, quality, output);
+					break;
+				case BlockBC3:
+					CompressBlockBC3(block, quality, output);
+					break;
+				case BlockBC7:
+					CompressBlockBC7(block, quality, output);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	});
+}
+
+void BlockCompression::CompressBlockBC1(const byte*const block, const BlockCompressionQuality quality, byte*const output)
+{
+	BlockChannels channels;
+	SplitChannels(block, channels);
+
+	CompressColorBlock(channels, quality, output);
+}
+
+void BlockCompression::CompressBlockBC3(const byte*const block, const BlockCompressionQuality quality, byte*const output)
+{
+	BlockChannels channels;
+	SplitChannels(block, channels);
+
+	EncodeAlphaBlock(channels, output);
+	CompressColorBlock(channels, quality, output + 8);
+}
+
+void BlockCompression::CompressBlockBC7(const byte*const block, const BlockCompressionQuality quality, byte*const output)
+{
+	BlockChannels channels;
+	SplitChannels(block, channels);
+
+	float endpoint0[4];
+	float endpoint1[4];
+	GetEndpoints(channels, 4, quality, endpoint0, endpoint1);
+
+	byte indices[16];
+	float bestError = EncodeBC7Mode6(channels, endpoint0, endpoint1, output, indices, endpoint0, endpoint1);
+
+	if (quality == BlockQualityFast)
+		return;
+
+	float weights[16];
+	for (int i = 0; i < 16; i++)
+		weights[i] = BC7Weights[i] / 64.0f;
+
+	const int iterations = quality == BlockQualityHigh ? 4 : 1;
+	byte candidate[16];
+	byte candidateIndices[16];
+
+	for (int i = 0; i < iterations && bestError > 0.0f; i++)
+	{
+		if (!RefineEndpoints(channels, 4, indices, weights, endpoint0, endpoint1))
+			break;
+
+		const float error = EncodeBC7Mode6(channels, endpoint0, endpoint1, candidate, candidateIndices, endpoint0, endpoint1);
+		if (error >= bestError)
+			break;
+
+		bestError = error;
+		memcpy(output, candidate, sizeof(candidate));
+		memcpy(indices, candidateIndices, sizeof(candidateIndices));
+	}
+}
+
+// Edge blocks repeat the last row and column of the image.
+void LoadBlock(const ImageData& image, const int blockX, const int blockY, byte*const block)
+{
+	const int components = image.Components;
+
+	for (int y = 0; y < 4; y++)
+	{
+		const int sourceY = blockY * 4 + y < image.Height ? blockY * 4 + y : image.Height - 1;
+
+		for (int x = 0; x < 4; x++)
+		{
+			const int sourceX = blockX * 4 + x < image.Width ? blockX * 4 + x : image.Width - 1;
+			const byte* pixel = image.Pixels + (sourceY * image.Width + sourceX) * components;
+			byte* target = block + (y * 4 + x) * 4;
+
+			if (components >= 3)
+			{
+				target[0] = pixel[0];
+				target[1] = pixel[1];
+				target[2] = pixel[2];
+				target[3] = components == 4 ? pixel[3] : 255;
+			}
+			else
+			{
+				target[0] = target[1] = target[2] = pixel[0];
+				target[3] = components == 2 ? pixel[1] : 255;
+			}
+		}
+	}
+}
+
+void SplitChannels(const byte*const block, BlockChannels& channels)
+{
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 4; c++)
+			channels.Values[c][i] = block[i * 4 + c];
+	}
+}
+
+// Writes the index of the closest palette entry for every pixel and returns the total squared error.
+float FindNearestIndices(const float (*values)[16], const int channelCount, const float (*palette)[4], const int paletteSize, byte*const indices)
+{
+	float totalError = 0.0f;
+
+#ifdef S3_SSE2
+	for (int pixel = 0; pixel < 16; pixel += 4)
+	{
+		__m128 bestDistance = _mm_set1_ps(FLT_MAX);
+		__m128i bestIndex = _mm_setzero_si128();
+
+		for (int entry = 0; entry < paletteSize; entry++)
+		{
+			__m128 distance = _mm_setzero_ps();
+			for (int c = 0; c < channelCount; c++)
+			{
+				const __m128 difference = _mm_sub_ps(_mm_loadu_ps(&values[c][pixel]), _mm_set1_ps(palette[entry][c]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(difference, difference));
+			}
+
+			const __m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, bestDistance));
+			bestDistance = _mm_min_ps(distance, bestDistance);
+			bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(entry)), _mm_andnot_si128(closer, bestIndex));
+		}
+
+		int pixelIndices[4];
+		float pixelErrors[4];
+		_mm_storeu_si128((__m128i*)pixelIndices, bestIndex);
+		_mm_storeu_ps(pixelErrors, bestDistance);
+
+		for (int i = 0; i < 4; i++)
+		{
+			indices[pixel + i] = (byte)pixelIndices[i];
+			totalError += pixelErrors[i];
+		}
+	}
+#else
+	for (int pixel = 0; pixel < 16; pixel++)
+	{
+		float bestDistance = FLT_MAX;
+		int bestIndex = 0;
+
+		for (int entry = 0; entry < paletteSize; entry++)
+		{
+			float distance = 0.0f;
+			for (int c = 0; c < channelCount; c++)
+			{
+				const float difference = values[c][pixel] - palette[entry][c];
+				distance += difference * difference;
+			}
+
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				bestIndex = entry;
+			}
+		}
+
+		indices[pixel] = (byte)bestIndex;
+		totalError += bestDistance;
+	}
+#endif
+
+	return totalError;
+}
+
+// Picks endpoints along the direction of the largest color variance, or the bounding box corners for the fast preset.
+void GetEndpoints(const BlockChannels& channels, const int channelCount, const BlockCompressionQuality quality, float*const endpoint0, float*const endpoint1)
+{
+	float minimum[4];
+	float maximum[4];
+	float mean[4];
+
+	for (int c = 0; c < channelCount; c++)
+	{
+		minimum[c] = maximum[c] = channels.Values[c][0];
+		mean[c] = 0.0f;
+
+		for (int i = 0; i < 16; i++)
+		{
+			const float value = channels.Values[c][i];
+			minimum[c] = value < minimum[c] ? value : minimum[c];
+			maximum[c] = value > maximum[c] ? value : maximum[c];
+			mean[c] += value;
+		}
+
+		mean[c] /= 16.0f;
+	}
+
+	if (quality == BlockQualityFast)
+	{
+		memcpy(endpoint0, minimum, channelCount * sizeof(float));
+		memcpy(endpoint1, maximum, channelCount * sizeof(float));
+		return;
+	}
+
+	float covariance[4][4];
+	for (int a = 0; a < channelCount; a++)
+	{
+		for (int b = a; b < channelCount; b++)
+		{
+			float sum = 0.0f;
+			for (int i = 0; i < 16; i++)
+				sum += (channels.Values[a][i] - mean[a]) * (channels.Values[b][i] - mean[b]);
+
+			covariance[a][b] = covariance[b][a] = sum;
+		}
+	}
+
+	// Power iteration starting from the bounding box diagonal.
+	float axis[4];
+	for (int c = 0; c < channelCount; c++)
+		axis[c] = maximum[c] - minimum[c];
+
+	for (int iteration = 0; iteration < 8; iteration++)
+	{
+		float next[4];
+		float largest = 0.0f;
+
+		for (int a = 0; a < channelCount; a++)
+		{
+			next[a] = 0.0f;
+			for (int b = 0; b < channelCount; b++)
+				next[a] += covariance[a][b] * axis[b];
+
+			largest = fabsf(next[a]) > largest ? fabsf(next[a]) : largest;
+		}
+
+		if (largest <= 0.0f)
+			break;
+
+		for (int c = 0; c < channelCount; c++)
+			axis[c] = next[c] / largest;
+	}
+
+	float length = 0.0f;
+	for (int c = 0; c < channelCount; c++)
+		length += axis[c] * axis[c];
+
+	if (length <= 0.0f)
+	{
+		memcpy(endpoint0, mean, channelCount * sizeof(float));
+		memcpy(endpoint1, mean, channelCount * sizeof(float));
+		return;
+	}
+
+	length = sqrtf(length);
+	float minimumProjection = FLT_MAX;
+	float maximumProjection = -FLT_MAX;
+
+	for (int i = 0; i < 16; i++)
+	{
+		float projection = 0.0f;
+		for (int c = 0; c < channelCount; c++)
+			projection += (channels.Values[c][i] - mean[c]) * axis[c] / length;
+
+		minimumProjection = projection < minimumProjection ? projection : minimumProjection;
+		maximumProjection = projection > maximumProjection ? projection : maximumProjection;
+	}
+
+	for (int c = 0; c < channelCount; c++)
+	{
+		const float value0 = mean[c] + axis[c] / length * minimumProjection;
+		const float value1 = mean[c] + axis[c] / length * maximumProjection;
+		endpoint0[c] = value0 < 0.0f ? 0.0f : (value0 > 255.0f ? 255.0f : value0);
+		endpoint1[c] = value1 < 0.0f ? 0.0f : (value1 > 255.0f ? 255.0f : value1);
+	}
+}
+
+// Solves for the endpoints that minimize the squared error of the current index assignment.
+bool RefineEndpoints(const BlockChannels& channels, const int channelCount, const byte*const indices, const float*const weights, float*const endpoint0, float*const endpoint1)
+{
+	float a = 0.0f;
+	float b = 0.0f;
+	float c = 0.0f;
+	float x[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float y[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	for (int i = 0; i < 16; i++)
+	{
+		const float weight = weights[indices[i]];
+		const float inverse = 1.0f - weight;
+
+		a += inverse * inverse;
+		b += inverse * weight;
+		c += weight * weight;
+
+		for (int channel = 0; channel < channelCount; channel++)
+		{
+			x[channel] += inverse * channels.Values[channel][i];
+			y[channel] += weight * channels.Values[channel][i];
+		}
+	}
+
+	const float determinant = a * c - b * b;
+	if (fabsf(determinant) < 1e-6f)
+		return false;
+
+	for (int channel = 0; channel < channelCount; channel++)
+	{
+		const float value0 = (c * x[channel] - b * y[channel]) / determinant;
+		const float value1 = (a * y[channel] - b * x[channel]) / determinant;
+		endpoint0[channel] = value0 < 0.0f ? 0.0f : (value0 > 255.0f ? 255.0f : value0);
+		endpoint1[channel] = value1 < 0.0f ? 0.0f : (value1 > 255.0f ? 255.0f : value1);
+	}
+
+	return true;
+}
+
+static ushort PackColor565(const float*const color)
+{
+	const uint r = (uint)(color[0] * 31.0f / 255.0f + 0.5f);
+	const uint g = (uint)(color[1] * 63.0f / 255.0f + 0.5f);
+	const uint b = (uint)(color[2] * 31.0f / 255.0f + 0.5f);
+
+	return (ushort)(r << 11 | g << 5 | b);
+}
+
+static void UnpackColor565(const ushort packed, float*const color)
+{
+	const uint r = packed >> 11 & 31;
+	const uint g = packed >> 5 & 63;
+	const uint b = packed & 31;
+
+	color[0] = (float)(r << 3 | r >> 2);
+	color[1] = (float)(g << 2 | g >> 4);
+	color[2] = (float)(b << 3 | b >> 2);
+	color[3] = 255.0f;
+}
+
+// Writes an 8-byte BC1 color block, palette0 and palette1 receive the quantized endpoints in index order.
+float EncodeColorBlock(const BlockChannels& channels, const float*const endpoint0, const float*const endpoint1, byte*const output, byte*const indices, float*const palette0, float*const palette1)
+{
+	ushort color0 = PackColor565(endpoint0);
+	ushort color1 = PackColor565(endpoint1);
+
+	// color0 > color1 selects the 4-color mode.
+	if (color0 < color1)
+	{
+		const ushort swap = color0;
+		color0 = color1;
+		color1 = swap;
+	}
+
+	float palette[4][4];
+	UnpackColor565(color0, palette[0]);
+	UnpackColor565(color1, palette[1]);
+	for (int c = 0; c < 3; c++)
+	{
+		palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+		palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+	}
+
+	const float error = FindNearestIndices(channels.Values, 3, palette, color0 == color1 ? 1 : 4, indices);
+
+	uint bits = 0;
+	for (int i = 0; i < 16; i++)
+		bits |= (uint)indices[i] << (i * 2);
+
+	output[0] = (byte)(color0 & 0xff);
+	output[1] = (byte)(color0 >> 8);
+	output[2] = (byte)(color1 & 0xff);
+	output[3] = (byte)(color1 >> 8);
+	for (int i = 0; i < 4; i++)
+		output[4 + i] = (byte)(bits >> (i * 8));
+
+	memcpy(palette0, palette[0], 3 * sizeof(float));
+	memcpy(palette1, palette[1], 3 * sizeof(float));
+
+	return error;
+}
+
+void CompressColorBlock(const BlockChannels& channels, const BlockCompressionQuality quality, byte*const output)
+{
+	float endpoint0[4];
+	float endpoint1[4];
+	GetEndpoints(channels, 3, quality, endpoint0, endpoint1);
+
+	byte indices[16];
+	float bestError = EncodeColorBlock(channels, endpoint0, endpoint1, output, indices, endpoint0, endpoint1);
+
+	if (quality == BlockQualityFast)
+		return;
+
+	const int iterations = quality == BlockQualityHigh ? 4 : 1;
+	byte candidate[8];
+	byte candidateIndices[16];
+
+	for (int i = 0; i < iterations && bestError > 0.0f; i++)
+	{
+		if (!RefineEndpoints(channels, 3, indices, BC1Weights, endpoint0, endpoint1))
+			break;
+
+		const float error = EncodeColorBlock(channels, endpoint0, endpoint1, candidate, candidateIndices, endpoint0, endpoint1);
+		if (error >= bestError)
+			break;
+
+		bestError = error;
+		memcpy(output, candidate, sizeof(candidate));
+		memcpy(indices, candidateIndices, sizeof(candidateIndices));
+	}
+}
+
+// Writes an 8-byte block of alpha values interpolated between the block's extremes.
+void EncodeAlphaBlock(const BlockChannels& channels, byte*const output)
+{
+	float minimum = channels.Values[3][0];
+	float maximum = minimum;
+	for (int i = 1; i < 16; i++)
+	{
+		minimum = channels.Values[3][i] < minimum ? channels.Values[3][i] : minimum;
+		maximum = channels.Values[3][i] > maximum ? channels.Values[3][i] : maximum;
+	}
+
+	const byte alpha0 = (byte)maximum;
+	const byte alpha1 = (byte)minimum;
+
+	// alpha0 > alpha1 selects the 8-alpha mode.
+	float palette[8][4];
+	palette[0][0] = alpha0;
+	palette[1][0] = alpha1;
+	for (int i = 2; i < 8; i++)
+		palette[i][0] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7.0f;
+
+	byte indices[16];
+	FindNearestIndices(&channels.Values[3], 1, palette, alpha0 == alpha1 ? 1 : 8, indices);
+
+	unsigned long long bits = 0;
+	for (int i = 0; i < 16; i++)
+		bits |= (unsigned long long)indices[i] << (i * 3);
+
+	output[0] = alpha0;
+	output[1] = alpha1;
+	for (int i = 0; i < 6; i++)
+		output[2 + i] = (byte)(bits >> (i * 8));
+}
+
+static void WriteBits(byte*const output, uint& position, const uint value, const uint count)
+{
+	for (uint i = 0; i < count; i++, position++)
+	{
+		if ((value >> i) & 1)
+			output[position >> 3] |= (byte)(1 << (position & 7));
+	}
+}
+
+// Quantizes an endpoint to 7 bits per channel plus a shared p-bit, choosing the p-bit with the smaller error.
+static void QuantizeEndpointBC7(const float*const endpoint, uint*const quantized, uint& pBit)
+{
+	float bestError = FLT_MAX;
+
+	for (uint p = 0; p < 2; p++)
+	{
+		uint candidate[4];
+		float error = 0.0f;
+
+		for (int c = 0; c < 4; c++)
+		{
+			const float value = (endpoint[c] - p) * 0.5f + 0.5f;
+			candidate[c] = value < 0.0f ? 0 : (value > 127.0f ? 127 : (uint)value);
+
+			const float difference = (float)(candidate[c] << 1 | p) - endpoint[c];
+			error += difference * difference;
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+			pBit = p;
+			memcpy(quantized, candidate, sizeof(candidate));
+		}
+	}
+}
+
+// Writes a mode 6 block, reconstructed0 and reconstructed1 receive the quantized endpoints in index order.
+float EncodeBC7Mode6(const BlockChannels& channels, const float*const endpoint0, const float*const endpoint1, byte*const output, byte*const indices, float*const reconstructed0, float*const reconstructed1)
+{
+	uint quantized[2][4];
+	uint pBits[2];
+	QuantizeEndpointBC7(endpoint0, quantized[0], pBits[0]);
+	QuantizeEndpointBC7(endpoint1, quantized[1], pBits[1]);
+
+	int values[2][4];
+	for (int e = 0; e < 2; e++)
+	{
+		for (int c = 0; c < 4; c++)
+			values[e][c] = quantized[e][c] << 1 | pBits[e];
+	}
+
+	float palette[16][4];
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 4; c++)
+			palette[i][c] = (float)(((64 - BC7Weights[i]) * values[0][c] + BC7Weights[i] * values[1][c] + 32) >> 6);
+	}
+
+	const float error = FindNearestIndices(channels.Values, 4, palette, 16, indices);
+
+	// The most significant bit of the first index is implied to be 0.
+	const bool swap = (indices[0] & 8) != 0;
+	const int first = swap ? 1 : 0;
+	const int second = swap ? 0 : 1;
+	if (swap)
+	{
+		for (int i = 0; i < 16; i++)
+			indices[i] = 15 - indices[i];
+	}
+
+	memset(output, 0, 16);
+	uint position = 0;
+	WriteBits(output, position, 1 << 6, 7);
+
+	for (int c = 0; c < 4; c++)
+	{
+		WriteBits(output, position, quantized[first][c], 7);
+		WriteBits(output, position, quantized[second][c], 7);
+	}
+
+	WriteBits(output, position, pBits[first], 1);
+	WriteBits(output, position, pBits[second], 1);
+
+	WriteBits(output, position, indices[0], 3);
+	for (int i = 1; i < 16; i++)
+		WriteBits(output, position, indices[i], 4);
+
+	for (int c = 0; c < 4; c++)
+	{
+		reconstructed0[c] = (float)values[first][c];
+		reconstructed1[c] = (float)values[second][c];
+	}
+
+	return error;
+}
\ No newline at end of file
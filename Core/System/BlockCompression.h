@@ -0,0 +1,44 @@
+/*
+===========================================================================
+BlockCompression.h
+
+Encodes images into GPU block-compressed formats (BC1, BC3, BC7).
+Blocks are independent, so rows of blocks are spread over a thread pool.
+The nearest palette entry search uses SSE2 where it is available.
+===========================================================================
+*/
+
+#pragma once
+
+#include <CustomTypes.h>
+#include "ImageUtils.h"
+
+namespace sedge
+{
+	class ThreadPool;
+
+	enum BlockCompressionQuality
+	{
+		BlockQualityFast, // bounding box endpoints
+		BlockQualityNormal, // principal axis endpoints with one least squares refinement
+		BlockQualityHigh // principal axis endpoints refined until the error stops improving
+	};
+
+	class BlockCompression
+	{
+	public:
+		// Compresses an uncompressed image into destination.Pixels, which must hold GetDataSize bytes
+		// of the compressed image. Sets the size and format of destination.
+		static void Compress(const ImageData& source, const BlockFormat format, const BlockCompressionQuality quality, ImageData& destination, ThreadPool& pool);
+
+		// A block holds 16 RGBA pixels, row by row.
+		static void CompressBlockBC1(const byte*const block, const BlockCompressionQuality quality, byte*const output);
+		static void CompressBlockBC3(const byte*const block, const BlockCompressionQuality quality, byte*const output);
+		static void CompressBlockBC7(const byte*const block, const BlockCompressionQuality quality, byte*const output);
+
+	private:
+		BlockCompression();
+		BlockCompression(const BlockCompression& tRef) = delete;
+		BlockCompression& operator = (const BlockCompression& tRef) = delete;
+	};
+}
\ No newline at end of file
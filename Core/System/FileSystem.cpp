@@ -0,0 +1,279 @@
+/*
+===========================================================================
+FileSystem.cpp
+
+Implements the FileView and FileSystem classes.
+===========================================================================
+*/
+
+#include "FileSystem.h"
+#include "FileUtils.h"
+#include "Logger.h"
+#include <mutex>
+#include <sys/stat.h>
+
+using namespace sedge;
+
+struct MountEntry
+{
+	std::string Point; // normalized, empty for the root
+	std::string Directory; // empty for archives
+	std::shared_ptr<const PackFile> Pack;
+};
+
+struct ResolvedFile
+{
+	std::shared_ptr<const PackFile> Pack;
+	int Entry;
+	std::string NativePath; // for loose files
+	unsigned long long Size;
+};
+
+typedef std::vector<MountEntry> MountList;
+
+// Mounting replaces the whole list, so lookups take a snapshot and never hold the lock while they touch the disk.
+static std::shared_ptr<const MountList> Mounts = std::make_shared<MountList>();
+static std::mutex MountMutex;
+
+static std::shared_ptr<const MountList> GetMounts();
+static bool GetRelativePath(const MountEntry& mount, const std::string& path, std::string& relative);
+static bool Resolve(const char*const path, ResolvedFile& file);
+static bool GetFileSize(const char*const path, unsigned long long& size);
+
+FileView::FileView()
+	: _data(nullptr), _size(0), _open(false)
+{
+}
+
+bool FileView::Open(const char*const path)
+{
+	return FileSystem::Open(path, *this);
+}
+
+void FileView::Close()
+{
+	_file.Close();
+	_buffer.clear();
+	_buffer.shrink_to_fit();
+	_pack.reset();
+	_data = nullptr;
+	_size = 0;
+	_open = false;
+}
+
+bool FileSystem::Mount(const char*const mountPoint, const char*const source)
+{
+	MountEntry mount;
+	mount.Point = FileUtils::NormalizePath(mountPoint);
+
+	if (PackFile::IsPackFile(source))
+	{
+		std::shared_ptr<PackFile> pack = std::make_shared<PackFile>();
+		if (!pack->Open(source))
+		{
+			LOG_ERROR("\"", source, "\" is not a valid pack file");
+			return false;
+		}
+
+		mount.Pack = pack;
+	}
+	else
+	{
+		struct stat status;
+		if (stat(source, &status) != 0 || !(status.st_mode & S_IFDIR))
+		{
+			LOG_ERROR("Cannot mount \"", source, "\", it is neither a directory nor a pack file");
+			return false;
+		}
+
+		mount.Directory = FileUtils::NormalizePath(source);
+		if (mount.Directory.empty())
+			mount.Directory = ".";
+	}
+
+	std::lock_guard<std::mutex> lock(MountMutex);
+
+	std::shared_ptr<MountList> mounts = std::make_shared<MountList>(*Mounts);
+	mounts->push_back(mount);
+	Mounts = mounts;
+
+	LOG_INFO("Mounted \"", source, "\" at \"", mount.Point, "/\"");
+
+	return true;
+}
+
+void FileSystem::UnmountAll()
+{
+	std::lock_guard<std::mutex> lock(MountMutex);
+
+	Mounts = std::make_shared<MountList>();
+}
+
+bool FileSystem::Exists(const char*const path)
+{
+	ResolvedFile file;
+
+	return Resolve(path, file);
+}
+
+bool FileSystem::Open(const char*const path, FileView& view)
+{
+	view.Close();
+
+	ResolvedFile file;
+	if (!Resolve(path, file))
+		return false;
+
+	if (file.Pack)
+	{
+		if (!file.Pack->Read(file.Entry, view._data, view._buffer))
+		{
+			LOG_ERROR("Pack entry \"", path, "\" is corrupt");
+			view.Close();
+			return false;
+		}
+
+		view._pack = file.Pack;
+	}
+	// Empty files cannot be mapped, their view is open with no data.
+	else if (file.Size > 0)
+	{
+		if (!view._file.Open(file.NativePath.c_str()))
+			return false;
+
+		view._data = view._file.GetData();
+	}
+
+	view._size = file.Size;
+	view._open = true;
+
+	return true;
+}
+
+bool FileSystem::ReadText(const char*const path, std::string& text)
+{
+	FileView view;
+	if (!Open(path, view))
+		return false;
+
+	text.assign((const char*)view.GetData(), (size_t)view.GetSize());
+
+	return true;
+}
+
+bool FileSystem::Locate(const char*const path, FileLocation& location)
+{
+	ResolvedFile file;
+	if (!Resolve(path, file))
+		return false;
+
+	location.Size = file.Size;
+
+	if (file.Pack)
+	{
+		location.NativePath = file.Pack->GetPath();
+		file.Pack->GetEntryLocation(file.Entry, location.Offset, location.StoredSize, location.Compression);
+	}
+	else
+	{
+		location.NativePath = file.NativePath;
+		location.Offset = 0;
+		location.StoredSize = file.Size;
+		location.Compression = PackCompressionNone;
+	}
+
+	return true;
+}
+
+std::string FileSystem::GetNativePath(const char*const path)
+{
+	const std::shared_ptr<const MountList> mounts = GetMounts();
+	if (mounts->empty())
+		return path;
+
+	const std::string normalized = FileUtils::NormalizePath(path);
+	std::string relative;
+
+	for (auto mount = mounts->rbegin(); mount != mounts->rend(); ++mount)
+	{
+		if (!mount->Pack && GetRelativePath(*mount, normalized, relative))
+			return mount->Directory + '/' + relative;
+	}
+
+	return path;
+}
+
+std::shared_ptr<const MountList> GetMounts()
+{
+	std::lock_guard<std::mutex> lock(MountMutex);
+
+	return Mounts;
+}
+
+bool GetRelativePath(const MountEntry& mount, const std::string& path, std::string& relative)
+{
+	if (mount.Point.empty())
+	{
+		relative = path;
+		return true;
+	}
+
+	if (path.size() <= mount.Point.size() || path[mount.Point.size()] != '/' || path.compare(0, mount.Point.size(), mount.Point) != 0)
+		return false;
+
+	relative = path.substr(mount.Point.size() + 1);
+
+	return true;
+}
+
+bool Resolve(const char*const path, ResolvedFile& file)
+{
+	const std::shared_ptr<const MountList> mounts = GetMounts();
+
+	if (!mounts->empty())
+	{
+		const std::string normalized = FileUtils::NormalizePath(path);
+		std::string relative;
+
+		for (auto mount = mounts->rbegin(); mount != mounts->rend(); ++mount)
+		{
+			if (!GetRelativePath(*mount, normalized, relative))
+				continue;
+
+			if (mount->Pack)
+			{
+				const int entry = mount->Pack->Find(relative.c_str());
+				if (entry < 0)
+					continue;
+
+				file.Pack = mount->Pack;
+				file.Entry = entry;
+				file.Size = mount->Pack->GetEntrySize(entry);
+				return true;
+			}
+
+			const std::string nativePath = mount->Directory + '/' + relative;
+			if (GetFileSize(nativePath.c_str(), file.Size))
+			{
+				file.NativePath = nativePath;
+				return true;
+			}
+		}
+	}
+
+	file.NativePath = path;
+
+	return GetFileSize(path, file.Size);
+}
+
+// Fails for directories and missing files.
+bool GetFileSize(const char*const path, unsigned long long& size)
+{
+	struct stat status;
+	if (stat(path, &status) != 0 || !(status.st_mode & S_IFREG))
+		return false;
+
+	size = status.st_size;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+/*
+===========================================================================
+FileSystem.h
+
+The virtual file system all assets are read through. Directories and
+pack archives are mounted at a point in the virtual tree, and a path
+under a mount point resolves to the file of the same relative path in
+the mounted source. Sources mounted later take precedence, so a loose
+directory mounted over a pack overrides single files of it. Paths that
+no mount resolves are opened as they are.
+
+Files are opened as views: loose files and stored pack entries are
+mapped and read without a copy, compressed entries are decompressed
+into memory the view owns.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <CustomTypes.h>
+#include "MappedFile.h"
+#include "PackFile.h"
+
+namespace sedge
+{
+	// Where the bytes of a file lie on disk, for reading it without a mapping.
+	struct FileLocation
+	{
+		std::string NativePath; // the file itself or the archive that contains it
+		unsigned long long Offset;
+		unsigned long long StoredSize;
+		unsigned long long Size; // once decompressed
+		PackCompression Compression;
+	};
+
+	// The contents of one file, valid while the view stays open.
+	class FileView
+	{
+	private:
+		const byte* _data;
+		unsigned long long _size;
+		bool _open;
+		MappedFile _file;
+		std::vector<byte> _buffer;
+		std::shared_ptr<const PackFile> _pack; // keeps the archive mapped while entries are viewed
+
+	public:
+		FileView();
+
+		// Resolves the path through the file system, fails without logging if the file does not exist.
+		bool Open(const char*const path);
+		void Close();
+
+		inline bool IsOpen() const { return _open; }
+		inline const byte* GetData() const { return _data; }
+		inline unsigned long long GetSize() const { return _size; }
+
+	private:
+		FileView(const FileView& tRef) = delete;
+		FileView& operator = (const FileView& tRef) = delete;
+
+		friend class FileSystem;
+		friend class AsyncFileReader;
+	};
+
+	class FileSystem
+	{
+	public:
+		// Mounts a directory or a *.spak archive, an empty mount point mounts it at the root.
+		// Thread-safe, files that are already open are not affected.
+		static bool Mount(const char*const mountPoint, const char*const source);
+		static void UnmountAll();
+
+		static bool Exists(const char*const path);
+		static bool Open(const char*const path, FileView& view);
+		static bool ReadText(const char*const path, std::string& text);
+		static bool Locate(const char*const path, FileLocation& location);
+
+		// The path on disk a file of the virtual tree is written to, so caches cooked next to their sources
+		// end up in a mounted directory. Files inside archives cannot be written and keep their path.
+		static std::string GetNativePath(const char*const path);
+
+	private:
+		FileSystem();
+		FileSystem(const FileSystem& tRef) = delete;
+		FileSystem& operator = (const FileSystem& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -8,33 +8,136 @@ Contains implementations for file utilities functions
 
 #include "FileUtils.h"
 #include "System/Logger.h"
+#include "FileSystem.h"
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
 
 using namespace std;
 using namespace sedge;
 
+static bool ListFiles(const string& directory, const string& prefix, vector<string>& files);
+
+// Reads through the file system, an empty string if the file does not exist.
 string FileUtils::ReadFromFile(const char* filepath)
 {
-	ifstream ifs(filepath);
-	string content(istreambuf_iterator<char>(ifs.rdbuf()), istreambuf_iterator<char>());
+	string content;
+	FileSystem::ReadText(filepath, content);
 
 	return content;
 }
 
 string FileUtils::ReadFromFile(const string& filepath)
 {
-	ifstream ifs((filepath).c_str());
-	string content(istreambuf_iterator<char>(ifs.rdbuf()), istreambuf_iterator<char>());
-
-	return content;
+	return ReadFromFile(filepath.c_str());
 }
 
 bool FileUtils::CheckFileExists(const char* name)
 {
-	if (FILE *file = fopen(name, "r"))
+	return FileSystem::Exists(name);
+}
+
+string FileUtils::NormalizePath(const string& path)
+{
+	string unified = path;
+	replace(unified.begin(), unified.end(), '\\', '/');
+
+	vector<string> parts;
+	stringstream stream(unified);
+	string part;
+
+	while (getline(stream, part, '/'))
 	{
-		fclose(file);
-		return true;
+		if (part.empty() || part == ".")
+			continue;
+
+		if (part == ".." && !parts.empty() && parts.back() != "..")
+			parts.pop_back();
+		else
+			parts.push_back(part);
 	}
-	else
+
+	string result = !unified.empty() && unified[0] == '/' ? "/" : "";
+	for (uint i = 0; i < parts.size(); i++)
+	{
+		if (i > 0)
+			result += '/';
+
+		result += parts[i];
+	}
+
+	return result;
+}
+
+bool FileUtils::ListFiles(const char* directory, vector<string>& files)
+{
+	return ::ListFiles(directory, "", files);
+}
+
+#ifdef _WIN32
+
+bool ListFiles(const string& directory, const string& prefix, vector<string>& files)
+{
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE)
+		return false;
+
+	bool result = true;
+	do
+	{
+		const string name = data.cFileName;
+		if (name == "." || name == "..")
+			continue;
+
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			result = ListFiles(directory + '/' + name, prefix + name + '/', files) && result;
+		else
+			files.push_back(prefix + name);
+	} while (FindNextFileA(find, &data));
+
+	FindClose(find);
+
+	return result;
+}
+
+#else
+
+bool ListFiles(const string& directory, const string& prefix, vector<string>& files)
+{
+	DIR* handle = opendir(directory.c_str());
+	if (!handle)
 		return false;
-}
\ No newline at end of file
+
+	bool result = true;
+	while (const dirent* entry = readdir(handle))
+	{
+		const string name = entry->d_name;
+		if (name == "." || name == "..")
+			continue;
+
+		const string path = directory + '/' + name;
+		struct stat status;
+		if (stat(path.c_str(), &status) != 0)
+			continue;
+
+		if (S_ISDIR(status.st_mode))
+			result = ListFiles(path, prefix + name + '/', files) && result;
+		else if (S_ISREG(status.st_mode))
+			files.push_back(prefix + name);
+	}
+
+	closedir(handle);
+
+	return result;
+}
+
+#endif
\ No newline at end of file
@@ -10,6 +10,8 @@ This file is included by the main header sedge.h
 #pragma once
 
 #include <fstream>
+#include <string>
+#include <vector>
 #include <CustomTypes.h>
 
 namespace sedge
@@ -20,6 +22,10 @@ namespace sedge
 		static std::string ReadFromFile(const char* filepath);
 		static std::string ReadFromFile(const std::string& filepath);
 		static bool CheckFileExists(const char* name);
+		// Unifies separators and resolves "." and "..", so "a\\b/../c.txt" becomes "a/c.txt" and paths can be compared as strings.
+		static std::string NormalizePath(const std::string& path);
+		// Appends the paths of all files under the directory and its subdirectories, relative to it and '/' separated.
+		static bool ListFiles(const char* directory, std::vector<std::string>& files);
 
 	private:
 		FileUtils(void);
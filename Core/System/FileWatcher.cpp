@@ -0,0 +1,193 @@
+/*
+===========================================================================
+FileWatcher.cpp
+
+Implements the FileWatcher class with inotify or by polling.
+===========================================================================
+*/
+
+#include "FileWatcher.h"
+#include "FileUtils.h"
+#include "FileSystem.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace sedge;
+
+// How often the thread checks whether it should stop and, without inotify, whether the files changed.
+static const int PollInterval = 250; // milliseconds
+
+FileWatcher::FileWatcher()
+	: _running(true), _inotify(-1)
+{
+#ifdef __linux__
+	_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (_inotify < 0)
+		LOG_WARNING("inotify is not available, watched files are polled instead");
+#endif
+
+	_thread = std::thread(&FileWatcher::Run, this);
+}
+
+FileWatcher::~FileWatcher()
+{
+	_running = false;
+	_thread.join();
+
+#ifdef __linux__
+	if (_inotify >= 0)
+		close(_inotify);
+#endif
+}
+
+void FileWatcher::Watch(const char*const path)
+{
+	const std::string normalized = FileUtils::NormalizePath(FileSystem::GetNativePath(path));
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_files.find(normalized) != _files.end())
+		return;
+
+	WatchedFile& file = _files[normalized];
+	file.Path = FileUtils::NormalizePath(path);
+	GetFileState(normalized.c_str(), file.Time, file.Size);
+
+#ifdef __linux__
+	if (_inotify < 0)
+		return;
+
+	// Files are often replaced rather than rewritten, so their directory is watched instead of the file itself.
+	// Adding a directory that is already watched returns its existing descriptor.
+	const size_t separator = normalized.find_last_of('/');
+	const std::string directory = separator == std::string::npos ? "." : separator == 0 ? "/" : normalized.substr(0, separator);
+
+	const int descriptor = inotify_add_watch(_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (descriptor < 0)
+		LOG_WARNING("Cannot watch \"", directory, "\" for changes");
+	else
+		_directories[descriptor] = directory;
+#endif
+}
+
+void FileWatcher::GetChanges(std::vector<std::string>& changes)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	changes.insert(changes.end(), _changes.begin(), _changes.end());
+	_changes.clear();
+}
+
+void FileWatcher::Run()
+{
+	while (_running)
+	{
+		if (_inotify >= 0)
+			ReadEvents();
+		else
+		{
+			Poll();
+			std::this_thread::sleep_for(std::chrono::milliseconds(PollInterval));
+		}
+	}
+}
+
+void FileWatcher::ReadEvents()
+{
+#ifdef __linux__
+	pollfd descriptor = { _inotify, POLLIN, 0 };
+	if (poll(&descriptor, 1, PollInterval) <= 0)
+		return;
+
+	alignas(inotify_event) char buffer[4096];
+	ssize_t length = 0;
+
+	while ((length = read(_inotify, buffer, sizeof(buffer))) > 0)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const inotify_event* event = (const inotify_event*)(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			auto directory = _directories.find(event->wd);
+			if (event->len == 0 || directory == _directories.end())
+				continue;
+
+			auto file = _files.find(FileUtils::NormalizePath(directory->second + '/' + event->name));
+			if (file != _files.end())
+				AddChange(file->second.Path);
+		}
+	}
+#endif
+}
+
+void FileWatcher::Poll()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	for (auto& file : _files)
+	{
+		long long time = 0;
+		long long size = 0;
+		GetFileState(file.first.c_str(), time, size);
+
+		// Some file systems only keep whole seconds, a second save within the same second usually changes the size.
+		if (time == file.second.Time && size == file.second.Size)
+			continue;
+
+		file.second.Time = time;
+		file.second.Size = size;
+		// A file that is being replaced may be missing for a moment.
+		if (time != 0)
+			AddChange(file.second.Path);
+	}
+}
+
+// The mutex must be held.
+void FileWatcher::AddChange(const std::string& path)
+{
+	if (std::find(_changes.begin(), _changes.end(), path) == _changes.end())
+		_changes.push_back(path);
+}
+
+void FileWatcher::GetFileState(const char*const path, long long& time, long long& size)
+{
+	time = 0;
+	size = 0;
+
+#ifdef _WIN32
+	// 100 ns ticks, stat only has seconds.
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes))
+		return;
+
+	time = (long long)attributes.ftLastWriteTime.dwHighDateTime << 32 | attributes.ftLastWriteTime.dwLowDateTime;
+	size = (long long)attributes.nFileSizeHigh << 32 | attributes.nFileSizeLow;
+#else
+	struct stat status;
+	if (stat(path, &status) != 0)
+		return;
+
+#ifdef __APPLE__
+	time = (long long)status.st_mtimespec.tv_sec * 1000000000LL + status.st_mtimespec.tv_nsec;
+#else
+	time = (long long)status.st_mtim.tv_sec * 1000000000LL + status.st_mtim.tv_nsec;
+#endif
+	size = status.st_size;
+#endif
+}
\ No newline at end of file
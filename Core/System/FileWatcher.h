@@ -0,0 +1,67 @@
+/*
+===========================================================================
+FileWatcher.h
+
+Reports changes to a set of files, detected on a background thread.
+On Linux the directories of the watched files are observed with inotify,
+elsewhere the sub-second modification times and sizes are polled. Only
+completed writes and renames onto a watched path count, so editors that
+save through a temporary file are handled, and a file saved several
+times between two calls to GetChanges is reported once. Paths are
+virtual paths, files of mounted directories are watched where they are
+stored.
+===========================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	class FileWatcher
+	{
+	private:
+		struct WatchedFile
+		{
+			std::string Path; // the normalized virtual path changes are reported with
+			long long Time; // last modification time, in the platform's finest unit, 0 while the file is missing
+			long long Size;
+		};
+
+		std::unordered_map<std::string, WatchedFile> _files; // by normalized native path
+		std::unordered_map<int, std::string> _directories; // inotify watch descriptor, directory
+		std::vector<std::string> _changes;
+		std::mutex _mutex;
+		std::thread _thread;
+		std::atomic<bool> _running;
+		int _inotify; // -1 when polling
+
+	public:
+		FileWatcher();
+		~FileWatcher();
+
+		// Thread-safe, watching a file twice has no effect.
+		void Watch(const char*const path);
+
+		// Moves the normalized paths of the files changed since the last call into changes.
+		void GetChanges(std::vector<std::string>& changes);
+
+	private:
+		void Run();
+		void ReadEvents();
+		void Poll();
+		void AddChange(const std::string& path);
+
+		static void GetFileState(const char*const path, long long& time, long long& size);
+
+		FileWatcher(const FileWatcher& tRef) = delete;
+		FileWatcher& operator = (const FileWatcher& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*
+===========================================================================
+FrameLimiter.cpp
+
+Implements the FrameLimiter class.
+===========================================================================
+*/
+
+#include "FrameLimiter.h"
+#include <thread>
+#include <cmath>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+using namespace sedge;
+
+// Optimistic on purpose, sleeps are only measured once the estimate lets the limiter sleep at all.
+static const double InitialSleepEstimate = 2.0e6;
+// Past this many samples older ones fade out, which keeps the estimate current, e.g. after the timer resolution changed.
+static const uint MaxSleepSamples = 1000;
+
+FrameLimiter::FrameLimiter()
+	: _frameTime(0), _sleepEstimate(InitialSleepEstimate), _sleepMean(0.0), _sleepVariance(0.0), _sleepCount(0)
+{
+}
+
+FrameLimiter::~FrameLimiter()
+{
+	SetFrameRate(0);
+}
+
+void FrameLimiter::SetFrameRate(const uint framesPerSecond)
+{
+	const long long frameTime = framesPerSecond > 0 ? 1000000000LL / framesPerSecond : 0;
+
+#ifdef _WIN32
+	// Sleeps last a whole timer period, 15.6 ms by default, which is too coarse to pace frames with.
+	if (frameTime > 0 && _frameTime == 0)
+		timeBeginPeriod(1);
+	else if (frameTime == 0 && _frameTime > 0)
+		timeEndPeriod(1);
+#endif
+
+	_frameTime = frameTime;
+	_frameEnd = clock::now() + std::chrono::nanoseconds(_frameTime);
+}
+
+void FrameLimiter::Wait()
+{
+	if (_frameTime == 0)
+		return;
+
+	clock::time_point now = clock::now();
+	if (now >= _frameEnd)
+	{
+		_frameEnd = now + std::chrono::nanoseconds(_frameTime);
+		return;
+	}
+
+	while ((double)std::chrono::duration_cast<std::chrono::nanoseconds>(_frameEnd - now).count() > _sleepEstimate)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		const clock::time_point sleepEnd = clock::now();
+		AddSleepSample((double)std::chrono::duration_cast<std::chrono::nanoseconds>(sleepEnd - now).count());
+		now = sleepEnd;
+	}
+
+	while (clock::now() < _frameEnd)
+		std::this_thread::yield();
+
+	_frameEnd += std::chrono::nanoseconds(_frameTime);
+}
+
+void FrameLimiter::AddSleepSample(const double nanoseconds)
+{
+	if (_sleepCount < MaxSleepSamples)
+		_sleepCount++;
+
+	// Running mean and variance weighted by 1 / count, the estimate leaves a standard deviation of margin.
+	const double weight = 1.0 / _sleepCount;
+	const double deviation = nanoseconds - _sleepMean;
+	_sleepMean += weight * deviation;
+	_sleepVariance = (1.0 - weight) * (_sleepVariance + weight * deviation * deviation);
+
+	_sleepEstimate = _sleepMean + sqrt(_sleepVariance);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+===========================================================================
+FrameLimiter.h
+
+Caps the frame rate without keeping a core busy. The time left until
+the next frame is slept off as long as it safely exceeds how much a
+sleep tends to take, which the limiter measures as it goes, and only
+the rest is spun off. Frames stay evenly paced even where the sleep
+granularity is coarse.
+===========================================================================
+*/
+
+#pragma once
+
+#include <chrono>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	class FrameLimiter
+	{
+	private:
+		typedef std::chrono::steady_clock clock;
+
+		long long _frameTime; // in nanoseconds, 0 without a limit
+		clock::time_point _frameEnd;
+		// How long a short sleep takes, in nanoseconds, from the running mean and variance of the ones observed.
+		double _sleepEstimate;
+		double _sleepMean;
+		double _sleepVariance;
+		uint _sleepCount;
+
+	public:
+		FrameLimiter();
+		~FrameLimiter();
+
+		// 0 removes the limit.
+		void SetFrameRate(const uint framesPerSecond);
+		inline bool IsLimited() const { return _frameTime > 0; }
+
+		// Returns once the current frame's time is up. A frame that ran late starts a new schedule
+		// instead of the following frames being rushed to make up for it.
+		void Wait();
+
+	private:
+		void AddSleepSample(const double nanoseconds);
+
+		FrameLimiter(const FrameLimiter& tRef) = delete;
+		FrameLimiter& operator = (const FrameLimiter& tRef) = delete;
+	};
+}
\ No newline at end of file
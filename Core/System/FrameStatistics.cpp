@@ -0,0 +1,277 @@
+/*
+===========================================================================
+FrameStatistics.cpp
+
+Implements the FrameStatistics class.
+===========================================================================
+*/
+
+#include "FrameStatistics.h"
+#include "Logger.h"
+#include <algorithm>
+#include <fstream>
+
+using namespace sedge;
+
+static const char*const StageNames[FrameStageCount] = { "update", "render", "present", "frame" };
+
+// The median for hitch detection is refreshed every this many frames, once the window holds at least as many.
+static const uint MedianInterval = 64;
+
+static float GetPercentile(const std::vector<float>& sortedTimes, const uint permille);
+static void WriteSummary(std::ofstream& stream, const FrameTimeSummary& summary);
+
+FrameStatistics::FrameStatistics(const uint windowSize)
+	: _windowSize(windowSize > 0 ? windowSize : 1), _hitchFactor(2.0f), _hitchTime(100.0f)
+{
+	Reset();
+}
+
+bool FrameStatistics::Record(const FrameTiming& timing)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	const float frameTime = timing.Times[FrameStageFrame];
+
+	// Held against the median of the frames before, a long frame does not raise its own bar.
+	const bool hitch = (_hitchTime > 0.0f && frameTime >= _hitchTime) ||
+		(_hitchFactor > 0.0f && _median > 0.0f && frameTime >= _hitchFactor * _median);
+
+	if (hitch)
+	{
+		const FrameHitch frameHitch = { _frameCount, _elapsedTime, _median, timing };
+		_hitches.push_back(frameHitch);
+		if (_hitches.size() > MaxRecentHitches)
+			_hitches.pop_front();
+
+		_hitchCount++;
+
+		LOG_WARNING("Hitch in frame ", (uint)_frameCount, ": ", frameTime, " ms, median ", _median, " ms (update ", timing.Times[FrameStageUpdate],
+			" ms, render ", timing.Times[FrameStageRender], " ms, present ", timing.Times[FrameStagePresent], " ms)");
+	}
+
+	if (_window.size() < _windowSize)
+		_window.push_back(timing);
+	else
+		_window[_windowNext] = timing;
+
+	_windowNext = (_windowNext + 1) % _windowSize;
+
+	const uint bucket = frameTime < HistogramBucketCount - 1 ? (uint)std::max(frameTime, 0.0f) : HistogramBucketCount - 1;
+	_histogram[bucket]++;
+
+	_frameCount++;
+	_elapsedTime += frameTime / 1000.0;
+
+	if (_frameCount % MedianInterval == 0)
+		UpdateMedian();
+
+	return hitch;
+}
+
+void FrameStatistics::Reset()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_window.clear();
+	_window.reserve(_windowSize);
+	_windowNext = 0;
+	_frameCount = 0;
+	_elapsedTime = 0.0;
+	_histogram.assign(HistogramBucketCount, 0);
+	_hitches.clear();
+	_hitchCount = 0;
+	_median = 0.0f;
+}
+
+void FrameStatistics::SetHitchThresholds(const float factor, const float milliseconds)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_hitchFactor = factor;
+	_hitchTime = milliseconds;
+}
+
+FrameTimeSummary FrameStatistics::GetSummary(const FrameStage stage) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return Summarize(stage);
+}
+
+unsigned long long FrameStatistics::GetFrameCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _frameCount;
+}
+
+unsigned long long FrameStatistics::GetHitchCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _hitchCount;
+}
+
+void FrameStatistics::GetHistogram(std::vector<unsigned long long>& counts) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	counts = _histogram;
+}
+
+void FrameStatistics::GetRecentHitches(std::vector<FrameHitch>& hitches) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	hitches.assign(_hitches.begin(), _hitches.end());
+}
+
+bool FrameStatistics::WriteCSV(const char*const path) const
+{
+	std::ofstream stream(path);
+	if (!stream)
+	{
+		LOG_ERROR("Could not write frame statistics to \"", path, "\"");
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	stream << "frame";
+	for (uint stage = 0; stage < FrameStageCount; stage++)
+		stream << ',' << StageNames[stage] << "_ms";
+	stream << ",updates\n";
+
+	const uint count = GetWindowCount();
+	for (uint i = 0; i < count; i++)
+	{
+		const FrameTiming& timing = GetWindowFrame(i);
+
+		stream << _frameCount - count + i;
+		for (uint stage = 0; stage < FrameStageCount; stage++)
+			stream << ',' << timing.Times[stage];
+		stream << ',' << timing.Updates << '\n';
+	}
+
+	return (bool)stream;
+}
+
+bool FrameStatistics::WriteJSON(const char*const path) const
+{
+	std::ofstream stream(path);
+	if (!stream)
+	{
+		LOG_ERROR("Could not write frame statistics to \"", path, "\"");
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	stream << "{\n\t\"frames\": " << _frameCount << ",\n\t\"window\": " << GetWindowCount() << ",\n\t\"seconds\": " << _elapsedTime << ",\n";
+
+	stream << "\t\"stages\": {";
+	for (uint stage = 0; stage < FrameStageCount; stage++)
+	{
+		stream << (stage > 0 ? ",\n" : "\n") << "\t\t\"" << StageNames[stage] << "\": ";
+		WriteSummary(stream, Summarize((FrameStage)stage));
+	}
+	stream << "\n\t},\n";
+
+	stream << "\t\"histogram\": { \"bucketMs\": 1, \"counts\": [";
+	for (uint i = 0; i < _histogram.size(); i++)
+		stream << (i > 0 ? ", " : "") << _histogram[i];
+	stream << "] },\n";
+
+	stream << "\t\"hitches\": { \"count\": " << _hitchCount << ", \"factor\": " << _hitchFactor << ", \"thresholdMs\": " << _hitchTime << ", \"recent\": [";
+	for (uint i = 0; i < _hitches.size(); i++)
+	{
+		const FrameHitch& hitch = _hitches[i];
+
+		stream << (i > 0 ? ",\n" : "\n") << "\t\t{ \"frame\": " << hitch.Frame << ", \"time\": " << hitch.Time << ", \"medianMs\": " << hitch.Median;
+		for (uint stage = 0; stage < FrameStageCount; stage++)
+			stream << ", \"" << StageNames[stage] << "Ms\": " << hitch.Timing.Times[stage];
+		stream << ", \"updates\": " << hitch.Timing.Updates << " }";
+	}
+	stream << (_hitches.empty() ? "] }\n}\n" : "\n\t] }\n}\n");
+
+	return (bool)stream;
+}
+
+void FrameStatistics::LogSummary() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	LOG_INFO("Frame statistics of the last ", GetWindowCount(), " of ", (uint)_frameCount, " frames, ", (uint)_hitchCount, " hitches:");
+
+	for (uint stage = 0; stage < FrameStageCount; stage++)
+	{
+		const FrameTimeSummary summary = Summarize((FrameStage)stage);
+		LOG_INFO(StageNames[stage], ": mean ", summary.Mean, " ms, p50 ", summary.P50, " ms, p95 ", summary.P95,
+			" ms, p99 ", summary.P99, " ms, max ", summary.Max, " ms");
+	}
+}
+
+uint FrameStatistics::GetWindowCount() const
+{
+	return _window.size();
+}
+
+const FrameTiming& FrameStatistics::GetWindowFrame(const uint index) const
+{
+	// Until the window is full the oldest frame is the first one, afterwards the one about to be overwritten.
+	return _window.size() < _windowSize ? _window[index] : _window[(_windowNext + index) % _windowSize];
+}
+
+FrameTimeSummary FrameStatistics::Summarize(const FrameStage stage) const
+{
+	FrameTimeSummary summary = {};
+	if (_window.empty())
+		return summary;
+
+	_scratch.resize(_window.size());
+	double sum = 0.0;
+	for (uint i = 0; i < _window.size(); i++)
+	{
+		_scratch[i] = _window[i].Times[stage];
+		sum += _scratch[i];
+	}
+
+	std::sort(_scratch.begin(), _scratch.end());
+
+	summary.Mean = (float)(sum / _scratch.size());
+	summary.P50 = GetPercentile(_scratch, 500);
+	summary.P95 = GetPercentile(_scratch, 950);
+	summary.P99 = GetPercentile(_scratch, 990);
+	summary.Max = _scratch.back();
+
+	return summary;
+}
+
+void FrameStatistics::UpdateMedian()
+{
+	if (_window.size() < MedianInterval)
+		return;
+
+	_scratch.resize(_window.size());
+	for (uint i = 0; i < _window.size(); i++)
+		_scratch[i] = _window[i].Times[FrameStageFrame];
+
+	std::nth_element(_scratch.begin(), _scratch.begin() + _scratch.size() / 2, _scratch.end());
+	_median = _scratch[_scratch.size() / 2];
+}
+
+// Nearest rank: the smallest time that at least the given share of the frames do not exceed.
+// The share is in thousandths, so that the rank is exact rather than rounded through a float.
+float GetPercentile(const std::vector<float>& sortedTimes, const uint permille)
+{
+	const uint rank = (uint)((permille * (unsigned long long)sortedTimes.size() + 999) / 1000);
+
+	return sortedTimes[rank > 0 ? rank - 1 : 0];
+}
+
+void WriteSummary(std::ofstream& stream, const FrameTimeSummary& summary)
+{
+	stream << "{ \"mean\": " << summary.Mean << ", \"p50\": " << summary.P50 << ", \"p95\": " << summary.P95
+		<< ", \"p99\": " << summary.P99 << ", \"max\": " << summary.Max << " }";
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*
+===========================================================================
+FrameStatistics.h
+
+Frame time telemetry. Every frame records how long its stages took,
+the last frames are kept for rolling percentiles and all frames since
+the last reset go into a histogram, so stutter shows up even when the
+average frame rate looks fine.
+
+Frames much slower than the rolling median, or slower than an absolute
+limit, are hitches: they are counted, the latest ones are kept with
+their breakdown and each one is logged as a warning.
+
+Everything can be queried while frames are recorded, from any thread,
+and written out as CSV (one row per frame of the window) or JSON (the
+summary, histogram and hitches).
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	enum FrameStage
+	{
+		FrameStageUpdate, // logic updates, on the simulation thread when there is one
+		FrameStageRender,
+		FrameStagePresent, // swapping the buffers, waiting for vsync included
+		FrameStageFrame, // start to start of consecutive frames, all waits included
+		FrameStageCount
+	};
+
+	// Times in milliseconds.
+	struct FrameTiming
+	{
+		float Times[FrameStageCount];
+		uint Updates;
+	};
+
+	struct FrameTimeSummary
+	{
+		float Mean;
+		float P50;
+		float P95;
+		float P99;
+		float Max;
+	};
+
+	struct FrameHitch
+	{
+		unsigned long long Frame;
+		double Time; // in seconds since the reset, the sum of the frame times before
+		float Median; // the rolling median frame time it was held against, 0 if there was none yet
+		FrameTiming Timing;
+	};
+
+	class FrameStatistics
+	{
+	public:
+		// The histogram counts frame times in 1 ms buckets, the last bucket counts everything slower.
+		static const uint HistogramBucketCount = 101;
+		static const uint MaxRecentHitches = 64;
+
+	private:
+		std::vector<FrameTiming> _window; // ring buffer of the latest frames
+		uint _windowSize;
+		uint _windowNext;
+		unsigned long long _frameCount;
+		double _elapsedTime;
+		std::vector<unsigned long long> _histogram;
+		std::deque<FrameHitch> _hitches;
+		unsigned long long _hitchCount;
+		float _hitchFactor;
+		float _hitchTime;
+		float _median;
+		mutable std::vector<float> _scratch;
+		mutable std::mutex _mutex;
+
+	public:
+		// The rolling statistics cover the last windowSize frames.
+		explicit FrameStatistics(const uint windowSize = 1024);
+
+		// Returns true if the frame is a hitch.
+		bool Record(const FrameTiming& timing);
+		void Reset();
+
+		// A frame is a hitch when it takes factor times the rolling median or longer, or milliseconds or longer.
+		// Either test is disabled by passing 0, the defaults are 2 and 100 ms.
+		void SetHitchThresholds(const float factor, const float milliseconds);
+
+		FrameTimeSummary GetSummary(const FrameStage stage) const;
+		unsigned long long GetFrameCount() const;
+		unsigned long long GetHitchCount() const;
+		void GetHistogram(std::vector<unsigned long long>& counts) const;
+		// The latest hitches, oldest first.
+		void GetRecentHitches(std::vector<FrameHitch>& hitches) const;
+
+		bool WriteCSV(const char*const path) const;
+		bool WriteJSON(const char*const path) const;
+		void LogSummary() const;
+
+	private:
+		uint GetWindowCount() const;
+		const FrameTiming& GetWindowFrame(const uint index) const; // 0 is the oldest
+		FrameTimeSummary Summarize(const FrameStage stage) const;
+		void UpdateMedian();
+
+		FrameStatistics(const FrameStatistics& tRef) = delete;
+		FrameStatistics& operator = (const FrameStatistics& tRef) = delete;
+	};
+}
\ No newline at end of file
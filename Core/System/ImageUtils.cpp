@@ -4,10 +4,18 @@ ImageUtils.cpp
 
 Implements the functions declared in the header file.
 Image loading done via stb_image library by Sean T. Barrett.
+Resampling is separable: rows are filtered horizontally into a float
+buffer in linear space, then the buffer is filtered vertically.
 ===========================================================================
 */
 
 #include "ImageUtils.h"
+#include "ThreadPool.h"
+#include "FileSystem.h"
+#include "Platform/SIMD.h"
+#include <vector>
+#include <cmath>
+#include <algorithm>
 
 // WARNING! MUST ONLY BE DEFINED ONCE!
 #define STB_IMAGE_IMPLEMENTATION
@@ -15,18 +23,437 @@ Image loading done via stb_image library by Sean T. Barrett.
 
 using namespace sedge;
 
+// Filter taps of every destination sample along one axis.
+struct FilterTaps
+{
+	int TapCount;
+	std::vector<int> Indices;
+	std::vector<float> Weights;
+};
+
+struct SRGBTables
+{
+	float ToLinear[256];
+	float Thresholds[255]; // linear values halfway between neighbouring encoded values
+
+	SRGBTables();
+};
+
+static const float KaiserWidth = 3.0f;
+static const float KaiserAlpha = 4.0f;
+static const uint RowGrain = 16;
+
+static const SRGBTables& GetSRGBTables();
+static byte LinearToSRGB(const float value);
+static int GetAlphaChannel(const int components);
+static float BesselI0(const float x);
+static float EvaluateFilter(const ImageFilter filter, const float distance);
+static void ComputeTaps(const int sourceSize, const int destinationSize, const ImageFilter filter, FilterTaps& taps);
+static void DecodeRow(const byte*const pixels, const int width, const int components, const ImageFilterSettings& settings, float*const row);
+static void EncodeRow(const float*const row, const int width, const int components, const ImageFilterSettings& settings, byte*const pixels);
+static void FilterRow(const float*const source, const FilterTaps& taps, const int width, const int components, float*const destination);
+static void AccumulateRow(const float*const source, const float weight, const int count, float*const destination);
+
 void ImageUtils::SetFlipVertically(const bool flip)
 {
 	stbi_set_flip_vertically_on_load(flip);
 }
 
 // image loading via stb_image. Supports *.bmp, *.png and whatnot.
+// The file is read through the file system and decoded straight from its view.
 byte* ImageUtils::LoadImage(const char* path, int* width, int* height, int* components)
 {
-	return stbi_load(path, width, height, components, 0);
+	FileView file;
+	if (!file.Open(path) || file.GetSize() == 0)
+		return nullptr;
+
+	return stbi_load_from_memory(file.GetData(), (int)file.GetSize(), width, height, components, 0);
+}
+
+// Safe to call from several threads at once.
+bool ImageUtils::LoadImage(const char* path, ImageData& image)
+{
+	image.Pixels = LoadImage(path, &image.Width, &image.Height, &image.Components);
+
+	return image.Pixels != nullptr;
+}
+
+bool ImageUtils::LoadImage(const byte*const data, const unsigned long long size, ImageData& image)
+{
+	image.Pixels = size > 0 ? stbi_load_from_memory(data, (int)size, &image.Width, &image.Height, &image.Components, 0) : nullptr;
+
+	return image.Pixels != nullptr;
 }
 
 void ImageUtils::ReleaseImage(void* data)
 {
 	stbi_image_free(data);
+}
+
+void ImageUtils::ReleaseImage(ImageData& image)
+{
+	stbi_image_free(image.Pixels);
+	image.Pixels = nullptr;
+}
+
+uint ImageUtils::GetDataSize(const ImageData& image)
+{
+	if (image.Format == BlockNone)
+		return image.Width * image.Height * image.Components;
+
+	const uint blockCount = ((image.Width + 3) / 4) * ((image.Height + 3) / 4);
+
+	return blockCount * (image.Format == BlockBC1 ? 8 : 16);
+}
+
+uint ImageUtils::GetMipLevelCount(const int width, const int height)
+{
+	uint levels = 1;
+	int size = width > height ? width : height;
+
+	while (size > 1)
+	{
+		size /= 2;
+		levels++;
+	}
+
+	return levels;
+}
+
+void ImageUtils::GenerateMipLevel(const ImageData& source, ImageData& destination, const ImageFilterSettings& settings)
+{
+	destination.Width = source.Width > 1 ? source.Width / 2 : 1;
+	destination.Height = source.Height > 1 ? source.Height / 2 : 1;
+
+	Resize(source, destination, settings);
+}
+
+void ImageUtils::Resize(const ImageData& source, ImageData& destination, const ImageFilterSettings& settings)
+{
+	const int components = source.Components;
+	destination.Components = components;
+	destination.Format = BlockNone;
+
+	FilterTaps horizontal;
+	FilterTaps vertical;
+	ComputeTaps(source.Width, destination.Width, settings.Filter, horizontal);
+	ComputeTaps(source.Height, destination.Height, settings.Filter, vertical);
+
+	// Source rows filtered horizontally, in linear space.
+	const int rowSize = destination.Width * components;
+	std::vector<float> filtered(rowSize * source.Height);
+	ThreadPool& pool = ThreadPool::GetShared();
+
+	pool.ParallelFor(0, source.Height, RowGrain, [&](const uint begin, const uint end)
+	{
+		std::vector<float> row(source.Width * components);
+
+		for (uint y = begin; y < end; y++)
+		{
+			DecodeRow(source.Pixels + y * source.Width * components, source.Width, components, settings, row.data());
+			FilterRow(row.data(), horizontal, destination.Width, components, filtered.data() + y * rowSize);
+		}
+	});
+
+	pool.ParallelFor(0, destination.Height, RowGrain, [&](const uint begin, const uint end)
+	{
+		std::vector<float> row(rowSize);
+
+		for (uint y = begin; y < end; y++)
+		{
+			const int* indices = &vertical.Indices[y * vertical.TapCount];
+			const float* weights = &vertical.Weights[y * vertical.TapCount];
+
+			std::fill(row.begin(), row.end(), 0.0f);
+			for (int t = 0; t < vertical.TapCount; t++)
+			{
+				if (weights[t] != 0.0f)
+					AccumulateRow(filtered.data() + indices[t] * rowSize, weights[t], rowSize, row.data());
+			}
+
+			EncodeRow(row.data(), destination.Width, components, settings, destination.Pixels + y * rowSize);
+		}
+	});
+}
+
+void ImageUtils::PremultiplyAlpha(ImageData& image, const bool srgb)
+{
+	const int components = image.Components;
+	const int alphaChannel = GetAlphaChannel(components);
+	if (alphaChannel < 0)
+		return;
+
+	const SRGBTables& tables = GetSRGBTables();
+
+	ThreadPool::GetShared().ParallelFor(0, image.Height, RowGrain, [&](const uint begin, const uint end)
+	{
+		for (uint y = begin; y < end; y++)
+		{
+			byte* pixel = image.Pixels + y * image.Width * components;
+
+			for (int x = 0; x < image.Width; x++, pixel += components)
+			{
+				const uint alpha = pixel[alphaChannel];
+
+				for (int c = 0; c < alphaChannel; c++)
+				{
+					if (srgb)
+						pixel[c] = LinearToSRGB(tables.ToLinear[pixel[c]] * alpha / 255.0f);
+					else
+						pixel[c] = (byte)((pixel[c] * alpha + 127) / 255);
+				}
+			}
+		}
+	});
+}
+
+bool ImageUtils::Swizzle(const ImageData& source, ImageData& destination, const char*const mapping)
+{
+	const int count = (int)strlen(mapping);
+	if (count < 1 || count > 4)
+		return false;
+
+	// Non-negative values pick a source channel, negative ones encode a constant.
+	int channels[4];
+	for (int i = 0; i < count; i++)
+	{
+		switch (mapping[i])
+		{
+		case 'r': channels[i] = 0; break;
+		case 'g': channels[i] = 1; break;
+		case 'b': channels[i] = 2; break;
+		case 'a': channels[i] = 3; break;
+		case '0': channels[i] = -1; break;
+		case '1': channels[i] = -2; break;
+		default: return false;
+		}
+
+		if (channels[i] >= source.Components)
+			return false;
+	}
+
+	destination.Width = source.Width;
+	destination.Height = source.Height;
+	destination.Components = count;
+	destination.Format = BlockNone;
+
+	ThreadPool::GetShared().ParallelFor(0, source.Height, RowGrain, [&](const uint begin, const uint end)
+	{
+		for (uint y = begin; y < end; y++)
+		{
+			const byte* pixel = source.Pixels + y * source.Width * source.Components;
+			byte* target = destination.Pixels + y * destination.Width * count;
+
+			for (int x = 0; x < source.Width; x++, pixel += source.Components)
+			{
+				for (int i = 0; i < count; i++)
+					*target++ = channels[i] >= 0 ? pixel[channels[i]] : (channels[i] == -1 ? 0 : 255);
+			}
+		}
+	});
+
+	return true;
+}
+
+void ImageUtils::ExpandToRGBA(const ImageData& source, ImageData& destination)
+{
+	static const char*const mappings[] = { "", "rrr1", "rrrg", "rgb1", "rgba" };
+
+	Swizzle(source, destination, mappings[source.Components]);
+}
+
+SRGBTables::SRGBTables()
+{
+	for (int i = 0; i < 256; i++)
+	{
+		const float value = i / 255.0f;
+		ToLinear[i] = value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	for (int i = 0; i < 255; i++)
+		Thresholds[i] = (ToLinear[i] + ToLinear[i + 1]) * 0.5f;
+}
+
+const SRGBTables& GetSRGBTables()
+{
+	static const SRGBTables tables;
+
+	return tables;
+}
+
+// Finds the encoded value whose linear value is the closest, which is exact and cheaper than powf.
+byte LinearToSRGB(const float value)
+{
+	const float* thresholds = GetSRGBTables().Thresholds;
+
+	return (byte)(std::upper_bound(thresholds, thresholds + 255, value) - thresholds);
+}
+
+int GetAlphaChannel(const int components)
+{
+	return components == 2 || components == 4 ? components - 1 : -1;
+}
+
+float BesselI0(const float x)
+{
+	const float halfSquared = x * x * 0.25f;
+	float sum = 1.0f;
+	float term = 1.0f;
+
+	for (int k = 1; k < 32 && term > sum * 1e-7f; k++)
+	{
+		term *= halfSquared / (float)(k * k);
+		sum += term;
+	}
+
+	return sum;
+}
+
+// Distance is measured in filter units, which are destination pixels when shrinking.
+float EvaluateFilter(const ImageFilter filter, const float distance)
+{
+	if (filter == ImageFilterBox)
+		return distance >= -0.5f && distance < 0.5f ? 1.0f : 0.0f;
+
+	if (fabsf(distance) >= KaiserWidth)
+		return 0.0f;
+
+	const float pi = 3.14159265f;
+	const float sinc = distance == 0.0f ? 1.0f : sinf(pi * distance) / (pi * distance);
+	const float t = distance / KaiserWidth;
+
+	return sinc * BesselI0(KaiserAlpha * sqrtf(1.0f - t * t)) / BesselI0(KaiserAlpha);
+}
+
+void ComputeTaps(const int sourceSize, const int destinationSize, const ImageFilter filter, FilterTaps& taps)
+{
+	const float scale = (float)sourceSize / destinationSize;
+	const float filterScale = scale > 1.0f ? scale : 1.0f;
+	const float radius = (filter == ImageFilterBox ? 0.5f : KaiserWidth) * filterScale;
+
+	taps.TapCount = (int)ceilf(radius * 2.0f) + 1;
+	taps.Indices.resize(destinationSize * taps.TapCount);
+	taps.Weights.resize(destinationSize * taps.TapCount);
+
+	for (int i = 0; i < destinationSize; i++)
+	{
+		const float center = (i + 0.5f) * scale;
+		const int first = (int)floorf(center - radius);
+		int* indices = &taps.Indices[i * taps.TapCount];
+		float* weights = &taps.Weights[i * taps.TapCount];
+		float sum = 0.0f;
+
+		// Samples past the edges repeat the edge pixels.
+		for (int t = 0; t < taps.TapCount; t++)
+		{
+			const int index = first + t;
+			indices[t] = index < 0 ? 0 : (index >= sourceSize ? sourceSize - 1 : index);
+			weights[t] = EvaluateFilter(filter, (index + 0.5f - center) / filterScale);
+			sum += weights[t];
+		}
+
+		if (sum != 0.0f)
+		{
+			for (int t = 0; t < taps.TapCount; t++)
+				weights[t] /= sum;
+		}
+	}
+}
+
+void DecodeRow(const byte*const pixels, const int width, const int components, const ImageFilterSettings& settings, float*const row)
+{
+	const float* toLinear = GetSRGBTables().ToLinear;
+	const int alphaChannel = GetAlphaChannel(components);
+	const bool weighted = settings.AlphaWeighted && alphaChannel >= 0;
+
+	for (int x = 0; x < width; x++)
+	{
+		const byte* pixel = pixels + x * components;
+		float* target = row + x * components;
+		const float alpha = alphaChannel >= 0 ? pixel[alphaChannel] / 255.0f : 1.0f;
+
+		for (int c = 0; c < components; c++)
+		{
+			if (c == alphaChannel)
+			{
+				target[c] = alpha;
+				continue;
+			}
+
+			const float value = settings.SRGB ? toLinear[pixel[c]] : pixel[c] / 255.0f;
+			target[c] = weighted ? value * alpha : value;
+		}
+	}
+}
+
+void EncodeRow(const float*const row, const int width, const int components, const ImageFilterSettings& settings, byte*const pixels)
+{
+	const int alphaChannel = GetAlphaChannel(components);
+	const bool weighted = settings.AlphaWeighted && alphaChannel >= 0;
+
+	for (int x = 0; x < width; x++)
+	{
+		const float* pixel = row + x * components;
+		byte* target = pixels + x * components;
+
+		const float alpha = alphaChannel >= 0 ? pixel[alphaChannel] : 1.0f;
+		const float colorScale = weighted && alpha > 0.0f ? 1.0f / alpha : 1.0f;
+
+		for (int c = 0; c < components; c++)
+		{
+			float value = c == alphaChannel ? alpha : pixel[c] * colorScale;
+			value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+
+			if (settings.SRGB && c != alphaChannel)
+				target[c] = LinearToSRGB(value);
+			else
+				target[c] = (byte)(value * 255.0f + 0.5f);
+		}
+	}
+}
+
+void FilterRow(const float*const source, const FilterTaps& taps, const int width, const int components, float*const destination)
+{
+	for (int x = 0; x < width; x++)
+	{
+		const int* indices = &taps.Indices[x * taps.TapCount];
+		const float* weights = &taps.Weights[x * taps.TapCount];
+		float* target = destination + x * components;
+
+#ifdef S3_SSE2
+		if (components == 4)
+		{
+			__m128 sum = _mm_setzero_ps();
+			for (int t = 0; t < taps.TapCount; t++)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source + indices[t] * 4), _mm_set1_ps(weights[t])));
+
+			_mm_storeu_ps(target, sum);
+			continue;
+		}
+#endif
+
+		for (int c = 0; c < components; c++)
+			target[c] = 0.0f;
+
+		for (int t = 0; t < taps.TapCount; t++)
+		{
+			const float* pixel = source + indices[t] * components;
+			for (int c = 0; c < components; c++)
+				target[c] += pixel[c] * weights[t];
+		}
+	}
+}
+
+void AccumulateRow(const float*const source, const float weight, const int count, float*const destination)
+{
+	int i = 0;
+
+#ifdef S3_SSE2
+	const __m128 weights = _mm_set1_ps(weight);
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(source + i), weights)));
+#endif
+
+	for (; i < count; i++)
+		destination[i] += source[i] * weight;
 }
\ No newline at end of file
@@ -3,7 +3,8 @@
 ImageUtils.h
 
 Declares image IO and processing functions.
-At the moment only includes image loading. A lot of stuff to do here.
+Loading is done by stb_image, processing kernels are vectorized with SSE2
+where available and spread rows over the shared thread pool.
 ===========================================================================
 */
 
@@ -14,11 +15,72 @@ At the moment only includes image loading. A lot of stuff to do here.
 
 namespace sedge
 {
+	enum BlockFormat
+	{
+		BlockNone, // uncompressed pixels
+		BlockBC1, // 4x4 blocks of 8 bytes, opaque RGB
+		BlockBC3, // 4x4 blocks of 16 bytes, RGB with interpolated alpha
+		BlockBC7 // 4x4 blocks of 16 bytes, high quality RGBA
+	};
+
+	struct ImageData
+	{
+		byte* Pixels;
+		int Width;
+		int Height;
+		int Components; // of the source image, compressed blocks always decode to RGBA
+		BlockFormat Format;
+
+		ImageData() : Pixels(nullptr), Width(0), Height(0), Components(0), Format(BlockNone) { }
+	};
+
+	enum ImageFilter
+	{
+		ImageFilterBox, // averages the covered pixels, cheap and blurry
+		ImageFilterKaiser // Kaiser-windowed sinc, keeps mip levels sharp
+	};
+
+	struct ImageFilterSettings
+	{
+		ImageFilter Filter;
+		bool SRGB; // colour channels are sRGB encoded and are filtered in linear space
+		bool AlphaWeighted; // colours are weighted by alpha, so transparent pixels do not bleed into opaque ones
+
+		ImageFilterSettings() : Filter(ImageFilterBox), SRGB(false), AlphaWeighted(false) { }
+		ImageFilterSettings(const ImageFilter filter, const bool srgb, const bool alphaWeighted)
+			: Filter(filter), SRGB(srgb), AlphaWeighted(alphaWeighted) { }
+	};
+
 	class ImageUtils
 	{
 	public:
 		static void SetFlipVertically(const bool flip);
 		static byte* LoadImage(const char* path, int* width, int* height, int* components);
+		static bool LoadImage(const char* path, ImageData& image);
+		// Decodes an image file that is already in memory.
+		static bool LoadImage(const byte*const data, const unsigned long long size, ImageData& image);
 		static void ReleaseImage(void* data);
+		static void ReleaseImage(ImageData& image);
+
+		// Size of the pixel data in bytes, compressed images are padded to whole blocks.
+		static uint GetDataSize(const ImageData& image);
+
+		// Number of levels in a full mip chain down to 1x1.
+		static uint GetMipLevelCount(const int width, const int height);
+		// Halves the image, the destination must hold the pixels of the next level.
+		static void GenerateMipLevel(const ImageData& source, ImageData& destination, const ImageFilterSettings& settings = ImageFilterSettings());
+
+		// Resamples the image to the size set in destination, which must hold its pixels.
+		// Works for both shrinking and enlarging, every axis is filtered separately.
+		static void Resize(const ImageData& source, ImageData& destination, const ImageFilterSettings& settings = ImageFilterSettings());
+
+		// Multiplies the colour channels by alpha in place. Does nothing for images without alpha.
+		static void PremultiplyAlpha(ImageData& image, const bool srgb);
+
+		// Rearranges the channels, destination gets one component per character of mapping.
+		// 'r', 'g', 'b' and 'a' pick a source channel, '0' and '1' write a constant.
+		static bool Swizzle(const ImageData& source, ImageData& destination, const char*const mapping);
+		// Converts grey, grey-alpha and RGB images to RGBA, the destination must hold 4 components per pixel.
+		static void ExpandToRGBA(const ImageData& source, ImageData& destination);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,212 @@
+/*
+===========================================================================
+LZ4.cpp
+
+Implements the LZ4 class.
+A block is a series of sequences, each a token (literal count in the high
+nibble, match length - 4 in the low one, 15 meaning more length bytes
+follow), the literals and a 16-bit offset back to the match. The last
+sequence has literals only.
+===========================================================================
+*/
+
+#include "LZ4.h"
+#include <cstring>
+
+using namespace sedge;
+
+static const uint MinMatch = 4;
+static const uint LastLiterals = 5; // the last bytes of a block are always literals
+static const uint MatchFindLimit = 12; // matches start at least this far from the end of the block
+static const uint MaxOffset = 65535;
+static const uint HashBits = 12;
+
+static inline uint Read32(const byte*const data);
+static inline uint Hash(const uint sequence);
+static bool WriteSequence(const byte*const literals, const uint literalLength, const uint offset, const uint matchLength, byte*const destination, uint& position, const uint capacity);
+static void WriteLength(uint length, byte*const destination, uint& position);
+static bool ReadLength(const byte*const source, const uint size, uint& position, uint& length);
+
+uint LZ4::GetMaxCompressedSize(const uint size)
+{
+	return size + size / 255 + 16;
+}
+
+uint LZ4::Compress(const byte*const source, const uint size, byte*const destination, const uint capacity)
+{
+	uint position = 0;
+	uint anchor = 0;
+
+	if (size > MatchFindLimit)
+	{
+		// Positions are stored plus one, so 0 marks an empty slot.
+		uint table[1 << HashBits];
+		memset(table, 0, sizeof(table));
+
+		const uint matchLimit = size - LastLiterals;
+		const uint searchLimit = size - MatchFindLimit;
+		uint current = 0;
+
+		while (current <= searchLimit)
+		{
+			const uint sequence = Read32(source + current);
+			const uint hash = Hash(sequence);
+			const uint candidate = table[hash];
+			table[hash] = current + 1;
+
+			if (candidate == 0 || current - (candidate - 1) > MaxOffset || Read32(source + candidate - 1) != sequence)
+			{
+				current++;
+				continue;
+			}
+
+			uint match = candidate - 1;
+			while (current > anchor && match > 0 && source[current - 1] == source[match - 1])
+			{
+				current--;
+				match--;
+			}
+
+			uint length = MinMatch;
+			while (current + length < matchLimit && source[current + length] == source[match + length])
+				length++;
+
+			if (!WriteSequence(source + anchor, current - anchor, current - match, length, destination, position, capacity))
+				return 0;
+
+			current += length;
+			anchor = current;
+		}
+	}
+
+	if (!WriteSequence(source + anchor, size - anchor, 0, 0, destination, position, capacity))
+		return 0;
+
+	return position;
+}
+
+bool LZ4::Decompress(const byte*const source, const uint size, byte*const destination, const uint decompressedSize)
+{
+	uint input = 0;
+	uint output = 0;
+
+	while (input < size)
+	{
+		const uint token = source[input++];
+
+		uint literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLength(source, size, input, literalLength))
+			return false;
+
+		if (literalLength > size - input || literalLength > decompressedSize - output)
+			return false;
+
+		memcpy(destination + output, source + input, literalLength);
+		input += literalLength;
+		output += literalLength;
+
+		if (input == size)
+			break;
+
+		if (size - input < 2)
+			return false;
+
+		const uint offset = source[input] | source[input + 1] << 8;
+		input += 2;
+
+		if (offset == 0 || offset > output)
+			return false;
+
+		uint matchLength = token & 15;
+		if (matchLength == 15 && !ReadLength(source, size, input, matchLength))
+			return false;
+
+		matchLength += MinMatch;
+		if (matchLength > decompressedSize - output)
+			return false;
+
+		// A match may overlap the bytes it produces, which repeats a pattern of offset bytes. Every copied
+		// chunk doubles the repeated part, so chunks never overlap and short patterns take few copies.
+		uint copied = 0;
+		while (copied < matchLength)
+		{
+			const uint period = (offset + copied) / offset * offset;
+			const uint chunk = period < matchLength - copied ? period : matchLength - copied;
+			memcpy(destination + output + copied, destination + output + copied - period, chunk);
+			copied += chunk;
+		}
+
+		output += matchLength;
+	}
+
+	return output == decompressedSize;
+}
+
+uint Read32(const byte*const data)
+{
+	uint value;
+	memcpy(&value, data, sizeof(value));
+
+	return value;
+}
+
+uint Hash(const uint sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+// An offset of 0 writes the final sequence, which has no match.
+bool WriteSequence(const byte*const literals, const uint literalLength, const uint offset, const uint matchLength, byte*const destination, uint& position, const uint capacity)
+{
+	const uint matchCode = offset != 0 ? matchLength - MinMatch : 0;
+	const unsigned long long required = 1ull + literalLength + literalLength / 255 + 1 + (offset != 0 ? 2 + matchCode / 255 + 1 : 0);
+	if (position + required > capacity)
+		return false;
+
+	const uint tokenPosition = position++;
+	destination[tokenPosition] = (byte)((literalLength >= 15 ? 15 : literalLength) << 4);
+
+	if (literalLength >= 15)
+		WriteLength(literalLength - 15, destination, position);
+
+	memcpy(destination + position, literals, literalLength);
+	position += literalLength;
+
+	if (offset == 0)
+		return true;
+
+	destination[position++] = (byte)(offset & 0xff);
+	destination[position++] = (byte)(offset >> 8);
+	destination[tokenPosition] |= (byte)(matchCode >= 15 ? 15 : matchCode);
+
+	if (matchCode >= 15)
+		WriteLength(matchCode - 15, destination, position);
+
+	return true;
+}
+
+void WriteLength(uint length, byte*const destination, uint& position)
+{
+	while (length >= 255)
+	{
+		destination[position++] = 255;
+		length -= 255;
+	}
+
+	destination[position++] = (byte)length;
+}
+
+bool ReadLength(const byte*const source, const uint size, uint& position, uint& length)
+{
+	uint value = 255;
+	while (value == 255)
+	{
+		if (position >= size || length > 0x7fffffff)
+			return false;
+
+		value = source[position++];
+		length += value;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+/*
+===========================================================================
+LZ4.h
+
+Compresses and decompresses raw LZ4 blocks, as used by pack archives.
+The compressor is the greedy single-probe variant of the reference
+implementation and the decompressor checks every read and write, so
+corrupt data fails instead of overrunning a buffer.
+===========================================================================
+*/
+
+#pragma once
+
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	class LZ4
+	{
+	public:
+		// Worst case size of incompressible data.
+		static uint GetMaxCompressedSize(const uint size);
+
+		// Returns the compressed size, 0 if it would not fit into capacity.
+		static uint Compress(const byte*const source, const uint size, byte*const destination, const uint capacity);
+
+		// The decompressed size must be known, fails unless the block decodes to exactly that many bytes.
+		static bool Decompress(const byte*const source, const uint size, byte*const destination, const uint decompressedSize);
+
+	private:
+		LZ4();
+		LZ4(const LZ4& tRef) = delete;
+		LZ4& operator = (const LZ4& tRef) = delete;
+	};
+}
\ No newline at end of file
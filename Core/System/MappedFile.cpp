@@ -0,0 +1,128 @@
+/*
+===========================================================================
+MappedFile.cpp
+
+Implements the MappedFile class with Win32 file mappings or POSIX mmap.
+===========================================================================
+*/
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace sedge;
+
+MappedFile::MappedFile()
+	: _data(nullptr), _size(0), _fileHandle(nullptr), _mappingHandle(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char*const path)
+{
+	Close();
+
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_data = (const byte*)data;
+	_size = size.QuadPart;
+	_fileHandle = file;
+	_mappingHandle = mapping;
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mappingHandle)
+		CloseHandle((HANDLE)_mappingHandle);
+	if (_fileHandle)
+		CloseHandle((HANDLE)_fileHandle);
+
+	_data = nullptr;
+	_size = 0;
+	_fileHandle = nullptr;
+	_mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const char*const path)
+{
+	Close();
+
+	const int file = open(path, O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	// The mapping stays valid after the descriptor is closed.
+	close(file);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	_data = (const byte*)data;
+	_size = status.st_size;
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (_data)
+		munmap((void*)_data, _size);
+
+	_data = nullptr;
+	_size = 0;
+}
+
+#endif
\ No newline at end of file
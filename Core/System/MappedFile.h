@@ -0,0 +1,39 @@
+/*
+===========================================================================
+MappedFile.h
+
+Maps a whole file into memory for reading.
+The contents are paged in by the OS on first access.
+===========================================================================
+*/
+
+#pragma once
+
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	class MappedFile
+	{
+	private:
+		const byte* _data;
+		unsigned long long _size;
+		void* _fileHandle;
+		void* _mappingHandle;
+
+	public:
+		MappedFile();
+		~MappedFile();
+
+		bool Open(const char*const path);
+		void Close();
+
+		inline bool IsOpen() const { return _data != nullptr; }
+		inline const byte* GetData() const { return _data; }
+		inline unsigned long long GetSize() const { return _size; }
+
+	private:
+		MappedFile(const MappedFile& tRef) = delete;
+		MappedFile& operator = (const MappedFile& tRef) = delete;
+	};
+}
\ No newline at end of file
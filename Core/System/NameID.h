@@ -0,0 +1,26 @@
+/*
+===========================================================================
+NameID.h
+
+Interned asset names. A name is reduced to a 32-bit FNV-1a hash, which is
+computed by the compiler for string literals passed to S3_NAME, so looking
+an asset up by a constant name costs no hashing or string building at all.
+===========================================================================
+*/
+
+#pragma once
+
+#include <type_traits>
+#include <CustomTypes.h>
+
+#define S3_NAME(name) (std::integral_constant<sedge::NameID, sedge::HashName(name)>::value)
+
+namespace sedge
+{
+	typedef uint NameID;
+
+	constexpr NameID HashName(const char*const name, const NameID hash = 2166136261u)
+	{
+		return *name == 0 ? hash : HashName(name + 1, (hash ^ (byte)*name) * 16777619u);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+/*
+===========================================================================
+PackFile.cpp
+
+Implements the PackFile class.
+===========================================================================
+*/
+
+#include "PackFile.h"
+#include "FileUtils.h"
+#include "LZ4.h"
+#include "Logger.h"
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
+
+using namespace sedge;
+
+static const char PackFileMagic[4] = { 'S', 'P', 'A', 'K' };
+static const uint PackFileVersion = 1;
+static const uint EntryAlignment = 16;
+static const unsigned long long MaxCompressedEntrySize = 1ull << 30; // LZ4 blocks are addressed with 32 bits
+
+struct PackFile::Header
+{
+	char Magic[4];
+	uint Version;
+	uint EntryCount;
+	uint StringSize;
+};
+
+struct PackFile::Entry
+{
+	unsigned long long Offset;
+	unsigned long long StoredSize;
+	unsigned long long Size;
+	uint PathOffset; // into the string table
+	uint Compression;
+};
+
+static unsigned long long Align(const unsigned long long offset);
+
+PackFile::PackFile()
+	: _header(nullptr), _entries(nullptr), _strings(nullptr)
+{
+}
+
+bool PackFile::Open(const char*const path)
+{
+	Close();
+
+	if (!_file.Open(path))
+		return false;
+
+	const byte* bytes = _file.GetData();
+	const unsigned long long size = _file.GetSize();
+	const Header* header = (const Header*)bytes;
+	const unsigned long long stringOffset = size >= sizeof(Header) ? sizeof(Header) + (unsigned long long)header->EntryCount * sizeof(Entry) : 0;
+
+	bool valid = size >= sizeof(Header)
+		&& memcmp(header->Magic, PackFileMagic, sizeof(PackFileMagic)) == 0
+		&& header->Version == PackFileVersion
+		&& stringOffset + header->StringSize <= size
+		&& header->StringSize > 0 && bytes[stringOffset + header->StringSize - 1] == 0;
+
+	const Entry* entries = (const Entry*)(bytes + sizeof(Header));
+	for (uint i = 0; valid && i < header->EntryCount; i++)
+	{
+		const Entry& entry = entries[i];
+		valid = entry.Offset <= size && entry.StoredSize <= size - entry.Offset
+			&& entry.PathOffset < header->StringSize
+			&& (entry.Compression == PackCompressionNone ? entry.StoredSize == entry.Size
+				: entry.Compression == PackCompressionLZ4 && entry.Size <= MaxCompressedEntrySize);
+	}
+
+	if (!valid)
+	{
+		_file.Close();
+		return false;
+	}
+
+	_path = path;
+	_header = header;
+	_entries = entries;
+	_strings = (const char*)(bytes + stringOffset);
+
+	return true;
+}
+
+void PackFile::Close()
+{
+	_file.Close();
+	_path.clear();
+	_header = nullptr;
+	_entries = nullptr;
+	_strings = nullptr;
+}
+
+uint PackFile::GetEntryCount() const
+{
+	return _header != nullptr ? _header->EntryCount : 0;
+}
+
+const char* PackFile::GetEntryPath(const uint index) const
+{
+	return _strings + _entries[index].PathOffset;
+}
+
+unsigned long long PackFile::GetEntrySize(const uint index) const
+{
+	return _entries[index].Size;
+}
+
+void PackFile::GetEntryLocation(const uint index, unsigned long long& offset, unsigned long long& storedSize, PackCompression& compression) const
+{
+	const Entry& entry = _entries[index];
+	offset = entry.Offset;
+	storedSize = entry.StoredSize;
+	compression = (PackCompression)entry.Compression;
+}
+
+int PackFile::Find(const char*const path) const
+{
+	int first = 0;
+	int last = (int)GetEntryCount() - 1;
+
+	while (first <= last)
+	{
+		const int middle = first + (last - first) / 2;
+		const int order = strcmp(_strings + _entries[middle].PathOffset, path);
+
+		if (order == 0)
+			return middle;
+
+		if (order < 0)
+			first = middle + 1;
+		else
+			last = middle - 1;
+	}
+
+	return -1;
+}
+
+bool PackFile::Read(const uint index, const byte*& data, std::vector<byte>& buffer) const
+{
+	const Entry& entry = _entries[index];
+	const byte* stored = _file.GetData() + entry.Offset;
+
+	if (entry.Compression == PackCompressionNone)
+	{
+		data = stored;
+		return true;
+	}
+
+	buffer.resize((size_t)entry.Size);
+	if (!Decompress((PackCompression)entry.Compression, stored, entry.StoredSize, buffer.data(), entry.Size))
+		return false;
+
+	data = buffer.data();
+
+	return true;
+}
+
+bool PackFile::IsPackFile(const char*const path)
+{
+	const size_t length = strlen(path);
+
+	return length >= 5 && strcmp(path + length - 5, ".spak") == 0;
+}
+
+bool PackFile::Decompress(const PackCompression compression, const byte*const source, const unsigned long long storedSize, byte*const destination, const unsigned long long size)
+{
+	switch (compression)
+	{
+	case PackCompressionNone:
+		if (storedSize != size)
+			return false;
+
+		memcpy(destination, source, (size_t)size);
+		return true;
+	case PackCompressionLZ4:
+		return size <= MaxCompressedEntrySize && LZ4::Decompress(source, (uint)storedSize, destination, (uint)size);
+	default:
+		return false;
+	}
+}
+
+bool PackFile::Write(const char*const path, const char*const directory, const PackCompression compression)
+{
+	std::vector<std::string> files;
+	if (!FileUtils::ListFiles(directory, files))
+	{
+		LOG_ERROR("Cannot list the files in \"", directory, "\"");
+		return false;
+	}
+
+	// The archive may be written into the directory it packs.
+	const std::string packPath = FileUtils::NormalizePath(path);
+	files.erase(std::remove_if(files.begin(), files.end(), [&](const std::string& file)
+	{
+		return FileUtils::NormalizePath(std::string(directory) + '/' + file) == packPath;
+	}), files.end());
+
+	// std::string orders like strcmp, which Find relies on.
+	std::sort(files.begin(), files.end());
+
+	std::ofstream stream(path, std::ios::binary);
+	if (!stream)
+	{
+		LOG_ERROR("Cannot create pack file \"", path, "\"");
+		return false;
+	}
+
+	Header header;
+	memcpy(header.Magic, PackFileMagic, sizeof(PackFileMagic));
+	header.Version = PackFileVersion;
+	header.EntryCount = files.size();
+
+	std::vector<Entry> entries(files.size());
+	std::string strings;
+	for (uint i = 0; i < files.size(); i++)
+	{
+		entries[i].PathOffset = strings.size();
+		strings += files[i];
+		strings += '\0';
+	}
+
+	// Keeps the table terminated even for an empty archive.
+	if (strings.empty())
+		strings += '\0';
+
+	header.StringSize = strings.size();
+
+	// The data goes first, header and directory are written once the stored sizes are known.
+	unsigned long long offset = Align(sizeof(Header) + entries.size() * sizeof(Entry) + strings.size());
+	stream.seekp(offset);
+
+	const char padding[EntryAlignment] = {};
+	std::vector<byte> compressed;
+	MappedFile source;
+
+	for (uint i = 0; i < files.size(); i++)
+	{
+		const std::string filePath = std::string(directory) + '/' + files[i];
+
+		// Mapping fails for empty files, which are packed as they are.
+		struct stat status;
+		if (stat(filePath.c_str(), &status) != 0 || (status.st_size > 0 && !source.Open(filePath.c_str())))
+		{
+			LOG_ERROR("Cannot read \"", filePath, "\" into pack file \"", path, "\"");
+			return false;
+		}
+
+		const byte* data = source.GetData();
+		const unsigned long long size = source.GetSize();
+
+		Entry& entry = entries[i];
+		entry.Offset = offset;
+		entry.Size = size;
+		entry.StoredSize = size;
+		entry.Compression = PackCompressionNone;
+
+		if (compression == PackCompressionLZ4 && size > 0 && size <= MaxCompressedEntrySize)
+		{
+			compressed.resize(LZ4::GetMaxCompressedSize((uint)size));
+			const uint compressedSize = LZ4::Compress(data, (uint)size, compressed.data(), (uint)(size - size / 8));
+			if (compressedSize > 0)
+			{
+				data = compressed.data();
+				entry.StoredSize = compressedSize;
+				entry.Compression = PackCompressionLZ4;
+			}
+		}
+
+		stream.write((const char*)data, entry.StoredSize);
+		source.Close();
+
+		const unsigned long long end = offset + entry.StoredSize;
+		offset = Align(end);
+		stream.write(padding, offset - end);
+	}
+
+	stream.seekp(0);
+	stream.write((const char*)&header, sizeof(header));
+	stream.write((const char*)entries.data(), entries.size() * sizeof(Entry));
+	stream.write(strings.data(), strings.size());
+
+	if (!stream)
+	{
+		LOG_ERROR("Failed to write pack file \"", path, "\"");
+		return false;
+	}
+
+	return true;
+}
+
+unsigned long long Align(const unsigned long long offset)
+{
+	return (offset + EntryAlignment - 1) / EntryAlignment * EntryAlignment;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+===========================================================================
+PackFile.h
+
+A read-only archive that holds a whole directory tree in one file, so
+shipping thousands of assets costs one open and one mapping instead of
+one of each per asset. Stored entries are handed out as pointers into
+the mapping, compressed ones are decompressed into a buffer on read.
+
+Layout of a *.spak file:
+	header (entry count, string table size)
+	Entry entries[EntryCount], sorted by path
+	paths relative to the packed directory, '/' separated, null-terminated
+	entry data, every entry starting at a multiple of 16
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <CustomTypes.h>
+#include "MappedFile.h"
+
+namespace sedge
+{
+	enum PackCompression
+	{
+		PackCompressionNone,
+		PackCompressionLZ4
+	};
+
+	class PackFile
+	{
+	private:
+		struct Header;
+		struct Entry;
+
+		std::string _path;
+		MappedFile _file;
+		const Header* _header;
+		const Entry* _entries;
+		const char* _strings;
+
+	public:
+		PackFile();
+
+		// Fails without logging if the file is missing or malformed.
+		bool Open(const char*const path);
+		void Close();
+
+		inline bool IsOpen() const { return _header != nullptr; }
+		inline const char* GetPath() const { return _path.c_str(); }
+
+		uint GetEntryCount() const;
+		const char* GetEntryPath(const uint index) const;
+		unsigned long long GetEntrySize(const uint index) const;
+		// Where the entry's stored bytes lie in the archive, for reading them without the mapping.
+		void GetEntryLocation(const uint index, unsigned long long& offset, unsigned long long& storedSize, PackCompression& compression) const;
+
+		// Looks up a normalized relative path, -1 if the archive does not contain it.
+		int Find(const char*const path) const;
+
+		// Points data into the mapping for stored entries, decompresses into buffer otherwise.
+		// Thread-safe as long as every thread passes its own buffer.
+		bool Read(const uint index, const byte*& data, std::vector<byte>& buffer) const;
+
+		static bool IsPackFile(const char*const path);
+		static bool Decompress(const PackCompression compression, const byte*const source, const unsigned long long storedSize, byte*const destination, const unsigned long long size);
+
+		// Packs every file under the directory. With LZ4, entries are compressed when that saves at least
+		// an eighth of their size, the rest stays stored and can still be read without a copy.
+		static bool Write(const char*const path, const char*const directory, const PackCompression compression);
+
+	private:
+		PackFile(const PackFile& tRef) = delete;
+		PackFile& operator = (const PackFile& tRef) = delete;
+	};
+}
\ No newline at end of file
@@ -51,4 +51,12 @@ float Stopwatch::ElapsedMS() const
 		return std::chrono::duration_cast<ms>(clock::now() - _startTime).count();
 	else
 		return std::chrono::duration_cast<ms>(_stopTime - _startTime).count();
+}
+
+long long Stopwatch::ElapsedNanoseconds() const
+{
+	if (_running)
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _startTime).count();
+	else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(_stopTime - _startTime).count();
 }
\ No newline at end of file
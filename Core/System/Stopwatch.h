@@ -33,5 +33,7 @@ namespace sedge
 		float ElapsedS() const;
 		float ElapsedNS() const;
 		float ElapsedMS() const;
+		// Exact however long the stopwatch runs, unlike the floats above.
+		long long ElapsedNanoseconds() const;
 	};
 }
\ No newline at end of file
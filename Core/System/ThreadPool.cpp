@@ -0,0 +1,337 @@
+/*
+===========================================================================
+ThreadPool.cpp
+
+Implements the JobCounter and ThreadPool classes.
+===========================================================================
+*/
+
+#include "ThreadPool.h"
+#include <deque>
+#include <algorithm>
+
+using namespace sedge;
+
+struct ThreadPool::Job
+{
+	std::function<void()> Task;
+	JobCounter* Counter;
+};
+
+struct ThreadPool::WorkQueue
+{
+	std::deque<Job> Jobs;
+	std::mutex Mutex;
+};
+
+// The pool and queue of the worker running on this thread, nullptr for threads that are no workers.
+static thread_local ThreadPool* CurrentPool = nullptr;
+static thread_local uint CurrentQueue = 0;
+
+JobCounter::JobCounter()
+	: _count(0)
+{
+}
+
+bool JobCounter::IsDone() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _count == 0;
+}
+
+ThreadPool::ThreadPool(const uint threadCount)
+	: _queueCount(threadCount > 0 ? threadCount : 1), _nextQueue(0), _queuedJobs(0), _sleepingWorkers(0), _waitingThreads(0), _running(true)
+{
+	_queues = new WorkQueue[_queueCount];
+
+	_workers.reserve(threadCount);
+	for (uint i = 0; i < threadCount; i++)
+		_workers.emplace_back(&ThreadPool::ProcessTasks, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_running = false;
+	}
+
+	_workCondition.notify_all();
+
+	for (std::thread& worker : _workers)
+		worker.join();
+
+	delete[] _queues;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	Job job = { std::move(task), nullptr };
+	Push(job);
+}
+
+void ThreadPool::Enqueue(std::function<void()> task, JobCounter& counter)
+{
+	{
+		std::lock_guard<std::mutex> lock(counter._mutex);
+		counter._count++;
+	}
+
+	Job job = { std::move(task), &counter };
+	Push(job);
+}
+
+void ThreadPool::Enqueue(std::function<void()> task, JobCounter& counter, JobCounter& dependency)
+{
+	{
+		std::lock_guard<std::mutex> lock(counter._mutex);
+		counter._count++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(dependency._mutex);
+		if (dependency._count > 0)
+		{
+			JobCounter* counterPointer = &counter;
+			dependency._continuations.emplace_back([this, task, counterPointer]() mutable
+			{
+				Job job = { std::move(task), counterPointer };
+				Push(job);
+			});
+
+			return;
+		}
+	}
+
+	Job job = { std::move(task), &counter };
+	Push(job);
+}
+
+void ThreadPool::Wait(const JobCounter& counter)
+{
+	const bool isWorker = CurrentPool == this;
+	// Without workers nobody else would run the jobs the counter's jobs depend on.
+	const JobCounter* filter = isWorker || _workers.empty() ? nullptr : &counter;
+
+	Job job;
+	while (!counter.IsDone())
+	{
+		if (TakeJob(job, filter))
+		{
+			RunJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		_waitingThreads++;
+
+		// Waiting workers are woken by new jobs as well, they may run any of them.
+		if (isWorker)
+		{
+			_sleepingWorkers++;
+			_workCondition.wait(lock, [&] { return _queuedJobs > 0 || counter.IsDone(); });
+			_sleepingWorkers--;
+		}
+		else
+			_waitCondition.wait(lock, [&] { return counter.IsDone(); });
+
+		_waitingThreads--;
+	}
+}
+
+void ThreadPool::ParallelFor(const uint begin, const uint end, const uint grainSize, const std::function<void(const uint, const uint)>& body)
+{
+	if (begin >= end)
+		return;
+
+	const uint grain = grainSize > 0 ? grainSize : 1;
+	const uint rangeCount = (end - begin + grain - 1) / grain;
+	const uint helperCount = rangeCount - 1 < _workers.size() ? rangeCount - 1 : _workers.size();
+
+	if (helperCount == 0)
+	{
+		body(begin, end);
+		return;
+	}
+
+	// Ranges are claimed rather than assigned, so helpers that start late find nothing left to do and the
+	// caller, which only runs the helpers of this call while it waits, never waits for a busy worker's queue.
+	std::atomic<uint> nextRange(0);
+	auto processRanges = [&]()
+	{
+		for (uint range = nextRange++; range < rangeCount; range = nextRange++)
+		{
+			const uint rangeBegin = begin + range * grain;
+			const uint rangeEnd = end - rangeBegin > grain ? rangeBegin + grain : end;
+			body(rangeBegin, rangeEnd);
+		}
+	};
+
+	JobCounter counter;
+	for (uint i = 0; i < helperCount; i++)
+		Enqueue(processRanges, counter);
+
+	processRanges();
+
+	Wait(counter);
+}
+
+void ThreadPool::EnqueueOnMainThread(std::function<void()> task)
+{
+	std::lock_guard<std::mutex> lock(_mainThreadMutex);
+
+	_mainThreadJobs.push_back(std::move(task));
+}
+
+void ThreadPool::RunMainThreadJobs()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mainThreadMutex);
+		if (_mainThreadJobs.empty())
+			return;
+
+		_mainThreadBatch.swap(_mainThreadJobs);
+	}
+
+	for (std::function<void()>& task : _mainThreadBatch)
+		task();
+
+	_mainThreadBatch.clear();
+}
+
+ThreadPool& ThreadPool::GetShared()
+{
+	// Keep at least one worker, tasks queued with Enqueue would never run otherwise.
+	static ThreadPool pool(std::thread::hardware_concurrency() > 2 ? std::thread::hardware_concurrency() - 1 : 1);
+
+	return pool;
+}
+
+void ThreadPool::ProcessTasks(const uint queueIndex)
+{
+	CurrentPool = this;
+	CurrentQueue = queueIndex;
+
+	Job job;
+	while (true)
+	{
+		if (TakeJob(job, nullptr))
+		{
+			RunJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (!_running && _queuedJobs == 0)
+			return;
+
+		// Registered as sleeping before checking for jobs, so Push either sees the sleeper or the sleeper sees the job.
+		_sleepingWorkers++;
+		_workCondition.wait(lock, [this] { return !_running || _queuedJobs > 0; });
+		_sleepingWorkers--;
+	}
+}
+
+void ThreadPool::Push(Job& job)
+{
+	const uint queueIndex = CurrentPool == this ? CurrentQueue : _nextQueue++ % _queueCount;
+
+	{
+		WorkQueue& queue = _queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+
+		// Counted before the job can be taken, TakeJob's decrement must never come first.
+		_queuedJobs++;
+		queue.Jobs.push_back(std::move(job));
+	}
+
+	if (_sleepingWorkers > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+		}
+
+		_workCondition.notify_one();
+	}
+}
+
+bool ThreadPool::TakeJob(Job& job, const JobCounter*const counter)
+{
+	if (_queuedJobs == 0)
+		return false;
+
+	const bool isWorker = CurrentPool == this;
+	const uint first = isWorker ? CurrentQueue : 0;
+
+	// Workers take their own newest job, which is likely still in the cache, and steal the oldest ones of the others.
+	for (uint i = 0; i < _queueCount; i++)
+	{
+		WorkQueue& queue = _queues[(first + i) % _queueCount];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+
+		if (queue.Jobs.empty())
+			continue;
+
+		if (counter != nullptr)
+		{
+			auto match = std::find_if(queue.Jobs.begin(), queue.Jobs.end(), [counter](const Job& queued) { return queued.Counter == counter; });
+			if (match == queue.Jobs.end())
+				continue;
+
+			job = std::move(*match);
+			queue.Jobs.erase(match);
+		}
+		else if (isWorker && i == 0)
+		{
+			job = std::move(queue.Jobs.back());
+			queue.Jobs.pop_back();
+		}
+		else
+		{
+			job = std::move(queue.Jobs.front());
+			queue.Jobs.pop_front();
+		}
+
+		_queuedJobs--;
+
+		return true;
+	}
+
+	return false;
+}
+
+void ThreadPool::RunJob(Job& job)
+{
+	job.Task();
+
+	// The task may hold references to whatever the waiting thread frees once the counter is done.
+	job.Task = nullptr;
+
+	if (job.Counter != nullptr)
+		Finish(*job.Counter);
+}
+
+void ThreadPool::Finish(JobCounter& counter)
+{
+	std::vector<std::function<void()>> continuations;
+
+	// The counter may be gone as soon as the lock is released, it is not touched afterwards.
+	{
+		std::lock_guard<std::mutex> lock(counter._mutex);
+		if (--counter._count > 0)
+			return;
+
+		continuations.swap(counter._continuations);
+	}
+
+	for (std::function<void()>& continuation : continuations)
+		continuation();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_waitingThreads > 0)
+	{
+		_workCondition.notify_all();
+		_waitCondition.notify_all();
+	}
+}
\ No newline at end of file
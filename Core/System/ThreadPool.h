@@ -0,0 +1,117 @@
+/*
+===========================================================================
+ThreadPool.h
+
+A work-stealing job scheduler with a fixed set of worker threads.
+Every worker owns a queue: jobs enqueued by a worker go to the back of
+its own queue and are taken from there, most recent first, while idle
+workers steal the oldest jobs from the front of the others. Jobs
+enqueued by other threads are spread over the queues in turn.
+
+Jobs can be grouped under a JobCounter, which is waited for or made the
+dependency of further jobs. A thread waiting for a counter runs queued
+jobs instead of blocking, so jobs may wait for jobs of their own.
+ParallelFor splits an index range into chunks that are processed by the
+workers and the calling thread together.
+
+Work that must run on the main thread, e.g. uploading what a job
+prepared to the graphics API, is queued with EnqueueOnMainThread and
+run by RunMainThreadJobs, which the engine calls once per frame.
+===========================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <CustomTypes.h>
+
+namespace sedge
+{
+	// The number of unfinished jobs of a group. Must outlive its jobs and the jobs depending on it.
+	class JobCounter
+	{
+	private:
+		uint _count;
+		std::vector<std::function<void()>> _continuations; // enqueue the dependent jobs once the count drops to zero
+		mutable std::mutex _mutex;
+
+	public:
+		JobCounter();
+
+		bool IsDone() const;
+
+	private:
+		JobCounter(const JobCounter& tRef) = delete;
+		JobCounter& operator = (const JobCounter& tRef) = delete;
+
+		friend class ThreadPool;
+	};
+
+	class ThreadPool
+	{
+	private:
+		struct Job;
+		struct WorkQueue;
+
+		std::vector<std::thread> _workers;
+		WorkQueue* _queues; // one per worker, at least one
+		uint _queueCount;
+		std::atomic<uint> _nextQueue;
+		std::atomic<uint> _queuedJobs;
+		std::atomic<uint> _sleepingWorkers;
+		uint _waitingThreads;
+		std::mutex _mutex;
+		std::condition_variable _workCondition;
+		std::condition_variable _waitCondition;
+		bool _running;
+
+		std::vector<std::function<void()>> _mainThreadJobs;
+		std::vector<std::function<void()>> _mainThreadBatch;
+		std::mutex _mainThreadMutex;
+
+	public:
+		// The calling thread takes part in ParallelFor, so threadCount + 1 cores are used.
+		explicit ThreadPool(const uint threadCount);
+		// Runs all queued jobs first, jobs still waiting for a dependency are dropped.
+		~ThreadPool();
+
+		inline uint GetThreadCount() const { return _workers.size(); }
+
+		void Enqueue(std::function<void()> task);
+		void Enqueue(std::function<void()> task, JobCounter& counter);
+		// The job is counted right away but only queued once the dependency is done.
+		void Enqueue(std::function<void()> task, JobCounter& counter, JobCounter& dependency);
+
+		// Returns once all jobs of the counter are done. Workers run any queued job meanwhile, other threads only
+		// the jobs of the counter, so waiting never makes them pick up an unrelated long task.
+		void Wait(const JobCounter& counter);
+
+		// Calls body(rangeBegin, rangeEnd) for consecutive ranges of grainSize indices, the last one possibly shorter,
+		// and returns once all of them are done. May be called from the pool's own jobs.
+		void ParallelFor(const uint begin, const uint end, const uint grainSize, const std::function<void(const uint, const uint)>& body);
+
+		// Queues a task for the next RunMainThreadJobs call, the way jobs hand over work that needs the graphics context.
+		void EnqueueOnMainThread(std::function<void()> task);
+		// Runs the tasks queued so far, tasks they queue themselves wait for the next call.
+		void RunMainThreadJobs();
+
+		// A pool with a worker for every hardware thread but the calling one.
+		static ThreadPool& GetShared();
+
+	private:
+		void ProcessTasks(const uint queueIndex);
+		void Push(Job& job);
+		// With a counter given only its jobs are taken.
+		bool TakeJob(Job& job, const JobCounter*const counter);
+		void RunJob(Job& job);
+		void Finish(JobCounter& counter);
+
+		ThreadPool(const ThreadPool& tRef) = delete;
+		ThreadPool& operator = (const ThreadPool& tRef) = delete;
+	};
+}
\ No newline at end of file